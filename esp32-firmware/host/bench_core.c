@@ -0,0 +1,239 @@
+/* Microbenchmarks for the firmware core's hot paths, run on the host:
+ *   bench_core [--iterations N] [--filter NAME] [--max-allocs N]
+ * Prints ns/op and heap calls/op per case. With --max-allocs the exit status is 1 when any case
+ * allocates more per op than allowed (the request paths are meant to stay at 0). */
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "fw_config.h"
+#include "fw_control.h"
+#include "fw_hal_host.h"
+#include "fw_json.h"
+#include "fw_manifest.h"
+#include "fw_util.h"
+
+/* Linked with -Wl,--wrap so every heap call made by the core and by this file is counted. */
+static uint64_t g_heap_calls;
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t n, size_t size);
+void *__real_realloc(void *p, size_t size);
+void *__wrap_malloc(size_t size) {
+    g_heap_calls++;
+    return __real_malloc(size);
+}
+void *__wrap_calloc(size_t n, size_t size) {
+    g_heap_calls++;
+    return __real_calloc(n, size);
+}
+void *__wrap_realloc(void *p, size_t size) {
+    g_heap_calls++;
+    return __real_realloc(p, size);
+}
+
+static const char *const OTA_KEY = "bench-ota-key";
+static const char *const DEVICE_TYPE = "relay_switch";
+static const char *const SHA256_HEX = "9f86d081884c7d659a2feaa0c55ad015a3bf4f1b2b0b822cd15d6c15b0f00a08";
+
+static char g_manifest[512];
+static char g_status_buf[JSON_WRITER_BUF];
+static uint8_t g_config_blob[sizeof(device_config_t)];
+static volatile size_t g_sink; /* keeps results observable so the loops are not optimised away */
+
+static const char *const CONTROL_BODIES[] = {
+    "{\"channel\":\"relay2\",\"state\":\"toggle\"}",
+    "{\"channel\":\"dimmer\",\"state\":\"set\",\"value\":42,\"transition_ms\":250}",
+    "{\"channel\":\"rgb\",\"state\":\"set\",\"r\":255,\"g\":64,\"b\":0}",
+    "{\"channel\":3,\"state\":\"on\",\"duration_ms\":5000}",
+};
+#define CONTROL_BODY_COUNT (sizeof(CONTROL_BODIES) / sizeof(CONTROL_BODIES[0]))
+
+/* Numbers strtod would take but JSON does not, or that no cast can hold: the flat parse must refuse them. */
+static const char *const REJECTED_BODIES[] = {
+    "{\"channel\":\"dimmer\",\"state\":\"set\",\"value\":inf}",
+    "{\"channel\":\"dimmer\",\"state\":\"set\",\"value\":-infinity}",
+    "{\"channel\":\"dimmer\",\"state\":\"set\",\"value\":nan}",
+    "{\"channel\":\"dimmer\",\"state\":\"set\",\"value\":0x40}",
+    "{\"channel\":\"dimmer\",\"state\":\"set\",\"value\":1e999}",
+    "{\"channel\":\"relay1\",\"state\":\"on\",\"apply_at\":-1e400}",
+    "{\"channel\":\"dimmer\",\"state\":\"set\",\"value\":+5}",
+    "{\"channel\":\"dimmer\",\"state\":\"set\",\"value\":.5}",
+    "{\"channel\":\"dimmer\",\"state\":\"set\",\"value\":5.}",
+    "{\"channel\":\"dimmer\",\"state\":\"set\",\"value\":1e}",
+};
+#define REJECTED_BODY_COUNT (sizeof(REJECTED_BODIES) / sizeof(REJECTED_BODIES[0]))
+
+static void case_control_dispatch(uint64_t i) {
+    flat_json_t fj;
+    control_op_t op;
+    char channel[24];
+    if (!flat_json_parse(CONTROL_BODIES[i % CONTROL_BODY_COUNT], &fj)) return;
+    if (control_op_from_flat(&fj, &op, channel, sizeof(channel))) g_sink += control_op_apply(&op);
+}
+
+static void case_control_batch(uint64_t i) {
+    control_op_t ops[4] = {
+        {.channel = CTRL_CH_RELAY1, .action = CTRL_ACT_TOGGLE},
+        {.channel = (control_channel_t)(CTRL_CH_RELAY1 + 1), .action = (i & 1) ? CTRL_ACT_ON : CTRL_ACT_OFF},
+        {.channel = CTRL_CH_DIMMER, .action = CTRL_ACT_SET, .value = (int)(i % 101)},
+        {.channel = CTRL_CH_FAN_SPEED, .action = CTRL_ACT_SET, .value = (int)(i % 101)},
+    };
+    begin_output_batch();
+    for (int k = 0; k < 4; k++) g_sink += control_op_apply(&ops[k]);
+    end_output_batch();
+}
+
+static void case_status_json(uint64_t i) {
+    json_writer_t jw;
+    g_state.dimmer_pct = (int)(i % 101);
+    jw_init_sink(&jw, NULL, NULL, g_status_buf, sizeof(g_status_buf));
+    jw_begin_object(&jw, NULL);
+    jw_begin_object(&jw, "outputs");
+    write_outputs_json(&jw, &g_state, MAX_RELAYS);
+    jw_end_object(&jw);
+    jw_end_object(&jw);
+    g_sink += jw.len;
+}
+
+static void case_status_delta(uint64_t i) {
+    output_state_t prev = g_state;
+    output_state_t cur = g_state;
+    cur.relay[i % MAX_RELAYS] = !cur.relay[i % MAX_RELAYS];
+    cur.dimmer_pct = (int)(i % 101);
+    json_writer_t jw;
+    jw_init_sink(&jw, NULL, NULL, g_status_buf, sizeof(g_status_buf));
+    jw_begin_object(&jw, NULL);
+    g_sink += (size_t)write_output_delta_json(&jw, &prev, &cur, MAX_RELAYS);
+    jw_end_object(&jw);
+}
+
+static void case_manifest_verify(uint64_t i) {
+    char sha[65];
+    g_sink += manifest_verify(g_manifest, OTA_KEY, DEVICE_TYPE, sha, sizeof(sha)) == MANIFEST_OK;
+}
+
+static void case_config_load(uint64_t i) {
+    static device_config_t cfg;
+    g_sink += cfg_load_device_blob(&cfg, g_config_blob, sizeof(g_config_blob));
+    sanitize_relay_gpio_map(&cfg);
+    sanitize_state_save_delay(&cfg);
+    for (size_t s = 0; s < CFG_SECTION_COUNT; s++) g_sink += cfg_section_hash(&CFG_SECTIONS[s], &cfg);
+}
+
+typedef struct {
+    const char *name;
+    void (*run)(uint64_t i);
+} bench_case_t;
+
+static const bench_case_t CASES[] = {
+    {"control_dispatch", case_control_dispatch},
+    {"control_batch4", case_control_batch},
+    {"status_json", case_status_json},
+    {"status_delta", case_status_delta},
+    {"manifest_verify", case_manifest_verify},
+    {"config_load", case_config_load},
+};
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/* Fails loudly if the fixtures do not exercise the success paths, so timings are never for early exits. */
+static bool setup_fixtures(void) {
+    static const int relay_gpio[MAX_RELAYS] = {16, 17, 18, 19, 21, 22, 23, 25};
+    init_gamma_table();
+    control_registry_build(g_channels, relay_gpio, MAX_RELAYS, -1, 27);
+
+    char sig[65];
+    if (!compute_manifest_signature(OTA_KEY, SHA256_HEX, "1.2.3", DEVICE_TYPE, sig, sizeof(sig))) return false;
+    snprintf(g_manifest, sizeof(g_manifest),
+             "{\"version\":\"1.2.3\",\"device_type\":\"%s\",\"firmware_filename\":\"fw-1.2.3.bin\",\"sha256\":\"%s\","
+             "\"size\":1048576,\"algorithm\":\"hmac-sha256\",\"signature\":\"%s\",\"patch\":{\"format\":\"8bdp1\"}}",
+             DEVICE_TYPE, SHA256_HEX, sig);
+    char sha[65];
+    if (manifest_verify(g_manifest, OTA_KEY, DEVICE_TYPE, sha, sizeof(sha)) != MANIFEST_OK) {
+        fprintf(stderr, "fixture: manifest does not verify\n");
+        return false;
+    }
+
+    device_config_t cfg = {0};
+    safe_strcpy(cfg.name, "bench", sizeof(cfg.name));
+    safe_strcpy(cfg.type, DEVICE_TYPE, sizeof(cfg.type));
+    cfg.relay_count = MAX_RELAYS;
+    memcpy(cfg.relay_gpio, relay_gpio, sizeof(cfg.relay_gpio));
+    cfg.state_save_delay_ms = STATE_SAVE_DELAY_DEFAULT_MS;
+    memcpy(g_config_blob, &cfg, sizeof(cfg));
+
+    flat_json_t fj;
+    control_op_t op;
+    char channel[24];
+    for (size_t i = 0; i < CONTROL_BODY_COUNT; i++) {
+        if (!flat_json_parse(CONTROL_BODIES[i], &fj) || !control_op_from_flat(&fj, &op, channel, sizeof(channel)) ||
+            !control_op_apply(&op)) {
+            fprintf(stderr, "fixture: control body %zu not applied\n", i);
+            return false;
+        }
+    }
+    for (size_t i = 0; i < REJECTED_BODY_COUNT; i++) {
+        if (flat_json_parse(REJECTED_BODIES[i], &fj)) {
+            fprintf(stderr, "fixture: rejected body %zu parsed\n", i);
+            return false;
+        }
+    }
+    /* In-range doubles that do not fit an int saturate instead of hitting an undefined cast. */
+    int big = 0;
+    int small = 0;
+    double apply_at = 0;
+    if (!flat_json_parse("{\"value\":1e300,\"rgb\":-3000000000,\"apply_at\":1.7e12}", &fj) ||
+        !flat_json_get_int(&fj, "value", &big) || big != INT_MAX || !flat_json_get_int(&fj, "rgb", &small) || small != INT_MIN ||
+        !flat_json_get_num(&fj, "apply_at", &apply_at) || apply_at != 1.7e12) {
+        fprintf(stderr, "fixture: out-of-range numbers not saturated\n");
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char **argv) {
+    uint64_t iterations = 1000000;
+    const char *filter = NULL;
+    long max_allocs = -1;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            iterations = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (strcmp(argv[i], "--max-allocs") == 0 && i + 1 < argc) {
+            max_allocs = strtol(argv[++i], NULL, 10);
+        } else {
+            fprintf(stderr, "usage: %s [--iterations N] [--filter NAME] [--max-allocs N]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (iterations == 0) iterations = 1;
+    if (!setup_fixtures()) return 1;
+
+    int status = 0;
+    printf("%-18s %12s %12s %14s\n", "case", "iterations", "ns/op", "heap calls/op");
+    for (size_t c = 0; c < sizeof(CASES) / sizeof(CASES[0]); c++) {
+        if (filter && !strstr(CASES[c].name, filter)) continue;
+        for (uint64_t i = 0; i < iterations / 100 + 1; i++) CASES[c].run(i); /* warm caches and branch predictors */
+        uint64_t heap_before = g_heap_calls;
+        uint64_t start = now_ns();
+        for (uint64_t i = 0; i < iterations; i++) CASES[c].run(i);
+        uint64_t elapsed = now_ns() - start;
+        double allocs = (double)(g_heap_calls - heap_before) / (double)iterations;
+        printf("%-18s %12llu %12.1f %14.3f\n", CASES[c].name, (unsigned long long)iterations, (double)elapsed / (double)iterations,
+               allocs);
+        if (max_allocs >= 0 && allocs > (double)max_allocs) status = 1;
+    }
+    printf("gpio writes %llu, batched %llu, pwm writes %llu, change notifications %llu\n",
+           (unsigned long long)g_host_hal.gpio_writes, (unsigned long long)g_host_hal.gpio_mask_writes,
+           (unsigned long long)g_host_hal.pwm_writes, (unsigned long long)g_host_hal.outputs_changed);
+    return status;
+}
@@ -0,0 +1,94 @@
+/* Applies an 8bdp1 delta patch on the host through the same fw_delta core the firmware runs:
+ *   delta_apply BASE PATCH TARGET_SIZE OUT [CHUNK]
+ * The patch is fed in CHUNK-byte pieces (default 4096) to exercise chunk-boundary handling.
+ * Prints the delta_result_t name; exit status 0 only when the patch applied completely. */
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "fw_delta.h"
+
+typedef struct {
+    const uint8_t *base;
+    size_t base_len;
+    FILE *out;
+} apply_ctx_t;
+
+static uint8_t *read_file(const char *path, size_t *len) {
+    FILE *f = fopen(path, "rb");
+    if (!f) return NULL;
+    uint8_t *buf = NULL;
+    size_t cap = 0;
+    bool ok = true;
+    *len = 0;
+    for (;;) {
+        if (*len == cap) {
+            cap = cap ? cap * 2 : 4096;
+            uint8_t *grown = realloc(buf, cap);
+            if (!grown) {
+                ok = false;
+                break;
+            }
+            buf = grown;
+        }
+        size_t n = fread(buf + *len, 1, cap - *len, f);
+        if (n == 0) break;
+        *len += n;
+    }
+    ok = ok && !ferror(f);
+    fclose(f);
+    if (!ok) {
+        free(buf);
+        return NULL;
+    }
+    return buf;
+}
+
+static bool apply_read_base(void *ctx, uint32_t offset, uint8_t *buf, size_t len) {
+    apply_ctx_t *a = (apply_ctx_t *)ctx;
+    if (offset > a->base_len || len > a->base_len - offset) return false;
+    memcpy(buf, a->base + offset, len);
+    return true;
+}
+
+static bool apply_emit(void *ctx, const uint8_t *data, size_t len) {
+    apply_ctx_t *a = (apply_ctx_t *)ctx;
+    return fwrite(data, 1, len, a->out) == len;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 5 || argc > 6) {
+        fprintf(stderr, "usage: %s BASE PATCH TARGET_SIZE OUT [CHUNK]\n", argv[0]);
+        return 2;
+    }
+    size_t base_len = 0;
+    size_t patch_len = 0;
+    uint8_t *base = read_file(argv[1], &base_len);
+    uint8_t *patch = read_file(argv[2], &patch_len);
+    unsigned long target_size = strtoul(argv[3], NULL, 10);
+    size_t chunk = argc == 6 ? strtoul(argv[5], NULL, 10) : 4096;
+    FILE *out = fopen(argv[4], "wb");
+    if (!base || !patch || !out || chunk == 0) {
+        fprintf(stderr, "cannot open inputs/output\n");
+        return 2;
+    }
+
+    /* Small scratch so long COPY ops are split the same way the firmware splits them. */
+    uint8_t scratch[1024];
+    apply_ctx_t ctx = {.base = base, .base_len = base_len, .out = out};
+    delta_state_t d;
+    delta_init(&d, (uint32_t)base_len, (uint32_t)target_size, scratch, sizeof(scratch), apply_read_base, apply_emit, &ctx);
+    delta_result_t res = DELTA_OK;
+    for (size_t off = 0; off < patch_len && res == DELTA_OK; off += chunk) {
+        size_t n = patch_len - off < chunk ? patch_len - off : chunk;
+        res = delta_feed(&d, patch + off, n);
+    }
+    if (res == DELTA_OK) res = delta_finish(&d);
+    fclose(out);
+    free(base);
+    free(patch);
+    printf("%s\n", delta_result_name(res));
+    return res == DELTA_OK ? 0 : 1;
+}
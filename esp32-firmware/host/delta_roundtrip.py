@@ -0,0 +1,111 @@
+#!/usr/bin/env python3
+"""Round-trip check for the 8bdp1 delta format: patches built by flasher-web's make_delta_patch
+are applied by the firmware's fw_delta core (via delta_apply) and the output sha256 must match.
+
+    delta_roundtrip.py PATH/TO/delta_apply
+"""
+from __future__ import annotations
+
+import hashlib
+import random
+import struct
+import subprocess
+import sys
+import tempfile
+from pathlib import Path
+
+sys.path.insert(0, str(Path(__file__).resolve().parents[2] / "flasher-web"))
+from app.ota import make_delta_patch  # noqa: E402
+
+HEADER = struct.Struct("<4sB3xII")
+OP_END = 0
+OP_COPY = 1
+OP_DATA = 2
+
+
+def header(base_size: int, target_size: int) -> bytes:
+    return HEADER.pack(b"8BDP", 1, base_size, target_size)
+
+
+def copy_op(src: int, length: int) -> bytes:
+    return struct.pack("<BII", OP_COPY, src, length)
+
+
+def data_op(payload: bytes) -> bytes:
+    return struct.pack("<BI", OP_DATA, len(payload)) + payload
+
+
+def apply(tool: str, work: Path, base: bytes, patch: bytes, target_size: int, chunk: int) -> tuple[str, bytes]:
+    (work / "base.bin").write_bytes(base)
+    (work / "patch.bin").write_bytes(patch)
+    out = work / "out.bin"
+    proc = subprocess.run(
+        [tool, str(work / "base.bin"), str(work / "patch.bin"), str(target_size), str(out), str(chunk)],
+        capture_output=True,
+        text=True,
+        check=False,
+    )
+    return proc.stdout.strip(), out.read_bytes() if out.exists() else b""
+
+
+def mutate(rng: random.Random, base: bytes) -> bytes:
+    target = bytearray(base)
+    for _ in range(12):
+        pos = rng.randrange(len(target))
+        target[pos : pos + rng.randrange(1, 64)] = rng.randbytes(rng.randrange(0, 96))
+    # Move a block so the patch needs a backwards COPY as well.
+    cut = rng.randrange(len(target) // 2)
+    return bytes(target[cut:] + target[:cut])
+
+
+def main() -> int:
+    if len(sys.argv) != 2:
+        print(__doc__.strip(), file=sys.stderr)
+        return 2
+    tool = sys.argv[1]
+    rng = random.Random(8)
+    base = rng.randbytes(64 * 1024)
+    target = mutate(rng, base)
+    failures: list[str] = []
+
+    def expect(name: str, base_image: bytes, patch: bytes, target_size: int, result: str, image: bytes | None = None) -> None:
+        for chunk in (1, 7, 4096):
+            with tempfile.TemporaryDirectory() as tmp:
+                got, out = apply(tool, Path(tmp), base_image, patch, target_size, chunk)
+            if got != result:
+                failures.append(f"{name} chunk={chunk}: result {got!r}, expected {result!r}")
+            elif image is not None and hashlib.sha256(out).hexdigest() != hashlib.sha256(image).hexdigest():
+                failures.append(f"{name} chunk={chunk}: sha256 mismatch")
+
+    patch = make_delta_patch(base, target)
+    expect("make_delta_patch", base, patch, len(target), "ok", target)
+    expect("identical image", base, make_delta_patch(base, base), len(base), "ok", base)
+    expect("unrelated image", base, make_delta_patch(base, rng.randbytes(5000)[:4321]), 4321, "ok")
+    expect("zero-length target", base, make_delta_patch(base, b""), 0, "ok", b"")
+    expect("zero-length base", b"", make_delta_patch(b"", target[:1000]), 1000, "ok", target[:1000])
+
+    tail = base[-16:]
+    expect("COPY at base_size, length 0", base, header(len(base), 16) + copy_op(len(base), 0) + data_op(tail) + bytes([OP_END]), 16, "ok", tail)
+    expect("COPY at base_size, length 1", base, header(len(base), 1) + copy_op(len(base), 1) + bytes([OP_END]), 1, "copy_range")
+    expect("COPY ending at base_size", base, header(len(base), 16) + copy_op(len(base) - 16, 16) + bytes([OP_END]), 16, "ok", tail)
+    expect("COPY length wraps", base, header(len(base), 16) + copy_op(16, 0xFFFFFFF8) + bytes([OP_END]), 16, "copy_range")
+
+    literal = data_op(b"x" * 40)
+    expect("truncated DATA op", base, header(len(base), 40) + literal[:20], 40, "incomplete")
+    expect("truncated DATA length", base, header(len(base), 40) + literal[:3], 40, "incomplete")
+    expect("missing END", base, header(len(base), 40) + literal, 40, "incomplete")
+    expect("DATA overruns target", base, header(len(base), 39) + literal + bytes([OP_END]), 39, "data_overrun")
+    expect("END before target_size", base, header(len(base), 41) + literal + bytes([OP_END]), 41, "incomplete")
+    expect("trailing bytes", base, header(len(base), 40) + literal + bytes([OP_END, 0]), 40, "trailing")
+    expect("unknown op", base, header(len(base), 0) + bytes([9]), 0, "bad_op")
+    expect("target_size mismatch", base, patch, len(target) + 1, "bad_header")
+    expect("truncated header", base, patch[:10], len(target), "incomplete")
+
+    for failure in failures:
+        print(f"FAIL {failure}")
+    print(f"delta round-trip: {'ok' if not failures else f'{len(failures)} failure(s)'}")
+    return 1 if failures else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,156 @@
+#include "fw_hal_host.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "fw_control.h"
+#include "fw_hal.h"
+
+/* Host HAL: records output writes instead of driving pins, and carries its own SHA-256 so the core
+ * builds with nothing but libc. */
+host_hal_stats_t g_host_hal;
+
+bool hal_gpio_output_capable(int pin) {
+    /* Mirrors the ESP32: GPIO 34-39 are input-only. */
+    return pin >= 0 && pin < 34;
+}
+
+void hal_gpio_write(int pin, bool on) {
+    g_host_hal.gpio_writes++;
+    if (on) {
+        g_host_hal.gpio_level |= 1ULL << pin;
+    } else {
+        g_host_hal.gpio_level &= ~(1ULL << pin);
+    }
+}
+
+void hal_gpio_write_masks(uint64_t set_mask, uint64_t clear_mask) {
+    g_host_hal.gpio_mask_writes++;
+    g_host_hal.gpio_level = (g_host_hal.gpio_level | set_mask) & ~clear_mask;
+}
+
+void hal_pwm_apply(int channel, uint32_t duty, int fade_ms) {
+    if (channel < 0 || channel >= FW_PWM_CHANNELS) return;
+    g_host_hal.pwm_writes++;
+    g_host_hal.pwm_duty[channel] = duty;
+}
+
+void hal_outputs_changed(void) {
+    g_host_hal.outputs_changed++;
+}
+
+typedef struct {
+    uint32_t h[8];
+    uint8_t block[64];
+    size_t block_len;
+    uint64_t total;
+} sha256_ctx_t;
+
+static const uint32_t SHA256_K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be,
+    0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa,
+    0x5cb0a9dc, 0x76f988da, 0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967, 0x27b70a85,
+    0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+    0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070, 0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f,
+    0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+#define ROTR(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+static void sha256_block(sha256_ctx_t *ctx, const uint8_t *p) {
+    uint32_t w[64];
+    for (int i = 0; i < 16; i++) {
+        w[i] = (uint32_t)p[i * 4] << 24 | (uint32_t)p[i * 4 + 1] << 16 | (uint32_t)p[i * 4 + 2] << 8 | p[i * 4 + 3];
+    }
+    for (int i = 16; i < 64; i++) {
+        uint32_t s0 = ROTR(w[i - 15], 7) ^ ROTR(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = ROTR(w[i - 2], 17) ^ ROTR(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+    uint32_t a = ctx->h[0], b = ctx->h[1], c = ctx->h[2], d = ctx->h[3];
+    uint32_t e = ctx->h[4], f = ctx->h[5], g = ctx->h[6], h = ctx->h[7];
+    for (int i = 0; i < 64; i++) {
+        uint32_t t1 = h + (ROTR(e, 6) ^ ROTR(e, 11) ^ ROTR(e, 25)) + ((e & f) ^ (~e & g)) + SHA256_K[i] + w[i];
+        uint32_t t2 = (ROTR(a, 2) ^ ROTR(a, 13) ^ ROTR(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+    ctx->h[0] += a;
+    ctx->h[1] += b;
+    ctx->h[2] += c;
+    ctx->h[3] += d;
+    ctx->h[4] += e;
+    ctx->h[5] += f;
+    ctx->h[6] += g;
+    ctx->h[7] += h;
+}
+
+static void sha256_init(sha256_ctx_t *ctx) {
+    static const uint32_t iv[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+    memcpy(ctx->h, iv, sizeof(iv));
+    ctx->block_len = 0;
+    ctx->total = 0;
+}
+
+static void sha256_update(sha256_ctx_t *ctx, const uint8_t *data, size_t len) {
+    ctx->total += len;
+    while (len > 0) {
+        size_t n = sizeof(ctx->block) - ctx->block_len;
+        if (n > len) n = len;
+        memcpy(ctx->block + ctx->block_len, data, n);
+        ctx->block_len += n;
+        data += n;
+        len -= n;
+        if (ctx->block_len == sizeof(ctx->block)) {
+            sha256_block(ctx, ctx->block);
+            ctx->block_len = 0;
+        }
+    }
+}
+
+static void sha256_finish(sha256_ctx_t *ctx, uint8_t out[32]) {
+    uint64_t bits = ctx->total * 8;
+    uint8_t pad = 0x80;
+    sha256_update(ctx, &pad, 1);
+    pad = 0;
+    while (ctx->block_len != 56) sha256_update(ctx, &pad, 1);
+    uint8_t len_be[8];
+    for (int i = 0; i < 8; i++) len_be[i] = (uint8_t)(bits >> (56 - 8 * i));
+    sha256_update(ctx, len_be, sizeof(len_be));
+    for (int i = 0; i < 8; i++) {
+        out[i * 4] = (uint8_t)(ctx->h[i] >> 24);
+        out[i * 4 + 1] = (uint8_t)(ctx->h[i] >> 16);
+        out[i * 4 + 2] = (uint8_t)(ctx->h[i] >> 8);
+        out[i * 4 + 3] = (uint8_t)ctx->h[i];
+    }
+}
+
+void hal_hmac_sha256(const uint8_t *key, size_t key_len, const uint8_t *msg, size_t msg_len, uint8_t out[32]) {
+    uint8_t k[64] = {0};
+    uint8_t pad[64];
+    sha256_ctx_t ctx;
+    if (key_len > sizeof(k)) {
+        sha256_init(&ctx);
+        sha256_update(&ctx, key, key_len);
+        sha256_finish(&ctx, k);
+    } else {
+        memcpy(k, key, key_len);
+    }
+    for (size_t i = 0; i < sizeof(pad); i++) pad[i] = k[i] ^ 0x36;
+    sha256_init(&ctx);
+    sha256_update(&ctx, pad, sizeof(pad));
+    sha256_update(&ctx, msg, msg_len);
+    sha256_finish(&ctx, out);
+    for (size_t i = 0; i < sizeof(pad); i++) pad[i] = k[i] ^ 0x5c;
+    sha256_init(&ctx);
+    sha256_update(&ctx, pad, sizeof(pad));
+    sha256_update(&ctx, out, 32);
+    sha256_finish(&ctx, out);
+}
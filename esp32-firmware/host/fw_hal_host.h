@@ -0,0 +1,15 @@
+#pragma once
+
+#include <stdint.h>
+
+/* Counters kept by the host HAL so benchmarks can check what the core actually drove. */
+typedef struct {
+    uint64_t gpio_writes;
+    uint64_t gpio_mask_writes;
+    uint64_t pwm_writes;
+    uint64_t outputs_changed;
+    uint64_t gpio_level; /* bit n = last level written to GPIO n */
+    uint32_t pwm_duty[8];
+} host_hal_stats_t;
+
+extern host_hal_stats_t g_host_hal;
@@ -0,0 +1,182 @@
+#include "fw_config.h"
+
+#include <string.h>
+
+#include "fw_hal.h"
+#include "fw_util.h"
+
+const int SAFE_SCAN_GPIOS[SAFE_SCAN_GPIO_COUNT] = {2, 4, 5, 12, 13, 14, 15, 16, 17, 18, 19, 21, 22, 23, 25, 26, 27, 32, 33};
+
+bool valid_output_gpio_int(int pin) {
+    return pin >= 0 && pin <= 39 && hal_gpio_output_capable(pin);
+}
+
+bool is_safe_scan_gpio_int(int pin) {
+    for (size_t i = 0; i < SAFE_SCAN_GPIO_COUNT; i++) {
+        if (SAFE_SCAN_GPIOS[i] == pin) return true;
+    }
+    return false;
+}
+
+bool valid_relay_gpio_int(int pin) {
+    return valid_output_gpio_int(pin) && is_safe_scan_gpio_int(pin);
+}
+
+void sanitize_relay_count(device_config_t *cfg) {
+    cfg->relay_count = clamp_int(cfg->relay_count, 1, MAX_RELAYS);
+}
+
+void sanitize_relay_gpio_map(device_config_t *cfg) {
+    sanitize_relay_count(cfg);
+    for (int i = 0; i < MAX_RELAYS; i++) {
+        int pin = cfg->relay_gpio[i];
+        if (pin == -1) continue;
+        if (!valid_relay_gpio_int(pin)) {
+            cfg->relay_gpio[i] = -1;
+            continue;
+        }
+        for (int j = 0; j < i; j++) {
+            if (cfg->relay_gpio[j] == pin) {
+                cfg->relay_gpio[i] = -1;
+                break;
+            }
+        }
+    }
+}
+
+void sanitize_state_save_delay(device_config_t *cfg) {
+    if (cfg->state_save_delay_ms <= 0) cfg->state_save_delay_ms = STATE_SAVE_DELAY_DEFAULT_MS;
+    cfg->state_save_delay_ms = clamp_int(cfg->state_save_delay_ms, STATE_SAVE_DELAY_MIN_MS, STATE_SAVE_DELAY_MAX_MS);
+}
+
+static const char *const POWER_PROFILE_NAMES[POWER_PROFILE_COUNT] = {"performance", "balanced", "low_power"};
+
+void sanitize_power_config(device_config_t *cfg) {
+    if (cfg->power_profile < 0 || cfg->power_profile >= POWER_PROFILE_COUNT) cfg->power_profile = POWER_PROFILE_PERFORMANCE;
+    if (cfg->power_wake_hold_ms <= 0) cfg->power_wake_hold_ms = POWER_WAKE_HOLD_DEFAULT_MS;
+    cfg->power_wake_hold_ms = clamp_int(cfg->power_wake_hold_ms, POWER_WAKE_HOLD_MIN_MS, POWER_WAKE_HOLD_MAX_MS);
+    if (cfg->power_listen_interval <= 0) cfg->power_listen_interval = POWER_LISTEN_INTERVAL_DEFAULT;
+    cfg->power_listen_interval = clamp_int(cfg->power_listen_interval, POWER_LISTEN_INTERVAL_MIN, POWER_LISTEN_INTERVAL_MAX);
+}
+
+const char *power_profile_name(int profile) {
+    return (profile >= 0 && profile < POWER_PROFILE_COUNT) ? POWER_PROFILE_NAMES[profile] : POWER_PROFILE_NAMES[0];
+}
+
+int power_profile_from_name(const char *name) {
+    if (!name) return -1;
+    for (int i = 0; i < POWER_PROFILE_COUNT; i++) {
+        if (strcmp(name, POWER_PROFILE_NAMES[i]) == 0) return i;
+    }
+    return -1;
+}
+
+void sanitize_wifi_field(char *value) {
+    if (!value) return;
+    size_t read_idx = 0;
+    size_t write_idx = 0;
+    while (value[read_idx] != '\0') {
+        char c = value[read_idx++];
+        if (c == '\r' || c == '\n' || c == '\t') {
+            continue;
+        }
+        value[write_idx++] = c;
+    }
+    value[write_idx] = '\0';
+
+    while (write_idx > 0 && (value[write_idx - 1] == ' ')) {
+        value[--write_idx] = '\0';
+    }
+    size_t start = 0;
+    while (value[start] == ' ') {
+        start++;
+    }
+    if (start > 0) {
+        memmove(value, value + start, strlen(value + start) + 1);
+    }
+}
+
+#define CFG_FIELD(member) {offsetof(device_config_t, member), sizeof(((device_config_t *)0)->member)}
+#define CFG_SECTION(key, fields) {key, fields, sizeof(fields) / sizeof(fields[0])}
+
+static const cfg_field_t CFG_IDENT_FIELDS[] = {CFG_FIELD(name), CFG_FIELD(type), CFG_FIELD(device_id)};
+static const cfg_field_t CFG_AUTH_FIELDS[] = {CFG_FIELD(passcode), CFG_FIELD(ota_key)};
+static const cfg_field_t CFG_RELAY_FIELDS[] = {CFG_FIELD(relay_count), CFG_FIELD(relay_gpio), CFG_FIELD(relay_names)};
+static const cfg_field_t CFG_WIFI_FIELDS[] = {CFG_FIELD(wifi_ssid), CFG_FIELD(wifi_pass), CFG_FIELD(ap_ssid), CFG_FIELD(ap_pass)};
+static const cfg_field_t CFG_IP_FIELDS[] = {CFG_FIELD(use_static_ip), CFG_FIELD(static_ip), CFG_FIELD(gateway), CFG_FIELD(subnet_mask)};
+static const cfg_field_t CFG_OUTPUT_FIELDS[] = {CFG_FIELD(restore_outputs), CFG_FIELD(state_save_delay_ms)};
+static const cfg_field_t CFG_SCHED_FIELDS[] = {CFG_FIELD(timezone), CFG_FIELD(ntp_server), CFG_FIELD(schedules)};
+static const cfg_field_t CFG_INPUT_FIELDS[] = {CFG_FIELD(inputs), CFG_FIELD(input_bindings)};
+static const cfg_field_t CFG_MQTT_FIELDS[] = {CFG_FIELD(mqtt_uri), CFG_FIELD(mqtt_user), CFG_FIELD(mqtt_pass), CFG_FIELD(mqtt_prefix)};
+static const cfg_field_t CFG_POWER_FIELDS[] = {CFG_FIELD(power_profile), CFG_FIELD(power_wake_hold_ms), CFG_FIELD(power_listen_interval)};
+
+const cfg_section_t CFG_SECTIONS[CFG_SECTION_COUNT] = {
+    CFG_SECTION("s_ident", CFG_IDENT_FIELDS),
+    CFG_SECTION("s_auth", CFG_AUTH_FIELDS),
+    CFG_SECTION("s_relay", CFG_RELAY_FIELDS),
+    CFG_SECTION("s_wifi", CFG_WIFI_FIELDS),
+    CFG_SECTION("s_ip", CFG_IP_FIELDS),
+    CFG_SECTION("s_out", CFG_OUTPUT_FIELDS),
+    CFG_SECTION("s_sched", CFG_SCHED_FIELDS),
+    CFG_SECTION("s_input", CFG_INPUT_FIELDS),
+    CFG_SECTION("s_mqtt", CFG_MQTT_FIELDS),
+    CFG_SECTION("s_power", CFG_POWER_FIELDS),
+};
+
+size_t cfg_section_size(const cfg_section_t *sec) {
+    size_t len = 0;
+    for (size_t i = 0; i < sec->field_count; i++) len += sec->fields[i].size;
+    return len;
+}
+
+uint32_t cfg_section_hash(const cfg_section_t *sec, const device_config_t *cfg) {
+    uint32_t hash = FNV1A_INIT;
+    for (size_t i = 0; i < sec->field_count; i++) {
+        hash = fnv1a_update(hash, (const uint8_t *)cfg + sec->fields[i].offset, sec->fields[i].size);
+    }
+    return hash;
+}
+
+void cfg_section_pack(const cfg_section_t *sec, const device_config_t *cfg, uint8_t *out) {
+    for (size_t i = 0; i < sec->field_count; i++) {
+        memcpy(out, (const uint8_t *)cfg + sec->fields[i].offset, sec->fields[i].size);
+        out += sec->fields[i].size;
+    }
+}
+
+void cfg_section_unpack(const cfg_section_t *sec, device_config_t *cfg, const uint8_t *in, size_t len) {
+    for (size_t i = 0; i < sec->field_count && sec->fields[i].size <= len; i++) {
+        memcpy((uint8_t *)cfg + sec->fields[i].offset, in, sec->fields[i].size);
+        in += sec->fields[i].size;
+        len -= sec->fields[i].size;
+    }
+}
+
+void cfg_migrate_legacy_v1(device_config_t *cfg, const legacy_device_config_v1_t *legacy) {
+    safe_strcpy(cfg->name, legacy->name, sizeof(cfg->name));
+    safe_strcpy(cfg->type, legacy->type, sizeof(cfg->type));
+    safe_strcpy(cfg->passcode, legacy->passcode, sizeof(cfg->passcode));
+    cfg->relay_count = 4;
+    for (int i = 0; i < 4; i++) cfg->relay_gpio[i] = legacy->relay_gpio[i];
+    for (int i = 4; i < MAX_RELAYS; i++) cfg->relay_gpio[i] = -1;
+    safe_strcpy(cfg->wifi_ssid, legacy->wifi_ssid, sizeof(cfg->wifi_ssid));
+    safe_strcpy(cfg->wifi_pass, legacy->wifi_pass, sizeof(cfg->wifi_pass));
+    safe_strcpy(cfg->ap_ssid, legacy->ap_ssid, sizeof(cfg->ap_ssid));
+    safe_strcpy(cfg->ap_pass, legacy->ap_pass, sizeof(cfg->ap_pass));
+    cfg->use_static_ip = legacy->use_static_ip;
+    safe_strcpy(cfg->static_ip, legacy->static_ip, sizeof(cfg->static_ip));
+    safe_strcpy(cfg->gateway, legacy->gateway, sizeof(cfg->gateway));
+    safe_strcpy(cfg->subnet_mask, legacy->subnet_mask, sizeof(cfg->subnet_mask));
+    safe_strcpy(cfg->ota_key, legacy->ota_key, sizeof(cfg->ota_key));
+}
+
+bool cfg_load_device_blob(device_config_t *cfg, const uint8_t *raw, size_t len) {
+    if (len == sizeof(legacy_device_config_v1_t)) {
+        legacy_device_config_v1_t legacy = {0};
+        memcpy(&legacy, raw, sizeof(legacy));
+        cfg_migrate_legacy_v1(cfg, &legacy);
+        return true;
+    }
+    memcpy(cfg, raw, len < sizeof(*cfg) ? len : sizeof(*cfg));
+    return false;
+}
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "fw_control.h"
+
+#define MAX_STR 96
+#define MAX_SCHEDULES 16
+#define MAX_INPUTS 8
+#define MAX_INPUT_BINDINGS 16
+
+#define STATE_SAVE_DELAY_DEFAULT_MS 3000
+#define STATE_SAVE_DELAY_MIN_MS 250
+#define STATE_SAVE_DELAY_MAX_MS 600000
+
+/* Wi-Fi/CPU power profile. Performance keeps the radio fully on; balanced uses minimum modem sleep
+ * (wake every DTIM); low_power uses maximum modem sleep at power_listen_interval plus automatic
+ * light sleep. Interactive traffic holds the radio fully on for power_wake_hold_ms. */
+typedef enum {
+    POWER_PROFILE_PERFORMANCE = 0,
+    POWER_PROFILE_BALANCED = 1,
+    POWER_PROFILE_LOW_POWER = 2,
+    POWER_PROFILE_COUNT,
+} power_profile_t;
+
+#define POWER_WAKE_HOLD_DEFAULT_MS 30000
+#define POWER_WAKE_HOLD_MIN_MS 1000
+#define POWER_WAKE_HOLD_MAX_MS 600000
+/* Beacon intervals (~102 ms each) between wakes under low_power. */
+#define POWER_LISTEN_INTERVAL_DEFAULT 10
+#define POWER_LISTEN_INTERVAL_MIN 1
+#define POWER_LISTEN_INTERVAL_MAX 20
+
+/* One on-device schedule: a control op fired at a local minute of day on the selected weekdays. */
+typedef struct {
+    uint8_t enabled;
+    uint8_t days;    /* bit n = tm_wday n (bit 0 Sunday) */
+    uint16_t minute; /* local minute of day, 0-1439 */
+    uint8_t channel;
+    uint8_t action;
+    int8_t rgb[RGB_CHANNELS]; /* -1 keeps the current component */
+    int16_t value;
+    uint16_t transition_ms;
+    uint32_t duration_ms; /* auto-off after firing, 0 leaves the output as set */
+} schedule_entry_t;
+
+typedef enum {
+    INPUT_MODE_BUTTON = 0, /* momentary: press and long events */
+    INPUT_MODE_SWITCH = 1, /* latching wall switch: every flip is a toggle event */
+} input_mode_t;
+
+typedef enum {
+    INPUT_EV_PRESS = 0,
+    INPUT_EV_LONG = 1,
+    INPUT_EV_TOGGLE = 2,
+    INPUT_EV_COUNT,
+} input_event_t;
+
+typedef struct {
+    uint8_t enabled;
+    uint8_t gpio;       /* one of SAFE_SCAN_GPIOS */
+    uint8_t mode;       /* input_mode_t */
+    uint8_t active_low; /* pressed pulls the pin low (internal pull-up); otherwise pull-down */
+} input_entry_t;
+
+/* Maps one input event to a control op; several bindings may share an event. */
+typedef struct {
+    uint8_t input; /* index into inputs[] */
+    uint8_t event; /* input_event_t */
+    uint8_t channel; /* 0 marks an unused slot */
+    uint8_t action;
+    int16_t value;
+    uint16_t transition_ms;
+    uint32_t duration_ms;
+} input_binding_t;
+
+typedef struct {
+    char name[MAX_STR];
+    char type[MAX_STR];
+    char passcode[MAX_STR];
+    int relay_count;
+    int relay_gpio[MAX_RELAYS];
+    char wifi_ssid[MAX_STR];
+    char wifi_pass[MAX_STR];
+    char ap_ssid[MAX_STR];
+    char ap_pass[MAX_STR];
+    bool use_static_ip;
+    char static_ip[MAX_STR];
+    char gateway[MAX_STR];
+    char subnet_mask[MAX_STR];
+    char ota_key[MAX_STR];
+    char device_id[MAX_STR];
+    char relay_names[MAX_RELAYS][MAX_STR];
+    bool restore_outputs;
+    int state_save_delay_ms;
+    char timezone[MAX_STR]; /* POSIX TZ string, e.g. CET-1CEST,M3.5.0,M10.5.0/3 */
+    char ntp_server[MAX_STR];
+    schedule_entry_t schedules[MAX_SCHEDULES];
+    input_entry_t inputs[MAX_INPUTS];
+    input_binding_t input_bindings[MAX_INPUT_BINDINGS];
+    char mqtt_uri[MAX_STR]; /* empty disables MQTT */
+    char mqtt_user[MAX_STR];
+    char mqtt_pass[MAX_STR];
+    char mqtt_prefix[MAX_STR];
+    int power_profile; /* power_profile_t */
+    int power_wake_hold_ms;
+    int power_listen_interval;
+} device_config_t;
+
+typedef struct {
+    char name[MAX_STR];
+    char type[MAX_STR];
+    char passcode[MAX_STR];
+    int relay_gpio[4];
+    char wifi_ssid[MAX_STR];
+    char wifi_pass[MAX_STR];
+    char ap_ssid[MAX_STR];
+    char ap_pass[MAX_STR];
+    bool use_static_ip;
+    char static_ip[MAX_STR];
+    char gateway[MAX_STR];
+    char subnet_mask[MAX_STR];
+    char ota_key[MAX_STR];
+} legacy_device_config_v1_t;
+
+/* GPIOs that are safe to drive or scan on the reference board (no strapping/flash/input-only pins). */
+#define SAFE_SCAN_GPIO_COUNT 19
+extern const int SAFE_SCAN_GPIOS[SAFE_SCAN_GPIO_COUNT];
+
+bool valid_output_gpio_int(int pin);
+bool is_safe_scan_gpio_int(int pin);
+bool valid_relay_gpio_int(int pin);
+
+void sanitize_relay_count(device_config_t *cfg);
+/* Drops invalid and duplicate relay pins (-1 = unmapped). */
+void sanitize_relay_gpio_map(device_config_t *cfg);
+void sanitize_state_save_delay(device_config_t *cfg);
+/* Unknown profiles fall back to performance; zero (older config) picks the defaults. */
+void sanitize_power_config(device_config_t *cfg);
+const char *power_profile_name(int profile);
+/* -1 for an unknown name. */
+int power_profile_from_name(const char *name);
+/* Strips control characters and surrounding spaces from a pasted SSID/password. */
+void sanitize_wifi_field(char *value);
+
+/* Config is persisted as one NVS blob per section so a save only rewrites what changed.
+ * Sections are the listed fields packed back to back; new fields are appended to a section
+ * (or a new section is added) and older, shorter blobs load as a prefix. */
+#define CFG_LAYOUT_VERSION 2
+#define CFG_SECTION_COUNT 10
+
+typedef struct {
+    uint16_t offset;
+    uint16_t size;
+} cfg_field_t;
+
+typedef struct {
+    const char *key;
+    const cfg_field_t *fields;
+    size_t field_count;
+} cfg_section_t;
+
+extern const cfg_section_t CFG_SECTIONS[CFG_SECTION_COUNT];
+
+size_t cfg_section_size(const cfg_section_t *sec);
+uint32_t cfg_section_hash(const cfg_section_t *sec, const device_config_t *cfg);
+void cfg_section_pack(const cfg_section_t *sec, const device_config_t *cfg, uint8_t *out);
+void cfg_section_unpack(const cfg_section_t *sec, device_config_t *cfg, const uint8_t *in, size_t len);
+
+void cfg_migrate_legacy_v1(device_config_t *cfg, const legacy_device_config_v1_t *legacy);
+/* Loads the pre-section "device" blob: a v1-sized blob is migrated, anything else is copied as a
+ * prefix of device_config_t. Returns true when it was migrated from v1. */
+bool cfg_load_device_blob(device_config_t *cfg, const uint8_t *raw, size_t len);
@@ -0,0 +1,339 @@
+#include "fw_control.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "fw_config.h"
+#include "fw_hal.h"
+#include "fw_util.h"
+
+output_state_t g_state = {0};
+channel_desc_t g_channels[CTRL_CH_COUNT];
+
+/* Percent -> duty with perceptual gamma for light channels; filled by init_gamma_table(). */
+static uint16_t g_gamma_duty[101];
+
+typedef struct {
+    bool active;
+    uint64_t set_mask;
+    uint64_t clear_mask;
+    uint32_t pwm_dirty;
+    uint32_t pwm_duty[FW_PWM_CHANNELS];
+    int pwm_fade_ms[FW_PWM_CHANNELS];
+} output_batch_t;
+
+static output_batch_t g_batch = {0};
+
+static void output_gpio_write(int pin, bool on) {
+    if (!g_batch.active) {
+        hal_gpio_write(pin, on);
+        return;
+    }
+    uint64_t bit = 1ULL << pin;
+    if (on) {
+        g_batch.set_mask |= bit;
+        g_batch.clear_mask &= ~bit;
+    } else {
+        g_batch.clear_mask |= bit;
+        g_batch.set_mask &= ~bit;
+    }
+}
+
+void init_gamma_table(void) {
+    for (int pct = 0; pct <= 100; pct++) {
+        g_gamma_duty[pct] = (uint16_t)lroundf(powf((float)pct / 100.0f, PWM_GAMMA) * (float)PWM_DUTY_MAX);
+    }
+}
+
+static void pwm_set_percent(int channel, int pct, bool gamma, int fade_ms) {
+    int val = clamp_int(pct, 0, 100);
+    uint32_t duty = gamma ? g_gamma_duty[val] : (uint32_t)((val * PWM_DUTY_MAX) / 100);
+    fade_ms = clamp_int(fade_ms, 0, MAX_TRANSITION_MS);
+    if (g_batch.active) {
+        g_batch.pwm_dirty |= 1u << channel;
+        g_batch.pwm_duty[channel] = duty;
+        g_batch.pwm_fade_ms[channel] = fade_ms;
+        return;
+    }
+    hal_pwm_apply(channel, duty, fade_ms);
+}
+
+void begin_output_batch(void) {
+    memset(&g_batch, 0, sizeof(g_batch));
+    g_batch.active = true;
+}
+
+void end_output_batch(void) {
+    g_batch.active = false;
+    hal_gpio_write_masks(g_batch.set_mask, g_batch.clear_mask);
+    for (int ch = 0; ch < FW_PWM_CHANNELS; ch++) {
+        if (g_batch.pwm_dirty & (1u << ch)) hal_pwm_apply(ch, g_batch.pwm_duty[ch], g_batch.pwm_fade_ms[ch]);
+    }
+    memset(&g_batch, 0, sizeof(g_batch));
+    hal_outputs_changed();
+}
+
+bool output_batch_active(void) {
+    return g_batch.active;
+}
+
+void apply_relay(int idx, bool on) {
+    if (idx < 0 || idx >= MAX_RELAYS) return;
+    const channel_desc_t *ch = &g_channels[CTRL_CH_RELAY1 + idx];
+    if (!ch->enabled || ch->gpio < 0) return;
+    output_gpio_write(ch->gpio, on);
+    g_state.relay[idx] = on;
+    if (!g_batch.active) hal_outputs_changed();
+}
+
+void apply_light_single(bool on) {
+    if (g_channels[CTRL_CH_LIGHT].gpio >= 0) {
+        output_gpio_write(g_channels[CTRL_CH_LIGHT].gpio, on);
+    }
+    g_state.light_single = on;
+    if (!g_batch.active) hal_outputs_changed();
+}
+
+void apply_dimmer(int pct, int transition_ms) {
+    g_state.dimmer_pct = clamp_int(pct, 0, 100);
+    pwm_set_percent(FW_PWM_DIMMER, g_state.dimmer_pct, true, transition_ms);
+    if (!g_batch.active) hal_outputs_changed();
+}
+
+void apply_rgb(int r, int g, int b, int w, int transition_ms) {
+    g_state.rgb[0] = clamp_int(r, 0, 100);
+    g_state.rgb[1] = clamp_int(g, 0, 100);
+    g_state.rgb[2] = clamp_int(b, 0, 100);
+    g_state.rgb[3] = clamp_int(w, 0, 100);
+    pwm_set_percent(FW_PWM_RGB_R, g_state.rgb[0], true, transition_ms);
+    pwm_set_percent(FW_PWM_RGB_G, g_state.rgb[1], true, transition_ms);
+    pwm_set_percent(FW_PWM_RGB_B, g_state.rgb[2], true, transition_ms);
+    pwm_set_percent(FW_PWM_RGB_W, g_state.rgb[3], true, transition_ms);
+    if (!g_batch.active) hal_outputs_changed();
+}
+
+void apply_fan(bool power, int speed_pct, int transition_ms) {
+    g_state.fan_power = power;
+    g_state.fan_speed_pct = clamp_int(speed_pct, 0, 100);
+    if (g_channels[CTRL_CH_FAN_POWER].gpio >= 0) {
+        output_gpio_write(g_channels[CTRL_CH_FAN_POWER].gpio, g_state.fan_power);
+    }
+    /* Motor speed tracks duty roughly linearly, so the fan channel skips the gamma curve. */
+    pwm_set_percent(FW_PWM_FAN, g_state.fan_power ? g_state.fan_speed_pct : 0, false, transition_ms);
+    if (!g_batch.active) hal_outputs_changed();
+}
+
+static bool resolve_on_off(control_action_t action, bool current) {
+    if (action == CTRL_ACT_TOGGLE) return !current;
+    if (action == CTRL_ACT_ON) return true;
+    if (action == CTRL_ACT_OFF) return false;
+    return current;
+}
+
+control_action_t parse_control_action(const char *state) {
+    if (!state) return CTRL_ACT_KEEP;
+    control_action_t act = CTRL_ACT_KEEP;
+    const char *expect = NULL;
+    switch (state[0]) {
+    case 't':
+        act = CTRL_ACT_TOGGLE, expect = "toggle";
+        break;
+    case 's':
+        act = CTRL_ACT_SET, expect = "set";
+        break;
+    case 'o':
+        act = state[1] == 'n' ? CTRL_ACT_ON : CTRL_ACT_OFF;
+        expect = state[1] == 'n' ? "on" : "off";
+        break;
+    default:
+        return CTRL_ACT_KEEP;
+    }
+    return strcmp(state, expect) == 0 ? act : CTRL_ACT_KEEP;
+}
+
+static uint32_t channel_name_hash(const char *name) {
+    return fnv1a_update(FNV1A_INIT, name, strlen(name));
+}
+
+control_channel_t parse_control_channel(const char *ch) {
+    if (!ch) return CTRL_CH_NONE;
+    uint32_t hash = channel_name_hash(ch);
+    for (int id = CTRL_CH_RELAY1; id < CTRL_CH_COUNT; id++) {
+        if (g_channels[id].name_hash == hash && strcmp(g_channels[id].name, ch) == 0) return (control_channel_t)id;
+    }
+    return CTRL_CH_NONE;
+}
+
+control_channel_t control_channel_from_id(int id) {
+    return (id >= CTRL_CH_RELAY1 && id < CTRL_CH_COUNT) ? (control_channel_t)id : CTRL_CH_NONE;
+}
+
+bool control_op_from_flat(const flat_json_t *fj, control_op_t *op, char *channel_name, size_t channel_size) {
+    char state[16] = {0};
+    int channel_id = 0;
+    memset(op, 0, sizeof(*op));
+    if (flat_json_get_int(fj, "channel", &channel_id)) {
+        op->channel = control_channel_from_id(channel_id);
+        if (op->channel != CTRL_CH_NONE) safe_strcpy(channel_name, g_channels[op->channel].name, channel_size);
+    } else if (flat_json_get_str(fj, "channel", channel_name, channel_size)) {
+        op->channel = parse_control_channel(channel_name);
+    } else {
+        return false;
+    }
+    op->action = parse_control_action(flat_json_get_str(fj, "state", state, sizeof(state)) ? state : "toggle");
+    if (!flat_json_get_int(fj, "value", &op->value)) op->value = 0;
+    int transition = 0;
+    op->transition_ms = flat_json_get_int(fj, "transition_ms", &transition) ? clamp_int(transition, 0, MAX_TRANSITION_MS) : 0;
+    int duration = 0;
+    op->duration_ms = flat_json_get_int(fj, "duration_ms", &duration) ? clamp_int(duration, 0, MAX_DURATION_MS) : 0;
+    static const char *const rgb_keys[RGB_CHANNELS] = {"r", "g", "b", "w"};
+    for (int i = 0; i < RGB_CHANNELS; i++) {
+        if (!flat_json_get_int(fj, rgb_keys[i], &op->rgb[i])) op->rgb[i] = -1;
+    }
+    return op->channel != CTRL_CH_NONE;
+}
+
+static bool apply_op_relay(const channel_desc_t *ch, const control_op_t *op) {
+    apply_relay(ch->index, resolve_on_off(op->action, g_state.relay[ch->index]));
+    return true;
+}
+
+static bool apply_op_light(const channel_desc_t *ch, const control_op_t *op) {
+    apply_light_single(resolve_on_off(op->action, g_state.light_single));
+    return true;
+}
+
+static bool apply_op_dimmer(const channel_desc_t *ch, const control_op_t *op) {
+    int pct = (op->action == CTRL_ACT_SET) ? op->value : (resolve_on_off(op->action, g_state.dimmer_pct > 0) ? 100 : 0);
+    apply_dimmer(pct, op->transition_ms);
+    return true;
+}
+
+static bool apply_op_rgb(const channel_desc_t *ch, const control_op_t *op) {
+    if (op->action == CTRL_ACT_OFF) {
+        apply_rgb(0, 0, 0, 0, op->transition_ms);
+    } else if (op->action == CTRL_ACT_ON) {
+        apply_rgb(100, 100, 100, op->channel == CTRL_CH_RGBW ? 100 : 0, op->transition_ms);
+    } else {
+        int rgb[RGB_CHANNELS];
+        for (int i = 0; i < RGB_CHANNELS; i++) rgb[i] = op->rgb[i] >= 0 ? op->rgb[i] : g_state.rgb[i];
+        apply_rgb(rgb[0], rgb[1], rgb[2], rgb[3], op->transition_ms);
+    }
+    return true;
+}
+
+static bool apply_op_fan(const channel_desc_t *ch, const control_op_t *op) {
+    bool power = g_state.fan_power;
+    int speed = g_state.fan_speed_pct;
+    if (op->channel == CTRL_CH_FAN_POWER) {
+        power = resolve_on_off(op->action, g_state.fan_power);
+    } else if (op->channel == CTRL_CH_FAN_SPEED || op->action == CTRL_ACT_SET) {
+        speed = op->value;
+        power = speed > 0;
+    } else {
+        power = resolve_on_off(op->action, g_state.fan_power);
+        if (!power) speed = 0;
+        if (power && speed == 0) speed = 50;
+    }
+    apply_fan(power, speed, op->transition_ms);
+    return true;
+}
+
+const channel_desc_t *channel_desc(control_channel_t id) {
+    if (id <= CTRL_CH_NONE || id >= CTRL_CH_COUNT || !g_channels[id].enabled) return NULL;
+    return &g_channels[id];
+}
+
+bool control_op_valid(const control_op_t *op) {
+    return channel_desc(op->channel) != NULL;
+}
+
+bool control_op_apply(const control_op_t *op) {
+    const channel_desc_t *ch = channel_desc(op->channel);
+    return ch && ch->apply(ch, op);
+}
+
+static void set_channel_desc(channel_desc_t *table, control_channel_t id, const char *name, int gpio, int pwm,
+                             bool (*apply)(const channel_desc_t *, const control_op_t *)) {
+    channel_desc_t *ch = &table[id];
+    ch->name = name;
+    ch->name_hash = channel_name_hash(name);
+    ch->enabled = true;
+    ch->gpio = gpio;
+    ch->pwm = pwm;
+    ch->index = 0;
+    ch->apply = apply;
+}
+
+void control_registry_build(channel_desc_t table[CTRL_CH_COUNT], const int relay_gpio[MAX_RELAYS], int relay_count, int light_pin,
+                            int fan_pin) {
+    static const char *const relay_names[MAX_RELAYS] = {"relay1", "relay2", "relay3", "relay4",
+                                                        "relay5", "relay6", "relay7", "relay8"};
+    memset(table, 0, sizeof(table[0]) * CTRL_CH_COUNT);
+    for (int i = 0; i < MAX_RELAYS; i++) {
+        control_channel_t id = (control_channel_t)(CTRL_CH_RELAY1 + i);
+        int pin = valid_relay_gpio_int(relay_gpio[i]) ? relay_gpio[i] : -1;
+        set_channel_desc(table, id, relay_names[i], pin, FW_PWM_NONE, apply_op_relay);
+        table[id].index = i;
+        table[id].enabled = i < relay_count;
+    }
+    set_channel_desc(table, CTRL_CH_LIGHT, "light", light_pin, FW_PWM_NONE, apply_op_light);
+    set_channel_desc(table, CTRL_CH_DIMMER, "dimmer", -1, FW_PWM_DIMMER, apply_op_dimmer);
+    set_channel_desc(table, CTRL_CH_RGB, "rgb", -1, FW_PWM_RGB_R, apply_op_rgb);
+    set_channel_desc(table, CTRL_CH_RGBW, "rgbw", -1, FW_PWM_RGB_R, apply_op_rgb);
+    set_channel_desc(table, CTRL_CH_FAN, "fan", fan_pin, FW_PWM_FAN, apply_op_fan);
+    set_channel_desc(table, CTRL_CH_FAN_POWER, "fan_power", fan_pin, FW_PWM_NONE, apply_op_fan);
+    set_channel_desc(table, CTRL_CH_FAN_SPEED, "fan_speed", -1, FW_PWM_FAN, apply_op_fan);
+}
+
+bool output_state_equal(const output_state_t *a, const output_state_t *b) {
+    for (int i = 0; i < MAX_RELAYS; i++) {
+        if (a->relay[i] != b->relay[i]) return false;
+    }
+    for (int i = 0; i < 4; i++) {
+        if (a->rgb[i] != b->rgb[i]) return false;
+    }
+    return a->light_single == b->light_single && a->dimmer_pct == b->dimmer_pct &&
+           a->fan_power == b->fan_power && a->fan_speed_pct == b->fan_speed_pct;
+}
+
+void write_outputs_json(json_writer_t *jw, const output_state_t *st, int relay_count) {
+    jw_begin_object(jw, "outputs");
+    for (int i = 0; i < relay_count; i++) {
+        char key[16] = {0};
+        snprintf(key, sizeof(key), "relay%d", i + 1);
+        jw_bool(jw, key, st->relay[i]);
+    }
+    jw_bool(jw, "light", st->light_single);
+    jw_int(jw, "dimmer", st->dimmer_pct);
+    jw_int(jw, "rgb_r", st->rgb[0]);
+    jw_int(jw, "rgb_g", st->rgb[1]);
+    jw_int(jw, "rgb_b", st->rgb[2]);
+    jw_int(jw, "rgb_w", st->rgb[3]);
+    jw_bool(jw, "fan_power", st->fan_power);
+    jw_int(jw, "fan_speed", st->fan_speed_pct);
+    jw_end_object(jw);
+}
+
+int write_output_delta_json(json_writer_t *jw, const output_state_t *prev, const output_state_t *cur, int relay_count) {
+    int written = 0;
+    jw_begin_object(jw, "outputs");
+    for (int i = 0; i < relay_count; i++) {
+        if (prev->relay[i] == cur->relay[i]) continue;
+        char key[16] = {0};
+        snprintf(key, sizeof(key), "relay%d", i + 1);
+        jw_bool(jw, key, cur->relay[i]);
+        written++;
+    }
+    if (prev->light_single != cur->light_single) { jw_bool(jw, "light", cur->light_single); written++; }
+    if (prev->dimmer_pct != cur->dimmer_pct) { jw_int(jw, "dimmer", cur->dimmer_pct); written++; }
+    if (prev->rgb[0] != cur->rgb[0]) { jw_int(jw, "rgb_r", cur->rgb[0]); written++; }
+    if (prev->rgb[1] != cur->rgb[1]) { jw_int(jw, "rgb_g", cur->rgb[1]); written++; }
+    if (prev->rgb[2] != cur->rgb[2]) { jw_int(jw, "rgb_b", cur->rgb[2]); written++; }
+    if (prev->rgb[3] != cur->rgb[3]) { jw_int(jw, "rgb_w", cur->rgb[3]); written++; }
+    if (prev->fan_power != cur->fan_power) { jw_bool(jw, "fan_power", cur->fan_power); written++; }
+    if (prev->fan_speed_pct != cur->fan_speed_pct) { jw_int(jw, "fan_speed", cur->fan_speed_pct); written++; }
+    jw_end_object(jw);
+    return written;
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "fw_json.h"
+
+#define MAX_RELAYS 8
+#define RGB_CHANNELS 4
+#define MAX_BATCH_OPS 16
+/* 13-bit duty is the finest LEDC_TIMER_0 can run at 5 kHz from the 80 MHz APB clock. */
+#define PWM_DUTY_BITS 13
+#define PWM_DUTY_MAX ((1u << PWM_DUTY_BITS) - 1)
+#define PWM_GAMMA 2.2f
+#define MAX_TRANSITION_MS 60000
+#define MAX_DURATION_MS 86400000
+
+/* PWM channel allocation for dimmer/RGB/fan; the firmware maps these 1:1 onto LEDC channels. */
+#define FW_PWM_DIMMER 0
+#define FW_PWM_RGB_R 1
+#define FW_PWM_RGB_G 2
+#define FW_PWM_RGB_B 3
+#define FW_PWM_RGB_W 4
+#define FW_PWM_FAN 5
+#define FW_PWM_CHANNELS 8
+#define FW_PWM_NONE FW_PWM_CHANNELS
+
+typedef struct {
+    bool relay[MAX_RELAYS];
+    bool light_single;
+    int dimmer_pct;
+    int rgb[4];
+    bool fan_power;
+    int fan_speed_pct;
+} output_state_t;
+
+/* Output channels addressable by control requests. Numeric values are part of the UDP wire format. */
+typedef enum {
+    CTRL_CH_NONE = 0,
+    CTRL_CH_RELAY1 = 1,
+    CTRL_CH_RELAY8 = CTRL_CH_RELAY1 + MAX_RELAYS - 1,
+    CTRL_CH_LIGHT = 9,
+    CTRL_CH_DIMMER = 10,
+    CTRL_CH_RGB = 11,
+    CTRL_CH_RGBW = 12,
+    CTRL_CH_FAN = 13,
+    CTRL_CH_FAN_POWER = 14,
+    CTRL_CH_FAN_SPEED = 15,
+} control_channel_t;
+
+typedef enum {
+    CTRL_ACT_OFF = 0,
+    CTRL_ACT_ON = 1,
+    CTRL_ACT_TOGGLE = 2,
+    CTRL_ACT_SET = 3,
+    CTRL_ACT_KEEP = 4,
+} control_action_t;
+
+typedef struct {
+    control_channel_t channel;
+    control_action_t action;
+    int value;
+    int rgb[RGB_CHANNELS]; /* -1 keeps the current component */
+    int transition_ms;     /* hardware fade length for dimmer/rgb/fan; 0 switches instantly */
+    int duration_ms;       /* switch the output off again after this long; 0 leaves it as set */
+} control_op_t;
+
+#define CTRL_CH_COUNT (CTRL_CH_FAN_SPEED + 1)
+
+/* Channel registry, rebuilt at boot and after every config change so control dispatch is one
+ * lookup against pins that were already validated. */
+typedef struct channel_desc {
+    const char *name;
+    uint32_t name_hash;
+    bool enabled; /* addressable with the current config (relays beyond relay_count are not) */
+    int gpio;     /* resolved digital output, -1 when absent or taken by a relay */
+    int pwm;      /* PWM channel, FW_PWM_NONE for digital-only channels */
+    int index;    /* relay index for relay channels */
+    bool (*apply)(const struct channel_desc *ch, const control_op_t *op);
+} channel_desc_t;
+
+/* Live output state and registry. Callers serialise access (the firmware only touches them from its actuation task). */
+extern output_state_t g_state;
+extern channel_desc_t g_channels[CTRL_CH_COUNT];
+
+/* Fills table for the given relay map (invalid pins leave the relay unmapped); light_pin/fan_pin are
+ * -1 when the pin is taken or absent. The caller swaps it into g_channels from wherever it
+ * serialises control. */
+void control_registry_build(channel_desc_t table[CTRL_CH_COUNT], const int relay_gpio[MAX_RELAYS], int relay_count, int light_pin,
+                            int fan_pin);
+
+void init_gamma_table(void);
+control_action_t parse_control_action(const char *state);
+control_channel_t parse_control_channel(const char *ch);
+control_channel_t control_channel_from_id(int id);
+bool control_op_from_flat(const flat_json_t *fj, control_op_t *op, char *channel_name, size_t channel_size);
+const channel_desc_t *channel_desc(control_channel_t id);
+bool control_op_valid(const control_op_t *op);
+/* Applies one op to g_state and the outputs; false if the channel is not addressable. */
+bool control_op_apply(const control_op_t *op);
+
+/* While a batch is open, output writes are staged and land together in end_output_batch(). */
+void begin_output_batch(void);
+void end_output_batch(void);
+bool output_batch_active(void);
+
+void apply_relay(int idx, bool on);
+void apply_light_single(bool on);
+void apply_dimmer(int pct, int transition_ms);
+void apply_rgb(int r, int g, int b, int w, int transition_ms);
+void apply_fan(bool power, int speed_pct, int transition_ms);
+
+bool output_state_equal(const output_state_t *a, const output_state_t *b);
+void write_outputs_json(json_writer_t *jw, const output_state_t *st, int relay_count);
+/* Writes only the members that differ; returns how many were written. */
+int write_output_delta_json(json_writer_t *jw, const output_state_t *prev, const output_state_t *cur, int relay_count);
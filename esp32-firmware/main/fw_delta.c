@@ -0,0 +1,137 @@
+#include "fw_delta.h"
+
+#include <string.h>
+
+static uint32_t read_le32(const uint8_t *b) {
+    return (uint32_t)b[0] | ((uint32_t)b[1] << 8) | ((uint32_t)b[2] << 16) | ((uint32_t)b[3] << 24);
+}
+
+void delta_init(delta_state_t *d, uint32_t base_size, uint32_t target_size, uint8_t *scratch, size_t scratch_size,
+                delta_read_fn read_base, delta_emit_fn emit, void *ctx) {
+    memset(d, 0, sizeof(*d));
+    d->stage = DELTA_ST_HEADER;
+    d->base_size = base_size;
+    d->target_size = target_size;
+    d->scratch = scratch;
+    d->scratch_size = scratch_size;
+    d->read_base = read_base;
+    d->emit = emit;
+    d->ctx = ctx;
+}
+
+static delta_result_t delta_emit(delta_state_t *d, const uint8_t *data, size_t len) {
+    if (len == 0) return DELTA_OK;
+    if (!d->emit(d->ctx, data, len)) return DELTA_EMIT_FAILED;
+    d->written += (uint32_t)len;
+    return DELTA_OK;
+}
+
+static delta_result_t delta_copy(delta_state_t *d, uint32_t src, uint32_t len) {
+    /* Written as subtractions so a huge src/len cannot wrap past the checks. */
+    if (src > d->base_size || len > d->base_size - src || len > d->target_size - d->written) return DELTA_COPY_RANGE;
+    while (len > 0) {
+        uint32_t n = len > d->scratch_size ? (uint32_t)d->scratch_size : len;
+        if (!d->read_base(d->ctx, src, d->scratch, n)) return DELTA_READ_FAILED;
+        delta_result_t res = delta_emit(d, d->scratch, n);
+        if (res != DELTA_OK) return res;
+        src += n;
+        len -= n;
+    }
+    return DELTA_OK;
+}
+
+/* Collects a fixed-size field across chunk boundaries; true once `need` bytes are buffered. */
+static bool delta_take(delta_state_t *d, const uint8_t **data, size_t *len, size_t need) {
+    size_t n = need - d->field_have;
+    if (n > *len) n = *len;
+    memcpy(d->field + d->field_have, *data, n);
+    d->field_have += n;
+    *data += n;
+    *len -= n;
+    if (d->field_have < need) return false;
+    d->field_have = 0;
+    return true;
+}
+
+delta_result_t delta_feed(delta_state_t *d, const uint8_t *data, size_t len) {
+    while (len > 0) {
+        switch (d->stage) {
+        case DELTA_ST_HEADER:
+            if (!delta_take(d, &data, &len, DELTA_HEADER_LEN)) return DELTA_OK;
+            if (memcmp(d->field, DELTA_MAGIC, 4) != 0 || d->field[4] != DELTA_VERSION || read_le32(d->field + 8) != d->base_size ||
+                read_le32(d->field + 12) != d->target_size) {
+                return DELTA_BAD_HEADER;
+            }
+            d->stage = DELTA_ST_OP;
+            break;
+        case DELTA_ST_OP: {
+            uint8_t op = *data++;
+            len--;
+            if (op == DELTA_OP_COPY) {
+                d->stage = DELTA_ST_COPY_ARGS;
+            } else if (op == DELTA_OP_DATA) {
+                d->stage = DELTA_ST_DATA_LEN;
+            } else if (op == DELTA_OP_END) {
+                d->stage = DELTA_ST_DONE;
+            } else {
+                return DELTA_BAD_OP;
+            }
+            break;
+        }
+        case DELTA_ST_COPY_ARGS: {
+            if (!delta_take(d, &data, &len, 8)) return DELTA_OK;
+            delta_result_t res = delta_copy(d, read_le32(d->field), read_le32(d->field + 4));
+            if (res != DELTA_OK) return res;
+            d->stage = DELTA_ST_OP;
+            break;
+        }
+        case DELTA_ST_DATA_LEN:
+            if (!delta_take(d, &data, &len, 4)) return DELTA_OK;
+            d->data_left = read_le32(d->field);
+            if (d->data_left > d->target_size - d->written) return DELTA_DATA_OVERRUN;
+            d->stage = d->data_left ? DELTA_ST_DATA : DELTA_ST_OP;
+            break;
+        case DELTA_ST_DATA: {
+            size_t n = d->data_left < len ? d->data_left : len;
+            delta_result_t res = delta_emit(d, data, n);
+            if (res != DELTA_OK) return res;
+            data += n;
+            len -= n;
+            d->data_left -= (uint32_t)n;
+            if (d->data_left == 0) d->stage = DELTA_ST_OP;
+            break;
+        }
+        case DELTA_ST_DONE:
+            return DELTA_TRAILING;
+        }
+    }
+    return DELTA_OK;
+}
+
+delta_result_t delta_finish(const delta_state_t *d) {
+    return d->stage == DELTA_ST_DONE && d->written == d->target_size ? DELTA_OK : DELTA_INCOMPLETE;
+}
+
+const char *delta_result_name(delta_result_t res) {
+    switch (res) {
+    case DELTA_OK:
+        return "ok";
+    case DELTA_BAD_HEADER:
+        return "bad_header";
+    case DELTA_BAD_OP:
+        return "bad_op";
+    case DELTA_COPY_RANGE:
+        return "copy_range";
+    case DELTA_DATA_OVERRUN:
+        return "data_overrun";
+    case DELTA_TRAILING:
+        return "trailing";
+    case DELTA_READ_FAILED:
+        return "read_failed";
+    case DELTA_EMIT_FAILED:
+        return "emit_failed";
+    case DELTA_INCOMPLETE:
+        return "incomplete";
+    }
+    return "unknown";
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Delta patch ("8bdp1", built by flasher-web/app/ota.py make_delta_patch): a 16-byte header
+ * (magic "8BDP", version, 3 pad bytes, base_size, target_size; little-endian) followed by
+ * COPY(u32 base_offset, u32 length), DATA(u32 length, bytes) and END ops. The applier is fed the
+ * patch in arbitrary chunks; it reads the base image and emits the target through callbacks, so
+ * the firmware wires them to the running partition and the OTA writer and the host build to
+ * plain buffers. */
+#define DELTA_MAGIC "8BDP"
+#define DELTA_VERSION 1
+#define DELTA_HEADER_LEN 16
+
+typedef enum {
+    DELTA_OP_END = 0,
+    DELTA_OP_COPY = 1,
+    DELTA_OP_DATA = 2,
+} delta_op_t;
+
+typedef enum {
+    DELTA_ST_HEADER,
+    DELTA_ST_OP,
+    DELTA_ST_COPY_ARGS,
+    DELTA_ST_DATA_LEN,
+    DELTA_ST_DATA,
+    DELTA_ST_DONE,
+} delta_stage_t;
+
+typedef enum {
+    DELTA_OK,
+    DELTA_BAD_HEADER,   /* magic/version wrong or sizes differ from what the caller expects */
+    DELTA_BAD_OP,
+    DELTA_COPY_RANGE,   /* COPY leaves the base or overruns the target */
+    DELTA_DATA_OVERRUN, /* DATA overruns the target */
+    DELTA_TRAILING,     /* bytes after END */
+    DELTA_READ_FAILED,
+    DELTA_EMIT_FAILED,
+    DELTA_INCOMPLETE,   /* stream ended before END, or END came before target_size bytes */
+} delta_result_t;
+
+typedef bool (*delta_read_fn)(void *ctx, uint32_t offset, uint8_t *buf, size_t len);
+typedef bool (*delta_emit_fn)(void *ctx, const uint8_t *data, size_t len);
+
+typedef struct {
+    delta_stage_t stage;
+    uint8_t field[DELTA_HEADER_LEN];
+    size_t field_have;
+    uint32_t base_size;
+    uint32_t target_size;
+    uint32_t written;
+    uint32_t data_left;
+    uint8_t *scratch; /* COPY staging buffer, scratch_size bytes */
+    size_t scratch_size;
+    delta_read_fn read_base;
+    delta_emit_fn emit;
+    void *ctx;
+} delta_state_t;
+
+/* base_size/target_size come from the (signed) manifest; the patch header must agree with them. */
+void delta_init(delta_state_t *d, uint32_t base_size, uint32_t target_size, uint8_t *scratch, size_t scratch_size,
+                delta_read_fn read_base, delta_emit_fn emit, void *ctx);
+/* Applies the next chunk of patch bytes. Once a call fails the state must not be fed again. */
+delta_result_t delta_feed(delta_state_t *d, const uint8_t *data, size_t len);
+/* Call at end of stream: DELTA_OK only if END was seen and exactly target_size bytes were emitted. */
+delta_result_t delta_finish(const delta_state_t *d);
+const char *delta_result_name(delta_result_t res);
@@ -0,0 +1,21 @@
+#pragma once
+
+/* Hardware seam for the portable core (fw_*.c). The firmware implements these in main.c on top of
+ * ESP-IDF; host/fw_hal_host.c implements them for the Linux build used by the microbenchmarks.
+ * Core code calls nothing else platform-specific. */
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Digital outputs. hal_gpio_write_masks switches every set/cleared pin (bit n = GPIO n) together. */
+bool hal_gpio_output_capable(int pin);
+void hal_gpio_write(int pin, bool on);
+void hal_gpio_write_masks(uint64_t set_mask, uint64_t clear_mask);
+
+/* PWM channel 0..FW_PWM_CHANNELS-1 to duty (0..PWM_DUTY_MAX), faded over fade_ms when > 0. */
+void hal_pwm_apply(int channel, uint32_t duty, int fade_ms);
+
+/* Called after outputs change outside a batch and once at the end of each batch. */
+void hal_outputs_changed(void);
+
+void hal_hmac_sha256(const uint8_t *key, size_t key_len, const uint8_t *msg, size_t msg_len, uint8_t out[32]);
@@ -0,0 +1,304 @@
+#include "fw_json.h"
+
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+void jw_init_sink(json_writer_t *jw, jw_sink_fn sink, void *ctx, char *buf, size_t cap) {
+    memset(jw, 0, sizeof(*jw));
+    jw->sink = sink;
+    jw->ctx = ctx;
+    jw->buf = buf;
+    /* Buffer-only mode keeps one byte back for the terminating NUL. */
+    jw->cap = (sink || cap == 0) ? cap : cap - 1;
+}
+
+bool jw_flush(json_writer_t *jw) {
+    if (jw->len == 0) return true;
+    if (!jw->sink || !jw->sink(jw->ctx, jw->buf, jw->len)) {
+        jw->failed = true;
+        return false;
+    }
+    jw->streamed = true;
+    jw->len = 0;
+    return true;
+}
+
+void jw_write(json_writer_t *jw, const char *data, size_t n) {
+    if (jw->failed) return;
+    jw->total += n;
+    if (!jw->buf) return;
+    while (n > 0) {
+        if (jw->len == jw->cap && !jw_flush(jw)) return;
+        size_t room = jw->cap - jw->len;
+        size_t take = n < room ? n : room;
+        memcpy(jw->buf + jw->len, data, take);
+        jw->len += take;
+        data += take;
+        n -= take;
+    }
+}
+
+static void jw_putc(json_writer_t *jw, char c) {
+    jw_write(jw, &c, 1);
+}
+
+static void jw_escaped(json_writer_t *jw, const char *s) {
+    jw_putc(jw, '"');
+    const char *run = s;
+    for (; s && *s; s++) {
+        unsigned char c = (unsigned char)*s;
+        if (c >= 0x20 && c != '"' && c != '\\') continue;
+        jw_write(jw, run, (size_t)(s - run));
+        char esc[8] = {0};
+        if (c == '"' || c == '\\') {
+            esc[0] = '\\';
+            esc[1] = (char)c;
+        } else if (c == '\n') {
+            memcpy(esc, "\\n", 2);
+        } else {
+            snprintf(esc, sizeof(esc), "\\u%04x", c);
+        }
+        jw_write(jw, esc, strlen(esc));
+        run = s + 1;
+    }
+    if (run) jw_write(jw, run, strlen(run));
+    jw_putc(jw, '"');
+}
+
+static void jw_key(json_writer_t *jw, const char *key) {
+    uint32_t bit = 1u << jw->depth;
+    if (jw->has_items & bit) jw_putc(jw, ',');
+    jw->has_items |= bit;
+    if (key) {
+        jw_escaped(jw, key);
+        jw_putc(jw, ':');
+    }
+}
+
+static void jw_open(json_writer_t *jw, const char *key, char brace) {
+    jw_key(jw, key);
+    if (jw->depth + 1 >= JSON_WRITER_MAX_DEPTH) {
+        jw->failed = true;
+        return;
+    }
+    jw_putc(jw, brace);
+    jw->depth++;
+    jw->has_items &= ~(1u << jw->depth);
+}
+
+static void jw_close(json_writer_t *jw, char brace) {
+    if (jw->depth > 0) jw->depth--;
+    jw_putc(jw, brace);
+}
+
+void jw_begin_object(json_writer_t *jw, const char *key) { jw_open(jw, key, '{'); }
+void jw_end_object(json_writer_t *jw) { jw_close(jw, '}'); }
+void jw_begin_array(json_writer_t *jw, const char *key) { jw_open(jw, key, '['); }
+void jw_end_array(json_writer_t *jw) { jw_close(jw, ']'); }
+
+void jw_str(json_writer_t *jw, const char *key, const char *value) {
+    jw_key(jw, key);
+    jw_escaped(jw, value ? value : "");
+}
+
+void jw_int(json_writer_t *jw, const char *key, long long value) {
+    char num[24] = {0};
+    int n = snprintf(num, sizeof(num), "%lld", value);
+    jw_key(jw, key);
+    jw_write(jw, num, (size_t)n);
+}
+
+void jw_bool(json_writer_t *jw, const char *key, bool value) {
+    jw_key(jw, key);
+    if (value) {
+        jw_write(jw, "true", 4);
+    } else {
+        jw_write(jw, "false", 5);
+    }
+}
+
+void jw_raw_members(json_writer_t *jw, const char *members) {
+    if (!members || members[0] == '\0') return;
+    jw_key(jw, NULL);
+    jw_write(jw, members, strlen(members));
+}
+
+const char *jw_cstr(json_writer_t *jw) {
+    if (!jw->buf || jw->failed) return NULL;
+    jw->buf[jw->len] = '\0';
+    return jw->buf;
+}
+
+static const char *flat_json_ws(const char *p) {
+    while (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r') p++;
+    return p;
+}
+
+/* p points at the opening quote; returns the position after the closing quote or NULL. */
+static const char *flat_json_string(const char *p, const char **start, int *len) {
+    const char *q = ++p;
+    while (*q && *q != '"') {
+        if (*q == '\\') {
+            q++;
+            if (!*q || *q == 'u') return NULL;
+        }
+        q++;
+    }
+    if (*q != '"') return NULL;
+    *start = p;
+    *len = (int)(q - p);
+    return q + 1;
+}
+
+/* p points at '{' or '['; returns the position after the matching close or NULL. Strings inside
+ * are stepped over so brackets in values do not count; contents are not otherwise validated. */
+static const char *flat_json_skip_nested(const char *p) {
+    int depth = 0;
+    for (; *p; p++) {
+        if (*p == '"') {
+            for (p++; *p && *p != '"'; p++) {
+                if (*p == '\\' && !*++p) return NULL;
+            }
+            if (!*p) return NULL;
+        } else if (*p == '{' || *p == '[') {
+            if (++depth > JSON_WRITER_MAX_DEPTH) return NULL;
+        } else if (*p == '}' || *p == ']') {
+            if (--depth == 0) return p + 1;
+        }
+    }
+    return NULL;
+}
+
+/* End of a JSON number (RFC 8259 grammar) starting at p, or NULL. strtod alone would also take
+ * inf, nan, hex and a leading '+'. */
+static const char *flat_json_number_end(const char *p) {
+    if (*p == '-') p++;
+    if (*p == '0') {
+        p++;
+    } else if (*p >= '1' && *p <= '9') {
+        while (*p >= '0' && *p <= '9') p++;
+    } else {
+        return NULL;
+    }
+    if (*p == '.') {
+        if (!(*++p >= '0' && *p <= '9')) return NULL;
+        while (*p >= '0' && *p <= '9') p++;
+    }
+    if (*p == 'e' || *p == 'E') {
+        p++;
+        if (*p == '+' || *p == '-') p++;
+        if (!(*p >= '0' && *p <= '9')) return NULL;
+        while (*p >= '0' && *p <= '9') p++;
+    }
+    return p;
+}
+
+static bool flat_json_parse_ex(const char *text, flat_json_t *out, bool nested) {
+    out->count = 0;
+    const char *p = flat_json_ws(text);
+    if (*p++ != '{') return false;
+    p = flat_json_ws(p);
+    if (*p == '}') return *flat_json_ws(p + 1) == '\0';
+    while (out->count < FLAT_JSON_MAX_FIELDS) {
+        flat_json_field_t *f = &out->fields[out->count];
+        if (*p != '"' || !(p = flat_json_string(p, &f->key, &f->key_len))) return false;
+        p = flat_json_ws(p);
+        if (*p++ != ':') return false;
+        p = flat_json_ws(p);
+        f->num = 0;
+        if (*p == '"') {
+            f->type = FLAT_JSON_STR;
+            if (!(p = flat_json_string(p, &f->val, &f->val_len))) return false;
+        } else if (strncmp(p, "true", 4) == 0 || strncmp(p, "false", 5) == 0) {
+            f->type = FLAT_JSON_BOOL;
+            f->num = (*p == 't') ? 1 : 0;
+            p += (*p == 't') ? 4 : 5;
+        } else if (strncmp(p, "null", 4) == 0) {
+            f->type = FLAT_JSON_NULL;
+            p += 4;
+        } else if (*p == '-' || (*p >= '0' && *p <= '9')) {
+            const char *end = flat_json_number_end(p);
+            if (!end) return false;
+            f->type = FLAT_JSON_NUM;
+            f->num = strtod(p, NULL);
+            /* Overflow (1e999) comes back as inf; nothing downstream can use a non-finite value. */
+            if (!isfinite(f->num)) return false;
+            p = end;
+        } else if (nested && (*p == '{' || *p == '[')) {
+            const char *end = flat_json_skip_nested(p);
+            if (!end) return false;
+            f->type = FLAT_JSON_RAW;
+            f->val = p;
+            f->val_len = (int)(end - p);
+            p = end;
+        } else {
+            return false;
+        }
+        out->count++;
+        p = flat_json_ws(p);
+        if (*p == ',') {
+            p = flat_json_ws(p + 1);
+            continue;
+        }
+        return *p == '}' && *flat_json_ws(p + 1) == '\0';
+    }
+    return false;
+}
+
+bool flat_json_parse(const char *text, flat_json_t *out) {
+    return flat_json_parse_ex(text, out, false);
+}
+
+bool flat_json_parse_doc(const char *text, flat_json_t *out) {
+    return flat_json_parse_ex(text, out, true);
+}
+
+const flat_json_field_t *flat_json_get(const flat_json_t *fj, const char *key, flat_json_type_t type) {
+    int key_len = (int)strlen(key);
+    for (int i = 0; i < fj->count; i++) {
+        const flat_json_field_t *f = &fj->fields[i];
+        if (f->key_len == key_len && memcmp(f->key, key, key_len) == 0) return f->type == type ? f : NULL;
+    }
+    return NULL;
+}
+
+bool flat_json_get_str(const flat_json_t *fj, const char *key, char *out, size_t out_size) {
+    const flat_json_field_t *f = flat_json_get(fj, key, FLAT_JSON_STR);
+    if (!f) return false;
+    size_t n = 0;
+    for (int i = 0; i < f->val_len; i++) {
+        char c = f->val[i];
+        if (c == '\\') {
+            c = f->val[++i];
+            if (c == 'n') c = '\n';
+            else if (c == 't') c = '\t';
+            else if (c == 'r') c = '\r';
+            else if (c == 'b') c = '\b';
+            else if (c == 'f') c = '\f';
+        }
+        if (n + 1 >= out_size) return false;
+        out[n++] = c;
+    }
+    out[n] = '\0';
+    return true;
+}
+
+bool flat_json_get_int(const flat_json_t *fj, const char *key, int *out) {
+    const flat_json_field_t *f = flat_json_get(fj, key, FLAT_JSON_NUM);
+    if (!f) return false;
+    /* Saturates like cJSON's valueint, so the flat and cJSON paths agree on out-of-range input. */
+    if (f->num >= (double)INT_MAX) *out = INT_MAX;
+    else if (f->num <= (double)INT_MIN) *out = INT_MIN;
+    else *out = (int)f->num;
+    return true;
+}
+
+bool flat_json_get_num(const flat_json_t *fj, const char *key, double *out) {
+    const flat_json_field_t *f = flat_json_get(fj, key, FLAT_JSON_NUM);
+    if (!f) return false;
+    *out = f->num;
+    return true;
+}
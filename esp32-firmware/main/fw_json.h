@@ -0,0 +1,79 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Streaming JSON emitter for responses: writes into a caller buffer and hands it to the sink when it
+ * fills, so response paths never touch the heap. Without a sink it renders into the buffer only;
+ * with buf == NULL it just counts bytes. */
+#define JSON_WRITER_BUF 512
+#define JSON_WRITER_MAX_DEPTH 8
+
+/* Returns false when the bytes could not be delivered; the writer then stops. */
+typedef bool (*jw_sink_fn)(void *ctx, const char *data, size_t len);
+
+typedef struct {
+    jw_sink_fn sink;
+    void *ctx;
+    char *buf;
+    size_t cap;
+    size_t len;
+    size_t total;
+    int depth;
+    uint32_t has_items;
+    bool streamed;
+    bool failed;
+} json_writer_t;
+
+void jw_init_sink(json_writer_t *jw, jw_sink_fn sink, void *ctx, char *buf, size_t cap);
+bool jw_flush(json_writer_t *jw);
+void jw_write(json_writer_t *jw, const char *data, size_t n);
+void jw_begin_object(json_writer_t *jw, const char *key);
+void jw_end_object(json_writer_t *jw);
+void jw_begin_array(json_writer_t *jw, const char *key);
+void jw_end_array(json_writer_t *jw);
+void jw_str(json_writer_t *jw, const char *key, const char *value);
+void jw_int(json_writer_t *jw, const char *key, long long value);
+void jw_bool(json_writer_t *jw, const char *key, bool value);
+/* Splices pre-rendered object members (no braces) into the current object. */
+void jw_raw_members(json_writer_t *jw, const char *members);
+const char *jw_cstr(json_writer_t *jw);
+
+/* Non-allocating reader for flat JSON objects (string/number/bool/null members only). Values are
+ * spans into the caller's buffer; anything nested or \u-escaped returns false so callers fall back to cJSON. */
+#define FLAT_JSON_MAX_FIELDS 16
+
+typedef enum {
+    FLAT_JSON_STR,
+    FLAT_JSON_NUM,
+    FLAT_JSON_BOOL,
+    FLAT_JSON_NULL,
+    FLAT_JSON_RAW, /* nested object/array kept as an unparsed span (flat_json_parse_doc only) */
+} flat_json_type_t;
+
+typedef struct {
+    const char *key;
+    int key_len;
+    const char *val; /* string body without quotes, still escaped */
+    int val_len;
+    double num;
+    flat_json_type_t type;
+} flat_json_field_t;
+
+typedef struct {
+    flat_json_field_t fields[FLAT_JSON_MAX_FIELDS];
+    int count;
+} flat_json_t;
+
+bool flat_json_parse(const char *text, flat_json_t *out);
+/* Like flat_json_parse, but nested members are skipped over as FLAT_JSON_RAW spans, for documents
+ * (manifests) whose interesting members are flat even when others are not. */
+bool flat_json_parse_doc(const char *text, flat_json_t *out);
+const flat_json_field_t *flat_json_get(const flat_json_t *fj, const char *key, flat_json_type_t type);
+/* Unescapes a string member into out; false if missing, not a string, or too long. */
+bool flat_json_get_str(const flat_json_t *fj, const char *key, char *out, size_t out_size);
+/* Numbers are strict JSON and always finite (the parse fails otherwise). get_int truncates toward
+ * zero and saturates at INT_MIN/INT_MAX. */
+bool flat_json_get_int(const flat_json_t *fj, const char *key, int *out);
+bool flat_json_get_num(const flat_json_t *fj, const char *key, double *out);
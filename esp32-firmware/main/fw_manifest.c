@@ -0,0 +1,60 @@
+#include "fw_manifest.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "fw_hal.h"
+#include "fw_json.h"
+#include "fw_util.h"
+
+#define MANIFEST_FIELD_MAX 96
+
+bool compute_manifest_signature(const char *ota_key, const char *sha256, const char *version, const char *device_type, char *out,
+                                size_t out_size) {
+    if (!ota_key || !sha256 || !version || !device_type || !out) return false;
+    char msg[256] = {0};
+    int len = snprintf(msg, sizeof(msg), "%s:%s:%s", sha256, version, device_type);
+    if (len < 0 || len >= (int)sizeof(msg)) return false;
+    uint8_t hmac[32] = {0};
+    hal_hmac_sha256((const uint8_t *)ota_key, strlen(ota_key), (const uint8_t *)msg, (size_t)len, hmac);
+    hex_encode(hmac, sizeof(hmac), out, out_size);
+    return true;
+}
+
+manifest_result_t manifest_check(const manifest_fields_t *m, const char *ota_key, const char *own_type) {
+    if (!m->algorithm || !m->sha256 || !m->version || !m->device_type || !m->signature) return MANIFEST_BAD_FIELDS;
+    if (strcmp(m->algorithm, "hmac-sha256") != 0) return MANIFEST_BAD_ALGORITHM;
+    if (strcmp(m->device_type, own_type) != 0 && strcmp(m->device_type, "any") != 0) return MANIFEST_WRONG_TYPE;
+
+    char expected[65] = {0};
+    if (!compute_manifest_signature(ota_key, m->sha256, m->version, m->device_type, expected, sizeof(expected))) {
+        return MANIFEST_BAD_FIELDS;
+    }
+    /* Fixed-length compare so response timing does not leak how much of a forged signature matched. */
+    if (strlen(m->signature) != 64 || !constant_time_equal((const uint8_t *)expected, (const uint8_t *)m->signature, 64)) {
+        return MANIFEST_BAD_SIGNATURE;
+    }
+    return MANIFEST_OK;
+}
+
+manifest_result_t manifest_verify(const char *manifest_json, const char *ota_key, const char *own_type, char *sha_out,
+                                  size_t sha_out_size) {
+    flat_json_t fj;
+    if (!manifest_json || !flat_json_parse_doc(manifest_json, &fj)) return MANIFEST_UNPARSED;
+    char algorithm[24];
+    char sha256[MANIFEST_FIELD_MAX];
+    char version[MANIFEST_FIELD_MAX];
+    char device_type[MANIFEST_FIELD_MAX];
+    char signature[MANIFEST_FIELD_MAX];
+    manifest_fields_t m = {
+        .algorithm = flat_json_get_str(&fj, "algorithm", algorithm, sizeof(algorithm)) ? algorithm : NULL,
+        .sha256 = flat_json_get_str(&fj, "sha256", sha256, sizeof(sha256)) ? sha256 : NULL,
+        .version = flat_json_get_str(&fj, "version", version, sizeof(version)) ? version : NULL,
+        .device_type = flat_json_get_str(&fj, "device_type", device_type, sizeof(device_type)) ? device_type : NULL,
+        .signature = flat_json_get_str(&fj, "signature", signature, sizeof(signature)) ? signature : NULL,
+    };
+    manifest_result_t res = manifest_check(&m, ota_key, own_type);
+    if (res == MANIFEST_OK) safe_strcpy(sha_out, m.sha256, sha_out_size);
+    return res;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/* Signed OTA manifest check: signature = hex(HMAC-SHA256(ota_key, "sha256:version:device_type")). */
+typedef enum {
+    MANIFEST_OK,
+    MANIFEST_UNPARSED, /* not flat-parsable (e.g. \u escapes); the caller may retry with a full parser */
+    MANIFEST_BAD_FIELDS,
+    MANIFEST_BAD_ALGORITHM,
+    MANIFEST_WRONG_TYPE,
+    MANIFEST_BAD_SIGNATURE,
+} manifest_result_t;
+
+typedef struct {
+    const char *algorithm;
+    const char *sha256;
+    const char *version;
+    const char *device_type;
+    const char *signature;
+} manifest_fields_t;
+
+bool compute_manifest_signature(const char *ota_key, const char *sha256, const char *version, const char *device_type, char *out,
+                                size_t out_size);
+/* Checks already-extracted members; any NULL member is MANIFEST_BAD_FIELDS. */
+manifest_result_t manifest_check(const manifest_fields_t *m, const char *ota_key, const char *own_type);
+/* Parses manifest_json without allocating and checks it; on MANIFEST_OK copies the signed sha256 to sha_out. */
+manifest_result_t manifest_verify(const char *manifest_json, const char *ota_key, const char *own_type, char *sha_out,
+                                  size_t sha_out_size);
@@ -0,0 +1,40 @@
+#include "fw_util.h"
+
+#include <stdio.h>
+
+void safe_strcpy(char *dst, const char *src, size_t dst_size) {
+    if (!dst || !src || dst_size == 0) return;
+    snprintf(dst, dst_size, "%s", src);
+}
+
+int clamp_int(int value, int min_val, int max_val) {
+    if (value < min_val) return min_val;
+    if (value > max_val) return max_val;
+    return value;
+}
+
+uint32_t fnv1a_update(uint32_t hash, const void *data, size_t len) {
+    const uint8_t *p = (const uint8_t *)data;
+    for (size_t i = 0; i < len; i++) {
+        hash ^= p[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+void hex_encode(const unsigned char *input, size_t len, char *out, size_t out_size) {
+    const char *hex = "0123456789abcdef";
+    size_t need = len * 2 + 1;
+    if (out_size < need) return;
+    for (size_t i = 0; i < len; i++) {
+        out[i * 2] = hex[(input[i] >> 4) & 0xF];
+        out[i * 2 + 1] = hex[input[i] & 0xF];
+    }
+    out[len * 2] = '\0';
+}
+
+bool constant_time_equal(const uint8_t *a, const uint8_t *b, size_t len) {
+    uint8_t diff = 0;
+    for (size_t i = 0; i < len; i++) diff |= a[i] ^ b[i];
+    return diff == 0;
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define FNV1A_INIT 2166136261u
+
+void safe_strcpy(char *dst, const char *src, size_t dst_size);
+int clamp_int(int value, int min_val, int max_val);
+uint32_t fnv1a_update(uint32_t hash, const void *data, size_t len);
+void hex_encode(const unsigned char *input, size_t len, char *out, size_t out_size);
+bool constant_time_equal(const uint8_t *a, const uint8_t *b, size_t len);
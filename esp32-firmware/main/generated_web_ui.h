@@ -0,0 +1,571 @@
+#pragma once
+
+// Auto-generated by flasher build endpoint from main/web/index.html. Do not edit manually.
+#include <stdint.h>
+
+#define WEB_UI_GZ_ETAG "\"2a41befd5f5f2e65\""
+#define WEB_UI_GZ_LEN 8982
+static const uint8_t WEB_UI_GZ[WEB_UI_GZ_LEN] = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xcd, 0x7d, 0x6b, 0x77, 0xdb, 0x38,
+    0x92, 0xe8, 0xf7, 0xfc, 0x0a, 0xfa, 0x64, 0xdb, 0x24, 0xd7, 0xb4, 0x2c, 0x4a, 0xf2, 0x4b, 0x32,
+    0xed, 0x75, 0xa7, 0x93, 0x19, 0xdf, 0x49, 0x62, 0x9f, 0x28, 0xbd, 0xb3, 0x73, 0x3a, 0x39, 0x3e,
+    0x94, 0x08, 0x49, 0x6c, 0x53, 0x24, 0x97, 0xa4, 0xec, 0x78, 0x15, 0xfd, 0xf7, 0x5b, 0x55, 0x00,
+    0x48, 0xf0, 0x25, 0x2b, 0xd9, 0xd9, 0xbd, 0x77, 0xe6, 0xc4, 0x36, 0x41, 0xa0, 0x50, 0xa8, 0x37,
+    0x0a, 0x05, 0xf6, 0xc5, 0x9e, 0x17, 0x4d, 0xb3, 0xe7, 0x98, 0x69, 0x8b, 0x6c, 0x19, 0x5c, 0xbe,
+    0xba, 0xa0, 0x5f, 0x17, 0x0b, 0xe6, 0x7a, 0x97, 0x17, 0x4b, 0x96, 0xb9, 0xda, 0x74, 0xe1, 0x26,
+    0x29, 0xcb, 0x1c, 0x7d, 0x95, 0xcd, 0x0e, 0xcf, 0xf4, 0x23, 0xe8, 0x43, 0xed, 0xa1, 0xbb, 0x64,
+    0x8e, 0xfe, 0xe8, 0xb3, 0xa7, 0x38, 0x4a, 0x32, 0x5d, 0x9b, 0x46, 0x61, 0xc6, 0x42, 0xe8, 0xf7,
+    0xe4, 0x7b, 0xd9, 0xc2, 0xf1, 0xd8, 0xa3, 0x3f, 0x65, 0x87, 0xf4, 0x60, 0xf9, 0xa1, 0x9f, 0xf9,
+    0x6e, 0x70, 0x98, 0x4e, 0xdd, 0x80, 0x39, 0x36, 0x01, 0xc9, 0xfc, 0x2c, 0x60, 0x97, 0x67, 0x93,
+    0x89, 0xf6, 0x76, 0x7c, 0xd7, 0xef, 0x5d, 0x1c, 0xf1, 0x86, 0x57, 0x17, 0x69, 0xf6, 0x8c, 0xbf,
+    0x87, 0x49, 0x14, 0x65, 0xeb, 0x69, 0x14, 0x44, 0x09, 0x8c, 0x5b, 0xb0, 0x25, 0x1b, 0x7a, 0x6e,
+    0xf2, 0x30, 0x3a, 0x3c, 0x9c, 0xcc, 0x87, 0xaf, 0xbb, 0x13, 0xbb, 0x6f, 0x9f, 0xd1, 0xc3, 0x61,
+    0x1a, 0xcd, 0xb2, 0xe1, 0x6b, 0xdb, 0xee, 0x75, 0x7b, 0xd8, 0x12, 0xbb, 0x21, 0x0b, 0xe0, 0x79,
+    0xd0, 0x1b, 0xf4, 0x3c, 0xf9, 0x2c, 0x3b, 0x9d, 0xf7, 0xed, 0xfe, 0x14, 0x1a, 0x03, 0x3f, 0x64,
+    0xc3, 0xd7, 0xbd, 0xf3, 0xc1, 0xe9, 0xf1, 0x40, 0x3c, 0x1e, 0xa6, 0x59, 0x12, 0x85, 0x00, 0xbb,
+    0x7f, 0x7a, 0x62, 0x9f, 0xf6, 0xa1, 0xd5, 0x0f, 0x1f, 0x86, 0xaf, 0x99, 0x3b, 0x3b, 0x99, 0x9d,
+    0xf1, 0x27, 0x01, 0xe5, 0xdc, 0x9b, 0x9c, 0x4e, 0xbb, 0x08, 0x3a, 0xf1, 0x97, 0x6e, 0xf2, 0x8c,
+    0x93, 0x9d, 0x9f, 0x9c, 0xce, 0x8a, 0x96, 0x1c, 0x56, 0x77, 0x76, 0x7a, 0x72, 0x72, 0xac, 0xbe,
+    0xe0, 0x78, 0xf4, 0xfb, 0x5e, 0x1f, 0x81, 0xa6, 0x0c, 0xe8, 0xe6, 0x71, 0x18, 0xd3, 0x7e, 0x7f,
+    0x80, 0x50, 0xd3, 0x85, 0xeb, 0x45, 0x4f, 0xc3, 0xae, 0x66, 0x9f, 0xc5, 0xdf, 0xb4, 0x41, 0x17,
+    0x7e, 0x24, 0xf3, 0x89, 0x6b, 0x74, 0x2d, 0xfc, 0x7f, 0xa7, 0x77, 0x66, 0x6e, 0x5e, 0xfd, 0xeb,
+    0x7a, 0x12, 0x7d, 0x3b, 0x4c, 0xfd, 0xff, 0xf2, 0x61, 0x96, 0x49, 0x94, 0x78, 0x2c, 0x39, 0x84,
+    0x96, 0xcd, 0xab, 0x49, 0xe4, 0x3d, 0xaf, 0x61, 0xa6, 0xb9, 0x1f, 0x0e, 0xbb, 0xa3, 0x19, 0x30,
+    0xe5, 0x70, 0xe6, 0x2e, 0xfd, 0xe0, 0x79, 0xa8, 0x8f, 0xd9, 0x3c, 0x62, 0xda, 0xef, 0x37, 0xba,
+    0xa5, 0x7f, 0x8c, 0xb2, 0x48, 0x1b, 0xbb, 0x61, 0xaa, 0x5b, 0x29, 0xfc, 0x04, 0x34, 0x12, 0x7f,
+    0x36, 0x9a, 0xb8, 0xd3, 0x87, 0x79, 0x12, 0xad, 0x42, 0x6f, 0x98, 0xb8, 0x1e, 0x32, 0x6c, 0x8e,
+    0xbf, 0x81, 0xab, 0xc6, 0xd4, 0x4f, 0xa6, 0x01, 0xd3, 0xdc, 0x4c, 0xb3, 0x07, 0xbf, 0x68, 0x76,
+    0xef, 0x17, 0x8b, 0x50, 0xea, 0x75, 0x2d, 0xfb, 0x18, 0xfe, 0xf5, 0x4e, 0xad, 0x8e, 0x7d, 0x66,
+    0x5a, 0x59, 0x02, 0xd0, 0x62, 0x37, 0x81, 0x21, 0x5a, 0xef, 0xec, 0x17, 0xd3, 0x6a, 0x87, 0x73,
+    0x86, 0x70, 0xba, 0x02, 0xce, 0x29, 0xc2, 0xb0, 0x2d, 0xfb, 0xe4, 0x04, 0xe0, 0x9c, 0x54, 0xe0,
+    0x0c, 0x00, 0x0e, 0x32, 0xc8, 0x4d, 0x0a, 0x38, 0xf6, 0x59, 0xd7, 0x63, 0x73, 0xeb, 0x75, 0xd7,
+    0xb3, 0x4f, 0x6d, 0x4f, 0x03, 0x38, 0xaf, 0xbb, 0xae, 0x6d, 0xdb, 0x27, 0x00, 0xb3, 0xfb, 0x8b,
+    0x39, 0x22, 0xb9, 0x19, 0x3e, 0xba, 0x89, 0x41, 0x8c, 0x03, 0x8a, 0x75, 0xd2, 0x05, 0x0b, 0x02,
+    0x20, 0xcd, 0x37, 0x2e, 0x94, 0x43, 0xbb, 0xdf, 0x03, 0xd2, 0x8e, 0x24, 0xad, 0x34, 0x77, 0x95,
+    0x45, 0xa3, 0xd8, 0xf5, 0x3c, 0x24, 0x69, 0x6f, 0x00, 0x54, 0xb7, 0x4f, 0xe0, 0x47, 0x1f, 0x7e,
+    0xc0, 0xe8, 0x05, 0x4b, 0xa2, 0xb5, 0xe7, 0xa7, 0x71, 0xe0, 0x3e, 0x0f, 0xe7, 0x89, 0xef, 0x8d,
+    0xf0, 0xc7, 0x61, 0xc6, 0x96, 0xd0, 0x92, 0xb1, 0x43, 0x98, 0x70, 0xb5, 0x0c, 0xd3, 0xe1, 0xd2,
+    0x0f, 0x61, 0x0a, 0xe0, 0x95, 0xdd, 0x39, 0x9e, 0x25, 0xa6, 0x26, 0x9e, 0x7b, 0x38, 0x97, 0xd5,
+    0x39, 0x83, 0xa6, 0xd1, 0xdc, 0x8d, 0x87, 0x08, 0x7a, 0xe4, 0x06, 0xfe, 0x3c, 0x3c, 0xf4, 0x01,
+    0x46, 0x3a, 0x64, 0xa1, 0x27, 0x50, 0x01, 0x3e, 0x66, 0x59, 0xb4, 0xa4, 0x2e, 0x62, 0x62, 0x80,
+    0x1e, 0x3f, 0xaf, 0x73, 0xdc, 0x7a, 0x80, 0x16, 0x22, 0x38, 0xe2, 0x8c, 0x1f, 0xda, 0xf0, 0x9c,
+    0x46, 0x81, 0xef, 0x71, 0x39, 0x39, 0x3e, 0xb6, 0xce, 0x4f, 0x2d, 0xdb, 0x3e, 0xb6, 0x3a, 0xc7,
+    0xc7, 0xa6, 0xe8, 0x74, 0x88, 0x94, 0x5b, 0xa5, 0x34, 0x58, 0x65, 0x74, 0x0b, 0x61, 0x39, 0x77,
+    0x8f, 0xad, 0xc1, 0xb9, 0x75, 0x02, 0x32, 0x77, 0xde, 0x33, 0x79, 0x13, 0x00, 0xed, 0xdb, 0xd6,
+    0x00, 0x9b, 0x06, 0x26, 0xc2, 0xfe, 0x26, 0xc5, 0x95, 0xd3, 0x9a, 0x3f, 0x20, 0xb9, 0xd9, 0x33,
+    0x9b, 0x24, 0xd1, 0xd3, 0x3a, 0x63, 0xdf, 0xb2, 0x43, 0xe2, 0xe7, 0x2c, 0x4a, 0x96, 0xc3, 0x55,
+    0x1c, 0xb3, 0x64, 0xea, 0xa6, 0x6c, 0x14, 0xb0, 0x2c, 0x03, 0xbc, 0x80, 0xcd, 0x53, 0x5c, 0x55,
+    0xc7, 0x1e, 0xb0, 0x25, 0x17, 0x58, 0x10, 0x6b, 0x36, 0xb4, 0x61, 0x55, 0xfc, 0xf1, 0x89, 0xf9,
+    0xf3, 0x45, 0x36, 0x3c, 0xed, 0x76, 0x05, 0x5b, 0x5f, 0x9f, 0xb1, 0xe9, 0x6c, 0xc2, 0x36, 0xaf,
+    0x16, 0xb6, 0x14, 0x75, 0xd4, 0x94, 0xae, 0x76, 0x22, 0x87, 0x10, 0x84, 0x3e, 0xb2, 0xb7, 0x32,
+    0xcb, 0x61, 0xa7, 0xdb, 0x67, 0x4b, 0x95, 0xac, 0x5a, 0x5c, 0xa8, 0x4b, 0x45, 0x6a, 0x48, 0x59,
+    0xcd, 0x11, 0x19, 0x87, 0x05, 0x47, 0xc2, 0xee, 0x9c, 0xc8, 0xc1, 0x6e, 0xea, 0x7b, 0xac, 0x22,
+    0x12, 0xc8, 0xd9, 0xae, 0xc2, 0xb6, 0x85, 0x1f, 0xe7, 0x6c, 0xb3, 0xa5, 0x48, 0x55, 0x38, 0x82,
+    0x5a, 0xbe, 0x23, 0x27, 0x15, 0xfd, 0x24, 0x66, 0x9c, 0x59, 0x7d, 0x60, 0xd1, 0x00, 0xe4, 0xea,
+    0xc4, 0x6c, 0x41, 0x7e, 0x0b, 0x87, 0x72, 0x14, 0x35, 0x6e, 0xad, 0xf2, 0xb5, 0x4c, 0x82, 0x68,
+    0xfa, 0x20, 0xa5, 0x31, 0x8b, 0xe2, 0x21, 0xca, 0x5a, 0x5d, 0xa3, 0x16, 0xbd, 0xb5, 0xc2, 0xae,
+    0x53, 0x55, 0x97, 0xc0, 0x76, 0xf5, 0x1a, 0x89, 0xdf, 0x23, 0xe2, 0x4f, 0xdd, 0xc4, 0x5b, 0xbf,
+    0xbc, 0xe4, 0x5e, 0x4d, 0x78, 0x91, 0xa3, 0x39, 0x3d, 0xcf, 0x7e, 0x40, 0x92, 0xbb, 0x56, 0xff,
+    0xc4, 0x1a, 0x1c, 0x93, 0xd8, 0x0a, 0x49, 0xee, 0x5b, 0xbd, 0x13, 0xab, 0xdf, 0x87, 0xa6, 0x13,
+    0x90, 0xe4, 0x8a, 0xee, 0x71, 0xed, 0x6a, 0x25, 0x1d, 0x0a, 0xf6, 0x0e, 0xc6, 0x20, 0x61, 0x31,
+    0x73, 0x33, 0xa3, 0x67, 0x15, 0x56, 0x01, 0x0c, 0x80, 0xb0, 0x00, 0x3d, 0x92, 0x13, 0x80, 0xd4,
+    0xff, 0x01, 0x50, 0xfd, 0xed, 0xa0, 0x06, 0x3f, 0x00, 0x6a, 0xd0, 0x0e, 0x2a, 0x70, 0x27, 0x2c,
+    0xa8, 0x88, 0x83, 0xc2, 0xea, 0x5e, 0x45, 0x33, 0x4f, 0xba, 0x6d, 0xaa, 0x53, 0xa6, 0xea, 0x49,
+    0x5d, 0x24, 0x84, 0x44, 0xf8, 0x61, 0xbc, 0xca, 0xac, 0x94, 0x05, 0x6c, 0x9a, 0x59, 0x93, 0x15,
+    0xf4, 0x0e, 0x2d, 0x34, 0x1c, 0xe0, 0x01, 0xdc, 0xb5, 0x30, 0xd7, 0x60, 0xd7, 0x0b, 0xde, 0xa3,
+    0x09, 0xb4, 0x07, 0x75, 0x5d, 0x6a, 0xb4, 0x8a, 0x1c, 0x2b, 0x94, 0x8f, 0x92, 0x0e, 0x09, 0xe7,
+    0x51, 0x93, 0xec, 0x51, 0xa3, 0x6b, 0xa5, 0x15, 0x0f, 0xfd, 0x10, 0xb4, 0xc6, 0xcf, 0x04, 0xc6,
+    0xc3, 0x59, 0x34, 0x5d, 0xa5, 0x02, 0x6f, 0xf1, 0x20, 0xd1, 0xe6, 0x8f, 0xeb, 0x68, 0x95, 0x51,
+    0xac, 0x11, 0x46, 0x21, 0x93, 0xc8, 0x0a, 0x2b, 0xd6, 0x9f, 0xb9, 0xc7, 0xe7, 0x03, 0x55, 0xcc,
+    0x50, 0x71, 0xba, 0xda, 0x40, 0x3a, 0xfc, 0x92, 0x77, 0x1d, 0x80, 0xdc, 0x71, 0xca, 0xac, 0xa7,
+    0xab, 0x24, 0x05, 0x00, 0x71, 0xe4, 0x43, 0xc8, 0x95, 0x94, 0xa1, 0x2a, 0x9e, 0x73, 0x07, 0xe5,
+    0xe0, 0x8b, 0x16, 0xb1, 0x89, 0x89, 0x6e, 0xb4, 0xd4, 0x22, 0xc2, 0x18, 0x53, 0x38, 0xd5, 0xaa,
+    0x35, 0xae, 0xf1, 0xd2, 0x06, 0x0b, 0x5e, 0x5a, 0x8e, 0x2d, 0x5d, 0x95, 0xd6, 0x14, 0x2e, 0x8c,
+    0x08, 0x59, 0x08, 0x0d, 0xa3, 0x70, 0x98, 0x7b, 0x08, 0x0d, 0x02, 0x80, 0x54, 0x63, 0xe0, 0x21,
+    0xac, 0x99, 0x1f, 0x00, 0x7c, 0xa5, 0xa1, 0x80, 0x5d, 0x34, 0x4a, 0xaa, 0x0c, 0x17, 0xd1, 0x23,
+    0x4b, 0xd6, 0x85, 0xa7, 0xa1, 0xbf, 0x50, 0xf0, 0xff, 0x61, 0x1c, 0x82, 0x2c, 0x00, 0xfa, 0x04,
+    0x6e, 0x98, 0xba, 0xd9, 0x2a, 0x81, 0x66, 0xc3, 0xee, 0x74, 0x07, 0x66, 0x05, 0x5f, 0xf4, 0xf8,
+    0xbd, 0xb3, 0x26, 0x7c, 0x7b, 0x39, 0xfd, 0x3b, 0x79, 0xd0, 0xb6, 0x7e, 0x99, 0xc2, 0xaf, 0x7b,
+    0x83, 0xfe, 0x6c, 0x30, 0xa3, 0x08, 0xc5, 0x3e, 0xeb, 0x41, 0xd4, 0x27, 0x88, 0x59, 0xe2, 0x1a,
+    0xcd, 0x76, 0x62, 0x5b, 0xe7, 0xc7, 0x96, 0xdd, 0x3d, 0xb7, 0x3a, 0xa7, 0x55, 0xbc, 0x30, 0x08,
+    0x24, 0xbf, 0xaf, 0x46, 0x82, 0xf6, 0x19, 0xc5, 0x35, 0x4b, 0x17, 0xe2, 0x9a, 0x8a, 0x7a, 0xee,
+    0xe2, 0xc9, 0x8e, 0x8f, 0x71, 0x74, 0x06, 0xe4, 0x48, 0x0f, 0x27, 0x6e, 0x18, 0x02, 0xf5, 0x14,
+    0x9b, 0x4f, 0x60, 0x76, 0xd3, 0xb7, 0xaa, 0x5b, 0xb2, 0xad, 0xde, 0xc0, 0xea, 0x03, 0x82, 0xa7,
+    0x79, 0xf8, 0xb1, 0xc5, 0xcc, 0x0f, 0xa0, 0x13, 0x58, 0x22, 0x89, 0xd7, 0x00, 0x41, 0x4a, 0xd3,
+    0x33, 0x0b, 0x58, 0x39, 0x4c, 0x9a, 0x32, 0x14, 0x79, 0xc0, 0x3b, 0x73, 0x27, 0xe9, 0xba, 0xd4,
+    0x4d, 0x3a, 0xdf, 0x11, 0x3e, 0x1d, 0x3e, 0x25, 0xf0, 0x88, 0x3f, 0xa4, 0x53, 0xa2, 0x25, 0x70,
+    0x0e, 0xf3, 0xe1, 0xc2, 0xae, 0x94, 0xc2, 0x3e, 0xa2, 0x73, 0x83, 0x8f, 0x3e, 0x3f, 0x3f, 0xdf,
+    0xc9, 0xd9, 0x88, 0x0d, 0x06, 0xe7, 0x76, 0x0f, 0x37, 0x20, 0x25, 0x6e, 0x6f, 0x73, 0x76, 0xc4,
+    0x4b, 0x40, 0xab, 0xe3, 0x4e, 0x33, 0xff, 0x91, 0xed, 0x26, 0x5a, 0xc7, 0xee, 0x69, 0x97, 0x4f,
+    0x36, 0x19, 0x9c, 0x1d, 0xbb, 0x4d, 0xa2, 0xf5, 0x7a, 0x30, 0x3b, 0x9b, 0xb8, 0x5d, 0x00, 0x4e,
+    0x1b, 0xa1, 0x9c, 0x66, 0x68, 0x90, 0x64, 0xa3, 0x9c, 0xb3, 0x64, 0xf1, 0xd1, 0xa3, 0x30, 0x78,
+    0x3a, 0x44, 0x2f, 0xf2, 0x33, 0x7e, 0xc5, 0xc6, 0xad, 0x4b, 0x83, 0x9b, 0x42, 0xa0, 0xbf, 0x66,
+    0xe1, 0x5a, 0x61, 0xfa, 0x49, 0xb7, 0xf4, 0xaa, 0x03, 0x46, 0x6e, 0x97, 0xf5, 0xcf, 0xce, 0xbc,
+    0x81, 0x4b, 0xeb, 0xef, 0xf5, 0x4e, 0x4e, 0x9a, 0x55, 0xeb, 0xf5, 0x49, 0x7f, 0x7a, 0x7a, 0x66,
+    0x97, 0xa0, 0xcf, 0x66, 0xbb, 0x80, 0x3f, 0x9f, 0xf6, 0xdd, 0x01, 0x27, 0xef, 0x89, 0x0b, 0xbc,
+    0x6c, 0x06, 0x3f, 0xeb, 0xba, 0x5d, 0xf7, 0x38, 0x27, 0x16, 0x58, 0x86, 0x99, 0x3f, 0xff, 0x51,
+    0x9a, 0xe5, 0x6e, 0xdd, 0xee, 0x35, 0xd2, 0xec, 0x21, 0xf6, 0x7f, 0x8a, 0x03, 0xfd, 0x46, 0x68,
+    0xd3, 0xd9, 0xfc, 0x30, 0x74, 0x1f, 0x7f, 0x4a, 0x7d, 0x06, 0x2a, 0x04, 0x4d, 0x38, 0xa4, 0x56,
+    0x4d, 0x1a, 0x34, 0x6b, 0x52, 0x0d, 0xc2, 0xff, 0x9c, 0xd0, 0xe3, 0x3c, 0x60, 0xaf, 0xd1, 0xc7,
+    0x54, 0x45, 0x5f, 0x79, 0xd5, 0xa2, 0x00, 0x71, 0xb2, 0x13, 0x4a, 0xdd, 0x73, 0xda, 0x79, 0xd2,
+    0x26, 0x74, 0x42, 0xfb, 0xd1, 0x5d, 0x95, 0x1e, 0x4c, 0xdf, 0x8b, 0xdb, 0x03, 0x6c, 0x42, 0xd7,
+    0x36, 0x0b, 0xc0, 0x15, 0x10, 0x8d, 0x71, 0x0f, 0x2b, 0x14, 0x87, 0xef, 0x61, 0xc5, 0xa2, 0xbd,
+    0xb3, 0xd9, 0x19, 0x63, 0x0d, 0x56, 0xfe, 0xdf, 0x96, 0x0c, 0xb6, 0xe1, 0x9a, 0xa1, 0x6c, 0x7e,
+    0xbb, 0xe8, 0x95, 0xcd, 0x35, 0xdf, 0xd7, 0x36, 0x4b, 0x13, 0xc8, 0xcd, 0x86, 0x07, 0x95, 0x3f,
+    0x14, 0xdd, 0x6e, 0x50, 0x5a, 0x2d, 0xd5, 0x76, 0xfc, 0xd8, 0xf0, 0x26, 0x74, 0x4f, 0xd1, 0x40,
+    0x00, 0xb6, 0x7c, 0x0f, 0x9f, 0x93, 0x0c, 0xbd, 0x35, 0x0f, 0x31, 0xc0, 0x65, 0x13, 0xae, 0x16,
+    0x05, 0xd4, 0xf4, 0x73, 0x60, 0xd5, 0x55, 0xd2, 0xda, 0x11, 0x37, 0x5a, 0x3a, 0xba, 0x18, 0x2b,
+    0x57, 0x16, 0xd4, 0x0f, 0x9a, 0x05, 0x9a, 0xad, 0x66, 0x05, 0x40, 0xae, 0x03, 0xfa, 0x17, 0x47,
+    0x3c, 0x85, 0x75, 0x71, 0xc4, 0xd3, 0x68, 0x98, 0x92, 0xb9, 0x7c, 0x75, 0xe1, 0xf9, 0x8f, 0xda,
+    0x34, 0x70, 0xd3, 0xd4, 0xd1, 0x69, 0x19, 0x7a, 0xb9, 0x0d, 0x19, 0xd1, 0xd0, 0x44, 0x7b, 0xd4,
+    0x4a, 0xbb, 0xd8, 0x5a, 0xeb, 0x97, 0xef, 0xa3, 0xa9, 0x1b, 0x68, 0x3c, 0xd5, 0x86, 0x09, 0x38,
+    0x90, 0x32, 0x76, 0x71, 0x04, 0x3d, 0x31, 0x91, 0x67, 0x17, 0xc9, 0x35, 0xed, 0x37, 0xea, 0x02,
+    0x08, 0xd9, 0xf0, 0x26, 0xbe, 0x7c, 0x03, 0xc1, 0x42, 0x12, 0x05, 0x1a, 0x04, 0xa7, 0x10, 0xc5,
+    0xa6, 0x96, 0x96, 0xad, 0x42, 0xa6, 0x85, 0x2c, 0x7b, 0x8a, 0x92, 0x07, 0x2d, 0x85, 0xb0, 0x0e,
+    0xc8, 0x8b, 0xcd, 0x2c, 0xcd, 0xb4, 0xbf, 0xdc, 0xdd, 0xdc, 0x6a, 0x4b, 0x37, 0x8e, 0xa1, 0xcd,
+    0xd2, 0xdc, 0x10, 0xc4, 0x78, 0x15, 0x6a, 0xb7, 0x9f, 0xaf, 0xb5, 0x55, 0xec, 0x01, 0xd1, 0x52,
+    0xcd, 0xf3, 0x13, 0x50, 0xa3, 0xe0, 0x59, 0x9b, 0x25, 0xd1, 0x52, 0xcb, 0x16, 0x4c, 0xa2, 0x14,
+    0x85, 0xda, 0x73, 0xb4, 0x4a, 0xb4, 0xf7, 0xd7, 0x1f, 0x3b, 0x17, 0x47, 0x31, 0xcc, 0x2d, 0x90,
+    0xab, 0x2e, 0x92, 0xf6, 0xd2, 0x8d, 0xab, 0x87, 0xed, 0xa9, 0x7e, 0x79, 0x01, 0x21, 0x66, 0x58,
+    0x5b, 0xfd, 0x0d, 0x86, 0x02, 0x33, 0x17, 0xd7, 0x85, 0xef, 0xa1, 0x17, 0x45, 0xab, 0x82, 0x2a,
+    0x4f, 0x6c, 0x42, 0x39, 0x49, 0x58, 0x27, 0x32, 0x84, 0xde, 0xb4, 0x4d, 0xbf, 0x6d, 0x96, 0xeb,
+    0xbb, 0x9b, 0x0a, 0xfc, 0x23, 0x37, 0xf6, 0x8f, 0x78, 0xdc, 0x54, 0x83, 0x5c, 0xfe, 0xa5, 0xcc,
+    0x83, 0x5b, 0x5e, 0xa0, 0x6c, 0x9a, 0x82, 0xb5, 0x39, 0xc4, 0x07, 0x5c, 0xed, 0xa2, 0x77, 0x39,
+    0xe6, 0x4d, 0xc0, 0x9a, 0x5e, 0x79, 0x00, 0x4d, 0x4e, 0x2d, 0x97, 0x17, 0xb4, 0x1f, 0xbb, 0xbc,
+    0x83, 0xf6, 0x69, 0xe4, 0xc1, 0x72, 0xf9, 0xf3, 0x05, 0xed, 0x41, 0x34, 0xdf, 0x73, 0xf4, 0x18,
+    0x5e, 0xe9, 0x1a, 0xe6, 0x71, 0xf9, 0xdf, 0xc0, 0x47, 0x4f, 0xd7, 0x40, 0xa6, 0xa7, 0x6c, 0x11,
+    0x05, 0x60, 0x4d, 0x00, 0x1e, 0xfb, 0xcf, 0x15, 0xf0, 0xc9, 0xd3, 0x20, 0x38, 0xd6, 0x9e, 0x60,
+    0x0f, 0xc3, 0x34, 0x97, 0x6c, 0x5f, 0xaa, 0x1f, 0xa9, 0x84, 0x29, 0x66, 0xf3, 0x13, 0xed, 0x33,
+    0x08, 0x40, 0x3e, 0x1d, 0x97, 0x75, 0x31, 0x9f, 0x9f, 0x80, 0x27, 0xd5, 0xa9, 0xd7, 0xc5, 0x11,
+    0x7f, 0x73, 0xd9, 0xbe, 0xfa, 0xfa, 0x62, 0x14, 0xe4, 0x13, 0xb6, 0x64, 0xcb, 0x09, 0x4b, 0xee,
+    0x94, 0x45, 0x4c, 0x17, 0x6c, 0xfa, 0x00, 0x21, 0xb0, 0xae, 0x91, 0x2e, 0x89, 0xac, 0xb2, 0x34,
+    0x7f, 0x14, 0xa4, 0x26, 0x64, 0xe0, 0x40, 0x25, 0x01, 0xff, 0x4f, 0x02, 0x84, 0x16, 0x0b, 0x1a,
+    0xa1, 0xe8, 0x65, 0x0b, 0x3f, 0xd5, 0x90, 0x89, 0x29, 0x4b, 0xf2, 0x45, 0xd4, 0x17, 0x3a, 0x76,
+    0x1f, 0x81, 0x2a, 0x35, 0xe2, 0x2a, 0xab, 0x9d, 0x06, 0x60, 0xf6, 0xa9, 0x1b, 0xf6, 0xc2, 0x75,
+    0xe7, 0x8a, 0x2c, 0x77, 0x02, 0xfa, 0xe5, 0x1b, 0xec, 0xa4, 0x55, 0x81, 0xed, 0x42, 0x99, 0x01,
+    0x92, 0x46, 0x99, 0x2e, 0x61, 0xb3, 0x84, 0xa5, 0x0b, 0xa2, 0xef, 0x27, 0xfe, 0xb7, 0x36, 0x16,
+    0xe2, 0x26, 0xe0, 0x95, 0xfa, 0x83, 0x6a, 0x06, 0xcf, 0x6f, 0x66, 0x73, 0x1a, 0x80, 0x08, 0x68,
+    0x6f, 0xc8, 0xe2, 0x6d, 0xef, 0xfd, 0x89, 0x4d, 0xa2, 0x28, 0x2b, 0xc6, 0x1c, 0x68, 0xbc, 0xa5,
+    0x79, 0x54, 0x92, 0xf7, 0x6e, 0x58, 0x3a, 0x1f, 0x98, 0x1b, 0x99, 0x7c, 0xbc, 0xb2, 0x5a, 0x9a,
+    0x99, 0xc4, 0xed, 0x76, 0x95, 0x15, 0x30, 0x70, 0xeb, 0xa2, 0x95, 0xb6, 0x20, 0x08, 0xcd, 0xf5,
+    0x9e, 0x3b, 0x0d, 0xa4, 0xa2, 0xde, 0xba, 0xd4, 0x18, 0xa9, 0xdc, 0x29, 0x8e, 0x7f, 0xd6, 0x02,
+    0x52, 0xfa, 0x2c, 0xe2, 0x5c, 0xe7, 0xf6, 0xa7, 0x43, 0xec, 0xd0, 0x70, 0xc5, 0x3e, 0x98, 0x29,
+    0xee, 0x07, 0xb4, 0x27, 0x3f, 0x5b, 0x80, 0xe1, 0xd3, 0xf8, 0x92, 0xb4, 0x55, 0x18, 0x00, 0x40,
+    0xb4, 0x53, 0xda, 0x74, 0x11, 0x45, 0x29, 0x13, 0x2f, 0x3a, 0xed, 0x3c, 0x43, 0xc7, 0xa0, 0xf0,
+    0xac, 0x68, 0xd5, 0x78, 0x18, 0xa1, 0x6b, 0x60, 0x17, 0xdd, 0x43, 0x68, 0x70, 0x74, 0xf4, 0xdc,
+    0x78, 0x48, 0x72, 0x87, 0x71, 0xb6, 0x7e, 0x79, 0x2b, 0x1e, 0xeb, 0x54, 0x2e, 0xa0, 0xa8, 0xc3,
+    0xe5, 0x22, 0xc5, 0x70, 0x61, 0xb8, 0xd3, 0x5d, 0x87, 0xcf, 0x63, 0x3f, 0x12, 0x43, 0xc9, 0x8c,
+    0x8f, 0xa7, 0x44, 0xe4, 0x1f, 0x98, 0x1d, 0x28, 0x56, 0xcc, 0xdd, 0x28, 0x54, 0xcd, 0x43, 0x13,
+    0x57, 0x2e, 0xf9, 0x93, 0xfb, 0x54, 0x17, 0xdf, 0x8a, 0x68, 0x94, 0xa9, 0x24, 0x41, 0xd2, 0xde,
+    0x44, 0xd2, 0xb4, 0x6e, 0x4e, 0x85, 0x05, 0xfd, 0x28, 0xdc, 0x16, 0xe0, 0x17, 0xf2, 0x68, 0xae,
+    0x6e, 0x4c, 0xc1, 0xeb, 0x57, 0xec, 0xcf, 0x87, 0x66, 0x43, 0x0a, 0x3e, 0x10, 0xdf, 0xe8, 0x20,
+    0x04, 0xb0, 0xf5, 0x0e, 0x83, 0xe7, 0x46, 0xdb, 0x28, 0xa6, 0x02, 0x4d, 0x1f, 0x8f, 0x6f, 0x7e,
+    0x6b, 0x06, 0x33, 0x06, 0x97, 0xf6, 0x02, 0x98, 0x31, 0xf8, 0xd0, 0x9b, 0xbb, 0x96, 0xe1, 0x99,
+    0x7b, 0x13, 0xbf, 0x30, 0xfe, 0xfa, 0xae, 0x75, 0xf8, 0x75, 0xdc, 0x3c, 0xba, 0x2e, 0xcc, 0x75,
+    0xd2, 0x70, 0x46, 0xaf, 0x92, 0xad, 0xcb, 0x03, 0x0b, 0xb2, 0xc3, 0x0a, 0xdf, 0x81, 0xc6, 0x62,
+    0x00, 0xad, 0x01, 0xaa, 0xed, 0xb0, 0xae, 0xe3, 0x1d, 0x40, 0xbd, 0x77, 0x21, 0x16, 0xf9, 0xbb,
+    0x7f, 0xf8, 0xce, 0x07, 0x43, 0xe5, 0xa6, 0xc8, 0xe5, 0x26, 0x58, 0xfc, 0xdd, 0x0b, 0xb0, 0x3e,
+    0x61, 0xfc, 0xa7, 0xdd, 0x45, 0x49, 0x96, 0x36, 0x40, 0xa1, 0xe8, 0xf0, 0x0d, 0x44, 0xfc, 0xd9,
+    0xbf, 0x83, 0x48, 0x6e, 0xa1, 0x62, 0x9d, 0xa6, 0xe4, 0x2d, 0x4a, 0x2a, 0x5b, 0x92, 0xe5, 0x76,
+    0x21, 0xbe, 0xe5, 0x91, 0x98, 0x22, 0xb9, 0x39, 0x26, 0xbf, 0x92, 0xce, 0xa4, 0x39, 0xa4, 0x22,
+    0x78, 0xd5, 0x2f, 0x9b, 0x1d, 0x4a, 0x3f, 0xf7, 0x9a, 0x4a, 0x3e, 0x07, 0x1d, 0x65, 0xd9, 0xa6,
+    0x07, 0xe8, 0x40, 0xc9, 0x01, 0x7c, 0x8e, 0xe6, 0xf3, 0x80, 0x69, 0xef, 0xb1, 0xa1, 0xd9, 0xfe,
+    0xcf, 0xdc, 0xf0, 0x2e, 0x7a, 0x62, 0x89, 0xda, 0xfd, 0x1d, 0x44, 0x4b, 0xd4, 0xd8, 0xe6, 0x32,
+    0xc8, 0x75, 0x09, 0x93, 0xd5, 0xea, 0x3a, 0x82, 0xc8, 0xf5, 0xb4, 0x06, 0xbb, 0xb6, 0x4b, 0x10,
+    0xf1, 0x9b, 0xbf, 0x5c, 0x82, 0xd3, 0xff, 0xa5, 0x81, 0x89, 0x1e, 0xbd, 0xfa, 0x77, 0x37, 0x90,
+    0x11, 0x45, 0xb8, 0xc2, 0x00, 0x41, 0xc7, 0x03, 0x39, 0x47, 0xef, 0xc2, 0x6f, 0xf7, 0x9b, 0xa3,
+    0x43, 0xc4, 0xae, 0x6b, 0x8f, 0x6e, 0xb0, 0x82, 0x0e, 0xc7, 0x5d, 0xbd, 0x45, 0x86, 0x43, 0x6d,
+    0x1c, 0x33, 0xd0, 0x86, 0xa6, 0x79, 0x80, 0x30, 0x3f, 0x3d, 0x49, 0xeb, 0x12, 0x15, 0x2a, 0x42,
+    0x30, 0xce, 0x57, 0xc9, 0x3d, 0x35, 0x03, 0x37, 0x4b, 0x8f, 0xcd, 0x34, 0x87, 0xde, 0x80, 0x6e,
+    0xde, 0x35, 0x47, 0xbd, 0x4e, 0xd7, 0x66, 0xd9, 0x2d, 0xfc, 0xc5, 0x8e, 0x72, 0x4b, 0x5e, 0x85,
+    0x47, 0x89, 0x0d, 0x01, 0x6c, 0xbf, 0xc2, 0x2f, 0xec, 0xdd, 0x40, 0x43, 0x9a, 0xd5, 0x0f, 0xb7,
+    0x12, 0xb1, 0x7f, 0x9e, 0xd3, 0xd0, 0x3e, 0x69, 0x66, 0xd4, 0x7b, 0xf6, 0xc8, 0x82, 0x1c, 0x3c,
+    0x4f, 0xca, 0xe7, 0xf0, 0xe9, 0x25, 0x28, 0x4c, 0x14, 0xa3, 0x87, 0xc8, 0x41, 0x81, 0x47, 0xfe,
+    0xa8, 0x19, 0xb6, 0x79, 0x71, 0xc4, 0x5f, 0x54, 0x3b, 0x74, 0xa1, 0xc3, 0xbb, 0x77, 0x9a, 0xd1,
+    0x55, 0x7a, 0x1c, 0x71, 0xd0, 0x8d, 0x16, 0x19, 0x83, 0xab, 0xa6, 0x10, 0x12, 0x51, 0x00, 0x8e,
+    0xe4, 0x9c, 0xe1, 0x94, 0x78, 0x31, 0x3a, 0x14, 0x21, 0xcf, 0x67, 0xd8, 0x9f, 0x46, 0x09, 0x28,
+    0x0c, 0xdf, 0x91, 0xa1, 0x31, 0xea, 0x68, 0xbf, 0x45, 0x10, 0xd3, 0x84, 0x10, 0xc1, 0x4c, 0x17,
+    0x6e, 0x38, 0x67, 0x5a, 0x4a, 0xa1, 0x27, 0x59, 0x07, 0xb9, 0x5d, 0xeb, 0x6c, 0xdf, 0x8f, 0xa8,
+    0x3c, 0xcc, 0x23, 0x83, 0x06, 0x36, 0x56, 0x03, 0xd4, 0x14, 0xfa, 0x82, 0x7f, 0x4a, 0xc4, 0x72,
+    0xf0, 0x2f, 0x1a, 0x0f, 0x84, 0xec, 0x1c, 0xa7, 0x66, 0x8b, 0x68, 0x42, 0x87, 0x3b, 0x77, 0x95,
+    0xb2, 0x16, 0x4b, 0x40, 0xef, 0xda, 0x87, 0xa2, 0x85, 0xf0, 0xc3, 0x55, 0xdb, 0x68, 0xf9, 0xba,
+    0x1d, 0xc0, 0x18, 0x8c, 0x60, 0xcb, 0x60, 0x7c, 0xf5, 0x92, 0xe5, 0xd9, 0xd1, 0xa6, 0xe2, 0x4c,
+    0xa8, 0x0e, 0xb7, 0x5c, 0x09, 0xf1, 0x4f, 0x0d, 0x24, 0xec, 0xcd, 0x2a, 0xa1, 0x5a, 0x86, 0x12,
+    0xdb, 0x9b, 0x07, 0xce, 0x66, 0xca, 0x48, 0x10, 0xbd, 0xdd, 0x86, 0x7e, 0x64, 0xdf, 0xda, 0xa2,
+    0x73, 0x7c, 0x55, 0x1d, 0xfd, 0xc3, 0x4b, 0x54, 0xa3, 0x16, 0xe2, 0xf7, 0x3b, 0xdc, 0xea, 0xb7,
+    0xe8, 0x73, 0x2e, 0x1f, 0x6d, 0x4a, 0xdd, 0x93, 0x4a, 0xdd, 0x7f, 0x51, 0xa9, 0xe5, 0xf2, 0x49,
+    0xbe, 0xb6, 0xcc, 0x27, 0xfa, 0xd1, 0x8c, 0xdb, 0x83, 0x2e, 0x04, 0x84, 0xf1, 0x28, 0x6b, 0xc7,
+    0x3c, 0x53, 0x02, 0x40, 0x89, 0x60, 0x0a, 0xd4, 0x88, 0x99, 0xb7, 0xd5, 0x7c, 0xcb, 0x1d, 0x0a,
+    0x40, 0x49, 0x49, 0x4b, 0x41, 0x29, 0x67, 0x4c, 0xe4, 0x60, 0x78, 0xb2, 0x85, 0xd6, 0x90, 0x76,
+    0xb4, 0xdf, 0x61, 0xa3, 0x41, 0x22, 0xaf, 0xf9, 0x21, 0x6c, 0x60, 0x42, 0x4c, 0x9f, 0x3c, 0x2d,
+    0x58, 0x28, 0x14, 0x78, 0x1a, 0xf8, 0xd3, 0x07, 0x99, 0x81, 0xb9, 0xfd, 0x78, 0x04, 0x92, 0x60,
+    0x61, 0x66, 0x25, 0xd4, 0xa4, 0xa4, 0x77, 0x5e, 0x8c, 0x42, 0xf2, 0xd0, 0x7d, 0x47, 0x5b, 0x2e,
+    0x03, 0xfc, 0xaa, 0x05, 0x10, 0xb9, 0xae, 0x8a, 0xa4, 0x43, 0xeb, 0x07, 0x16, 0xae, 0xfe, 0xc2,
+    0xc0, 0x6a, 0xb8, 0xc5, 0x1c, 0x32, 0x5a, 0x17, 0xed, 0xcd, 0x12, 0x2b, 0xc6, 0x8a, 0xc8, 0x5d,
+    0x97, 0x21, 0xfc, 0xd6, 0xce, 0x14, 0xb3, 0xa5, 0x3a, 0x8f, 0xdd, 0xd2, 0xad, 0x5d, 0x6f, 0x33,
+    0x17, 0xcc, 0xf6, 0xe7, 0xeb, 0xf6, 0xfd, 0x06, 0x74, 0x1c, 0xf3, 0xbd, 0x42, 0x15, 0x7f, 0x25,
+    0x29, 0xdc, 0xbc, 0xf3, 0x68, 0x70, 0x6b, 0x7c, 0xe3, 0xab, 0x7d, 0x74, 0x97, 0x4d, 0x32, 0x05,
+    0x10, 0xf1, 0x4d, 0x25, 0x1d, 0x73, 0x36, 0x99, 0x1c, 0xb2, 0x34, 0xee, 0xf7, 0x9a, 0xc5, 0x5e,
+    0x80, 0x6c, 0x8c, 0x98, 0x01, 0x20, 0x7f, 0x7d, 0xe3, 0xfd, 0x14, 0xd0, 0xcf, 0xa0, 0x90, 0xcd,
+    0x60, 0xf1, 0x4d, 0x2d, 0x6d, 0x04, 0xe4, 0xbe, 0x4f, 0x61, 0xd3, 0x3c, 0x5d, 0xec, 0x12, 0xba,
+    0x28, 0xd3, 0x7d, 0x64, 0x4f, 0x22, 0x27, 0xa0, 0x6d, 0x49, 0x5d, 0x21, 0x79, 0x70, 0xe3, 0xd7,
+    0x90, 0xc0, 0x3a, 0x6a, 0x75, 0xb1, 0x5a, 0x2e, 0x5e, 0x0d, 0xd9, 0x9a, 0xd9, 0x9c, 0xfa, 0x88,
+    0x2e, 0x64, 0x4d, 0x2b, 0x83, 0x9a, 0xfd, 0x6e, 0xab, 0x8c, 0x48, 0x39, 0x6d, 0x90, 0x11, 0xfd,
+    0x25, 0x22, 0xf0, 0x1d, 0x4b, 0xcb, 0xde, 0x07, 0x00, 0xfd, 0xdd, 0x9f, 0xf9, 0xb4, 0xfb, 0x69,
+    0x5c, 0x2c, 0x1f, 0x7d, 0x27, 0x08, 0xd2, 0x0e, 0xe1, 0x05, 0xf2, 0xed, 0xc2, 0xad, 0x1d, 0xb6,
+    0x6a, 0x44, 0xd9, 0x76, 0x64, 0x55, 0x08, 0xdb, 0x51, 0xbe, 0x8e, 0xff, 0x09, 0x08, 0xa3, 0x05,
+    0x45, 0x5b, 0xed, 0x4f, 0xd5, 0x5d, 0xb0, 0x12, 0xf6, 0x21, 0x03, 0xe9, 0x3d, 0xf4, 0xd4, 0x1b,
+    0x02, 0xbb, 0x8f, 0x91, 0x66, 0xfc, 0xf6, 0xd7, 0x37, 0x77, 0xad, 0xc1, 0x1f, 0x44, 0x87, 0xff,
+    0x60, 0xe9, 0x4e, 0x81, 0x5f, 0x1d, 0x91, 0xd2, 0x82, 0xf9, 0x6b, 0xdc, 0x92, 0x97, 0x94, 0xcb,
+    0x3e, 0xef, 0x75, 0xec, 0x93, 0xb3, 0x0e, 0x84, 0x4d, 0x2d, 0x9b, 0x8f, 0xbf, 0x80, 0x2f, 0x7a,
+    0x72, 0x9f, 0x9b, 0xa1, 0x8a, 0x97, 0xad, 0x40, 0xed, 0x1f, 0xa4, 0xe8, 0x78, 0x35, 0x81, 0x1d,
+    0xb4, 0xf6, 0xc1, 0x4d, 0x1f, 0x9a, 0x27, 0xc4, 0x37, 0x95, 0xd9, 0x7a, 0xc7, 0xc7, 0x1d, 0xf9,
+    0xaf, 0xbb, 0x4d, 0x63, 0x73, 0x1b, 0xdf, 0xae, 0xb1, 0xa2, 0x8b, 0xa2, 0xb1, 0x55, 0xc7, 0xf0,
+    0xb2, 0xeb, 0x25, 0x43, 0x05, 0xa1, 0x2f, 0xa6, 0x02, 0x97, 0x6e, 0xb8, 0xc2, 0x93, 0x00, 0x3f,
+    0x08, 0xb4, 0x18, 0xb6, 0xa3, 0xf8, 0x1b, 0x4f, 0x27, 0xa6, 0x32, 0xa6, 0xa0, 0xfc, 0x8b, 0xa5,
+    0xcd, 0x39, 0x1d, 0xe9, 0x6c, 0x23, 0xe5, 0x34, 0x20, 0x57, 0xec, 0x3e, 0xba, 0x3e, 0x60, 0x1b,
+    0xb0, 0xce, 0x8b, 0x26, 0x42, 0x78, 0xa7, 0x9f, 0xb1, 0x10, 0x45, 0x32, 0x42, 0xa3, 0xa4, 0x03,
+    0x44, 0xd1, 0x87, 0x67, 0x66, 0x33, 0x03, 0x3e, 0xe5, 0xa9, 0x89, 0xc6, 0xb8, 0xca, 0x16, 0x71,
+    0xd5, 0x59, 0x1e, 0x56, 0x0d, 0xb6, 0xb1, 0xa4, 0x98, 0xb3, 0x85, 0x2b, 0xc5, 0x74, 0x34, 0xa0,
+    0x29, 0xba, 0xfc, 0x9d, 0xce, 0x80, 0x34, 0xbe, 0x88, 0x4f, 0xd1, 0x53, 0xba, 0x8d, 0x57, 0x4a,
+    0x76, 0x05, 0x43, 0x0d, 0xec, 0x5e, 0x49, 0x6b, 0x28, 0x67, 0x75, 0xad, 0xd1, 0x68, 0x8b, 0x2c,
+    0xef, 0x14, 0xbc, 0x52, 0xbe, 0xe2, 0x30, 0xaa, 0x46, 0x80, 0x65, 0xab, 0xf1, 0x09, 0x82, 0xae,
+    0x28, 0x61, 0x22, 0x27, 0xd3, 0x64, 0x3a, 0xae, 0x41, 0x92, 0x20, 0x52, 0xdf, 0x62, 0x38, 0x04,
+    0x0c, 0x8d, 0xd2, 0x56, 0x62, 0xb2, 0x1d, 0xed, 0x08, 0xe3, 0x69, 0xeb, 0xdf, 0x88, 0xa4, 0xc6,
+    0x32, 0x35, 0xdb, 0x6d, 0x0a, 0xc3, 0x9e, 0xd4, 0xb1, 0x39, 0xce, 0x3e, 0x96, 0xdb, 0xe7, 0x93,
+    0x2e, 0xfe, 0x0f, 0x69, 0xc4, 0x62, 0xd1, 0x2e, 0x70, 0xed, 0x63, 0xfb, 0x4b, 0x76, 0x62, 0x27,
+    0xda, 0x72, 0xa1, 0xe2, 0x92, 0x00, 0x7b, 0xdc, 0x55, 0xbc, 0x4d, 0xd7, 0xb9, 0xc2, 0x28, 0xaa,
+    0x5e, 0x89, 0xeb, 0x4a, 0xb4, 0xd9, 0xd1, 0x4f, 0x63, 0xdc, 0xf7, 0x33, 0x1a, 0x88, 0x67, 0x99,
+    0x7f, 0x63, 0x2d, 0x46, 0x16, 0x80, 0xc2, 0xbb, 0x1f, 0x89, 0x4d, 0xaa, 0xe0, 0x1a, 0x56, 0x0f,
+    0x40, 0x95, 0xa5, 0xab, 0xa1, 0xea, 0x0b, 0x3b, 0xf6, 0x06, 0x46, 0x60, 0xa5, 0x85, 0xcc, 0x22,
+    0xc2, 0xcc, 0x06, 0x3f, 0xfe, 0x7c, 0xe7, 0x07, 0x4c, 0xfb, 0x3d, 0xc6, 0xec, 0x9a, 0xb9, 0xcb,
+    0xe1, 0xe2, 0x3b, 0x3f, 0x59, 0x3e, 0xb9, 0x20, 0xb0, 0x9d, 0x89, 0xdf, 0x94, 0x5a, 0x8d, 0x32,
+    0x17, 0x41, 0x4a, 0x3a, 0xcc, 0xe8, 0x6f, 0x77, 0x3a, 0x65, 0x71, 0xe6, 0xe8, 0x38, 0xc6, 0xa2,
+    0x63, 0x96, 0xa9, 0x8b, 0x14, 0x3f, 0x8a, 0xa6, 0x19, 0xcb, 0xb0, 0x7a, 0x90, 0xb9, 0xcb, 0x66,
+    0x52, 0x71, 0xd4, 0x94, 0x53, 0xa7, 0x3a, 0xb1, 0x60, 0x4a, 0xde, 0x8b, 0x48, 0x25, 0x06, 0xe0,
+    0x12, 0x11, 0x91, 0xdd, 0x5d, 0x02, 0x1f, 0x98, 0x6a, 0x33, 0xb9, 0xc2, 0xfc, 0xb8, 0xba, 0x7c,
+    0x5a, 0xc4, 0x8f, 0xb6, 0x09, 0x1b, 0xb1, 0x79, 0x73, 0x67, 0x58, 0x7e, 0x98, 0xae, 0x60, 0x95,
+    0x69, 0x3a, 0x5b, 0x05, 0x34, 0x39, 0x1d, 0x9d, 0x76, 0x76, 0xca, 0x04, 0xe7, 0x67, 0x20, 0x2f,
+    0x6f, 0xc0, 0xe8, 0x28, 0x58, 0x1c, 0x92, 0xc0, 0x9f, 0x17, 0xe0, 0xae, 0xf8, 0x86, 0x94, 0xda,
+    0xf0, 0xcc, 0xec, 0xf2, 0x3d, 0xac, 0x02, 0x73, 0x3a, 0x1d, 0x3c, 0x4a, 0x4f, 0xd8, 0x65, 0x6b,
+    0x52, 0x07, 0x61, 0xbd, 0x8f, 0xe6, 0x65, 0x40, 0x41, 0x34, 0x27, 0x28, 0xe5, 0xb1, 0xe2, 0x57,
+    0x3a, 0x4d, 0xfc, 0x38, 0xbb, 0x7c, 0x85, 0x25, 0x04, 0x99, 0xf6, 0x2f, 0x0e, 0x0c, 0xb8, 0xf4,
+    0xa2, 0xe9, 0x6a, 0x09, 0x5e, 0xb2, 0x33, 0x67, 0xd9, 0xdb, 0x80, 0xe1, 0x9f, 0xbf, 0x3e, 0xdf,
+    0x78, 0x86, 0xef, 0x99, 0x23, 0xd1, 0xf1, 0xc3, 0xf5, 0x7f, 0xdc, 0x7f, 0x7a, 0xfb, 0xfe, 0xfa,
+    0x1f, 0x63, 0xe7, 0x4c, 0xb6, 0x8d, 0xaf, 0xdf, 0xbd, 0xbd, 0xc7, 0x3d, 0xae, 0xf3, 0x47, 0xcf,
+    0x1a, 0x58, 0xc7, 0x96, 0xdd, 0xb3, 0xec, 0xbe, 0x65, 0x0f, 0x2c, 0x1b, 0xfe, 0x3e, 0xb1, 0xec,
+    0x53, 0xcb, 0x3e, 0xb3, 0xec, 0x73, 0xab, 0x67, 0x5b, 0xbd, 0x9e, 0xd5, 0xeb, 0x5b, 0xbd, 0x63,
+    0x2c, 0xc4, 0xee, 0x9d, 0x5a, 0xfd, 0x9e, 0xd5, 0xef, 0x7f, 0x95, 0x80, 0xee, 0xae, 0xc7, 0xe3,
+    0xfb, 0xf7, 0xb7, 0x6f, 0xae, 0xdf, 0xdf, 0xff, 0xed, 0xed, 0x3f, 0x68, 0x6f, 0x73, 0xcf, 0x19,
+    0x75, 0x2f, 0x0f, 0x79, 0xef, 0x1f, 0x6d, 0xbd, 0xd4, 0x7d, 0xfc, 0x16, 0x22, 0xd7, 0xdb, 0x8f,
+    0xed, 0x03, 0xc4, 0x01, 0xbc, 0x3a, 0xf0, 0xf3, 0xed, 0xdf, 0xde, 0x7e, 0x6c, 0x1d, 0x99, 0x45,
+    0x0f, 0x2c, 0x6c, 0x1a, 0x06, 0xb1, 0xc3, 0xe7, 0xdf, 0xc7, 0xf7, 0x77, 0xb7, 0xef, 0xdf, 0xdf,
+    0x7f, 0x18, 0x3b, 0xc7, 0x60, 0x45, 0x2b, 0xaf, 0xc6, 0xef, 0x6f, 0xff, 0x9e, 0xbf, 0x47, 0x2b,
+    0x9b, 0x77, 0xb8, 0xbe, 0xbb, 0xb9, 0xff, 0x7c, 0xf3, 0xe1, 0xed, 0xed, 0xef, 0x9f, 0x8b, 0xb1,
+    0x01, 0x44, 0x1d, 0x63, 0x67, 0xbd, 0xe1, 0x7f, 0x89, 0x43, 0x84, 0x5f, 0x57, 0xe9, 0xb3, 0x33,
+    0x73, 0x03, 0x7e, 0x5d, 0x42, 0x9c, 0x60, 0x36, 0x36, 0xfe, 0xe6, 0x27, 0x59, 0xbd, 0xf5, 0xaf,
+    0xcf, 0x1e, 0x96, 0xba, 0x7a, 0xca, 0x0b, 0x90, 0x94, 0x8c, 0xfb, 0x75, 0xb0, 0x9b, 0xfe, 0xdc,
+    0xd1, 0x75, 0x3e, 0x63, 0xca, 0x13, 0x80, 0xce, 0x3a, 0x59, 0x85, 0x21, 0x56, 0xd7, 0xd0, 0x10,
+    0x2b, 0xc6, 0x1c, 0x85, 0x27, 0x1f, 0xfc, 0x30, 0x1d, 0xfe, 0xf1, 0xd5, 0xf2, 0xbd, 0x6f, 0xc3,
+    0xae, 0x35, 0xcd, 0x53, 0x2e, 0xc3, 0x70, 0x15, 0x04, 0x56, 0xe6, 0x2f, 0x59, 0x42, 0x7f, 0x6e,
+    0xe4, 0x4a, 0x41, 0xea, 0x9c, 0xa5, 0x73, 0xb9, 0x16, 0x4f, 0x7e, 0xc8, 0x1c, 0x23, 0xc4, 0x6d,
+    0x21, 0xd6, 0xdf, 0x9a, 0x9d, 0x2c, 0xba, 0x19, 0xdf, 0x8e, 0xb3, 0x04, 0xa6, 0x33, 0xcc, 0x03,
+    0x5d, 0xd3, 0x0f, 0x96, 0xe6, 0xe8, 0x5f, 0x0c, 0x29, 0xac, 0xd0, 0x81, 0x7d, 0xcb, 0xde, 0x88,
+    0x8b, 0x65, 0x06, 0x0e, 0x3f, 0xd0, 0xbf, 0x84, 0xfa, 0x41, 0x4b, 0x17, 0xb3, 0x93, 0x82, 0x05,
+    0x62, 0x46, 0xd7, 0x42, 0x77, 0x47, 0x90, 0x8a, 0x33, 0xe7, 0x32, 0x30, 0x84, 0x35, 0x02, 0x34,
+    0x67, 0xab, 0x90, 0xef, 0xf5, 0xd1, 0x46, 0xe0, 0xa6, 0x04, 0xf3, 0x5a, 0x63, 0xf0, 0xdc, 0xee,
+    0x1c, 0x10, 0x5c, 0x23, 0x61, 0x62, 0x24, 0x51, 0x96, 0x3c, 0xaf, 0x63, 0x47, 0xc8, 0x81, 0x78,
+    0x8f, 0x9a, 0x71, 0x93, 0xb1, 0xa5, 0x51, 0x95, 0x3d, 0xf3, 0xfb, 0x77, 0x18, 0xb2, 0x01, 0x5b,
+    0x38, 0x5d, 0x18, 0xf7, 0xe6, 0x7a, 0xe3, 0xcf, 0x8c, 0xbd, 0xd8, 0x5c, 0x73, 0x20, 0x74, 0x52,
+    0xdd, 0x08, 0x22, 0x97, 0xf6, 0x1a, 0x00, 0x84, 0x00, 0x00, 0x60, 0x41, 0x54, 0xe9, 0x61, 0x76,
+    0xb8, 0xf3, 0x8e, 0x47, 0x1b, 0x84, 0x09, 0xcd, 0xa5, 0x1a, 0x0a, 0xb3, 0x43, 0xe5, 0x13, 0xc0,
+    0xf6, 0xbd, 0xbd, 0x5d, 0x66, 0x53, 0x66, 0x6a, 0x07, 0xc5, 0x25, 0x68, 0xb3, 0x29, 0x48, 0x86,
+    0x09, 0x67, 0xec, 0xf4, 0x39, 0x2a, 0x08, 0xc6, 0x19, 0x1d, 0x3b, 0x15, 0x4c, 0x69, 0x3d, 0x88,
+    0x2a, 0x5f, 0x47, 0x85, 0x8e, 0x69, 0x0b, 0x1d, 0xad, 0x18, 0x50, 0x63, 0x30, 0x6d, 0x75, 0x00,
+    0xa0, 0x18, 0x3d, 0xb2, 0x66, 0xda, 0x03, 0x8a, 0x05, 0xdd, 0xc4, 0x94, 0xad, 0xab, 0xda, 0xdf,
+    0x07, 0x6c, 0x4a, 0x24, 0x4a, 0x1b, 0x49, 0x54, 0x60, 0x52, 0xea, 0x5c, 0xc5, 0x43, 0x25, 0xa9,
+    0xca, 0x3d, 0xa1, 0x0d, 0x48, 0x11, 0xc7, 0x30, 0x73, 0x7d, 0x68, 0x26, 0x53, 0x03, 0x59, 0x47,
+    0x09, 0x84, 0x53, 0x49, 0xa8, 0xc5, 0xa3, 0x5c, 0xb3, 0x80, 0x95, 0x9f, 0xd1, 0x36, 0x71, 0x78,
+    0xb8, 0x4e, 0xd1, 0xa7, 0x45, 0x46, 0x6b, 0x66, 0xae, 0x2a, 0x63, 0x62, 0x38, 0xb6, 0xa9, 0x7a,
+    0x91, 0x8a, 0x79, 0x8c, 0x8c, 0xcb, 0x2f, 0x50, 0x33, 0x6b, 0x65, 0x60, 0x6d, 0x12, 0x2b, 0x7b,
+    0x99, 0x83, 0x75, 0xcc, 0x2a, 0xc4, 0xcb, 0x71, 0x11, 0x25, 0x4c, 0x48, 0x1c, 0x45, 0xd4, 0x62,
+    0x7a, 0x1c, 0x09, 0x1d, 0x03, 0xbb, 0x60, 0xe8, 0x54, 0x24, 0x5e, 0xd4, 0x02, 0x81, 0xe7, 0x4f,
+    0xc1, 0x00, 0x8c, 0xb2, 0x05, 0xc4, 0x3d, 0x1a, 0xda, 0x9f, 0xb7, 0x49, 0x12, 0x25, 0x9c, 0xf6,
+    0xd4, 0x43, 0x16, 0x47, 0x41, 0xa7, 0x4d, 0x41, 0xeb, 0x32, 0x15, 0xdc, 0x89, 0x81, 0x77, 0x5e,
+    0xcd, 0x75, 0xee, 0x19, 0xff, 0x73, 0xc5, 0x92, 0xe7, 0x31, 0xc5, 0xf2, 0x51, 0x02, 0x5b, 0x02,
+    0x43, 0xe7, 0xe5, 0xd4, 0xc0, 0xce, 0x59, 0x94, 0xbc, 0x75, 0x61, 0x05, 0xb1, 0x73, 0x19, 0x77,
+    0xc8, 0x3b, 0xbf, 0xf7, 0xd3, 0x4c, 0x2c, 0xdb, 0x90, 0x59, 0x52, 0xd3, 0x1c, 0x6d, 0x03, 0x86,
+    0x25, 0x15, 0x05, 0xa8, 0xcc, 0xb9, 0xcc, 0xb6, 0x82, 0x2a, 0x84, 0x8a, 0xf0, 0x1c, 0x91, 0xae,
+    0xa9, 0xb3, 0xbb, 0x9e, 0x57, 0xf4, 0xff, 0xb1, 0x99, 0x89, 0xef, 0x28, 0x4c, 0xd7, 0x19, 0x98,
+    0x6b, 0x08, 0xbd, 0x60, 0x66, 0x59, 0xec, 0xa1, 0x9b, 0x8e, 0xe3, 0xd0, 0x94, 0x59, 0xeb, 0x64,
+    0x1b, 0xb3, 0x42, 0x4e, 0xbe, 0x03, 0x14, 0x81, 0xbb, 0x20, 0xec, 0x1f, 0xba, 0xcc, 0xc6, 0x5a,
+    0xba, 0xcc, 0xb9, 0x59, 0xba, 0xd8, 0x5a, 0x5b, 0x3a, 0x86, 0xf7, 0x5f, 0x73, 0xa4, 0x1e, 0x72,
+    0x35, 0x9a, 0x64, 0x21, 0x2a, 0x92, 0x48, 0xfe, 0xea, 0x07, 0x0f, 0x92, 0x14, 0x10, 0xff, 0x8b,
+    0x17, 0x62, 0x1e, 0x7a, 0x07, 0x2b, 0x81, 0x11, 0x26, 0xfc, 0x53, 0xb0, 0xcd, 0xe8, 0x48, 0x3b,
+    0x47, 0xd8, 0x7a, 0x80, 0x96, 0xf7, 0xb8, 0x57, 0x7c, 0xe3, 0xa6, 0xa0, 0x80, 0x72, 0x81, 0x38,
+    0x18, 0xa0, 0x9a, 0xf0, 0xef, 0x27, 0x06, 0x13, 0x11, 0x7e, 0x90, 0xe1, 0x51, 0x48, 0x47, 0x01,
+    0xa4, 0xe6, 0x42, 0x0a, 0xdb, 0xf9, 0x00, 0x42, 0xf0, 0xca, 0x4d, 0x9f, 0xc3, 0xa9, 0x96, 0x93,
+    0xda, 0x8d, 0x7d, 0x23, 0x76, 0xb3, 0x05, 0x38, 0xf2, 0x67, 0xf4, 0x71, 0xe4, 0xa5, 0xa3, 0x55,
+    0xf6, 0x21, 0x35, 0xd7, 0xc2, 0x94, 0x64, 0x4b, 0xc7, 0xf8, 0x48, 0xdb, 0xc6, 0x8e, 0x9f, 0xbe,
+    0xc3, 0xbb, 0xda, 0xcc, 0x28, 0x7a, 0xed, 0xef, 0xe7, 0x7f, 0x5f, 0x76, 0xcd, 0xab, 0xfc, 0x61,
+    0x58, 0x8e, 0x62, 0xa4, 0x5d, 0x82, 0xc0, 0xda, 0x41, 0x0d, 0xbb, 0x9e, 0x44, 0x49, 0x26, 0x8e,
+    0xf5, 0x03, 0x96, 0x18, 0x92, 0x27, 0x14, 0x24, 0x38, 0xb8, 0x12, 0x0e, 0xc8, 0xc0, 0x85, 0xc1,
+    0xa0, 0x8e, 0x8b, 0x03, 0x0c, 0xd3, 0xca, 0x96, 0x79, 0x7c, 0x09, 0xc1, 0x97, 0x23, 0xd0, 0x06,
+    0x43, 0x0d, 0x8b, 0xd8, 0x73, 0x1c, 0x9d, 0xaa, 0x2f, 0xb1, 0xfe, 0x50, 0xbf, 0x92, 0x36, 0xd0,
+    0x30, 0x87, 0x7a, 0x1e, 0x98, 0x2d, 0x9c, 0xb5, 0x2e, 0xbc, 0xfc, 0x21, 0xe5, 0xb3, 0x87, 0xba,
+    0xba, 0x33, 0xf9, 0x13, 0xab, 0x43, 0x36, 0xc8, 0x47, 0x80, 0x6e, 0x2e, 0x3a, 0xd7, 0xab, 0x6c,
+    0x11, 0x25, 0xfe, 0x7f, 0xd1, 0x5b, 0x47, 0xff, 0x95, 0xc1, 0x0e, 0x21, 0x81, 0x40, 0x04, 0xde,
+    0x4a, 0x88, 0x91, 0x44, 0xe2, 0x6a, 0xbd, 0x64, 0xd0, 0xdb, 0x1b, 0xea, 0x77, 0xb7, 0xe3, 0xcf,
+    0xba, 0x85, 0xe5, 0xbd, 0x2c, 0x49, 0x87, 0x0b, 0x0b, 0x4b, 0x7c, 0x87, 0xff, 0x67, 0x7c, 0xfb,
+    0xb1, 0x93, 0x52, 0x34, 0xe3, 0xcf, 0x9e, 0x0d, 0x31, 0xc8, 0xb4, 0x52, 0x7f, 0x1e, 0xba, 0xc1,
+    0x10, 0x17, 0xc9, 0xff, 0xdc, 0x0c, 0xd7, 0xf5, 0x36, 0x1e, 0x85, 0x25, 0x14, 0xa3, 0x65, 0x18,
+    0x72, 0xe0, 0x1f, 0x7f, 0x52, 0x40, 0x48, 0xd6, 0xdd, 0x71, 0x9f, 0x5c, 0x3f, 0xd3, 0x66, 0x0c,
+    0x0d, 0x23, 0x71, 0x34, 0x02, 0x8b, 0x26, 0x5a, 0x13, 0x0a, 0x6e, 0x0c, 0x93, 0x7c, 0xec, 0x9f,
+    0x4e, 0x76, 0x45, 0xb8, 0xc4, 0x78, 0x73, 0x1f, 0xcc, 0xf5, 0x70, 0xad, 0x18, 0x54, 0x00, 0x09,
+    0xfb, 0x92, 0x61, 0xb6, 0x91, 0x6d, 0xa0, 0x78, 0x40, 0x0d, 0xb6, 0xbf, 0xcf, 0x3a, 0x74, 0xa7,
+    0x1f, 0x68, 0x4c, 0xcc, 0x23, 0x1b, 0xa9, 0x83, 0xd5, 0xaf, 0x5a, 0xcd, 0x4f, 0x60, 0x2c, 0x99,
+    0x60, 0x25, 0x16, 0xd2, 0x61, 0x41, 0xa9, 0x7e, 0x80, 0x28, 0x81, 0x7c, 0xf3, 0xde, 0x10, 0x28,
+    0xcc, 0x7c, 0x58, 0x55, 0xf0, 0xbc, 0xa6, 0xe2, 0x49, 0xc9, 0x6c, 0xe2, 0x3e, 0x6a, 0x01, 0xcc,
+    0x98, 0x88, 0xbb, 0x47, 0x30, 0xe1, 0xa0, 0x6b, 0x83, 0x98, 0x01, 0x3f, 0xd6, 0xb9, 0xbb, 0xd1,
+    0xf5, 0xdc, 0xeb, 0x6d, 0x11, 0x61, 0x0e, 0x69, 0x2f, 0xe9, 0xe0, 0xd8, 0x2a, 0xa2, 0xc6, 0x9f,
+    0xfb, 0xfb, 0x7f, 0x76, 0x3c, 0x96, 0xb9, 0x7e, 0x00, 0xde, 0x2e, 0xfb, 0xfe, 0xdd, 0xd0, 0xff,
+    0xfa, 0xf9, 0xf3, 0x1d, 0x20, 0x2b, 0xe7, 0x36, 0x0b, 0x7b, 0xff, 0xa7, 0x6a, 0xa0, 0x60, 0x7b,
+    0xfd, 0xf0, 0xa6, 0x88, 0xab, 0xb9, 0xb7, 0xc9, 0xa3, 0xec, 0x2c, 0x59, 0x31, 0xb5, 0x37, 0xec,
+    0x7e, 0x3d, 0xde, 0xfb, 0x06, 0xf7, 0xcb, 0xe8, 0x9c, 0xb6, 0x68, 0xf9, 0x6b, 0xe5, 0x68, 0x4e,
+    0xe3, 0x17, 0x1f, 0x4b, 0x4d, 0xe2, 0x16, 0x64, 0xa9, 0x4d, 0x5e, 0x2a, 0x54, 0xac, 0x03, 0x0b,
+    0xb8, 0x55, 0x66, 0x41, 0x07, 0x0d, 0x00, 0x10, 0x0e, 0x38, 0x98, 0xff, 0x8d, 0x05, 0xea, 0xbf,
+    0xe2, 0xa5, 0x05, 0x64, 0xa7, 0xad, 0x9b, 0x7c, 0x91, 0x23, 0xbc, 0xea, 0xe3, 0x79, 0x6f, 0x1f,
+    0x01, 0x33, 0xb4, 0x5c, 0x68, 0x6d, 0x0d, 0x9d, 0x70, 0xd0, 0xad, 0xca, 0x9a, 0xcd, 0xe6, 0xce,
+    0xbc, 0xd8, 0xa0, 0xa1, 0x77, 0x09, 0x15, 0xb3, 0x09, 0x13, 0xc0, 0xa3, 0xe2, 0x07, 0x92, 0x62,
+    0x1f, 0x62, 0xa4, 0x79, 0x08, 0x52, 0xd1, 0x23, 0x20, 0xfd, 0x2a, 0xcc, 0x86, 0xe9, 0xfe, 0x7e,
+    0xca, 0x0b, 0xf7, 0xef, 0xa9, 0xe1, 0xfb, 0xf7, 0xae, 0x85, 0x55, 0x15, 0x43, 0x43, 0x79, 0x83,
+    0x0d, 0xc0, 0x6a, 0xd8, 0xa2, 0xa0, 0x28, 0xa7, 0xa5, 0x77, 0xd4, 0x42, 0x2f, 0xcb, 0x48, 0x4c,
+    0x56, 0x7e, 0xe0, 0x7d, 0x2a, 0x67, 0x25, 0xf3, 0xf0, 0x62, 0xea, 0x7c, 0x00, 0xc9, 0xeb, 0x2c,
+    0xfd, 0xd0, 0x28, 0x76, 0xbb, 0x16, 0x6f, 0xc3, 0x0b, 0x36, 0x16, 0xe9, 0xd8, 0x4d, 0x98, 0x19,
+    0xdc, 0xd1, 0x28, 0x09, 0xda, 0x22, 0xa6, 0x1b, 0xe8, 0x96, 0xdd, 0x35, 0x73, 0x0f, 0x9d, 0xcc,
+    0x9d, 0xeb, 0x24, 0x71, 0x9f, 0xc1, 0xda, 0xd2, 0x6f, 0x63, 0xac, 0x62, 0x7f, 0xa5, 0x3e, 0xc1,
+    0x66, 0x4b, 0x0e, 0x0a, 0x5b, 0x06, 0xf1, 0x65, 0x5d, 0x95, 0x1e, 0x8b, 0x61, 0xa0, 0x26, 0x8e,
+    0x31, 0xde, 0xdf, 0x1f, 0x77, 0x44, 0xad, 0x3f, 0xf6, 0x14, 0x7f, 0x82, 0x59, 0x20, 0x23, 0xb3,
+    0x40, 0x6b, 0x03, 0x62, 0x65, 0xe0, 0x83, 0xef, 0x74, 0x47, 0xfe, 0xc5, 0x74, 0xe4, 0x1f, 0x1c,
+    0x48, 0x1a, 0xc0, 0x6e, 0xcf, 0xf1, 0x0f, 0x6c, 0x89, 0x08, 0x4e, 0xf3, 0x37, 0xf6, 0x2c, 0x32,
+    0xb6, 0xfa, 0x01, 0xbc, 0x16, 0xaf, 0x1e, 0x15, 0x3f, 0x82, 0xc5, 0xf9, 0x73, 0x10, 0x98, 0x64,
+    0xfe, 0x87, 0xff, 0xd5, 0xbc, 0xa2, 0x5f, 0x43, 0xc3, 0xbf, 0x18, 0x5c, 0xfd, 0xa1, 0x64, 0x01,
+    0xbe, 0x62, 0xeb, 0xa1, 0x9d, 0x93, 0x26, 0xcd, 0x1c, 0x40, 0xee, 0x0f, 0x39, 0xc7, 0xd7, 0x2b,
+    0x1d, 0xac, 0xf5, 0x50, 0x8f, 0x66, 0x33, 0x5d, 0xf4, 0x08, 0xc1, 0x59, 0x19, 0x49, 0x08, 0xe3,
+    0x30, 0x7e, 0x85, 0x4d, 0x5d, 0xe2, 0x2f, 0x0d, 0x13, 0x55, 0x9b, 0x27, 0x1e, 0x09, 0x1f, 0x80,
+    0xb7, 0x38, 0x70, 0xf4, 0x7a, 0x96, 0x9d, 0xde, 0xc2, 0x46, 0xb3, 0xf9, 0xa8, 0xf6, 0x4b, 0xce,
+    0x41, 0x3a, 0xb0, 0xe5, 0x7d, 0xbf, 0xc8, 0x4c, 0xe9, 0x17, 0x5d, 0x3f, 0x08, 0x97, 0x40, 0x66,
+    0x3a, 0xff, 0x30, 0x8e, 0xf4, 0xa3, 0xb9, 0xa5, 0xef, 0xbf, 0xee, 0x9f, 0x8f, 0x74, 0x13, 0xbb,
+    0xc9, 0x34, 0x97, 0xfe, 0xc2, 0xdc, 0x54, 0x6e, 0x63, 0x50, 0x61, 0x00, 0x66, 0x99, 0xcc, 0x6d,
+    0x78, 0x14, 0x38, 0x50, 0xda, 0xed, 0x8b, 0x48, 0xef, 0x7e, 0xe1, 0xf9, 0xdd, 0x2f, 0xfa, 0xa1,
+    0xfd, 0x85, 0x27, 0x78, 0xbf, 0xe8, 0xfd, 0x7e, 0x09, 0xd3, 0xc7, 0xed, 0x28, 0xe5, 0x65, 0x15,
+    0xcd, 0x85, 0x10, 0x05, 0x06, 0xbc, 0x1a, 0x22, 0x47, 0xa3, 0x52, 0x15, 0x81, 0x33, 0xa5, 0x59,
+    0x79, 0xaa, 0x0d, 0xed, 0xb6, 0xca, 0x49, 0x7e, 0xb3, 0xe3, 0x63, 0x72, 0xe1, 0xaf, 0x9f, 0x3f,
+    0xbc, 0x77, 0x16, 0xa3, 0xba, 0xbd, 0x1c, 0x55, 0xb3, 0x12, 0xaa, 0x65, 0x18, 0xb7, 0xa8, 0xab,
+    0x28, 0x8c, 0xfc, 0x09, 0x5d, 0x1d, 0x97, 0x0d, 0x49, 0x4d, 0x41, 0xff, 0xd7, 0x74, 0xcd, 0x06,
+    0x5d, 0x73, 0x4a, 0xca, 0xf6, 0xa0, 0x6a, 0x56, 0x55, 0xe6, 0x0f, 0xed, 0x76, 0xa9, 0xcf, 0xb1,
+    0x9f, 0x06, 0x29, 0x29, 0xd1, 0x43, 0x45, 0x7f, 0x48, 0x04, 0x44, 0x7a, 0x55, 0x48, 0x13, 0x7f,
+    0xfa, 0x22, 0xf3, 0x93, 0x5f, 0x74, 0x79, 0x45, 0x12, 0x00, 0x02, 0x18, 0xe2, 0x38, 0x45, 0x97,
+    0xd4, 0x4e, 0xdc, 0x06, 0xa8, 0xd8, 0x7c, 0x89, 0xba, 0x00, 0xc2, 0x6c, 0xe8, 0x07, 0x46, 0x31,
+    0xd9, 0xed, 0x47, 0x98, 0xec, 0xf6, 0xdd, 0x3b, 0x54, 0x88, 0xa2, 0x0c, 0x4c, 0x11, 0x09, 0x59,
+    0xcb, 0x5a, 0x96, 0x87, 0x6d, 0x21, 0xb1, 0xc4, 0x48, 0xf1, 0x7c, 0x13, 0xe7, 0x72, 0x52, 0x8a,
+    0x8b, 0xbd, 0x48, 0x04, 0x9a, 0xc6, 0xa4, 0x29, 0x34, 0xe6, 0xd4, 0x34, 0x2d, 0x9d, 0xc7, 0xe9,
+    0xb8, 0x55, 0x52, 0xe4, 0x89, 0xee, 0x43, 0x88, 0xa3, 0x9e, 0xdf, 0x6f, 0x72, 0x61, 0x7a, 0x89,
+    0x99, 0xff, 0x34, 0x91, 0xfb, 0x51, 0x61, 0x00, 0xbf, 0xaf, 0xb8, 0x1a, 0xa9, 0x9e, 0xc2, 0xff,
+    0x9a, 0x6b, 0x70, 0xbc, 0x5c, 0x35, 0x9b, 0x44, 0x60, 0xb3, 0x69, 0xd0, 0x9e, 0xca, 0xc6, 0x4c,
+    0xde, 0x50, 0x40, 0x87, 0x2c, 0xc4, 0xcf, 0x49, 0x3b, 0xe2, 0x6e, 0xd8, 0xf7, 0xef, 0xb0, 0x74,
+    0x98, 0x5e, 0x96, 0xc9, 0xcb, 0x44, 0x54, 0xd8, 0x59, 0xc2, 0x23, 0x65, 0x14, 0xf8, 0x5b, 0xaa,
+    0x12, 0x28, 0xde, 0x4e, 0x65, 0xc1, 0xfc, 0x7d, 0x0a, 0x2f, 0xd4, 0x7e, 0x54, 0xe6, 0x5e, 0x74,
+    0x84, 0xb0, 0xec, 0xde, 0x8f, 0x95, 0x0e, 0x54, 0xc8, 0x5e, 0xbc, 0x77, 0xe3, 0xf2, 0x6b, 0x59,
+    0x86, 0x5e, 0x9a, 0x4a, 0x54, 0xaf, 0x57, 0xe7, 0x12, 0xb5, 0x0b, 0x45, 0xd7, 0x99, 0x28, 0x58,
+    0xb8, 0x07, 0xa8, 0x95, 0xbe, 0xa2, 0x8c, 0x5c, 0xf6, 0x35, 0x8c, 0xb0, 0x83, 0x26, 0xea, 0xde,
+    0xf3, 0x53, 0xb1, 0x96, 0xfb, 0x84, 0xba, 0xc0, 0xde, 0x6e, 0x15, 0x04, 0xe6, 0x95, 0xae, 0x0f,
+    0xdb, 0xba, 0x60, 0x9e, 0x53, 0x26, 0x39, 0x47, 0x85, 0x71, 0x94, 0xf5, 0xe5, 0xc5, 0x1c, 0xa5,
+    0xf8, 0x46, 0x01, 0x5c, 0x6a, 0x2f, 0x41, 0xab, 0xec, 0xa9, 0x67, 0x73, 0x9e, 0xbe, 0xc4, 0xd0,
+    0xd6, 0x48, 0x2d, 0x10, 0xad, 0x29, 0x6b, 0xe3, 0xa2, 0x70, 0xb8, 0x8b, 0x68, 0x15, 0x78, 0x63,
+    0xd8, 0x32, 0x3a, 0x7b, 0x7b, 0xd4, 0x1f, 0x8c, 0xca, 0x9e, 0x12, 0xec, 0xee, 0xef, 0xef, 0x15,
+    0x59, 0x67, 0xbe, 0xff, 0xcd, 0x87, 0x50, 0xba, 0x50, 0x96, 0x37, 0xc9, 0x65, 0xa4, 0xb4, 0x8b,
+    0xf8, 0xfe, 0xbd, 0xfe, 0x6a, 0xc4, 0x9b, 0xf2, 0xda, 0xa5, 0x62, 0x84, 0x48, 0xb6, 0x23, 0x07,
+    0x9a, 0xfb, 0x88, 0xa1, 0xb4, 0x9f, 0x2b, 0x86, 0xa1, 0x15, 0x93, 0x23, 0xd4, 0x57, 0xa2, 0x77,
+    0x51, 0xfc, 0x51, 0x0c, 0x49, 0xa9, 0x0d, 0x64, 0xe8, 0x9e, 0x85, 0x78, 0xb2, 0xef, 0x5d, 0x41,
+    0x54, 0x3a, 0xd4, 0xbb, 0x7a, 0x69, 0x8c, 0x22, 0x72, 0xca, 0x10, 0x29, 0x1e, 0x4a, 0xe5, 0x45,
+    0xd1, 0x4b, 0xd4, 0x10, 0x28, 0x7d, 0xa8, 0x58, 0x42, 0x01, 0x43, 0x85, 0x05, 0xf7, 0x4b, 0x68,
+    0x55, 0x3a, 0xe5, 0xe5, 0x3f, 0x5b, 0x04, 0xb8, 0xb9, 0xa7, 0x00, 0xb0, 0x83, 0x50, 0x37, 0x75,
+    0x1c, 0xb5, 0x85, 0xab, 0x8e, 0x51, 0x89, 0xb2, 0x07, 0x66, 0xde, 0xb7, 0x74, 0x2a, 0x5e, 0xac,
+    0x2c, 0xe1, 0x2f, 0xee, 0x85, 0x75, 0xcc, 0x29, 0x8a, 0xb2, 0x42, 0xd4, 0x63, 0xf7, 0x98, 0xd3,
+    0xbc, 0xf7, 0x08, 0xec, 0x32, 0x35, 0x0b, 0x52, 0x2b, 0xe7, 0xd7, 0x65, 0x82, 0x57, 0x86, 0x8c,
+    0x36, 0x42, 0x5c, 0x2b, 0xa1, 0x41, 0x5a, 0x91, 0xc8, 0xfd, 0x7d, 0x43, 0x08, 0xf1, 0x5e, 0xf9,
+    0x00, 0xe4, 0xfb, 0x77, 0x18, 0xba, 0xe7, 0x38, 0x95, 0x38, 0xc3, 0x34, 0xd7, 0xcd, 0xe1, 0xff,
+    0x68, 0x53, 0x36, 0x85, 0xa3, 0xaa, 0x9b, 0x18, 0x55, 0x0e, 0x58, 0x68, 0x4f, 0xd8, 0x10, 0xd8,
+    0x6c, 0xf8, 0xb6, 0x5e, 0x5c, 0xe9, 0x2b, 0x4e, 0x6e, 0x0a, 0xc5, 0xc5, 0xb2, 0x14, 0x2e, 0x76,
+    0xa8, 0xbc, 0x22, 0x30, 0x33, 0x0a, 0xb5, 0x1d, 0x97, 0xd4, 0x16, 0x96, 0x6b, 0xec, 0x35, 0xcb,
+    0xaa, 0xe4, 0x74, 0x4d, 0x86, 0x1d, 0xf0, 0x64, 0x65, 0x31, 0x36, 0xcd, 0xfd, 0x7d, 0x69, 0x6c,
+    0xcd, 0x96, 0x51, 0xf2, 0xbd, 0x3a, 0x65, 0x45, 0xee, 0xe5, 0x8c, 0x55, 0x75, 0xa0, 0x09, 0x15,
+    0x8d, 0x28, 0xa6, 0x9b, 0x3f, 0x99, 0xcd, 0x43, 0xe4, 0x6b, 0x75, 0x36, 0x55, 0x83, 0xe4, 0x54,
+    0x25, 0xad, 0xe2, 0x0b, 0x2b, 0x2b, 0x56, 0x31, 0x17, 0xb6, 0x98, 0x0d, 0xa3, 0x8a, 0xb7, 0xc0,
+    0x9d, 0x4a, 0xba, 0x4c, 0x30, 0xca, 0x48, 0xfd, 0x00, 0xb8, 0xc0, 0x2d, 0xa8, 0x48, 0x55, 0x92,
+    0xc1, 0xc3, 0xbc, 0x45, 0xc1, 0x4b, 0xb9, 0xad, 0x56, 0xd9, 0x4b, 0x82, 0x80, 0x69, 0x98, 0xb1,
+    0xc8, 0xcd, 0x60, 0xfa, 0x42, 0x57, 0xee, 0x0c, 0xeb, 0x16, 0x9d, 0x96, 0xf5, 0xce, 0xc4, 0x11,
+    0x55, 0x71, 0xc4, 0x5b, 0x3e, 0xa2, 0xaa, 0x6c, 0x83, 0xc7, 0x62, 0x98, 0x39, 0xaa, 0x59, 0xfa,
+    0xb1, 0x25, 0x6c, 0xb7, 0x82, 0x29, 0xe5, 0xc3, 0xf9, 0x2a, 0x4c, 0xca, 0x89, 0xf3, 0x69, 0xe4,
+    0x02, 0x79, 0xaa, 0x3b, 0x4f, 0x00, 0xa9, 0x3d, 0x18, 0x26, 0x4f, 0x86, 0x10, 0x01, 0xb2, 0x0e,
+    0x84, 0xb7, 0xa9, 0x3b, 0xc7, 0xcc, 0xa5, 0xcc, 0xe6, 0xd4, 0x05, 0x79, 0x53, 0xa3, 0x61, 0x11,
+    0x8e, 0x61, 0xb2, 0x20, 0x64, 0x81, 0x45, 0x1a, 0x6d, 0x11, 0xf5, 0x89, 0x84, 0xca, 0xe9, 0xa6,
+    0x98, 0x5b, 0xb4, 0x40, 0x74, 0x9f, 0x3e, 0x5b, 0x5a, 0x1c, 0xe0, 0x97, 0x7d, 0x34, 0x24, 0x5f,
+    0x91, 0x06, 0xc2, 0xe5, 0x93, 0x1d, 0xc8, 0x0f, 0x46, 0x73, 0x52, 0xcb, 0xcc, 0xf7, 0x5a, 0x26,
+    0xf4, 0x87, 0xa5, 0xa3, 0x02, 0x4b, 0xe0, 0x31, 0x2c, 0xe1, 0x33, 0xa4, 0x9f, 0xa4, 0x51, 0x84,
+    0x19, 0x58, 0x87, 0x55, 0xe8, 0x31, 0x58, 0x29, 0xf3, 0xcc, 0x58, 0xc8, 0x0a, 0x37, 0x96, 0x9c,
+    0x3c, 0x2c, 0xc4, 0xf3, 0x77, 0x79, 0x34, 0x8b, 0x21, 0x32, 0x07, 0x47, 0x07, 0x97, 0x04, 0xec,
+    0x40, 0xef, 0x74, 0x3a, 0x7a, 0xbe, 0x8d, 0xa8, 0x09, 0x80, 0x18, 0xaa, 0x5b, 0xb1, 0x35, 0x38,
+    0x46, 0xf6, 0xa3, 0x38, 0xed, 0xef, 0x27, 0x79, 0x8c, 0xb9, 0xce, 0x63, 0x4c, 0x27, 0x6f, 0xac,
+    0x9b, 0x9e, 0xcd, 0xcf, 0x48, 0x4d, 0x89, 0xcc, 0x8d, 0xb8, 0x6b, 0xd1, 0x43, 0x41, 0xed, 0xa4,
+    0x2a, 0x1d, 0x72, 0x68, 0x93, 0x78, 0x94, 0x38, 0x94, 0x27, 0xfe, 0x6a, 0x47, 0xd8, 0x1b, 0x6e,
+    0x0c, 0x19, 0x66, 0x94, 0xc6, 0x11, 0x04, 0xef, 0x34, 0x20, 0x6f, 0xfa, 0xc4, 0x80, 0x97, 0x1f,
+    0x52, 0xc7, 0xa6, 0xf3, 0xf0, 0xe2, 0x64, 0xd6, 0x7f, 0x64, 0xf9, 0x85, 0x4b, 0x23, 0xcf, 0x12,
+    0xed, 0xed, 0xe5, 0x70, 0xf6, 0xf7, 0xf3, 0x3f, 0x3b, 0xb8, 0x41, 0xe5, 0x51, 0x31, 0x58, 0x07,
+    0xbb, 0x25, 0xd0, 0xa7, 0x9c, 0x96, 0xb1, 0x24, 0x59, 0xdc, 0x5b, 0x82, 0xb3, 0x58, 0xe6, 0x1c,
+    0x10, 0x1a, 0x5d, 0xf0, 0xc1, 0x58, 0x52, 0x9c, 0x81, 0x79, 0xb4, 0x34, 0x74, 0x63, 0xf0, 0x35,
+    0x40, 0xf2, 0xab, 0x7c, 0xc0, 0xf0, 0x76, 0xf2, 0x27, 0x60, 0xd6, 0x01, 0x41, 0xf3, 0xe7, 0xa1,
+    0xb1, 0xde, 0x58, 0xf9, 0x50, 0xb4, 0xd7, 0x56, 0x01, 0xb9, 0xce, 0xc7, 0x9f, 0x61, 0xa3, 0xb2,
+    0x20, 0x11, 0x65, 0xd2, 0x62, 0x70, 0x17, 0x8c, 0x8b, 0x31, 0xf4, 0xbf, 0xb3, 0x09, 0x12, 0x82,
+    0x65, 0xba, 0xe6, 0x87, 0xda, 0x13, 0x78, 0xa4, 0xe8, 0xc9, 0x94, 0xcb, 0x42, 0x65, 0x51, 0xc8,
+    0xcf, 0x9e, 0xb4, 0xbc, 0xbb, 0x61, 0xe0, 0xd1, 0x26, 0x7d, 0x0c, 0x25, 0x4e, 0xa2, 0x2c, 0x9a,
+    0x46, 0x01, 0xae, 0x79, 0x91, 0x65, 0x71, 0x3a, 0xd4, 0xaf, 0xf4, 0xa7, 0x34, 0x1d, 0x1e, 0x1d,
+    0x81, 0x67, 0x7f, 0xa2, 0xdf, 0xe6, 0x41, 0xde, 0x7d, 0x11, 0x61, 0x0a, 0x80, 0x04, 0x9c, 0x60,
+    0xa7, 0xba, 0x7a, 0xa2, 0x5c, 0xe1, 0xb6, 0x40, 0x64, 0x53, 0x70, 0x2c, 0x0a, 0xa3, 0x58, 0x9e,
+    0x63, 0xd6, 0xe5, 0x80, 0x64, 0x0f, 0x45, 0x20, 0xff, 0xda, 0x44, 0xbe, 0x97, 0xc0, 0x69, 0x46,
+    0x2a, 0x1c, 0x21, 0x8f, 0x0e, 0x7b, 0x14, 0x47, 0xa2, 0x35, 0x96, 0x2b, 0x69, 0x71, 0xf6, 0x48,
+    0x19, 0x4a, 0xd3, 0x2c, 0x9d, 0xb3, 0x97, 0xe0, 0x4d, 0x83, 0x28, 0x65, 0x0a, 0x62, 0xc5, 0x2a,
+    0x94, 0xf3, 0x8b, 0x12, 0x17, 0x2c, 0x75, 0x01, 0xe6, 0xa8, 0xb4, 0x9c, 0x7c, 0xa7, 0xa8, 0xb6,
+    0xfe, 0x6b, 0xcf, 0xa2, 0xd2, 0x10, 0x5c, 0xca, 0xe6, 0x15, 0xd6, 0x35, 0xc8, 0x4b, 0x99, 0x66,
+    0xcb, 0x16, 0x97, 0xf7, 0xd0, 0x8b, 0xdd, 0xec, 0x08, 0x87, 0xa9, 0xf7, 0x33, 0x5b, 0x47, 0x42,
+    0xa7, 0xfb, 0x18, 0x7b, 0x55, 0x47, 0xd7, 0xaf, 0x6a, 0x96, 0x61, 0x48, 0xaf, 0xc8, 0x7b, 0x97,
+    0xae, 0x24, 0xb6, 0x4e, 0xc6, 0x2f, 0x60, 0xc2, 0x4c, 0xd0, 0x5d, 0x2f, 0xa5, 0x49, 0x8b, 0xab,
+    0x99, 0x45, 0x8a, 0xb4, 0xcb, 0xb7, 0xc3, 0x12, 0xbe, 0xb8, 0xc4, 0xb8, 0x75, 0x25, 0x29, 0x5e,
+    0x6c, 0x6c, 0x82, 0x2f, 0xae, 0x64, 0x36, 0x03, 0x57, 0x2e, 0xe2, 0x15, 0xd0, 0xc9, 0x81, 0xe5,
+    0x07, 0xe9, 0x75, 0x6f, 0xc2, 0x8f, 0x98, 0x79, 0xba, 0x59, 0x9d, 0x49, 0x5e, 0x5c, 0xac, 0x4e,
+    0xc5, 0x5d, 0x5d, 0xad, 0x2b, 0xbf, 0x83, 0x58, 0xed, 0xbc, 0x69, 0x75, 0x17, 0x78, 0xf9, 0xe7,
+    0x08, 0x07, 0xea, 0x58, 0x7f, 0x40, 0x9a, 0x80, 0x4f, 0xe2, 0x12, 0xe0, 0x03, 0xd8, 0xe0, 0x8a,
+    0x99, 0x48, 0xcc, 0x9a, 0x53, 0x2f, 0x06, 0x34, 0xfa, 0xf5, 0x0d, 0x11, 0x45, 0x7e, 0xce, 0x63,
+    0x3b, 0x45, 0xea, 0x08, 0xd2, 0x31, 0x9c, 0xd5, 0xe2, 0x75, 0x37, 0x14, 0xa9, 0xf0, 0xd3, 0x9c,
+    0xa4, 0x43, 0x85, 0x54, 0x14, 0x9f, 0xf1, 0x85, 0xe0, 0x50, 0x58, 0x83, 0x25, 0xeb, 0x15, 0x30,
+    0xa1, 0xe8, 0x7b, 0x80, 0x1d, 0xf4, 0x65, 0xdf, 0x62, 0x80, 0x92, 0xde, 0xfb, 0x30, 0xa0, 0x8b,
+    0x75, 0x41, 0x69, 0x3d, 0x58, 0xa1, 0xf1, 0x5b, 0x96, 0xd4, 0x50, 0xbd, 0x5c, 0x96, 0xa6, 0x96,
+    0xb8, 0x5f, 0x51, 0x87, 0xad, 0x7a, 0x50, 0x89, 0x79, 0x44, 0xf5, 0x14, 0x48, 0x96, 0x11, 0xfb,
+    0xa1, 0x15, 0x20, 0xa7, 0xcd, 0xf5, 0x16, 0x86, 0xb6, 0x85, 0x2a, 0x5c, 0xc6, 0x00, 0x04, 0x17,
+    0x21, 0x02, 0x54, 0x39, 0x3c, 0xe7, 0x53, 0xf1, 0xc2, 0x6b, 0xf2, 0x74, 0x58, 0x91, 0x81, 0x7a,
+    0x93, 0x5f, 0x5e, 0x93, 0x91, 0x6e, 0xd6, 0x30, 0xee, 0x8d, 0x3c, 0x8f, 0x4b, 0xb8, 0xcb, 0x10,
+    0xcd, 0x1d, 0x7e, 0x34, 0x57, 0x3e, 0xae, 0x2b, 0xbf, 0x1b, 0x95, 0x1e, 0xb9, 0x21, 0xac, 0x47,
+    0x7f, 0x92, 0x12, 0x19, 0x8b, 0x85, 0x4f, 0x92, 0xc3, 0x44, 0x61, 0x19, 0x6c, 0xc5, 0x44, 0x03,
+    0xaf, 0x2d, 0x93, 0xbe, 0x49, 0xed, 0x8a, 0x85, 0x66, 0x1d, 0x88, 0x5d, 0xe7, 0xd9, 0xc2, 0x5c,
+    0x37, 0x2c, 0x58, 0x67, 0xfc, 0x70, 0x52, 0x44, 0x66, 0xbc, 0x83, 0x14, 0x87, 0x30, 0xe2, 0xd7,
+    0xee, 0x28, 0xd1, 0x0e, 0xaf, 0x3c, 0x9f, 0x1c, 0x87, 0x5e, 0x2c, 0x40, 0x60, 0x22, 0xc2, 0x12,
+    0xe9, 0x92, 0x14, 0x62, 0x14, 0xa5, 0x6d, 0x7b, 0x22, 0x0f, 0xc3, 0xfd, 0x09, 0xf1, 0x53, 0xe1,
+    0x75, 0xbd, 0xbf, 0xd5, 0xad, 0xc7, 0xd5, 0x02, 0x3d, 0x22, 0xad, 0x46, 0x0a, 0x09, 0x31, 0x57,
+    0x6d, 0x24, 0xc8, 0xf9, 0xcc, 0x85, 0x80, 0xdd, 0xab, 0x09, 0x34, 0x46, 0x48, 0x6e, 0x86, 0x1f,
+    0xa9, 0x82, 0x78, 0xa4, 0x3b, 0xaa, 0x0f, 0xe5, 0xbc, 0x78, 0x5a, 0xc0, 0x68, 0x43, 0x76, 0xbc,
+    0x68, 0xa0, 0xe5, 0xfe, 0x7e, 0xc3, 0x58, 0xb9, 0x40, 0x65, 0xf9, 0xbe, 0xf7, 0xed, 0xd2, 0x69,
+    0xe2, 0x85, 0xd2, 0xc1, 0xe9, 0xca, 0x82, 0x13, 0x80, 0xa1, 0xf6, 0xfd, 0x43, 0xe9, 0x74, 0x70,
+    0xf0, 0x75, 0x24, 0x11, 0x3a, 0x80, 0x70, 0x4c, 0x48, 0xa9, 0x72, 0x59, 0x53, 0x8a, 0xaa, 0x48,
+    0x69, 0x01, 0x00, 0x8a, 0x8b, 0x2a, 0x96, 0xb5, 0xf4, 0xba, 0x91, 0x13, 0xa8, 0x32, 0xb6, 0xd9,
+    0x44, 0x1b, 0x78, 0x33, 0x6a, 0x12, 0x21, 0x21, 0x04, 0x55, 0x21, 0x12, 0xfc, 0x89, 0x89, 0x21,
+    0xb7, 0x1f, 0xf5, 0x56, 0x76, 0xa6, 0x0f, 0x7e, 0x5c, 0xea, 0x5d, 0xe3, 0x5b, 0xa3, 0x40, 0xe5,
+    0xf4, 0xfe, 0x51, 0xb1, 0xc6, 0x4f, 0xe5, 0x54, 0x44, 0x5a, 0x08, 0xcc, 0x2e, 0x92, 0xfd, 0xa2,
+    0x16, 0x36, 0xe1, 0x53, 0xee, 0x72, 0xa5, 0xf3, 0xdf, 0x10, 0x03, 0xca, 0xcb, 0xb0, 0x66, 0x3e,
+    0x45, 0xd9, 0x36, 0x54, 0xea, 0x3b, 0xd6, 0x25, 0xa3, 0xd0, 0x11, 0xf4, 0x74, 0x2e, 0x9b, 0x96,
+    0xa9, 0xd2, 0x10, 0x88, 0x88, 0x1f, 0x60, 0xed, 0x36, 0xd9, 0x3f, 0x20, 0x65, 0x71, 0xf4, 0x33,
+    0xcb, 0x37, 0xc3, 0xb5, 0x93, 0x1b, 0xe4, 0xd0, 0x7d, 0x41, 0x32, 0x4c, 0xe3, 0x57, 0x9a, 0x8a,
+    0x13, 0x9c, 0x09, 0xec, 0x3a, 0x9d, 0x02, 0x96, 0x90, 0xfa, 0xab, 0xa2, 0x65, 0x98, 0x97, 0x37,
+    0x17, 0xc2, 0x9f, 0x3a, 0x38, 0xac, 0xb3, 0x74, 0x63, 0xe3, 0x9b, 0x73, 0x99, 0xfb, 0xfc, 0x6f,
+    0x14, 0x73, 0x74, 0xf8, 0x47, 0x67, 0x0d, 0x88, 0x48, 0x6b, 0x47, 0xa3, 0x8f, 0xe6, 0xfe, 0x7e,
+    0x0e, 0xaf, 0xe3, 0x83, 0x9f, 0x59, 0x79, 0x2c, 0x85, 0xe6, 0x7c, 0x43, 0xc5, 0xd7, 0x82, 0xd3,
+    0x53, 0xd5, 0xac, 0x90, 0x73, 0xaa, 0x5a, 0x78, 0x55, 0x18, 0xfc, 0x64, 0x6b, 0x34, 0x53, 0x95,
+    0x0c, 0xda, 0x34, 0x97, 0x19, 0x2b, 0xa4, 0x45, 0x55, 0x62, 0xa7, 0x44, 0xe5, 0x51, 0x83, 0xef,
+    0x18, 0xfd, 0xb3, 0xcd, 0x25, 0xc5, 0xdf, 0x6d, 0xb6, 0x4d, 0x1e, 0x0f, 0xc3, 0x62, 0x3f, 0xb9,
+    0x4f, 0x8e, 0x1a, 0x59, 0x95, 0x6e, 0x9b, 0x2b, 0x85, 0x94, 0x48, 0x7f, 0x44, 0xb2, 0x46, 0x77,
+    0x09, 0xc5, 0x94, 0xd2, 0xc3, 0xbe, 0xb9, 0xd3, 0xac, 0x6c, 0xef, 0x60, 0xdb, 0xc4, 0xbe, 0xdd,
+    0xce, 0x8a, 0xbe, 0x74, 0xbe, 0x82, 0xfd, 0x2e, 0x9d, 0x6e, 0xae, 0x2b, 0x64, 0x07, 0xa9, 0x55,
+    0x54, 0x39, 0x8a, 0x9c, 0x1d, 0x6c, 0xe4, 0xca, 0xe0, 0x60, 0x4f, 0xec, 0xdd, 0x20, 0x48, 0x14,
+    0x84, 0x47, 0xb0, 0xad, 0x39, 0x58, 0x15, 0x92, 0x81, 0x03, 0x01, 0xfe, 0x15, 0xfe, 0x1e, 0x22,
+    0x65, 0x44, 0xed, 0x64, 0xc9, 0xea, 0xaa, 0x66, 0xa5, 0xe4, 0x27, 0x5b, 0x68, 0x21, 0x6d, 0x67,
+    0x9b, 0x8d, 0xfe, 0x6a, 0xe6, 0xda, 0x5b, 0xb2, 0x45, 0x84, 0x23, 0x37, 0x90, 0x65, 0x46, 0x92,
+    0x12, 0x37, 0x59, 0x45, 0xce, 0x9f, 0x6d, 0x51, 0x59, 0xe9, 0x23, 0x10, 0xe5, 0xd8, 0x6a, 0x5d,
+    0x91, 0x49, 0x55, 0x4e, 0x4b, 0x72, 0xd7, 0x84, 0xab, 0x30, 0x4c, 0x15, 0xc3, 0xc9, 0x5b, 0xf1,
+    0x3f, 0x36, 0x21, 0xcc, 0xb4, 0xd1, 0x68, 0x8f, 0xc5, 0x39, 0x0b, 0x7e, 0x15, 0x54, 0x1f, 0xd6,
+    0x3b, 0xa0, 0xb6, 0xe5, 0xc8, 0xab, 0x9f, 0xa1, 0xa8, 0xe0, 0xdf, 0x60, 0x64, 0x65, 0x68, 0xb3,
+    0x4d, 0xdd, 0x5a, 0x7c, 0xd2, 0x2e, 0x16, 0x73, 0x2a, 0x90, 0x69, 0x31, 0x9d, 0xa3, 0xc2, 0x46,
+    0xf0, 0x4f, 0x5f, 0x34, 0x99, 0x88, 0x66, 0xc7, 0xb1, 0x0d, 0xe1, 0xff, 0x77, 0x46, 0xa0, 0x3d,
+    0x7a, 0xc0, 0xb2, 0xe9, 0x46, 0x11, 0x96, 0x6e, 0xaa, 0xec, 0xb9, 0xf3, 0xe6, 0x82, 0x46, 0xf2,
+    0x03, 0x1a, 0xbb, 0x33, 0x55, 0x55, 0xc3, 0xb2, 0x0b, 0x6d, 0x24, 0xdb, 0x56, 0x4e, 0xa2, 0xc2,
+    0xb7, 0x70, 0xb1, 0x40, 0xb1, 0xf8, 0xae, 0xc8, 0x4b, 0x3b, 0xd7, 0x56, 0x96, 0x5c, 0xd5, 0xdf,
+    0xec, 0xb4, 0xa1, 0x1d, 0xd5, 0xe3, 0x2d, 0x8c, 0xb6, 0x5e, 0x0e, 0xe7, 0x9a, 0x23, 0x32, 0xce,
+    0x0e, 0x71, 0x3d, 0x57, 0x7c, 0xe2, 0x22, 0x0f, 0xa5, 0x6a, 0xa6, 0xa5, 0xd2, 0xef, 0x05, 0xf3,
+    0xa2, 0x7c, 0x44, 0xe5, 0xff, 0x0b, 0x32, 0x75, 0xff, 0xa9, 0x64, 0x7a, 0xf7, 0x6e, 0x47, 0x3a,
+    0x41, 0xc7, 0xad, 0x1b, 0x7e, 0xba, 0x74, 0xd0, 0x5a, 0x0b, 0x48, 0xd5, 0xc6, 0xf5, 0x7b, 0x08,
+    0x72, 0x7b, 0x5c, 0xba, 0x4a, 0xd1, 0x5e, 0x23, 0xb8, 0x15, 0x4a, 0xfd, 0xa3, 0x9a, 0x55, 0x7f,
+    0xa0, 0x96, 0x82, 0x22, 0xdb, 0x76, 0xbe, 0x7a, 0x51, 0xbe, 0xff, 0xf1, 0x43, 0x77, 0x47, 0x8a,
+    0xa1, 0xd5, 0xbb, 0x36, 0xfc, 0xc8, 0x76, 0xeb, 0xe5, 0x18, 0xae, 0xd2, 0xf4, 0x19, 0xa6, 0xfc,
+    0x66, 0x01, 0x2d, 0x53, 0xda, 0x9a, 0x72, 0x11, 0xd3, 0x1b, 0x51, 0xe0, 0x49, 0x45, 0xad, 0x86,
+    0xb8, 0xac, 0x9a, 0xdf, 0x6b, 0x00, 0x4f, 0xea, 0x88, 0x36, 0x90, 0x2f, 0xbc, 0xc9, 0x38, 0x6a,
+    0x4b, 0x4c, 0xe5, 0x87, 0xf9, 0x2c, 0xbb, 0x99, 0x39, 0xc6, 0x83, 0xf5, 0x28, 0x4c, 0xd7, 0xa3,
+    0x7a, 0xa6, 0xb1, 0xbf, 0xff, 0x28, 0xc4, 0x1b, 0xc2, 0x4e, 0x2e, 0x77, 0x8f, 0xa6, 0x08, 0x1e,
+    0x2e, 0xbb, 0x66, 0xfc, 0xc7, 0xc3, 0x57, 0xe7, 0x71, 0x44, 0xe7, 0x21, 0x34, 0xb9, 0xe3, 0xd0,
+    0xac, 0xdf, 0xbf, 0xcb, 0xa7, 0xb9, 0x28, 0xce, 0xa7, 0x2a, 0xdd, 0x9b, 0x99, 0xa1, 0xe3, 0x41,
+    0xbf, 0x6e, 0xd5, 0x0f, 0xfa, 0x45, 0x79, 0x12, 0xe5, 0x7f, 0xb0, 0x5f, 0x7e, 0xbc, 0x2f, 0x3b,
+    0x57, 0x8f, 0xf7, 0xab, 0x03, 0x30, 0xe1, 0x2e, 0xfb, 0xaa, 0x07, 0xfb, 0xd5, 0x7e, 0x10, 0x14,
+    0xe7, 0x77, 0xfb, 0x72, 0x44, 0xc4, 0xc7, 0x44, 0xc4, 0x10, 0x93, 0xe2, 0xa5, 0xe6, 0x05, 0x89,
+    0x73, 0x55, 0x58, 0x50, 0xdc, 0x01, 0x83, 0x7d, 0x9f, 0x1f, 0x91, 0x3a, 0x6d, 0x05, 0x04, 0x54,
+    0x4c, 0x2b, 0x67, 0x7f, 0xf2, 0x67, 0x3e, 0x1d, 0xb1, 0xcb, 0xa9, 0xab, 0x47, 0xf4, 0x66, 0xa9,
+    0x27, 0x49, 0x93, 0xd2, 0xb3, 0x8c, 0xa5, 0xe8, 0x29, 0x0e, 0xed, 0x65, 0xbf, 0xf2, 0xa1, 0xbd,
+    0xda, 0x4b, 0x85, 0x26, 0x3e, 0xa7, 0x51, 0xed, 0x95, 0x2f, 0x47, 0xf6, 0xab, 0x1e, 0xf1, 0x56,
+    0xc9, 0x29, 0x4e, 0x6c, 0x65, 0xf7, 0xca, 0x11, 0x6d, 0xb5, 0xb7, 0x72, 0xee, 0x2a, 0x47, 0xa8,
+    0xc7, 0xac, 0x79, 0xf7, 0x76, 0xfa, 0x27, 0xfc, 0x66, 0xc7, 0xff, 0x4c, 0xad, 0x6d, 0x5c, 0x2a,
+    0xa6, 0x99, 0x16, 0xb5, 0xb7, 0xb0, 0xdb, 0xab, 0xd4, 0x5c, 0x15, 0xb3, 0xa9, 0xc5, 0x57, 0xe5,
+    0x42, 0x2b, 0x59, 0x63, 0xb5, 0x87, 0x79, 0xbd, 0x64, 0xde, 0x89, 0x57, 0xe9, 0xc2, 0x38, 0xb4,
+    0xe9, 0xac, 0x8f, 0x82, 0x30, 0x59, 0xa2, 0x90, 0xa8, 0xdb, 0x13, 0x59, 0x8d, 0x05, 0x88, 0x1d,
+    0xda, 0xf9, 0x8e, 0x04, 0xbb, 0x38, 0x0e, 0x0c, 0x2e, 0x01, 0xa2, 0x58, 0x5f, 0x6b, 0xda, 0xb0,
+    0x40, 0xff, 0xe6, 0xad, 0x62, 0x42, 0x9b, 0x18, 0x09, 0x04, 0x9f, 0xc4, 0x3e, 0x44, 0x85, 0x4b,
+    0x56, 0x29, 0x91, 0x65, 0x82, 0x07, 0xba, 0x74, 0x20, 0x12, 0x37, 0x68, 0xc1, 0xaf, 0xc8, 0x61,
+    0xca, 0x0c, 0xb3, 0xb1, 0x78, 0xed, 0x42, 0x03, 0x64, 0xd1, 0x57, 0xc4, 0x4a, 0x29, 0xb2, 0x93,
+    0xcc, 0x8b, 0xf2, 0xc8, 0x9f, 0xa3, 0xa1, 0xa8, 0xaa, 0x85, 0xed, 0x6d, 0xc8, 0xd1, 0x63, 0xc1,
+    0x95, 0xb0, 0x44, 0x0a, 0xa1, 0xf2, 0xf2, 0xc6, 0x61, 0xb9, 0xba, 0x31, 0xc7, 0x86, 0xca, 0x2e,
+    0x1d, 0x88, 0xc0, 0xe2, 0x6a, 0xe9, 0x89, 0xb3, 0xb5, 0x52, 0x85, 0x2b, 0xaf, 0x30, 0x95, 0x9e,
+    0x53, 0x91, 0xa6, 0xe6, 0x72, 0x94, 0xc2, 0xb5, 0x37, 0xee, 0x24, 0x3d, 0xe0, 0x4b, 0xea, 0xa1,
+    0xf5, 0x6c, 0xaa, 0x5a, 0x71, 0x52, 0x6f, 0x8b, 0xf4, 0x47, 0x99, 0x5b, 0x98, 0x52, 0x78, 0xb8,
+    0x7f, 0x60, 0xb9, 0xea, 0x89, 0x8f, 0x0e, 0x14, 0x36, 0x4c, 0xb9, 0x94, 0x56, 0xcd, 0xb7, 0xba,
+    0x8f, 0xe2, 0xdc, 0xdf, 0xe0, 0x97, 0xd7, 0xaf, 0xf1, 0xd6, 0x3a, 0x2e, 0xc4, 0xca, 0x5d, 0x0a,
+    0x3f, 0x72, 0x97, 0x45, 0x5c, 0xf9, 0x79, 0x2e, 0x7e, 0x0d, 0x39, 0xa5, 0x2f, 0x24, 0x07, 0x74,
+    0x6c, 0xaa, 0x15, 0xdb, 0x0f, 0x99, 0xd6, 0x51, 0x6e, 0x1c, 0x57, 0x4e, 0xdb, 0xc1, 0xe8, 0xc6,
+    0xac, 0xcd, 0x43, 0x35, 0xf9, 0x37, 0xec, 0xcf, 0xc5, 0xbf, 0x8c, 0x26, 0x5a, 0x5f, 0xde, 0x24,
+    0x2e, 0x56, 0x48, 0x37, 0x8a, 0x87, 0xed, 0x98, 0x28, 0x85, 0x71, 0x07, 0xba, 0xb8, 0xd0, 0xac,
+    0x9e, 0xaf, 0x73, 0x4e, 0x37, 0x1d, 0xb2, 0x43, 0x47, 0x3c, 0x63, 0x3f, 0xed, 0x8a, 0x33, 0x76,
+    0xde, 0x73, 0x7f, 0x9f, 0xff, 0x2e, 0x55, 0xd3, 0xad, 0xc7, 0x65, 0x3b, 0x51, 0xeb, 0x41, 0x1c,
+    0x6c, 0x04, 0x40, 0xe5, 0xfa, 0x6b, 0xb5, 0x5c, 0xdf, 0xa9, 0xbd, 0x6f, 0x1f, 0xcd, 0x6b, 0x89,
+    0xd7, 0xa5, 0x5a, 0x62, 0xa7, 0xde, 0x43, 0xb2, 0x40, 0xbd, 0xdf, 0xdd, 0x72, 0x74, 0x51, 0x3b,
+    0x5f, 0xae, 0xf2, 0xd9, 0xcb, 0xc9, 0x59, 0xe5, 0xc1, 0x95, 0xae, 0x89, 0x26, 0xba, 0x0a, 0x09,
+    0xfa, 0x03, 0xdb, 0x19, 0x7d, 0x08, 0xad, 0xfc, 0xe3, 0xd9, 0xf0, 0x60, 0x72, 0xf3, 0x57, 0x63,
+    0x5e, 0x25, 0xd5, 0x27, 0x8f, 0x48, 0x90, 0x95, 0x16, 0xfe, 0x30, 0xad, 0xfe, 0x71, 0xb7, 0xb8,
+    0xd2, 0xc9, 0xca, 0xe2, 0xb7, 0xb5, 0xd8, 0xa4, 0x76, 0xdd, 0x7d, 0x43, 0x69, 0x2f, 0xf5, 0x7b,
+    0xe7, 0xe5, 0x98, 0x51, 0xd1, 0x05, 0x7e, 0x61, 0x9d, 0xa4, 0x92, 0xc7, 0x9b, 0xf5, 0xef, 0x9e,
+    0xb7, 0x8e, 0x25, 0xdc, 0x95, 0xa1, 0x0d, 0x5f, 0x14, 0x7b, 0x69, 0xde, 0x3c, 0x56, 0x2a, 0x01,
+    0x50, 0x3e, 0x70, 0xf4, 0x12, 0x80, 0x3c, 0x36, 0x29, 0x01, 0x28, 0xbe, 0x9a, 0xf2, 0xd2, 0x78,
+    0xe9, 0x5b, 0x4b, 0xc3, 0xc5, 0x67, 0x47, 0x5e, 0x1a, 0x4b, 0x96, 0x49, 0x0e, 0x54, 0x3f, 0xf2,
+    0x67, 0x56, 0xaf, 0x23, 0x96, 0x6f, 0x71, 0xd6, 0x57, 0xad, 0x7e, 0xe5, 0xef, 0xa5, 0xc1, 0xb5,
+    0x15, 0x2b, 0x5f, 0xfd, 0x7b, 0x69, 0x6c, 0x75, 0xb5, 0xf2, 0x2b, 0x80, 0x2f, 0x8d, 0x2b, 0xad,
+    0x54, 0x0d, 0xf7, 0x60, 0x18, 0x6d, 0x62, 0xf2, 0x2c, 0xc0, 0xd6, 0x88, 0xd0, 0x5c, 0xb7, 0x14,
+    0xf1, 0xc9, 0xfd, 0x56, 0xd2, 0x20, 0x74, 0xbb, 0x1d, 0xb1, 0xf2, 0x91, 0xdb, 0x0e, 0x59, 0x85,
+    0x7f, 0x2f, 0x2b, 0xef, 0x4e, 0x67, 0xc3, 0x62, 0xd0, 0x96, 0x7d, 0x62, 0xe9, 0x13, 0x2c, 0xdb,
+    0x51, 0x9f, 0x39, 0xbc, 0x3f, 0x7d, 0x25, 0x86, 0xf2, 0xde, 0x68, 0xf2, 0xea, 0x6d, 0x7f, 0x74,
+    0xbf, 0x92, 0x21, 0x99, 0x35, 0xdc, 0x2c, 0x14, 0x9f, 0x61, 0x9a, 0xa9, 0xdf, 0xa2, 0xc9, 0x6f,
+    0x6f, 0x6f, 0xa4, 0x73, 0x29, 0x11, 0xa0, 0x72, 0x78, 0xce, 0xaf, 0x47, 0x72, 0xd2, 0xc1, 0xc4,
+    0x47, 0x2b, 0xc2, 0x1e, 0xc8, 0xd7, 0x7c, 0x73, 0x73, 0xeb, 0x55, 0xd1, 0xd2, 0x47, 0x6c, 0x2c,
+    0xfd, 0x3f, 0x0e, 0xe5, 0x57, 0x0c, 0xf5, 0x61, 0xbc, 0xe1, 0x57, 0x3e, 0x67, 0x9b, 0xfc, 0x5e,
+    0x6b, 0xf5, 0x26, 0x66, 0x7e, 0x7d, 0xf3, 0x47, 0xae, 0x64, 0xfe, 0xb7, 0x2f, 0x33, 0x12, 0x5f,
+    0x61, 0xe1, 0x1a, 0x5f, 0x78, 0x63, 0x95, 0xc0, 0x9f, 0x75, 0x49, 0x50, 0x46, 0xb4, 0x49, 0x43,
+    0xe3, 0x07, 0x32, 0x46, 0xaf, 0x1a, 0x4a, 0x5e, 0x5f, 0x6d, 0x4f, 0xc5, 0xbd, 0x92, 0x2e, 0x82,
+    0x5b, 0x1b, 0xf2, 0x11, 0xa3, 0x4a, 0x2d, 0x13, 0xc0, 0x80, 0xb8, 0x08, 0x6f, 0xf1, 0x83, 0x96,
+    0x19, 0x79, 0x26, 0xae, 0x52, 0x0a, 0x66, 0x96, 0x9c, 0x0d, 0x81, 0xc3, 0x13, 0xa3, 0xf2, 0xa7,
+    0x59, 0x5a, 0x60, 0xfd, 0x10, 0x28, 0xf5, 0x53, 0x2e, 0x00, 0xef, 0xe2, 0x48, 0x7e, 0x30, 0x27,
+    0xff, 0x8e, 0x0e, 0xfd, 0x37, 0x7e, 0x2e, 0x8e, 0xf8, 0x7f, 0x44, 0xfb, 0xff, 0x02, 0x44, 0xc7,
+    0xe6, 0xa8, 0x55, 0x7b, 0x00, 0x00,
+};
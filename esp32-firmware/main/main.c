@@ -1,37 +1,73 @@
+#include <math.h>
+#include <stdarg.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
+#include <sys/time.h>
+#include <time.h>
 
 #include "cJSON.h"
 #include "driver/gpio.h"
 #include "driver/ledc.h"
+#include "fw_config.h"
+#include "fw_control.h"
+#include "fw_delta.h"
+#include "fw_hal.h"
+#include "fw_json.h"
+#include "fw_manifest.h"
+#include "fw_util.h"
 #include "generated_defaults.h"
+#include "generated_web_ui.h"
+#include "esp_attr.h"
 #include "esp_event.h"
+#include "esp_heap_caps.h"
 #include "esp_http_client.h"
 #include "esp_http_server.h"
 #include "esp_log.h"
+#include "esp_mac.h"
 #include "esp_netif.h"
 #include "esp_ota_ops.h"
+#include "esp_pm.h"
+#include "esp_random.h"
+#include "esp_sntp.h"
 #include "esp_system.h"
+#include "esp_timer.h"
 #include "esp_wifi.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/event_groups.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
 #include "lwip/inet.h"
 #include "lwip/ip4_addr.h"
+#include "lwip/sockets.h"
 #include "mbedtls/md.h"
 #include "mbedtls/sha256.h"
+#if CONFIG_EIGHTBB_MDNS
+#include "mdns.h"
+#endif
+#if CONFIG_EIGHTBB_MQTT
+#include "mqtt_client.h"
+#endif
 #include "nvs.h"
 #include "nvs_flash.h"
+#if CONFIG_IDF_TARGET_ESP32
+#include "soc/gpio_struct.h"
+#endif
 
 #define TAG "8BB_FW"
 
-#define MAX_STR 96
 #define OTA_BUFFER_MAX 8192
 #define WIFI_CONNECTED_BIT BIT0
 #define WIFI_FAIL_BIT BIT1
-#define MAX_RELAYS 8
+#define WIFI_STA_MAX_RETRIES 5
+#define WIFI_STA_CONNECT_TIMEOUT_MS 15000
+#define WIFI_BACKOFF_BASE_MS 500
+#define WIFI_BACKOFF_MAX_MS 60000
+#define MAX_EVENT_CLIENTS 8
 #define WEB_STATUS_LED_PIN GPIO_NUM_2
 
 /* GPIO and PWM mapping for default reference board. */
@@ -49,6 +85,39 @@
 #define RGB_W_PIN GPIO_NUM_14
 #define FAN_SPEED_PIN GPIO_NUM_33
 
+#ifndef FW_BUILD_VERSION
+#define FW_BUILD_VERSION "0.3.0"
+#endif
+/* httpd tuning (overridable from generated_defaults.h). httpd reserves 3 lwIP sockets itself; the rest of
+ * CONFIG_LWIP_MAX_SOCKETS is left for the UDP control/discovery sockets, MQTT and OTA/HTTP clients. */
+#ifndef HTTPD_CFG_MAX_SOCKETS
+#define HTTPD_CFG_MAX_SOCKETS 10
+#endif
+#ifndef HTTPD_CFG_MAX_URI_HANDLERS
+#define HTTPD_CFG_MAX_URI_HANDLERS 24
+#endif
+#ifndef HTTPD_CFG_STACK_SIZE
+#define HTTPD_CFG_STACK_SIZE 5120
+#endif
+#ifndef HTTPD_CFG_LRU_PURGE
+#define HTTPD_CFG_LRU_PURGE 1
+#endif
+#ifndef HTTPD_CFG_KEEP_ALIVE
+#define HTTPD_CFG_KEEP_ALIVE 1
+#endif
+/* Per-client request budgets (requests/s and burst) and the in-flight cap; see http_admit(). */
+#ifndef HTTPD_CFG_RL_CONTROL_PER_S
+#define HTTPD_CFG_RL_CONTROL_PER_S 20
+#endif
+#ifndef HTTPD_CFG_RL_STATUS_PER_S
+#define HTTPD_CFG_RL_STATUS_PER_S 5
+#endif
+#ifndef HTTPD_CFG_RL_BULK_PER_S
+#define HTTPD_CFG_RL_BULK_PER_S 1
+#endif
+#ifndef HTTPD_CFG_INFLIGHT_MAX
+#define HTTPD_CFG_INFLIGHT_MAX 6
+#endif
 #ifndef FW_DEFAULT_RELAY_COUNT
 #define FW_DEFAULT_RELAY_COUNT 4
 #endif
@@ -76,50 +145,18 @@
 #ifndef FW_DEFAULT_RELAY_GPIO_8
 #define FW_DEFAULT_RELAY_GPIO_8 -1
 #endif
-
-typedef struct {
-    char name[MAX_STR];
-    char type[MAX_STR];
-    char passcode[MAX_STR];
-    int relay_count;
-    int relay_gpio[MAX_RELAYS];
-    char wifi_ssid[MAX_STR];
-    char wifi_pass[MAX_STR];
-    char ap_ssid[MAX_STR];
-    char ap_pass[MAX_STR];
-    bool use_static_ip;
-    char static_ip[MAX_STR];
-    char gateway[MAX_STR];
-    char subnet_mask[MAX_STR];
-    char ota_key[MAX_STR];
-    char device_id[MAX_STR];
-    char relay_names[MAX_RELAYS][MAX_STR];
-} device_config_t;
-
-typedef struct {
-    bool relay[MAX_RELAYS];
-    bool light_single;
-    int dimmer_pct;
-    int rgb[4];
-    bool fan_power;
-    int fan_speed_pct;
-} output_state_t;
-
-typedef struct {
-    char name[MAX_STR];
-    char type[MAX_STR];
-    char passcode[MAX_STR];
-    int relay_gpio[4];
-    char wifi_ssid[MAX_STR];
-    char wifi_pass[MAX_STR];
-    char ap_ssid[MAX_STR];
-    char ap_pass[MAX_STR];
-    bool use_static_ip;
-    char static_ip[MAX_STR];
-    char gateway[MAX_STR];
-    char subnet_mask[MAX_STR];
-    char ota_key[MAX_STR];
-} legacy_device_config_v1_t;
+#ifndef FW_DEFAULT_RESTORE_OUTPUTS
+#define FW_DEFAULT_RESTORE_OUTPUTS 0
+#endif
+#ifndef FW_DEFAULT_TIMEZONE
+#define FW_DEFAULT_TIMEZONE "UTC0"
+#endif
+#ifndef FW_DEFAULT_NTP_SERVER
+#define FW_DEFAULT_NTP_SERVER "pool.ntp.org"
+#endif
+#ifndef FW_DEFAULT_MQTT_PREFIX
+#define FW_DEFAULT_MQTT_PREFIX "8bb"
+#endif
 
 static device_config_t g_cfg = {
     .name = FW_DEFAULT_NAME,
@@ -156,68 +193,196 @@ static device_config_t g_cfg = {
         "Relay 7",
         "Relay 8",
     },
+    .restore_outputs = FW_DEFAULT_RESTORE_OUTPUTS,
+    .state_save_delay_ms = STATE_SAVE_DELAY_DEFAULT_MS,
+    .timezone = FW_DEFAULT_TIMEZONE,
+    .ntp_server = FW_DEFAULT_NTP_SERVER,
+    .mqtt_prefix = FW_DEFAULT_MQTT_PREFIX,
+    .power_profile = POWER_PROFILE_PERFORMANCE,
+    .power_wake_hold_ms = POWER_WAKE_HOLD_DEFAULT_MS,
+    .power_listen_interval = POWER_LISTEN_INTERVAL_DEFAULT,
 };
 
-static output_state_t g_state = {0};
 static httpd_handle_t g_server = NULL;
 static EventGroupHandle_t g_wifi_events;
 static int g_sta_fail_count = 0;
+
+typedef enum {
+    WIFI_STATE_IDLE,
+    WIFI_STATE_CONNECTING,
+    WIFI_STATE_CONNECTED,
+    WIFI_STATE_BACKOFF,
+    WIFI_STATE_AP_ONLY,
+} wifi_state_t;
+
+static const char *const WIFI_STATE_NAMES[] = {"idle", "connecting", "connected", "backoff", "ap_only"};
+static wifi_state_t g_wifi_state = WIFI_STATE_IDLE;
+static bool g_wifi_ap_active = false;
+
+/* Reconnect timings reported under network.reconnect in /api/status. */
+typedef struct {
+    uint32_t connects;
+    uint32_t disconnects;
+    int32_t last_connect_ms;
+    bool last_fast;
+    int64_t outage_start_us;
+    int64_t next_retry_us;
+} wifi_timing_t;
+
+static wifi_timing_t g_wifi_timing = {.last_connect_ms = -1};
 static int g_last_wifi_disc_reason = 0;
 static bool g_web_led_enabled = false;
 static esp_netif_t *g_sta_netif = NULL;
 static esp_netif_t *g_ap_netif = NULL;
 
-/* LEDC channel allocation for dimmer/RGB/fan. */
-static const ledc_channel_t CH_DIMMER = LEDC_CHANNEL_0;
-static const ledc_channel_t CH_RGB_R = LEDC_CHANNEL_1;
-static const ledc_channel_t CH_RGB_G = LEDC_CHANNEL_2;
-static const ledc_channel_t CH_RGB_B = LEDC_CHANNEL_3;
-static const ledc_channel_t CH_RGB_W = LEDC_CHANNEL_4;
-static const ledc_channel_t CH_FAN = LEDC_CHANNEL_5;
-static const int SAFE_SCAN_GPIOS[] = {2, 4, 5, 12, 13, 14, 15, 16, 17, 18, 19, 21, 22, 23, 25, 26, 27, 32, 33};
-static void safe_strcpy(char *dst, const char *src, size_t dst_size);
+/* Push stream (/api/events) client sockets and last published output snapshot. */
+static int g_event_fds[MAX_EVENT_CLIENTS];
+static int g_event_client_count = 0;
+static uint32_t g_event_seq = 0;
+static output_state_t g_published_state = {0};
+static portMUX_TYPE g_event_lock = portMUX_INITIALIZER_UNLOCKED;
+
+/* Generation counters behind the /api/status tiers and their ETags. */
+static uint32_t g_cfg_generation = 1;
+static uint32_t g_state_generation = 1;
+static uint32_t g_net_generation = 1;
+/* Drawn on the first status request; part of every status ETag so none repeats across reboots. */
+static uint32_t g_status_boot_id = 0;
+static char *g_status_cfg_cache = NULL;
+static uint32_t g_status_cfg_cache_gen = 0;
+
+/* Flash wear counters exported on /api/metrics. */
+typedef struct {
+    uint32_t config_saves;
+    uint32_t config_section_writes;
+    uint32_t state_writes;
+    uint32_t wifi_cache_writes;
+    uint32_t ota_cache_writes;
+} nvs_stats_t;
+
+static nvs_stats_t g_nvs_stats = {0};
+
+/* LEDC channel allocation for dimmer/RGB/fan, matching the core's FW_PWM_* numbering. */
+static const ledc_channel_t CH_DIMMER = (ledc_channel_t)FW_PWM_DIMMER;
+static const ledc_channel_t CH_RGB_R = (ledc_channel_t)FW_PWM_RGB_R;
+static const ledc_channel_t CH_RGB_G = (ledc_channel_t)FW_PWM_RGB_G;
+static const ledc_channel_t CH_RGB_B = (ledc_channel_t)FW_PWM_RGB_B;
+static const ledc_channel_t CH_RGB_W = (ledc_channel_t)FW_PWM_RGB_W;
+static const ledc_channel_t CH_FAN = (ledc_channel_t)FW_PWM_FAN;
+/* Channels bound to a GPIO; writes to the rest would stall the fade engine waiting on an ISR that never fires. */
+static uint32_t g_ledc_ready_mask = 0;
+static bool g_ledc_fade_ready = false;
+
+/* Actuation: g_state, g_cfg, g_channels, the auto-off table and the schedule/input tables are only
+ * changed by jobs that run on one high-priority task pinned to ACT_CORE. Network, parsing and
+ * persistence run on NET_CORE and hand their ops over through g_act_q. act_call() blocks the
+ * caller on a stack semaphore until its job ran, so results come back without shared state; other
+ * tasks read outputs through outputs_snapshot(). */
+#if CONFIG_FREERTOS_UNICORE
+#define ACT_CORE 0
+#else
+#define ACT_CORE 1
+#endif
+#define NET_CORE 0
+#define ACT_PRIORITY 15
+#define ACT_STACK 4096
+#define ACT_QUEUE_LEN 16
 
-static void set_default_relay_names(void) {
-    for (int i = 0; i < MAX_RELAYS; i++) {
-        if (g_cfg.relay_names[i][0] == '\0') {
-            snprintf(g_cfg.relay_names[i], sizeof(g_cfg.relay_names[i]), "Relay %d", i + 1);
-        }
+typedef void (*act_fn_t)(void *ctx);
+
+typedef struct {
+    act_fn_t fn;
+    void *ctx;
+    SemaphoreHandle_t done; /* NULL for act_post */
+    int64_t queued_us;
+} act_job_t;
+
+static QueueHandle_t g_act_q = NULL;
+static TaskHandle_t g_act_task = NULL;
+/* Only created if the task cannot start; callers then serialise on it instead. */
+static SemaphoreHandle_t g_act_fallback_lock = NULL;
+/* Queue wait of the last and the slowest job, for /api/metrics. */
+static uint32_t g_act_jobs = 0;
+static uint32_t g_act_dropped = 0;
+static int32_t g_act_last_wait_us = 0;
+static int32_t g_act_max_wait_us = 0;
+
+static void act_task(void *arg) {
+    (void)arg;
+    act_job_t job;
+    for (;;) {
+        if (xQueueReceive(g_act_q, &job, portMAX_DELAY) != pdTRUE) continue;
+        int32_t wait_us = (int32_t)(esp_timer_get_time() - job.queued_us);
+        g_act_last_wait_us = wait_us;
+        if (wait_us > g_act_max_wait_us) g_act_max_wait_us = wait_us;
+        g_act_jobs++;
+        job.fn(job.ctx);
+        if (job.done) xSemaphoreGive(job.done);
     }
 }
 
-static void ensure_device_id(void) {
-    if (g_cfg.device_id[0] == '\0') {
-        safe_strcpy(g_cfg.device_id, g_cfg.name, sizeof(g_cfg.device_id));
+/* Runs fn(ctx) on the actuation task and returns once it has run. Called from the task itself, or
+ * at boot before it starts, fn runs inline. */
+static void act_call(act_fn_t fn, void *ctx) {
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+    if (g_act_task && self != g_act_task) {
+        StaticSemaphore_t done_buf;
+        act_job_t job = {.fn = fn, .ctx = ctx, .done = xSemaphoreCreateBinaryStatic(&done_buf), .queued_us = esp_timer_get_time()};
+        xQueueSend(g_act_q, &job, portMAX_DELAY);
+        xSemaphoreTake(job.done, portMAX_DELAY);
+        vSemaphoreDelete(job.done);
+        return;
     }
+    if (g_act_fallback_lock) xSemaphoreTakeRecursive(g_act_fallback_lock, portMAX_DELAY);
+    fn(ctx);
+    if (g_act_fallback_lock) xSemaphoreGiveRecursive(g_act_fallback_lock);
 }
 
-static void safe_strcpy(char *dst, const char *src, size_t dst_size) {
-    if (!dst || !src || dst_size == 0) return;
-    snprintf(dst, dst_size, "%s", src);
+/* Queues fn(ctx) without waiting, for callers that must not block. ctx has to stay valid until the
+ * job runs, so pass values rather than stack pointers. False when the queue is full. */
+static bool act_post(act_fn_t fn, void *ctx) {
+    if (!g_act_task) {
+        act_call(fn, ctx);
+        return true;
+    }
+    act_job_t job = {.fn = fn, .ctx = ctx, .done = NULL, .queued_us = esp_timer_get_time()};
+    if (xQueueSend(g_act_q, &job, 0) == pdTRUE) return true;
+    g_act_dropped++;
+    return false;
 }
 
-static void sanitize_wifi_field(char *value) {
-    if (!value) return;
-    size_t read_idx = 0;
-    size_t write_idx = 0;
-    while (value[read_idx] != '\0') {
-        char c = value[read_idx++];
-        if (c == '\r' || c == '\n' || c == '\t') {
-            continue;
+static void start_actuator(void) {
+    g_act_q = xQueueCreate(ACT_QUEUE_LEN, sizeof(act_job_t));
+    if (g_act_q && xTaskCreatePinnedToCore(act_task, "actuator", ACT_STACK, NULL, ACT_PRIORITY, &g_act_task, ACT_CORE) == pdPASS) return;
+    ESP_LOGE(TAG, "Actuation task start failed; control runs on the calling task");
+    g_act_task = NULL;
+    g_act_fallback_lock = xSemaphoreCreateRecursiveMutex();
+}
+
+/* Outputs as last published by the actuation task; safe from any task. */
+static void outputs_snapshot(output_state_t *out) {
+    portENTER_CRITICAL(&g_event_lock);
+    *out = g_published_state;
+    portEXIT_CRITICAL(&g_event_lock);
+}
+
+static void write_current_outputs_json(json_writer_t *jw) {
+    output_state_t st;
+    outputs_snapshot(&st);
+    write_outputs_json(jw, &st, g_cfg.relay_count);
+}
+
+static void set_default_relay_names(void) {
+    for (int i = 0; i < MAX_RELAYS; i++) {
+        if (g_cfg.relay_names[i][0] == '\0') {
+            snprintf(g_cfg.relay_names[i], sizeof(g_cfg.relay_names[i]), "Relay %d", i + 1);
         }
-        value[write_idx++] = c;
     }
-    value[write_idx] = '\0';
+}
 
-    while (write_idx > 0 && (value[write_idx - 1] == ' ')) {
-        value[--write_idx] = '\0';
-    }
-    size_t start = 0;
-    while (value[start] == ' ') {
-        start++;
-    }
-    if (start > 0) {
-        memmove(value, value + start, strlen(value + start) + 1);
+static void ensure_device_id(void) {
+    if (g_cfg.device_id[0] == '\0') {
+        safe_strcpy(g_cfg.device_id, g_cfg.name, sizeof(g_cfg.device_id));
     }
 }
 
@@ -230,34 +395,24 @@ static size_t copy_wifi_field(uint8_t *dst, size_t dst_size, const char *src) {
     return len;
 }
 
-static int clamp_int(int value, int min_val, int max_val) {
-    if (value < min_val) return min_val;
-    if (value > max_val) return max_val;
-    return value;
-}
-
-static void sanitize_relay_count(void) {
-    g_cfg.relay_count = clamp_int(g_cfg.relay_count, 1, MAX_RELAYS);
-}
-
-static bool valid_output_gpio_int(int pin) {
-    return pin >= 0 && pin <= 39 && GPIO_IS_VALID_OUTPUT_GPIO(pin);
-}
-
-static bool is_safe_scan_gpio_int(int pin) {
-    for (size_t i = 0; i < sizeof(SAFE_SCAN_GPIOS) / sizeof(SAFE_SCAN_GPIOS[0]); i++) {
-        if (SAFE_SCAN_GPIOS[i] == pin) return true;
+/* Clears schedule slots a corrupt or foreign blob left unusable. */
+static void sanitize_automation_config(void) {
+    g_cfg.timezone[sizeof(g_cfg.timezone) - 1] = '\0';
+    g_cfg.ntp_server[sizeof(g_cfg.ntp_server) - 1] = '\0';
+    if (g_cfg.timezone[0] == '\0') snprintf(g_cfg.timezone, sizeof(g_cfg.timezone), "%s", FW_DEFAULT_TIMEZONE);
+    for (int i = 0; i < MAX_SCHEDULES; i++) {
+        schedule_entry_t *e = &g_cfg.schedules[i];
+        if (e->channel == CTRL_CH_NONE || e->channel >= CTRL_CH_COUNT || e->action >= CTRL_ACT_KEEP || e->minute >= 24 * 60 ||
+            (e->days & 0x7f) == 0 || e->duration_ms > MAX_DURATION_MS) {
+            memset(e, 0, sizeof(*e)); /* unused slots are all zero */
+        }
     }
-    return false;
-}
-
-static bool valid_relay_gpio_int(int pin) {
-    return valid_output_gpio_int(pin) && is_safe_scan_gpio_int(pin);
 }
 
+/* Read-only: g_cfg is sanitized when it is committed or loaded, the clamp only bounds the loop. */
 static bool relay_pin_in_use(int pin) {
-    sanitize_relay_count();
-    for (int i = 0; i < g_cfg.relay_count; i++) {
+    int count = clamp_int(g_cfg.relay_count, 0, MAX_RELAYS);
+    for (int i = 0; i < count; i++) {
         if (g_cfg.relay_gpio[i] == pin) return true;
     }
     return false;
@@ -267,6 +422,40 @@ static bool aux_pin_available(int pin) {
     return valid_output_gpio_int(pin) && !relay_pin_in_use(pin);
 }
 
+/* Inputs may not share a pin with any mapped relay (inactive relays are still driven low), the fixed
+ * aux/PWM outputs, the status LED or an earlier input. */
+static bool input_pin_available(int pin, int self) {
+    static const int reserved[] = {
+        LIGHT_SINGLE_PIN, FAN_POWER_PIN, DIMMER_PIN, RGB_R_PIN, RGB_G_PIN, RGB_B_PIN, RGB_W_PIN, FAN_SPEED_PIN, WEB_STATUS_LED_PIN,
+    };
+    if (!is_safe_scan_gpio_int(pin)) return false;
+    for (size_t i = 0; i < sizeof(reserved) / sizeof(reserved[0]); i++) {
+        if (reserved[i] == pin) return false;
+    }
+    for (int i = 0; i < MAX_RELAYS; i++) {
+        if (g_cfg.relay_gpio[i] == pin) return false;
+    }
+    for (int i = 0; i < self; i++) {
+        if (g_cfg.inputs[i].enabled && g_cfg.inputs[i].gpio == pin) return false;
+    }
+    return true;
+}
+
+/* Clears input and binding slots with impossible values; pin conflicts are checked at setup time. */
+static void sanitize_input_config(void) {
+    for (int i = 0; i < MAX_INPUTS; i++) {
+        input_entry_t *in = &g_cfg.inputs[i];
+        if (in->enabled && (!is_safe_scan_gpio_int(in->gpio) || in->mode > INPUT_MODE_SWITCH)) memset(in, 0, sizeof(*in));
+    }
+    for (int i = 0; i < MAX_INPUT_BINDINGS; i++) {
+        input_binding_t *b = &g_cfg.input_bindings[i];
+        if (b->channel == CTRL_CH_NONE || b->channel >= CTRL_CH_COUNT || b->action >= CTRL_ACT_KEEP || b->input >= MAX_INPUTS ||
+            b->event >= INPUT_EV_COUNT || b->duration_ms > MAX_DURATION_MS) {
+            memset(b, 0, sizeof(*b));
+        }
+    }
+}
+
 static void set_web_status_led(bool on) {
     if (!g_web_led_enabled) return;
     gpio_set_level(WEB_STATUS_LED_PIN, on ? 1 : 0);
@@ -288,26 +477,8 @@ static void setup_web_status_led(void) {
     g_web_led_enabled = true;
 }
 
-static void sanitize_relay_gpio_map(void) {
-    sanitize_relay_count();
-    for (int i = 0; i < MAX_RELAYS; i++) {
-        int pin = g_cfg.relay_gpio[i];
-        if (pin == -1) continue;
-        if (!valid_relay_gpio_int(pin)) {
-            g_cfg.relay_gpio[i] = -1;
-            continue;
-        }
-        for (int j = 0; j < i; j++) {
-            if (g_cfg.relay_gpio[j] == pin) {
-                g_cfg.relay_gpio[i] = -1;
-                break;
-            }
-        }
-    }
-}
-
 static void configure_relay_gpio_outputs(void) {
-    sanitize_relay_gpio_map();
+    sanitize_relay_gpio_map(&g_cfg);
     for (int i = 0; i < MAX_RELAYS; i++) {
         if (!valid_relay_gpio_int(g_cfg.relay_gpio[i])) continue;
         gpio_num_t pin = (gpio_num_t)g_cfg.relay_gpio[i];
@@ -316,29 +487,62 @@ static void configure_relay_gpio_outputs(void) {
     }
 }
 
-static void hex_encode(const unsigned char *input, size_t len, char *out, size_t out_size) {
-    const char *hex = "0123456789abcdef";
-    size_t need = len * 2 + 1;
-    if (out_size < need) return;
-    for (size_t i = 0; i < len; i++) {
-        out[i * 2] = hex[(input[i] >> 4) & 0xF];
-        out[i * 2 + 1] = hex[input[i] & 0xF];
+/* HAL: HMAC-SHA256 built on a stack SHA context; mbedtls_md_hmac allocates its contexts per call. */
+void hal_hmac_sha256(const uint8_t *key, size_t key_len, const uint8_t *msg, size_t msg_len, uint8_t out[32]) {
+    uint8_t k[64] = {0};
+    uint8_t pad[64];
+    mbedtls_sha256_context ctx;
+    if (key_len > sizeof(k)) {
+        mbedtls_sha256(key, key_len, k, 0);
+    } else {
+        memcpy(k, key, key_len);
     }
-    out[len * 2] = '\0';
+    mbedtls_sha256_init(&ctx);
+    for (size_t i = 0; i < sizeof(pad); i++) pad[i] = k[i] ^ 0x36;
+    mbedtls_sha256_starts(&ctx, 0);
+    mbedtls_sha256_update(&ctx, pad, sizeof(pad));
+    mbedtls_sha256_update(&ctx, msg, msg_len);
+    mbedtls_sha256_finish(&ctx, out);
+    for (size_t i = 0; i < sizeof(pad); i++) pad[i] = k[i] ^ 0x5c;
+    mbedtls_sha256_starts(&ctx, 0);
+    mbedtls_sha256_update(&ctx, pad, sizeof(pad));
+    mbedtls_sha256_update(&ctx, out, 32);
+    mbedtls_sha256_finish(&ctx, out);
+    mbedtls_sha256_free(&ctx);
 }
 
-static void save_config_to_nvs(void);
-
-static void load_config_from_nvs(void) {
-    nvs_handle_t nvs;
-    if (nvs_open("cfg", NVS_READONLY, &nvs) != ESP_OK) {
-        ESP_LOGW(TAG, "NVS cfg not found, using defaults");
-        sanitize_relay_count();
-        sanitize_relay_gpio_map();
-        ensure_device_id();
-        set_default_relay_names();
-        return;
+/* Hash of each section as it currently sits in flash; a save skips sections that still match. */
+static uint32_t g_cfg_section_hash[CFG_SECTION_COUNT];
+static bool g_cfg_section_stored[CFG_SECTION_COUNT];
+static bool g_cfg_layout_stored = false;
+
+static bool load_config_sections(nvs_handle_t nvs) {
+    uint8_t layout = 0;
+    if (nvs_get_u8(nvs, "layout", &layout) != ESP_OK || layout < CFG_LAYOUT_VERSION) return false;
+    g_cfg_layout_stored = true;
+    for (size_t i = 0; i < CFG_SECTION_COUNT; i++) {
+        const cfg_section_t *sec = &CFG_SECTIONS[i];
+        size_t len = 0;
+        if (nvs_get_blob(nvs, sec->key, NULL, &len) != ESP_OK || len == 0) {
+            ESP_LOGW(TAG, "Config section %s missing, using defaults", sec->key);
+            continue;
+        }
+        uint8_t *raw = malloc(len);
+        if (!raw) continue;
+        if (nvs_get_blob(nvs, sec->key, raw, &len) == ESP_OK) {
+            cfg_section_unpack(sec, &g_cfg, raw, len);
+            g_cfg_section_hash[i] = fnv1a_update(FNV1A_INIT, raw, len);
+            g_cfg_section_stored[i] = true;
+        }
+        free(raw);
     }
+    ESP_LOGI(TAG, "Loaded config sections layout=%u", (unsigned)layout);
+    return true;
+}
+
+/* Pre-section firmware stored the whole device_config_t under "device"; it is read once to migrate
+ * and left in place so a rollback to older firmware still finds its config. */
+static void load_config_blob(nvs_handle_t nvs) {
     size_t stored_len = 0;
     esp_err_t err = nvs_get_blob(nvs, "device", NULL, &stored_len);
     if (err == ESP_OK && stored_len > 0) {
@@ -346,28 +550,9 @@ static void load_config_from_nvs(void) {
         if (raw) {
             size_t read_len = stored_len;
             if (nvs_get_blob(nvs, "device", raw, &read_len) == ESP_OK) {
-                if (stored_len == sizeof(legacy_device_config_v1_t)) {
-                    legacy_device_config_v1_t legacy = {0};
-                    memcpy(&legacy, raw, sizeof(legacy));
+                if (cfg_load_device_blob(&g_cfg, raw, stored_len)) {
                     ESP_LOGW(TAG, "Loaded legacy config from NVS, migrating");
-                    safe_strcpy(g_cfg.name, legacy.name, sizeof(g_cfg.name));
-                    safe_strcpy(g_cfg.type, legacy.type, sizeof(g_cfg.type));
-                    safe_strcpy(g_cfg.passcode, legacy.passcode, sizeof(g_cfg.passcode));
-                    g_cfg.relay_count = 4;
-                    for (int i = 0; i < 4; i++) g_cfg.relay_gpio[i] = legacy.relay_gpio[i];
-                    for (int i = 4; i < MAX_RELAYS; i++) g_cfg.relay_gpio[i] = -1;
-                    safe_strcpy(g_cfg.wifi_ssid, legacy.wifi_ssid, sizeof(g_cfg.wifi_ssid));
-                    safe_strcpy(g_cfg.wifi_pass, legacy.wifi_pass, sizeof(g_cfg.wifi_pass));
-                    safe_strcpy(g_cfg.ap_ssid, legacy.ap_ssid, sizeof(g_cfg.ap_ssid));
-                    safe_strcpy(g_cfg.ap_pass, legacy.ap_pass, sizeof(g_cfg.ap_pass));
-                    g_cfg.use_static_ip = legacy.use_static_ip;
-                    safe_strcpy(g_cfg.static_ip, legacy.static_ip, sizeof(g_cfg.static_ip));
-                    safe_strcpy(g_cfg.gateway, legacy.gateway, sizeof(g_cfg.gateway));
-                    safe_strcpy(g_cfg.subnet_mask, legacy.subnet_mask, sizeof(g_cfg.subnet_mask));
-                    safe_strcpy(g_cfg.ota_key, legacy.ota_key, sizeof(g_cfg.ota_key));
                 } else {
-                    size_t copy_len = stored_len < sizeof(g_cfg) ? stored_len : sizeof(g_cfg);
-                    memcpy(&g_cfg, raw, copy_len);
                     ESP_LOGI(TAG, "Loaded config from NVS len=%u", (unsigned)stored_len);
                 }
             } else {
@@ -383,254 +568,1536 @@ static void load_config_from_nvs(void) {
         err = nvs_get_blob(nvs, "device", &legacy, &len);
         if (err == ESP_OK) {
             ESP_LOGW(TAG, "Loaded legacy config from NVS, migrating");
-            safe_strcpy(g_cfg.name, legacy.name, sizeof(g_cfg.name));
-            safe_strcpy(g_cfg.type, legacy.type, sizeof(g_cfg.type));
-            safe_strcpy(g_cfg.passcode, legacy.passcode, sizeof(g_cfg.passcode));
-            g_cfg.relay_count = 4;
-            for (int i = 0; i < 4; i++) g_cfg.relay_gpio[i] = legacy.relay_gpio[i];
-            for (int i = 4; i < MAX_RELAYS; i++) g_cfg.relay_gpio[i] = -1;
-            safe_strcpy(g_cfg.wifi_ssid, legacy.wifi_ssid, sizeof(g_cfg.wifi_ssid));
-            safe_strcpy(g_cfg.wifi_pass, legacy.wifi_pass, sizeof(g_cfg.wifi_pass));
-            safe_strcpy(g_cfg.ap_ssid, legacy.ap_ssid, sizeof(g_cfg.ap_ssid));
-            safe_strcpy(g_cfg.ap_pass, legacy.ap_pass, sizeof(g_cfg.ap_pass));
-            g_cfg.use_static_ip = legacy.use_static_ip;
-            safe_strcpy(g_cfg.static_ip, legacy.static_ip, sizeof(g_cfg.static_ip));
-            safe_strcpy(g_cfg.gateway, legacy.gateway, sizeof(g_cfg.gateway));
-            safe_strcpy(g_cfg.subnet_mask, legacy.subnet_mask, sizeof(g_cfg.subnet_mask));
-            safe_strcpy(g_cfg.ota_key, legacy.ota_key, sizeof(g_cfg.ota_key));
+            cfg_migrate_legacy_v1(&g_cfg, &legacy);
         } else {
             ESP_LOGW(TAG, "Config read failed, using defaults");
         }
     }
+}
+
+static void save_config_to_nvs(void);
+
+static void load_config_from_nvs(void) {
+    nvs_handle_t nvs;
+    if (nvs_open("cfg", NVS_READONLY, &nvs) != ESP_OK) {
+        ESP_LOGW(TAG, "NVS cfg not found, using defaults");
+        sanitize_relay_count(&g_cfg);
+        sanitize_relay_gpio_map(&g_cfg);
+        ensure_device_id();
+        set_default_relay_names();
+        return;
+    }
+    if (!load_config_sections(nvs)) load_config_blob(nvs);
     nvs_close(nvs);
-    sanitize_relay_count();
-    sanitize_relay_gpio_map();
+    sanitize_relay_count(&g_cfg);
+    sanitize_state_save_delay(&g_cfg);
+    sanitize_power_config(&g_cfg);
+    sanitize_automation_config();
+    sanitize_relay_gpio_map(&g_cfg);
+    sanitize_input_config();
     sanitize_wifi_field(g_cfg.wifi_ssid);
     sanitize_wifi_field(g_cfg.wifi_pass);
     sanitize_wifi_field(g_cfg.ap_ssid);
     sanitize_wifi_field(g_cfg.ap_pass);
     ensure_device_id();
     set_default_relay_names();
+    /* Only sections that migration or sanitizing actually changed get written here. */
     save_config_to_nvs();
 }
 
+/* The 32-bit hash only says a section may be unchanged; the bytes in flash decide, so a collision
+ * can never drop a save. */
+static bool cfg_section_matches_stored(nvs_handle_t nvs, const char *key, const uint8_t *raw, size_t len) {
+    uint8_t *stored = malloc(len);
+    if (!stored) return false;
+    size_t stored_len = len;
+    bool same = nvs_get_blob(nvs, key, stored, &stored_len) == ESP_OK && stored_len == len && memcmp(stored, raw, len) == 0;
+    free(stored);
+    return same;
+}
+
 static void save_config_to_nvs(void) {
     nvs_handle_t nvs;
     if (nvs_open("cfg", NVS_READWRITE, &nvs) != ESP_OK) {
         ESP_LOGE(TAG, "NVS open failed");
         return;
     }
-    nvs_set_blob(nvs, "device", &g_cfg, sizeof(g_cfg));
-    nvs_commit(nvs);
+    int written = 0;
+    bool all_stored = true;
+    for (size_t i = 0; i < CFG_SECTION_COUNT; i++) {
+        const cfg_section_t *sec = &CFG_SECTIONS[i];
+        uint32_t hash = cfg_section_hash(sec, &g_cfg);
+        bool maybe_same = g_cfg_section_stored[i] && g_cfg_section_hash[i] == hash;
+        size_t len = cfg_section_size(sec);
+        uint8_t *raw = malloc(len);
+        esp_err_t err = ESP_ERR_NO_MEM;
+        if (raw) {
+            cfg_section_pack(sec, &g_cfg, raw);
+            if (maybe_same && cfg_section_matches_stored(nvs, sec->key, raw, len)) {
+                free(raw);
+                continue;
+            }
+            err = nvs_set_blob(nvs, sec->key, raw, len);
+            free(raw);
+        }
+        if (err != ESP_OK) {
+            ESP_LOGE(TAG, "Config section %s write failed: %s", sec->key, esp_err_to_name(err));
+            all_stored = false;
+            continue;
+        }
+        g_cfg_section_hash[i] = hash;
+        g_cfg_section_stored[i] = true;
+        written++;
+    }
+    /* The layout marker goes last so an interrupted migration falls back to the legacy blob. */
+    if (!g_cfg_layout_stored && all_stored && nvs_set_u8(nvs, "layout", CFG_LAYOUT_VERSION) == ESP_OK) {
+        g_cfg_layout_stored = true;
+        written++;
+    }
+    if (written > 0) nvs_commit(nvs);
     nvs_close(nvs);
-    ESP_LOGI(TAG, "Config saved");
+    if (written == 0) {
+        ESP_LOGD(TAG, "Config unchanged, nothing written");
+        return;
+    }
+    g_cfg_generation++;
+    g_nvs_stats.config_saves++;
+    g_nvs_stats.config_section_writes += (uint32_t)written;
+    ESP_LOGI(TAG, "Config saved gen=%u writes=%d", (unsigned)g_cfg_generation, written);
 }
 
-static esp_err_t send_json(httpd_req_t *req, cJSON *root) {
-    char *body = cJSON_PrintUnformatted(root);
-    if (!body) return ESP_FAIL;
-    httpd_resp_set_type(req, "application/json");
-    esp_err_t err = httpd_resp_send(req, body, HTTPD_RESP_USE_STRLEN);
-    cJSON_free(body);
-    return err;
+/* Per-route request metrics: count, errors and a fixed latency histogram, exported by /api/metrics. */
+#define HTTP_LAT_BUCKETS 14
+
+static const uint32_t HTTP_LAT_BOUNDS_US[HTTP_LAT_BUCKETS] = {
+    1000, 2000, 5000, 10000, 20000, 50000, 100000, 200000, 500000, 1000000, 2000000, 5000000, 10000000, 30000000,
+};
+
+typedef enum {
+    HTTP_AUTH_NONE, /* no Authorization header; the handler falls back to the body passcode */
+    HTTP_AUTH_OK,
+    HTTP_AUTH_BAD,
+} http_auth_t;
+
+/* auth is the session-token check http_route_entry already ran (HTTP_AUTH_NONE on routes without
+ * .auth), so handlers never verify the token a second time. */
+typedef esp_err_t (*http_handler_fn_t)(httpd_req_t *req, http_auth_t auth);
+
+/* Admission classes, in priority order under load. Unlisted routes are STATUS. */
+typedef enum {
+    HTTP_CLASS_STATUS = 0, /* status, metrics, OTA progress, UI assets */
+    HTTP_CLASS_CONTROL,
+    HTTP_CLASS_BULK, /* config, OTA, reboot, pairing */
+    HTTP_CLASS_COUNT,
+} http_class_t;
+
+typedef struct {
+    uint32_t count;
+    uint32_t errors;
+    uint32_t limited;
+    uint64_t sum_us;
+    uint32_t hist[HTTP_LAT_BUCKETS + 1]; /* last bucket is +Inf */
+} http_route_stats_t;
+
+typedef struct {
+    const char *uri;
+    httpd_method_t method;
+    http_handler_fn_t fn;
+    bool async;
+    bool auth; /* takes a session token; a bad one is rejected before the body is read */
+    http_class_t cls;
+    http_route_stats_t stats;
+} http_route_t;
+
+static portMUX_TYPE g_metrics_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static void http_route_record(http_route_t *route, int64_t elapsed_us, bool failed) {
+    if (!route) return;
+    int bucket = 0;
+    while (bucket < HTTP_LAT_BUCKETS && elapsed_us > (int64_t)HTTP_LAT_BOUNDS_US[bucket]) bucket++;
+    portENTER_CRITICAL(&g_metrics_lock);
+    route->stats.count++;
+    route->stats.sum_us += (uint64_t)(elapsed_us > 0 ? elapsed_us : 0);
+    route->stats.hist[bucket]++;
+    if (failed) route->stats.errors++;
+    portEXIT_CRITICAL(&g_metrics_lock);
+}
+
+/* httpd_resp_send_err plus an error count against the route that produced it. */
+static esp_err_t http_send_err(httpd_req_t *req, httpd_err_code_t code, const char *msg) {
+    http_route_t *route = req ? (http_route_t *)req->user_ctx : NULL;
+    if (route) {
+        portENTER_CRITICAL(&g_metrics_lock);
+        route->stats.errors++;
+        portEXIT_CRITICAL(&g_metrics_lock);
+    }
+    return httpd_resp_send_err(req, code, msg);
+}
+
+/* Responses stream through the core JSON writer (fw_json.h) with httpd_resp_send_chunk as the sink.
+ * With req == NULL it renders into the buffer only. */
+static bool jw_httpd_sink(void *ctx, const char *data, size_t len) {
+    return httpd_resp_send_chunk((httpd_req_t *)ctx, data, len) == ESP_OK;
+}
+
+static void jw_init(json_writer_t *jw, httpd_req_t *req, char *buf, size_t cap) {
+    jw_init_sink(jw, req ? jw_httpd_sink : NULL, req, buf, cap);
+    if (req) httpd_resp_set_type(req, "application/json");
+}
+
+static esp_err_t jw_send(json_writer_t *jw) {
+    httpd_req_t *req = (httpd_req_t *)jw->ctx;
+    if (jw->failed) {
+        if (!jw->streamed) return http_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "response render failed");
+        return ESP_FAIL;
+    }
+    if (!jw->streamed) return httpd_resp_send(req, jw->buf, jw->len);
+    if (!jw_flush(jw)) return ESP_FAIL;
+    return httpd_resp_send_chunk(req, NULL, 0);
+}
+
+/* Session tokens from /api/pair are "<expiry><mac>": expiry is 8 hex digits of uptime seconds, mac is
+ * hex of the first 16 bytes of HMAC-SHA256(session key, expiry). The session key is
+ * HMAC-SHA256(per-boot random secret, passcode), so a reboot or passcode change revokes every token. */
+#define SESSION_TOKEN_TTL_S 3600
+#define SESSION_TOKEN_MIN_TTL_S 60
+#define SESSION_TOKEN_MAX_TTL_S 86400
+#define SESSION_TOKEN_EXP_LEN 8
+#define SESSION_TOKEN_MAC_LEN 16
+#define SESSION_TOKEN_LEN (SESSION_TOKEN_EXP_LEN + SESSION_TOKEN_MAC_LEN * 2)
+
+/* Passcode digest and session key are derived once per config commit instead of on every request.
+ * The passcode (UDP control MAC key) and device id are copied in on the actuation task, so tasks on
+ * NET_CORE never read them from g_cfg while a commit may be rewriting it. */
+typedef struct {
+    bool valid;
+    uint8_t boot_secret[32];
+    uint8_t passcode_digest[32];
+    uint8_t session_key[32];
+    char passcode[MAX_STR];
+    char device_id[MAX_STR];
+} auth_cache_t;
+
+static auth_cache_t g_auth_cache = {0};
+static bool g_auth_secret_ready = false;
+static uint32_t g_auth_epoch = 0;
+static portMUX_TYPE g_auth_lock = portMUX_INITIALIZER_UNLOCKED;
+
+/* Called by config_commit_job once the new g_cfg is in place. */
+static void auth_invalidate(void) {
+    portENTER_CRITICAL(&g_auth_lock);
+    g_auth_cache.valid = false;
+    g_auth_epoch++;
+    portEXIT_CRITICAL(&g_auth_lock);
+}
+
+static void auth_source_job(void *ctx) {
+    auth_cache_t *out = (auth_cache_t *)ctx;
+    safe_strcpy(out->passcode, g_cfg.passcode, sizeof(out->passcode));
+    safe_strcpy(out->device_id, g_cfg.device_id, sizeof(out->device_id));
+}
+
+static void auth_snapshot(auth_cache_t *out) {
+    portENTER_CRITICAL(&g_auth_lock);
+    *out = g_auth_cache;
+    uint32_t epoch = g_auth_epoch;
+    bool secret_ready = g_auth_secret_ready;
+    portEXIT_CRITICAL(&g_auth_lock);
+    if (out->valid) return;
+
+    if (!secret_ready) {
+        /* Drawn on first use, once Wi-Fi is up and the RNG is fed by RF noise. */
+        uint8_t secret[32];
+        esp_fill_random(secret, sizeof(secret));
+        portENTER_CRITICAL(&g_auth_lock);
+        if (!g_auth_secret_ready) {
+            memcpy(g_auth_cache.boot_secret, secret, sizeof(secret));
+            g_auth_secret_ready = true;
+        }
+        memcpy(out->boot_secret, g_auth_cache.boot_secret, sizeof(out->boot_secret));
+        portEXIT_CRITICAL(&g_auth_lock);
+    }
+    act_call(auth_source_job, out);
+    size_t pass_len = strlen(out->passcode);
+    mbedtls_sha256((const unsigned char *)out->passcode, pass_len, out->passcode_digest, 0);
+    hal_hmac_sha256(out->boot_secret, sizeof(out->boot_secret), (const uint8_t *)out->passcode, pass_len, out->session_key);
+    out->valid = true;
+    portENTER_CRITICAL(&g_auth_lock);
+    /* A passcode change while deriving leaves the cache empty so the next caller recomputes. */
+    if (g_auth_epoch == epoch) g_auth_cache = *out;
+    portEXIT_CRITICAL(&g_auth_lock);
+}
+
+/* Compares digests so the time taken does not depend on how much of the passcode matched. */
+static bool passcode_matches(const char *candidate) {
+    if (!candidate) return false;
+    auth_cache_t auth;
+    auth_snapshot(&auth);
+    uint8_t digest[32];
+    mbedtls_sha256((const unsigned char *)candidate, strlen(candidate), digest, 0);
+    return constant_time_equal(digest, auth.passcode_digest, sizeof(digest));
+}
+
+static uint32_t uptime_s(void) {
+    return (uint32_t)(esp_timer_get_time() / 1000000);
+}
+
+static void session_token_mac(const auth_cache_t *auth, const char *exp_hex, char out[SESSION_TOKEN_MAC_LEN * 2 + 1]) {
+    uint8_t mac[32];
+    hal_hmac_sha256(auth->session_key, sizeof(auth->session_key), (const uint8_t *)exp_hex, SESSION_TOKEN_EXP_LEN, mac);
+    hex_encode(mac, SESSION_TOKEN_MAC_LEN, out, SESSION_TOKEN_MAC_LEN * 2 + 1);
+}
+
+static void session_token_issue(uint32_t ttl_s, char out[SESSION_TOKEN_LEN + 1]) {
+    auth_cache_t auth;
+    auth_snapshot(&auth);
+    snprintf(out, SESSION_TOKEN_EXP_LEN + 1, "%08x", (unsigned)(uptime_s() + ttl_s));
+    session_token_mac(&auth, out, out + SESSION_TOKEN_EXP_LEN);
+}
+
+static bool session_token_valid(const char *token) {
+    if (strlen(token) != SESSION_TOKEN_LEN) return false;
+    char exp_hex[SESSION_TOKEN_EXP_LEN + 1];
+    memcpy(exp_hex, token, SESSION_TOKEN_EXP_LEN);
+    exp_hex[SESSION_TOKEN_EXP_LEN] = '\0';
+    char *end = NULL;
+    uint32_t exp = (uint32_t)strtoul(exp_hex, &end, 16);
+    uint32_t now = uptime_s();
+    if (*end != '\0' || exp <= now || exp - now > SESSION_TOKEN_MAX_TTL_S) return false;
+
+    auth_cache_t auth;
+    auth_snapshot(&auth);
+    char expected[SESSION_TOKEN_MAC_LEN * 2 + 1];
+    session_token_mac(&auth, exp_hex, expected);
+    return constant_time_equal((const uint8_t *)expected, (const uint8_t *)token + SESSION_TOKEN_EXP_LEN, SESSION_TOKEN_MAC_LEN * 2);
+}
+
+/* Reads only the request headers, so it can run before any of the body is received. */
+static http_auth_t http_session_auth(httpd_req_t *req) {
+    char hdr[sizeof("Bearer ") + SESSION_TOKEN_LEN];
+    esp_err_t err = httpd_req_get_hdr_value_str(req, "Authorization", hdr, sizeof(hdr));
+    if (err == ESP_ERR_NOT_FOUND) return HTTP_AUTH_NONE;
+    if (err != ESP_OK || strncmp(hdr, "Bearer ", 7) != 0) return HTTP_AUTH_BAD;
+    return session_token_valid(hdr + 7) ? HTTP_AUTH_OK : HTTP_AUTH_BAD;
 }
 
 static bool check_passcode(cJSON *root) {
     cJSON *pass = cJSON_GetObjectItem(root, "passcode");
-    return cJSON_IsString(pass) && strcmp(pass->valuestring, g_cfg.passcode) == 0;
+    return cJSON_IsString(pass) && passcode_matches(pass->valuestring);
 }
 
 static bool check_passcode_header(httpd_req_t *req) {
     if (!req) return false;
     char pass[MAX_STR] = {0};
     if (httpd_req_get_hdr_value_str(req, "X-Passcode", pass, sizeof(pass)) != ESP_OK) return false;
-    return strcmp(pass, g_cfg.passcode) == 0;
+    return passcode_matches(pass);
 }
 
-static void add_outputs_json(cJSON *root) {
-    if (!root) return;
-    cJSON *outputs = cJSON_CreateObject();
-    for (int i = 0; i < g_cfg.relay_count; i++) {
-        char key[16] = {0};
-        snprintf(key, sizeof(key), "relay%d", i + 1);
-        cJSON_AddBoolToObject(outputs, key, g_state.relay[i]);
-    }
-    cJSON_AddBoolToObject(outputs, "light", g_state.light_single);
-    cJSON_AddNumberToObject(outputs, "dimmer", g_state.dimmer_pct);
-    cJSON_AddNumberToObject(outputs, "rgb_r", g_state.rgb[0]);
-    cJSON_AddNumberToObject(outputs, "rgb_g", g_state.rgb[1]);
-    cJSON_AddNumberToObject(outputs, "rgb_b", g_state.rgb[2]);
-    cJSON_AddNumberToObject(outputs, "rgb_w", g_state.rgb[3]);
-    cJSON_AddBoolToObject(outputs, "fan_power", g_state.fan_power);
-    cJSON_AddNumberToObject(outputs, "fan_speed", g_state.fan_speed_pct);
-    cJSON_AddItemToObject(root, "outputs", outputs);
+/* A valid session token (as checked by http_route_entry), else the passcode field of the JSON body. */
+static bool check_request_auth(http_auth_t auth, cJSON *root) {
+    return auth == HTTP_AUTH_OK || check_passcode(root);
 }
 
-static void delayed_restart_task(void *arg) {
-    int delay_ms = (int)(intptr_t)arg;
-    if (delay_ms < 50) delay_ms = 50;
-    vTaskDelay(pdMS_TO_TICKS(delay_ms));
-    esp_restart();
+static void events_reset_clients(void) {
+    for (int i = 0; i < MAX_EVENT_CLIENTS; i++) g_event_fds[i] = -1;
+    g_event_client_count = 0;
 }
 
-static void schedule_restart_ms(int delay_ms) {
-    xTaskCreate(delayed_restart_task, "reboot_task", 2048, (void *)(intptr_t)delay_ms, 5, NULL);
+static bool events_add_client(int fd) {
+    int free_slot = -1;
+    for (int i = 0; i < MAX_EVENT_CLIENTS; i++) {
+        if (g_event_fds[i] == fd) return true;
+        if (g_event_fds[i] < 0 && free_slot < 0) free_slot = i;
+    }
+    if (free_slot < 0) return false;
+    g_event_fds[free_slot] = fd;
+    g_event_client_count++;
+    return true;
 }
 
-static void ledc_set_percent(ledc_channel_t channel, int pct) {
-    int val = clamp_int(pct, 0, 100);
-    uint32_t duty = (uint32_t)((val * 255) / 100);
-    ledc_set_duty(LEDC_LOW_SPEED_MODE, channel, duty);
-    ledc_update_duty(LEDC_LOW_SPEED_MODE, channel);
+static void events_remove_client(int fd) {
+    for (int i = 0; i < MAX_EVENT_CLIENTS; i++) {
+        if (g_event_fds[i] != fd) continue;
+        g_event_fds[i] = -1;
+        if (g_event_client_count > 0) g_event_client_count--;
+        ESP_LOGI(TAG, "Event client fd=%d removed (clients=%d)", fd, g_event_client_count);
+    }
 }
 
-static void apply_relay(int idx, bool on) {
-    if (idx < 0 || idx >= MAX_RELAYS) return;
-    if (idx >= g_cfg.relay_count) return;
-    sanitize_relay_gpio_map();
-    int pin = g_cfg.relay_gpio[idx];
-    if (!valid_relay_gpio_int(pin)) return;
-    gpio_set_level((gpio_num_t)pin, on ? 1 : 0);
-    g_state.relay[idx] = on;
+typedef struct {
+    size_t len;
+    char data[];
+} event_frame_t;
+
+/* Runs on the httpd task via httpd_queue_work, so the client list is only touched from one task. */
+static void events_broadcast_work(void *arg) {
+    event_frame_t *frame = (event_frame_t *)arg;
+    if (!frame) return;
+    httpd_ws_frame_t ws = {
+        .final = true,
+        .type = HTTPD_WS_TYPE_TEXT,
+        .payload = (uint8_t *)frame->data,
+        .len = frame->len,
+    };
+    for (int i = 0; i < MAX_EVENT_CLIENTS && g_server; i++) {
+        int fd = g_event_fds[i];
+        if (fd < 0) continue;
+        if (httpd_ws_get_fd_info(g_server, fd) != HTTPD_WS_CLIENT_WEBSOCKET ||
+            httpd_ws_send_frame_async(g_server, fd, &ws) != ESP_OK) {
+            events_remove_client(fd);
+        }
+    }
+    free(frame);
 }
 
-static void apply_light_single(bool on) {
-    if (aux_pin_available(LIGHT_SINGLE_PIN)) {
-        gpio_set_level(LIGHT_SINGLE_PIN, on ? 1 : 0);
+/* Last-state restore: every change is mirrored into RTC memory at once (free, survives warm resets)
+ * and into NVS by a write-behind task once the outputs have been quiet for state_save_delay_ms. */
+#define PERSISTED_OUTPUTS_VERSION 1
+#define RTC_OUTPUTS_MAGIC 0x8b0057a7u
+/* A continuous stream of changes defers the NVS write by at most this many debounce windows. */
+#define STATE_SAVE_MAX_DEFER 4
+
+typedef struct __attribute__((packed)) {
+    uint8_t version;
+    uint8_t relay_mask;
+    uint8_t light_single;
+    uint8_t dimmer_pct;
+    uint8_t rgb[RGB_CHANNELS];
+    uint8_t fan_power;
+    uint8_t fan_speed_pct;
+} persisted_outputs_t;
+
+RTC_NOINIT_ATTR static persisted_outputs_t g_rtc_outputs;
+RTC_NOINIT_ATTR static uint32_t g_rtc_outputs_check;
+
+static TaskHandle_t g_persist_task = NULL;
+static persisted_outputs_t g_nvs_outputs;
+static bool g_nvs_outputs_valid = false;
+
+static void pack_outputs(const output_state_t *st, persisted_outputs_t *out) {
+    memset(out, 0, sizeof(*out));
+    out->version = PERSISTED_OUTPUTS_VERSION;
+    for (int i = 0; i < MAX_RELAYS; i++) {
+        if (st->relay[i]) out->relay_mask |= (uint8_t)(1u << i);
     }
-    g_state.light_single = on;
+    out->light_single = st->light_single ? 1 : 0;
+    out->dimmer_pct = (uint8_t)clamp_int(st->dimmer_pct, 0, 100);
+    for (int i = 0; i < RGB_CHANNELS; i++) out->rgb[i] = (uint8_t)clamp_int(st->rgb[i], 0, 100);
+    out->fan_power = st->fan_power ? 1 : 0;
+    out->fan_speed_pct = (uint8_t)clamp_int(st->fan_speed_pct, 0, 100);
 }
 
-static void apply_dimmer(int pct) {
-    g_state.dimmer_pct = clamp_int(pct, 0, 100);
-    ledc_set_percent(CH_DIMMER, g_state.dimmer_pct);
+static void unpack_outputs(const persisted_outputs_t *in, output_state_t *st) {
+    memset(st, 0, sizeof(*st));
+    for (int i = 0; i < MAX_RELAYS; i++) st->relay[i] = (in->relay_mask >> i) & 1u;
+    st->light_single = in->light_single != 0;
+    st->dimmer_pct = in->dimmer_pct;
+    for (int i = 0; i < RGB_CHANNELS; i++) st->rgb[i] = in->rgb[i];
+    st->fan_power = in->fan_power != 0;
+    st->fan_speed_pct = in->fan_speed_pct;
 }
 
-static void apply_rgb(int r, int g, int b, int w) {
-    g_state.rgb[0] = clamp_int(r, 0, 100);
-    g_state.rgb[1] = clamp_int(g, 0, 100);
-    g_state.rgb[2] = clamp_int(b, 0, 100);
-    g_state.rgb[3] = clamp_int(w, 0, 100);
-    ledc_set_percent(CH_RGB_R, g_state.rgb[0]);
-    ledc_set_percent(CH_RGB_G, g_state.rgb[1]);
-    ledc_set_percent(CH_RGB_B, g_state.rgb[2]);
-    ledc_set_percent(CH_RGB_W, g_state.rgb[3]);
+static uint32_t rtc_outputs_checksum(const persisted_outputs_t *p) {
+    return fnv1a_update(FNV1A_INIT ^ RTC_OUTPUTS_MAGIC, p, sizeof(*p));
 }
 
-static void apply_fan(bool power, int speed_pct) {
-    g_state.fan_power = power;
-    g_state.fan_speed_pct = clamp_int(speed_pct, 0, 100);
-    if (aux_pin_available(FAN_POWER_PIN)) {
-        gpio_set_level(FAN_POWER_PIN, g_state.fan_power ? 1 : 0);
-    }
-    ledc_set_percent(CH_FAN, g_state.fan_power ? g_state.fan_speed_pct : 0);
+static void output_persist_kick(void) {
+    if (g_persist_task && g_cfg.restore_outputs) xTaskNotifyGive(g_persist_task);
 }
 
-static bool parse_on_off_toggle(const char *state, bool current) {
-    if (!state) return current;
-    if (strcmp(state, "toggle") == 0) return !current;
-    if (strcmp(state, "on") == 0) return true;
-    if (strcmp(state, "off") == 0) return false;
-    return current;
+static void output_persist_note(const output_state_t *cur) {
+    persisted_outputs_t snap;
+    pack_outputs(cur, &snap);
+    g_rtc_outputs = snap;
+    g_rtc_outputs_check = rtc_outputs_checksum(&snap);
+    output_persist_kick();
 }
 
-static bool handle_control(cJSON *root) {
-    cJSON *channel = cJSON_GetObjectItem(root, "channel");
-    cJSON *state = cJSON_GetObjectItem(root, "state");
-    cJSON *value = cJSON_GetObjectItem(root, "value");
-    if (!cJSON_IsString(channel)) return false;
-
-    const char *ch = channel->valuestring;
-    const char *st = cJSON_IsString(state) ? state->valuestring : "toggle";
-    int val = cJSON_IsNumber(value) ? value->valueint : 0;
-
-    if (strncmp(ch, "relay", 5) == 0) {
-        int idx = atoi(ch + 5) - 1;
-        if (idx < 0 || idx >= g_cfg.relay_count) return false;
-        bool target = parse_on_off_toggle(st, (idx >= 0 && idx < MAX_RELAYS) ? g_state.relay[idx] : false);
-        apply_relay(idx, target);
-        return true;
+/* Prefers the RTC copy after a warm reset (it holds changes still inside the debounce window),
+ * otherwise the last NVS snapshot. */
+static bool load_persisted_outputs(output_state_t *st) {
+    nvs_handle_t nvs;
+    if (nvs_open("state", NVS_READONLY, &nvs) == ESP_OK) {
+        persisted_outputs_t snap;
+        size_t len = sizeof(snap);
+        if (nvs_get_blob(nvs, "outputs", &snap, &len) == ESP_OK && len == sizeof(snap) &&
+            snap.version == PERSISTED_OUTPUTS_VERSION) {
+            g_nvs_outputs = snap;
+            g_nvs_outputs_valid = true;
+        }
+        nvs_close(nvs);
     }
-
-    if (strcmp(ch, "light") == 0) {
-        bool target = parse_on_off_toggle(st, g_state.light_single);
-        apply_light_single(target);
+    esp_reset_reason_t reason = esp_reset_reason();
+    if (reason != ESP_RST_POWERON && g_rtc_outputs.version == PERSISTED_OUTPUTS_VERSION &&
+        g_rtc_outputs_check == rtc_outputs_checksum(&g_rtc_outputs)) {
+        unpack_outputs(&g_rtc_outputs, st);
+        ESP_LOGI(TAG, "Restoring outputs from RTC memory (reset reason %d)", (int)reason);
         return true;
     }
-
-    if (strcmp(ch, "dimmer") == 0) {
-        int pct = (strcmp(st, "set") == 0) ? val : (parse_on_off_toggle(st, g_state.dimmer_pct > 0) ? 100 : 0);
-        apply_dimmer(pct);
+    if (g_nvs_outputs_valid) {
+        unpack_outputs(&g_nvs_outputs, st);
+        ESP_LOGI(TAG, "Restoring outputs from NVS");
         return true;
     }
+    return false;
+}
 
-    if (strcmp(ch, "rgb") == 0 || strcmp(ch, "rgbw") == 0) {
-        cJSON *r = cJSON_GetObjectItem(root, "r");
-        cJSON *g = cJSON_GetObjectItem(root, "g");
-        cJSON *b = cJSON_GetObjectItem(root, "b");
-        cJSON *w = cJSON_GetObjectItem(root, "w");
-        if (strcmp(st, "off") == 0) {
-            apply_rgb(0, 0, 0, 0);
-        } else if (strcmp(st, "on") == 0) {
-            apply_rgb(100, 100, 100, strcmp(ch, "rgbw") == 0 ? 100 : 0);
-        } else {
-            apply_rgb(cJSON_IsNumber(r) ? r->valueint : g_state.rgb[0],
-                      cJSON_IsNumber(g) ? g->valueint : g_state.rgb[1],
-                      cJSON_IsNumber(b) ? b->valueint : g_state.rgb[2],
-                      cJSON_IsNumber(w) ? w->valueint : g_state.rgb[3]);
-        }
-        return true;
+static bool save_outputs_to_nvs(const persisted_outputs_t *snap) {
+    nvs_handle_t nvs;
+    if (nvs_open("state", NVS_READWRITE, &nvs) != ESP_OK) return false;
+    esp_err_t err = nvs_set_blob(nvs, "outputs", snap, sizeof(*snap));
+    if (err == ESP_OK) err = nvs_commit(nvs);
+    nvs_close(nvs);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Output state save failed: %s", esp_err_to_name(err));
+        return false;
     }
+    g_nvs_stats.state_writes++;
+    return true;
+}
 
-    if (strcmp(ch, "fan") == 0 || strcmp(ch, "fan_power") == 0 || strcmp(ch, "fan_speed") == 0) {
-        bool power = g_state.fan_power;
-        int speed = g_state.fan_speed_pct;
-        if (strcmp(ch, "fan_power") == 0) {
-            power = parse_on_off_toggle(st, g_state.fan_power);
-        } else if (strcmp(ch, "fan_speed") == 0) {
-            speed = val;
-            power = speed > 0;
-        } else if (strcmp(st, "set") == 0) {
-            speed = val;
-            power = speed > 0;
-        } else {
-            power = parse_on_off_toggle(st, g_state.fan_power);
-            if (!power) speed = 0;
-            if (power && speed == 0) speed = 50;
+static void output_persist_task(void *arg) {
+    (void)arg;
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        TickType_t window = pdMS_TO_TICKS(g_cfg.state_save_delay_ms);
+        for (int i = 0; i < STATE_SAVE_MAX_DEFER && ulTaskNotifyTake(pdTRUE, window) > 0; i++) {
+        }
+        if (!g_cfg.restore_outputs) continue;
+
+        output_state_t st;
+        persisted_outputs_t snap;
+        outputs_snapshot(&st);
+        pack_outputs(&st, &snap);
+        if (g_nvs_outputs_valid && memcmp(&snap, &g_nvs_outputs, sizeof(snap)) == 0) continue;
+        if (save_outputs_to_nvs(&snap)) {
+            g_nvs_outputs = snap;
+            g_nvs_outputs_valid = true;
+            ESP_LOGI(TAG, "Output state saved");
         }
-        apply_fan(power, speed);
-        return true;
     }
-
-    return false;
 }
 
-static void configure_output_pins_only(void) {
-    configure_relay_gpio_outputs();
-    if (aux_pin_available(LIGHT_SINGLE_PIN)) {
-        gpio_reset_pin(LIGHT_SINGLE_PIN);
-        gpio_set_direction(LIGHT_SINGLE_PIN, GPIO_MODE_OUTPUT);
-    } else {
-        ESP_LOGW(TAG, "LIGHT_SINGLE pin %d conflicts with relay mapping; feature disabled", LIGHT_SINGLE_PIN);
-    }
-    if (aux_pin_available(FAN_POWER_PIN)) {
-        gpio_reset_pin(FAN_POWER_PIN);
-        gpio_set_direction(FAN_POWER_PIN, GPIO_MODE_OUTPUT);
-    } else {
-        ESP_LOGW(TAG, "FAN_POWER pin %d conflicts with relay mapping; feature disabled", FAN_POWER_PIN);
+static void start_output_persist_task(void) {
+    if (xTaskCreatePinnedToCore(output_persist_task, "state_save", 3072, NULL, 3, &g_persist_task, NET_CORE) != pdPASS) {
+        ESP_LOGW(TAG, "Output state save task start failed");
+        g_persist_task = NULL;
+        return;
     }
+    /* Catch NVS up with a state restored from RTC memory. */
+    output_persist_kick();
+}
 
-    ledc_timer_config_t timer = {
-        .speed_mode = LEDC_LOW_SPEED_MODE,
-        .duty_resolution = LEDC_TIMER_8_BIT,
-        .timer_num = LEDC_TIMER_0,
-        .freq_hz = 5000,
-        .clk_cfg = LEDC_AUTO_CLK,
-    };
-    ledc_timer_config(&timer);
+/* Power profiles (see power_profile_t). The wake window is an esp_timer that re-arms itself until
+ * g_power_wake_until_us passes, so a burst of requests costs one timer start. Light sleep stops the
+ * LEDC clock and GPIO edge interrupts, so it is held off while any PWM output is lit (and until a
+ * fade to off finishes) or any local input is armed. */
+#define POWER_MIN_CPU_MHZ 40
+#define POWER_PWM_SETTLE_MS 50
+
+static portMUX_TYPE g_power_lock = portMUX_INITIALIZER_UNLOCKED;
+static esp_timer_handle_t g_power_wake_timer = NULL;
+static bool g_power_awake = false;
+static int64_t g_power_wake_until_us = 0;
+static uint32_t g_power_wakes = 0;
+#if CONFIG_PM_ENABLE
+static esp_pm_lock_handle_t g_pm_wake_lock = NULL;  /* CPU_FREQ_MAX during a wake window */
+static esp_pm_lock_handle_t g_pm_pwm_lock = NULL;   /* APB_FREQ_MAX: LEDC runs from APB */
+static esp_pm_lock_handle_t g_pm_input_lock = NULL; /* NO_LIGHT_SLEEP while inputs are armed */
+static esp_timer_handle_t g_power_pwm_timer = NULL;
+static uint32_t g_power_pwm_mask = 0;
+static bool g_power_pwm_held = false;
+static bool g_power_input_held = false;
+#endif
 
-    typedef struct {
-        int gpio;
+/* Modem sleep is a station feature; with the fallback AP up its clients need the radio on. */
+static wifi_ps_type_t power_wifi_ps_target(void) {
+    wifi_mode_t mode = WIFI_MODE_NULL;
+    if (esp_wifi_get_mode(&mode) != ESP_OK || mode != WIFI_MODE_STA || g_power_awake) return WIFI_PS_NONE;
+    switch (g_cfg.power_profile) {
+    case POWER_PROFILE_BALANCED:
+        return WIFI_PS_MIN_MODEM;
+    case POWER_PROFILE_LOW_POWER:
+        return WIFI_PS_MAX_MODEM;
+    default:
+        return WIFI_PS_NONE;
+    }
+}
+
+static void power_apply_wifi(void) {
+    esp_wifi_set_ps(power_wifi_ps_target());
+}
+
+/* Applies the configured profile; call after boot and after every config save. The listen
+ * interval is part of the association, so it follows on the next (re)connect. */
+static void power_apply(void) {
+#if CONFIG_PM_ENABLE
+    bool low = g_cfg.power_profile == POWER_PROFILE_LOW_POWER;
+    esp_pm_config_t pm = {
+        .max_freq_mhz = CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ,
+        .min_freq_mhz = low ? POWER_MIN_CPU_MHZ : CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ,
+        .light_sleep_enable = low,
+    };
+    esp_err_t err = esp_pm_configure(&pm);
+    if (err != ESP_OK) ESP_LOGW(TAG, "Power management config failed: %s", esp_err_to_name(err));
+#endif
+    power_apply_wifi();
+    ESP_LOGI(TAG, "Power profile %s (wake hold %d ms)", power_profile_name(g_cfg.power_profile), g_cfg.power_wake_hold_ms);
+}
+
+static void power_wake_timer_cb(void *arg) {
+    (void)arg;
+    portENTER_CRITICAL(&g_power_lock);
+    int64_t left_us = g_power_wake_until_us - esp_timer_get_time();
+    if (left_us <= 0) g_power_awake = false;
+    portEXIT_CRITICAL(&g_power_lock);
+    if (left_us > 0) {
+        esp_timer_start_once(g_power_wake_timer, (uint64_t)left_us);
+        return;
+    }
+    power_apply_wifi();
+#if CONFIG_PM_ENABLE
+    if (g_pm_wake_lock) esp_pm_lock_release(g_pm_wake_lock);
+#endif
+}
+
+/* Interactive traffic (control requests over HTTP/UDP/MQTT, event subscriptions) keeps the radio
+ * fully on for power_wake_hold_ms so follow-up requests do not wait for the next beacon. */
+static void power_wake_note(void) {
+    if (g_cfg.power_profile == POWER_PROFILE_PERFORMANCE || !g_power_wake_timer) return;
+    int64_t until_us = esp_timer_get_time() + (int64_t)g_cfg.power_wake_hold_ms * 1000;
+    portENTER_CRITICAL(&g_power_lock);
+    g_power_wake_until_us = until_us;
+    bool start = !g_power_awake;
+    g_power_awake = true;
+    portEXIT_CRITICAL(&g_power_lock);
+    if (!start) return;
+    g_power_wakes++;
+#if CONFIG_PM_ENABLE
+    if (g_pm_wake_lock) esp_pm_lock_acquire(g_pm_wake_lock);
+#endif
+    esp_wifi_set_ps(WIFI_PS_NONE);
+    esp_timer_start_once(g_power_wake_timer, (uint64_t)g_cfg.power_wake_hold_ms * 1000);
+}
+
+#if CONFIG_PM_ENABLE
+static void power_pwm_release_cb(void *arg) {
+    (void)arg;
+    portENTER_CRITICAL(&g_power_lock);
+    bool release = g_power_pwm_mask == 0 && g_power_pwm_held;
+    if (release) g_power_pwm_held = false;
+    portEXIT_CRITICAL(&g_power_lock);
+    if (release) esp_pm_lock_release(g_pm_pwm_lock);
+}
+#endif
+
+static void power_pwm_note(int channel, uint32_t duty, int fade_ms) {
+#if CONFIG_PM_ENABLE
+    if (!g_pm_pwm_lock || !g_power_pwm_timer) return;
+    portENTER_CRITICAL(&g_power_lock);
+    if (duty) {
+        g_power_pwm_mask |= 1u << channel;
+    } else {
+        g_power_pwm_mask &= ~(1u << channel);
+    }
+    bool acquire = g_power_pwm_mask != 0 && !g_power_pwm_held;
+    if (acquire) g_power_pwm_held = true;
+    bool settle = g_power_pwm_mask == 0 && g_power_pwm_held;
+    portEXIT_CRITICAL(&g_power_lock);
+    if (acquire) esp_pm_lock_acquire(g_pm_pwm_lock);
+    if (settle) {
+        /* Let a fade to off finish before the APB clock may drop or the chip may sleep. */
+        esp_timer_stop(g_power_pwm_timer);
+        esp_timer_start_once(g_power_pwm_timer, (uint64_t)(fade_ms + POWER_PWM_SETTLE_MS) * 1000);
+    }
+#endif
+}
+
+/* Called by the input task only. */
+static void power_inputs_note(bool armed) {
+#if CONFIG_PM_ENABLE
+    if (!g_pm_input_lock || armed == g_power_input_held) return;
+    g_power_input_held = armed;
+    if (armed) {
+        esp_pm_lock_acquire(g_pm_input_lock);
+    } else {
+        esp_pm_lock_release(g_pm_input_lock);
+    }
+#endif
+}
+
+/* Before init_outputs so restored PWM levels already take the clock lock. */
+static void power_init(void) {
+#if CONFIG_PM_ENABLE
+    if (esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "wake", &g_pm_wake_lock) != ESP_OK) g_pm_wake_lock = NULL;
+    if (esp_pm_lock_create(ESP_PM_APB_FREQ_MAX, 0, "pwm", &g_pm_pwm_lock) != ESP_OK) g_pm_pwm_lock = NULL;
+    if (esp_pm_lock_create(ESP_PM_NO_LIGHT_SLEEP, 0, "inputs", &g_pm_input_lock) != ESP_OK) g_pm_input_lock = NULL;
+    esp_timer_create_args_t pwm_args = {.callback = power_pwm_release_cb, .name = "power_pwm"};
+    if (esp_timer_create(&pwm_args, &g_power_pwm_timer) != ESP_OK) g_power_pwm_timer = NULL;
+#endif
+    esp_timer_create_args_t args = {.callback = power_wake_timer_cb, .name = "power_wake"};
+    if (esp_timer_create(&args, &g_power_wake_timer) != ESP_OK) {
+        ESP_LOGW(TAG, "Power wake timer create failed; modem sleep stays on during interactive use");
+        g_power_wake_timer = NULL;
+    }
+    power_apply();
+}
+
+#if CONFIG_EIGHTBB_MQTT
+/* MQTT client (defined after the UDP listener). */
+static bool g_mqtt_connected = false;
+static void mqtt_note_output_delta(const output_state_t *prev, const output_state_t *cur);
+static void mqtt_reconfigure(void);
+#endif
+#if CONFIG_EIGHTBB_MDNS
+static void mdns_reconfigure(void);
+#endif
+
+static void publish_output_delta(void) {
+    output_state_t prev;
+    output_state_t cur;
+    portENTER_CRITICAL(&g_event_lock);
+    prev = g_published_state;
+    cur = g_state;
+    g_published_state = g_state;
+    bool changed = !output_state_equal(&prev, &cur);
+    if (changed) g_state_generation++;
+    portEXIT_CRITICAL(&g_event_lock);
+    if (changed) output_persist_note(&cur);
+#if CONFIG_EIGHTBB_MQTT
+    if (changed) mqtt_note_output_delta(&prev, &cur);
+#endif
+    if (!changed || !g_server || g_event_client_count == 0) return;
+
+    portENTER_CRITICAL(&g_event_lock);
+    uint32_t seq = ++g_event_seq;
+    portEXIT_CRITICAL(&g_event_lock);
+    char buf[JSON_WRITER_BUF];
+    json_writer_t jw;
+    jw_init(&jw, NULL, buf, sizeof(buf));
+    jw_begin_object(&jw, NULL);
+    jw_str(&jw, "type", "outputs");
+    jw_int(&jw, "seq", (long)seq);
+    int fields = write_output_delta_json(&jw, &prev, &cur, g_cfg.relay_count);
+    jw_end_object(&jw);
+    const char *body = jw_cstr(&jw);
+    if (!body || fields == 0) return;
+
+    /* The frame outlives this call (it is sent from the httpd task), so it needs its own copy. */
+    event_frame_t *frame = malloc(sizeof(event_frame_t) + jw.len + 1);
+    if (!frame) return;
+    frame->len = jw.len;
+    memcpy(frame->data, body, jw.len + 1);
+    if (httpd_queue_work(g_server, events_broadcast_work, frame) != ESP_OK) {
+        ESP_LOGW(TAG, "Event broadcast queue failed seq=%u", (unsigned)seq);
+        free(frame);
+    }
+}
+
+static void delayed_restart_task(void *arg) {
+    int delay_ms = (int)(intptr_t)arg;
+    if (delay_ms < 50) delay_ms = 50;
+    vTaskDelay(pdMS_TO_TICKS(delay_ms));
+    esp_restart();
+}
+
+static void schedule_restart_ms(int delay_ms) {
+    xTaskCreate(delayed_restart_task, "reboot_task", 2048, (void *)(intptr_t)delay_ms, 5, NULL);
+}
+
+/* The fade engine owns the channel once installed, so instant writes go through its thread-safe setter too. */
+static void ledc_apply_duty(ledc_channel_t channel, uint32_t duty, int fade_ms) {
+    if (!(g_ledc_ready_mask & (1u << channel))) return;
+    if (!g_ledc_fade_ready) {
+        ledc_set_duty(LEDC_LOW_SPEED_MODE, channel, duty);
+        ledc_update_duty(LEDC_LOW_SPEED_MODE, channel);
+    } else if (fade_ms > 0) {
+        ledc_set_fade_time_and_start(LEDC_LOW_SPEED_MODE, channel, duty, (uint32_t)fade_ms, LEDC_FADE_NO_WAIT);
+    } else {
+        ledc_set_duty_and_update(LEDC_LOW_SPEED_MODE, channel, duty, 0);
+    }
+}
+
+/* HAL: the core (fw_control.c) drives outputs through these. */
+bool hal_gpio_output_capable(int pin) {
+    return GPIO_IS_VALID_OUTPUT_GPIO(pin);
+}
+
+void hal_gpio_write(int pin, bool on) {
+    gpio_set_level((gpio_num_t)pin, on ? 1 : 0);
+}
+
+void hal_gpio_write_masks(uint64_t set_mask, uint64_t clear_mask) {
+#if CONFIG_IDF_TARGET_ESP32
+    /* Write-1-to-set/clear registers switch every staged pin of a bank in one store. */
+    GPIO.out_w1ts = (uint32_t)(set_mask & 0xffffffffULL);
+    GPIO.out_w1tc = (uint32_t)(clear_mask & 0xffffffffULL);
+    GPIO.out1_w1ts.val = (uint32_t)(set_mask >> 32);
+    GPIO.out1_w1tc.val = (uint32_t)(clear_mask >> 32);
+#else
+    for (int pin = 0; pin < 64; pin++) {
+        if (set_mask & (1ULL << pin)) gpio_set_level((gpio_num_t)pin, 1);
+        if (clear_mask & (1ULL << pin)) gpio_set_level((gpio_num_t)pin, 0);
+    }
+#endif
+}
+
+void hal_pwm_apply(int channel, uint32_t duty, int fade_ms) {
+    if (channel < 0 || channel >= LEDC_CHANNEL_MAX) return;
+    power_pwm_note(channel, duty, fade_ms);
+    ledc_apply_duty((ledc_channel_t)channel, duty, fade_ms);
+}
+
+void hal_outputs_changed(void) {
+    publish_output_delta();
+}
+
+static bool control_op_from_json(cJSON *root, control_op_t *op) {
+    cJSON *channel = cJSON_GetObjectItem(root, "channel");
+    cJSON *state = cJSON_GetObjectItem(root, "state");
+    cJSON *value = cJSON_GetObjectItem(root, "value");
+    cJSON *transition = cJSON_GetObjectItem(root, "transition_ms");
+    cJSON *duration = cJSON_GetObjectItem(root, "duration_ms");
+    if (!cJSON_IsString(channel) && !cJSON_IsNumber(channel)) return false;
+
+    memset(op, 0, sizeof(*op));
+    /* Numeric ids are the UDP channel numbers and skip the name lookup. */
+    op->channel = cJSON_IsNumber(channel) ? control_channel_from_id(channel->valueint) : parse_control_channel(channel->valuestring);
+    op->action = parse_control_action(cJSON_IsString(state) ? state->valuestring : "toggle");
+    op->value = cJSON_IsNumber(value) ? value->valueint : 0;
+    op->transition_ms = cJSON_IsNumber(transition) ? clamp_int(transition->valueint, 0, MAX_TRANSITION_MS) : 0;
+    op->duration_ms = cJSON_IsNumber(duration) ? clamp_int(duration->valueint, 0, MAX_DURATION_MS) : 0;
+    static const char *const rgb_keys[RGB_CHANNELS] = {"r", "g", "b", "w"};
+    for (int i = 0; i < RGB_CHANNELS; i++) {
+        cJSON *c = cJSON_GetObjectItem(root, rgb_keys[i]);
+        op->rgb[i] = cJSON_IsNumber(c) ? c->valueint : -1;
+    }
+    return op->channel != CTRL_CH_NONE;
+}
+
+/* Call after the relay map is sanitized; resolves every channel's pins once. Runs on the actuation
+ * task; the table is built aside and copied in one go because transports look up names from theirs. */
+static void build_channel_registry(void) {
+    channel_desc_t next[CTRL_CH_COUNT];
+    int light_pin = aux_pin_available(LIGHT_SINGLE_PIN) ? LIGHT_SINGLE_PIN : -1;
+    int fan_pin = aux_pin_available(FAN_POWER_PIN) ? FAN_POWER_PIN : -1;
+    control_registry_build(next, g_cfg.relay_gpio, g_cfg.relay_count, light_pin, fan_pin);
+    memcpy(g_channels, next, sizeof(g_channels));
+}
+
+/* Auto-off timers (duration_ms): one deadline per physical output, so channels that drive the same
+ * hardware (rgb/rgbw, fan/fan_power/fan_speed) share a slot. Owned by the actuation task. */
+static int64_t g_auto_off_us[CTRL_CH_COUNT];
+static TaskHandle_t g_automation_task = NULL;
+
+static control_channel_t auto_off_slot(control_channel_t ch) {
+    if (ch == CTRL_CH_RGBW) return CTRL_CH_RGB;
+    if (ch == CTRL_CH_FAN_POWER || ch == CTRL_CH_FAN_SPEED) return CTRL_CH_FAN;
+    return ch;
+}
+
+/* The latest op on an output wins: one with duration_ms re-arms its timer, any other cancels it. */
+static void auto_off_note_act(const control_op_t *op) {
+    control_channel_t slot = auto_off_slot(op->channel);
+    if (op->duration_ms <= 0) {
+        g_auto_off_us[slot] = 0;
+        return;
+    }
+    g_auto_off_us[slot] = esp_timer_get_time() + (int64_t)op->duration_ms * 1000;
+    if (g_automation_task) xTaskNotifyGive(g_automation_task);
+}
+
+static bool apply_control_op_act(const control_op_t *op) {
+    if (!control_op_apply(op)) return false;
+    auto_off_note_act(op);
+    return true;
+}
+
+typedef struct {
+    const control_op_t *ops;
+    int count;
+    bool validate_only;
+    int bad; /* first invalid op, -1 when all are valid */
+} act_ops_job_t;
+
+/* Validates every op before touching an output, then applies them in one staged pass. */
+static void act_ops_job(void *ctx) {
+    act_ops_job_t *job = (act_ops_job_t *)ctx;
+    job->bad = -1;
+    for (int i = 0; i < job->count && job->bad < 0; i++) {
+        if (!control_op_valid(&job->ops[i])) job->bad = i;
+    }
+    if (job->bad >= 0 || job->validate_only) return;
+    if (job->count == 1) {
+        if (!apply_control_op_act(&job->ops[0])) job->bad = 0;
+        return;
+    }
+    begin_output_batch();
+    for (int i = 0; i < job->count; i++) apply_control_op_act(&job->ops[i]);
+    end_output_batch();
+}
+
+/* Shared by every control transport (HTTP, UDP, MQTT); runs the op on the actuation task. */
+static bool apply_control_op(const control_op_t *op) {
+    act_ops_job_t job = {.ops = op, .count = 1};
+    act_call(act_ops_job, &job);
+    return job.bad < 0;
+}
+
+/* Returns -1 on success, otherwise the index of the first invalid op (nothing is applied then). */
+static int apply_control_batch(const control_op_t *ops, int count) {
+    act_ops_job_t job = {.ops = ops, .count = count};
+    act_call(act_ops_job, &job);
+    return job.bad;
+}
+
+static int validate_control_ops(const control_op_t *ops, int count) {
+    act_ops_job_t job = {.ops = ops, .count = count, .validate_only = true};
+    act_call(act_ops_job, &job);
+    return job.bad;
+}
+
+/* On-device automation: auto-off deadlines and the schedule table run from one task that sleeps
+ * until the nearest deadline or local minute boundary. Schedules need wall-clock time from SNTP;
+ * auto-off runs on the monotonic timer and keeps working on a LAN without internet. */
+#define AUTOMATION_TIME_VALID_EPOCH 1704067200 /* 2024-01-01; earlier means the clock was never set */
+#define AUTOMATION_IDLE_MS 60000
+#define AUTOMATION_STACK 3072
+#define SCHED_CATCHUP_MINUTES 5
+/* The XTAL drifts ~10 ppm, so a 5 minute resync keeps apply_at skew between devices to a few ms. */
+#define SNTP_SYNC_INTERVAL_MS 300000
+
+static const char *const CONTROL_ACTION_NAMES[] = {"off", "on", "toggle", "set", "keep"};
+
+static bool g_time_synced = false;
+static int64_t g_sched_last_minute = -1;
+static char g_sntp_server[MAX_STR];
+
+static bool automation_time_valid(void) {
+    return time(NULL) > AUTOMATION_TIME_VALID_EPOCH;
+}
+
+static void schedule_to_op(const schedule_entry_t *e, control_op_t *op) {
+    memset(op, 0, sizeof(*op));
+    op->channel = (control_channel_t)e->channel;
+    op->action = (control_action_t)e->action;
+    op->value = e->value;
+    op->transition_ms = e->transition_ms;
+    op->duration_ms = (int)e->duration_ms;
+    for (int i = 0; i < RGB_CHANNELS; i++) op->rgb[i] = e->rgb[i];
+}
+
+/* Fires every auto-off that is due; returns the earliest deadline still pending (0 when none). */
+static int64_t auto_off_run_act(int64_t now_us) {
+    int64_t next_us = 0;
+    for (int slot = CTRL_CH_RELAY1; slot < CTRL_CH_COUNT; slot++) {
+        int64_t due_us = g_auto_off_us[slot];
+        if (due_us == 0) continue;
+        if (due_us > now_us) {
+            if (next_us == 0 || due_us < next_us) next_us = due_us;
+            continue;
+        }
+        control_op_t off = {.channel = (control_channel_t)slot, .action = CTRL_ACT_OFF, .rgb = {-1, -1, -1, -1}};
+        g_auto_off_us[slot] = 0;
+        if (apply_control_op_act(&off)) ESP_LOGI(TAG, "Auto-off %s", g_channels[slot].name);
+    }
+    return next_us;
+}
+
+static void schedules_run_minute_act(int64_t epoch_minute) {
+    time_t t = (time_t)(epoch_minute * 60);
+    struct tm local;
+    localtime_r(&t, &local);
+    int minute_of_day = local.tm_hour * 60 + local.tm_min;
+    for (int i = 0; i < MAX_SCHEDULES; i++) {
+        const schedule_entry_t *e = &g_cfg.schedules[i];
+        if (!e->enabled || e->minute != minute_of_day || !(e->days & (1u << local.tm_wday))) continue;
+        control_op_t op;
+        schedule_to_op(e, &op);
+        bool ok = apply_control_op_act(&op);
+        ESP_LOGI(TAG, "Schedule %d at %02d:%02d %s", i, local.tm_hour, local.tm_min, ok ? "applied" : "skipped (channel unavailable)");
+    }
+}
+
+static void schedules_run_act(void) {
+    if (!automation_time_valid()) return;
+    int64_t minute = (int64_t)time(NULL) / 60;
+    if (g_sched_last_minute < 0 || minute - g_sched_last_minute > SCHED_CATCHUP_MINUTES) {
+        /* First valid time or a big forward step: run the current minute, not the whole gap. */
+        g_sched_last_minute = minute - 1;
+    } else if (minute < g_sched_last_minute) {
+        /* Clock stepped back: never fire the same minute twice. */
+        g_sched_last_minute = minute;
+    }
+    for (int64_t m = g_sched_last_minute + 1; m <= minute; m++) schedules_run_minute_act(m);
+    g_sched_last_minute = minute;
+}
+
+static void automation_job(void *ctx) {
+    int64_t *next_off_us = (int64_t *)ctx;
+    *next_off_us = auto_off_run_act(esp_timer_get_time());
+    schedules_run_act();
+}
+
+static void automation_tz_job(void *ctx) {
+    (void)ctx;
+    setenv("TZ", g_cfg.timezone, 1);
+    tzset();
+}
+
+static void automation_task(void *arg) {
+    (void)arg;
+    for (;;) {
+        int64_t next_off_us = 0;
+        act_call(automation_job, &next_off_us);
+        int64_t now_us = esp_timer_get_time();
+
+        int64_t wait_ms = AUTOMATION_IDLE_MS;
+        if (automation_time_valid()) {
+            struct timeval tv;
+            gettimeofday(&tv, NULL);
+            /* Wake just past the next minute boundary so a 22:00 schedule fires at 22:00:00. */
+            wait_ms = 60000 - ((int64_t)(tv.tv_sec % 60) * 1000 + tv.tv_usec / 1000) + 20;
+        }
+        if (next_off_us) {
+            int64_t off_ms = (next_off_us - now_us + 999) / 1000;
+            if (off_ms < wait_ms) wait_ms = off_ms;
+        }
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(wait_ms > 0 ? wait_ms : 1));
+    }
+}
+
+static void sntp_sync_cb(struct timeval *tv) {
+    (void)tv;
+    if (!g_time_synced) ESP_LOGI(TAG, "Time synced via SNTP");
+    g_time_synced = true;
+    g_net_generation++;
+    if (g_automation_task) xTaskNotifyGive(g_automation_task);
+}
+
+/* (Re)starts SNTP when ntp_server changed; an empty server leaves SNTP off. */
+static void automation_start_sntp(void) {
+    bool running = esp_sntp_enabled();
+    if (strcmp(g_sntp_server, g_cfg.ntp_server) == 0 && running == (g_sntp_server[0] != '\0')) return;
+    if (running) esp_sntp_stop();
+    safe_strcpy(g_sntp_server, g_cfg.ntp_server, sizeof(g_sntp_server));
+    if (g_sntp_server[0] == '\0') return;
+    esp_sntp_setoperatingmode(ESP_SNTP_OPMODE_POLL);
+    esp_sntp_setservername(0, g_sntp_server);
+    sntp_set_time_sync_notification_cb(sntp_sync_cb);
+    sntp_set_sync_interval(SNTP_SYNC_INTERVAL_MS);
+    esp_sntp_init();
+}
+
+/* Call after a config save: picks up timezone, NTP server and schedule edits. */
+static void automation_reconfigure(void) {
+    act_call(automation_tz_job, NULL);
+    automation_start_sntp();
+    if (g_automation_task) xTaskNotifyGive(g_automation_task);
+}
+
+static void start_automation(void) {
+    if (xTaskCreatePinnedToCore(automation_task, "automation", AUTOMATION_STACK, NULL, 5, &g_automation_task, ACT_CORE) != pdPASS) {
+        ESP_LOGW(TAG, "Automation task start failed; schedules and duration_ms are inactive");
+        g_automation_task = NULL;
+    }
+    automation_reconfigure();
+}
+
+/* Scene sync: a control request carrying apply_at (Unix ms, needs SNTP time) is validated when it
+ * arrives and fired at that instant from a one-shot esp_timer. Devices given the same timestamp then
+ * switch together instead of each on request arrival. The timer callback only wakes the apply task,
+ * which hands the ops to the actuation task as one staged batch. */
+#define APPLY_AT_SLOTS 4
+#define APPLY_AT_MAX_AHEAD_MS 600000
+/* A timestamp up to this far in the past is applied at once; older ones are refused. */
+#define APPLY_AT_LATE_MS 1000
+#define APPLY_AT_STACK 4096
+#define APPLY_AT_PRIORITY 12
+/* 2^53: the largest ms count a JSON double holds exactly; also keeps apply_at_ms * 1000 in int64. */
+#define APPLY_AT_MS_MAX 9007199254740992.0
+
+typedef enum {
+    APPLY_AT_OK,
+    APPLY_AT_BAD_TIME,
+    APPLY_AT_NO_TIME,
+    APPLY_AT_RANGE,
+    APPLY_AT_FULL,
+    APPLY_AT_BAD_OP,
+} apply_at_result_t;
+
+typedef struct {
+    bool used;
+    int count;
+    int64_t fire_us;
+    control_op_t ops[MAX_BATCH_OPS];
+} apply_at_slot_t;
+
+static apply_at_slot_t g_apply_at[APPLY_AT_SLOTS];
+static esp_timer_handle_t g_apply_at_timers[APPLY_AT_SLOTS];
+static TaskHandle_t g_apply_at_task = NULL;
+static portMUX_TYPE g_apply_at_lock = portMUX_INITIALIZER_UNLOCKED;
+/* How late the last scheduled batch hit its outputs, for /api/metrics. */
+static int32_t g_apply_at_last_late_us = 0;
+
+static void apply_at_timer_cb(void *arg) {
+    xTaskNotify(g_apply_at_task, 1u << (uint32_t)(uintptr_t)arg, eSetBits);
+}
+
+static void apply_at_task(void *arg) {
+    (void)arg;
+    control_op_t ops[MAX_BATCH_OPS];
+    for (;;) {
+        uint32_t bits = 0;
+        xTaskNotifyWait(0, UINT32_MAX, &bits, portMAX_DELAY);
+        for (int i = 0; i < APPLY_AT_SLOTS; i++) {
+            if (!(bits & (1u << i))) continue;
+            portENTER_CRITICAL(&g_apply_at_lock);
+            int count = g_apply_at[i].used ? g_apply_at[i].count : 0;
+            int64_t fire_us = g_apply_at[i].fire_us;
+            memcpy(ops, g_apply_at[i].ops, sizeof(ops[0]) * (size_t)count);
+            g_apply_at[i].used = false;
+            portEXIT_CRITICAL(&g_apply_at_lock);
+            if (count == 0) continue;
+            /* Re-validated here too: a config save in between may have removed a channel. */
+            int bad = apply_control_batch(ops, count);
+            g_apply_at_last_late_us = (int32_t)(esp_timer_get_time() - fire_us);
+            if (bad >= 0) ESP_LOGW(TAG, "apply_at batch dropped: ops[%d] no longer valid", bad);
+        }
+    }
+}
+
+/* Validates ops and either applies them now (apply_at already passed) or parks them in a slot.
+ * *in_ms is the lead time (negative when applied late); *bad is the invalid op for APPLY_AT_BAD_OP. */
+static apply_at_result_t apply_at_schedule(const control_op_t *ops, int count, double apply_at, int64_t *in_ms, int *bad) {
+    /* Range-checked before the cast: converting a non-finite or out-of-range double is undefined. */
+    if (!isfinite(apply_at) || apply_at < 0 || apply_at > APPLY_AT_MS_MAX) return APPLY_AT_BAD_TIME;
+    int64_t apply_at_ms = (int64_t)apply_at;
+    if (!g_time_synced || !automation_time_valid()) return APPLY_AT_NO_TIME;
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    int64_t mono_us = esp_timer_get_time();
+    int64_t delay_us = apply_at_ms * 1000 - ((int64_t)tv.tv_sec * 1000000 + tv.tv_usec);
+    *in_ms = delay_us / 1000;
+    if (delay_us < -(int64_t)APPLY_AT_LATE_MS * 1000 || delay_us > (int64_t)APPLY_AT_MAX_AHEAD_MS * 1000) return APPLY_AT_RANGE;
+
+    *bad = validate_control_ops(ops, count);
+    if (*bad >= 0) return APPLY_AT_BAD_OP;
+    /* Under a millisecond out is "now" too, so in_ms > 0 exactly when the ops were parked. */
+    if (delay_us < 1000) {
+        apply_control_batch(ops, count);
+        return APPLY_AT_OK;
+    }
+    if (!g_apply_at_task) return APPLY_AT_FULL;
+
+    int slot = -1;
+    portENTER_CRITICAL(&g_apply_at_lock);
+    for (int i = 0; i < APPLY_AT_SLOTS && slot < 0; i++) {
+        if (g_apply_at[i].used) continue;
+        slot = i;
+        g_apply_at[i].used = true;
+        g_apply_at[i].count = count;
+        g_apply_at[i].fire_us = mono_us + delay_us;
+        memcpy(g_apply_at[i].ops, ops, sizeof(ops[0]) * (size_t)count);
+    }
+    portEXIT_CRITICAL(&g_apply_at_lock);
+    if (slot < 0) return APPLY_AT_FULL;
+    /* Measured from mono_us so request handling time does not shift the instant. */
+    int64_t remaining_us = mono_us + delay_us - esp_timer_get_time();
+    esp_timer_start_once(g_apply_at_timers[slot], remaining_us > 0 ? (uint64_t)remaining_us : 1);
+    return APPLY_AT_OK;
+}
+
+static void start_apply_at(void) {
+    for (int i = 0; i < APPLY_AT_SLOTS; i++) {
+        esp_timer_create_args_t args = {.callback = apply_at_timer_cb, .arg = (void *)(uintptr_t)i, .name = "apply_at"};
+        if (esp_timer_create(&args, &g_apply_at_timers[i]) != ESP_OK) {
+            ESP_LOGW(TAG, "apply_at timer create failed; timed control requests are refused");
+            return;
+        }
+    }
+    if (xTaskCreatePinnedToCore(apply_at_task, "apply_at", APPLY_AT_STACK, NULL, APPLY_AT_PRIORITY, &g_apply_at_task, ACT_CORE) !=
+        pdPASS) {
+        ESP_LOGW(TAG, "apply_at task start failed; timed control requests are refused");
+        g_apply_at_task = NULL;
+    }
+}
+
+static bool schedule_from_json(cJSON *item, schedule_entry_t *e) {
+    control_op_t op;
+    if (!cJSON_IsObject(item) || !control_op_from_json(item, &op) || op.action == CTRL_ACT_KEEP) return false;
+    cJSON *at = cJSON_GetObjectItem(item, "at");
+    cJSON *days = cJSON_GetObjectItem(item, "days");
+    cJSON *enabled = cJSON_GetObjectItem(item, "enabled");
+    int hour = -1;
+    int minute = -1;
+    if (!cJSON_IsString(at) || sscanf(at->valuestring, "%d:%d", &hour, &minute) != 2) return false;
+    if (hour < 0 || hour > 23 || minute < 0 || minute > 59) return false;
+    memset(e, 0, sizeof(*e));
+    e->enabled = !cJSON_IsFalse(enabled);
+    e->days = cJSON_IsNumber(days) ? (uint8_t)(days->valueint & 0x7f) : 0x7f;
+    e->minute = (uint16_t)(hour * 60 + minute);
+    e->channel = (uint8_t)op.channel;
+    e->action = (uint8_t)op.action;
+    e->value = (int16_t)clamp_int(op.value, INT16_MIN, INT16_MAX);
+    e->transition_ms = (uint16_t)op.transition_ms;
+    e->duration_ms = (uint32_t)op.duration_ms;
+    for (int i = 0; i < RGB_CHANNELS; i++) e->rgb[i] = (int8_t)clamp_int(op.rgb[i], -1, 100);
+    return e->days != 0;
+}
+
+static void write_schedules_json(json_writer_t *jw) {
+    jw_str(jw, "timezone", g_cfg.timezone);
+    jw_str(jw, "ntp_server", g_cfg.ntp_server);
+    jw_begin_array(jw, "schedules");
+    for (int i = 0; i < MAX_SCHEDULES; i++) {
+        const schedule_entry_t *e = &g_cfg.schedules[i];
+        if (e->channel == CTRL_CH_NONE) continue;
+        char at[8] = {0};
+        snprintf(at, sizeof(at), "%02d:%02d", e->minute / 60, e->minute % 60);
+        jw_begin_object(jw, NULL);
+        jw_int(jw, "id", i);
+        jw_bool(jw, "enabled", e->enabled);
+        jw_int(jw, "days", e->days);
+        jw_str(jw, "at", at);
+        jw_int(jw, "channel", e->channel);
+        jw_str(jw, "state", CONTROL_ACTION_NAMES[e->action]);
+        jw_int(jw, "value", e->value);
+        jw_int(jw, "transition_ms", e->transition_ms);
+        jw_int(jw, "duration_ms", (long)e->duration_ms);
+        static const char *const rgb_keys[RGB_CHANNELS] = {"r", "g", "b", "w"};
+        for (int c = 0; c < RGB_CHANNELS; c++) {
+            if (e->rgb[c] >= 0) jw_int(jw, rgb_keys[c], e->rgb[c]);
+        }
+        jw_end_object(jw);
+    }
+    jw_end_array(jw);
+}
+
+/* Local inputs (wall buttons and switches). The GPIO ISR only queues the input index; the input task
+ * acts on the first edge and then ignores bounce for INPUT_DEBOUNCE_MS before re-reading the pin, so
+ * a press actuates without waiting for the contact to settle. */
+#ifndef INPUT_DEBOUNCE_MS
+#define INPUT_DEBOUNCE_MS 30
+#endif
+#ifndef INPUT_LONG_PRESS_MS
+#define INPUT_LONG_PRESS_MS 800
+#endif
+#define INPUT_QUEUE_LEN 16
+#define INPUT_STACK 4096
+#define INPUT_RECONFIGURE 0xff
+
+static const char *const INPUT_MODE_NAMES[] = {"button", "switch"};
+static const char *const INPUT_EVENT_NAMES[INPUT_EV_COUNT] = {"press", "long", "toggle"};
+
+typedef struct {
+    bool active;
+    gpio_num_t gpio;
+    uint8_t mode;
+    bool active_low;
+    bool has_long;   /* a long binding exists, so a short press fires on release instead of on the edge */
+    bool pressed;    /* debounced logical level */
+    bool long_fired;
+    bool recheck;    /* re-read the pin once the debounce window closes */
+    int64_t changed_us;
+} input_runtime_t;
+
+static input_runtime_t g_input_rt[MAX_INPUTS];
+static QueueHandle_t g_input_q = NULL;
+
+static void IRAM_ATTR input_isr(void *arg) {
+    uint8_t idx = (uint8_t)(uintptr_t)arg;
+    BaseType_t woken = pdFALSE;
+    xQueueSendFromISR(g_input_q, &idx, &woken);
+    portYIELD_FROM_ISR(woken);
+}
+
+static bool input_read(const input_runtime_t *in) {
+    return (gpio_get_level(in->gpio) != 0) != in->active_low;
+}
+
+/* Applies every binding of (idx, ev) in one staged pass, like a control batch. ctx packs idx << 8 | ev. */
+static void input_fire_job(void *ctx) {
+    int idx = (int)((uintptr_t)ctx >> 8);
+    input_event_t ev = (input_event_t)((uintptr_t)ctx & 0xff);
+    int applied = 0;
+    begin_output_batch();
+    for (int i = 0; i < MAX_INPUT_BINDINGS; i++) {
+        const input_binding_t *b = &g_cfg.input_bindings[i];
+        if (b->channel == CTRL_CH_NONE || b->input != idx || b->event != ev) continue;
+        control_op_t op = {
+            .channel = (control_channel_t)b->channel,
+            .action = (control_action_t)b->action,
+            .value = b->value,
+            .rgb = {-1, -1, -1, -1},
+            .transition_ms = b->transition_ms,
+            .duration_ms = (int)b->duration_ms,
+        };
+        if (apply_control_op_act(&op)) applied++;
+    }
+    end_output_batch();
+    ESP_LOGD(TAG, "Input %d %s: %d binding(s) applied", idx, INPUT_EVENT_NAMES[ev], applied);
+}
+
+/* The input task only debounces; the bindings run on the actuation task. */
+static void input_fire(int idx, input_event_t ev) {
+    if (!act_post(input_fire_job, (void *)(((uintptr_t)idx << 8) | (uintptr_t)ev))) {
+        ESP_LOGW(TAG, "Input %d %s dropped: actuation queue full", idx, INPUT_EVENT_NAMES[ev]);
+    }
+}
+
+static void input_level_changed(int idx, bool pressed, int64_t now_us) {
+    input_runtime_t *in = &g_input_rt[idx];
+    in->pressed = pressed;
+    in->changed_us = now_us;
+    in->recheck = true;
+    if (in->mode == INPUT_MODE_SWITCH) {
+        input_fire(idx, INPUT_EV_TOGGLE);
+    } else if (pressed) {
+        in->long_fired = false;
+        if (!in->has_long) input_fire(idx, INPUT_EV_PRESS);
+    } else if (in->has_long && !in->long_fired) {
+        input_fire(idx, INPUT_EV_PRESS);
+    }
+}
+
+static void input_edge(int idx, int64_t now_us) {
+    input_runtime_t *in = &g_input_rt[idx];
+    if (!in->active || now_us - in->changed_us < (int64_t)INPUT_DEBOUNCE_MS * 1000) return;
+    bool pressed = input_read(in);
+    if (pressed != in->pressed) input_level_changed(idx, pressed, now_us);
+}
+
+/* Runs debounce re-reads and long-press timers; returns how long the task may block. */
+static TickType_t input_run_timers(int64_t now_us) {
+    int64_t wait_us = -1;
+    for (int i = 0; i < MAX_INPUTS; i++) {
+        input_runtime_t *in = &g_input_rt[i];
+        if (!in->active) continue;
+        if (in->recheck) {
+            int64_t due_us = in->changed_us + (int64_t)INPUT_DEBOUNCE_MS * 1000;
+            if (now_us >= due_us) {
+                in->recheck = false;
+                bool pressed = input_read(in);
+                if (pressed != in->pressed) input_level_changed(i, pressed, now_us);
+            }
+            if (in->recheck && (wait_us < 0 || due_us - now_us < wait_us)) wait_us = due_us - now_us;
+        }
+        if (in->mode == INPUT_MODE_BUTTON && in->pressed && in->has_long && !in->long_fired) {
+            int64_t due_us = in->changed_us + (int64_t)INPUT_LONG_PRESS_MS * 1000;
+            if (now_us >= due_us) {
+                in->long_fired = true;
+                input_fire(i, INPUT_EV_LONG);
+            } else if (wait_us < 0 || due_us - now_us < wait_us) {
+                wait_us = due_us - now_us;
+            }
+        }
+    }
+    if (wait_us < 0) return portMAX_DELAY;
+    return pdMS_TO_TICKS(wait_us / 1000) + 1;
+}
+
+/* Reads the input config into g_input_rt on the actuation task, which owns g_cfg and the pin map. */
+static void input_load_job(void *ctx) {
+    (void)ctx;
+    for (int i = 0; i < MAX_INPUTS; i++) {
+        const input_entry_t *cfg = &g_cfg.inputs[i];
+        input_runtime_t *in = &g_input_rt[i];
+        if (!cfg->enabled) continue;
+        if (!input_pin_available(cfg->gpio, i)) {
+            ESP_LOGW(TAG, "Input %d pin %d conflicts with an output or another input; input disabled", i, cfg->gpio);
+            continue;
+        }
+        in->gpio = (gpio_num_t)cfg->gpio;
+        in->mode = cfg->mode;
+        in->active_low = cfg->active_low;
+        for (int b = 0; b < MAX_INPUT_BINDINGS; b++) {
+            const input_binding_t *bind = &g_cfg.input_bindings[b];
+            if (bind->channel != CTRL_CH_NONE && bind->input == i && bind->event == INPUT_EV_LONG) in->has_long = true;
+        }
+        in->active = true;
+    }
+}
+
+/* Runs on the input task only, so the ISR table never changes under a pending edge. */
+static void input_setup(void) {
+    for (int i = 0; i < MAX_INPUTS; i++) {
+        if (!g_input_rt[i].active) continue;
+        /* No gpio_reset_pin: the pin may just have been handed to a relay by the same config save. */
+        gpio_isr_handler_remove(g_input_rt[i].gpio);
+        gpio_intr_disable(g_input_rt[i].gpio);
+    }
+    memset(g_input_rt, 0, sizeof(g_input_rt));
+
+    act_call(input_load_job, NULL);
+
+    int active = 0;
+    for (int i = 0; i < MAX_INPUTS; i++) {
+        input_runtime_t *in = &g_input_rt[i];
+        if (!in->active) continue;
+        gpio_config_t io = {
+            .pin_bit_mask = 1ULL << in->gpio,
+            .mode = GPIO_MODE_INPUT,
+            .pull_up_en = in->active_low ? GPIO_PULLUP_ENABLE : GPIO_PULLUP_DISABLE,
+            .pull_down_en = in->active_low ? GPIO_PULLDOWN_DISABLE : GPIO_PULLDOWN_ENABLE,
+            .intr_type = GPIO_INTR_ANYEDGE,
+        };
+        if (gpio_config(&io) != ESP_OK || gpio_isr_handler_add(in->gpio, input_isr, (void *)(uintptr_t)i) != ESP_OK) {
+            ESP_LOGW(TAG, "Input %d pin %d setup failed", i, in->gpio);
+            in->active = false;
+            continue;
+        }
+        /* The level at setup is the baseline: a switch's position or a held button does not fire. */
+        in->pressed = input_read(in);
+        in->long_fired = true;
+        in->changed_us = esp_timer_get_time() - (int64_t)INPUT_DEBOUNCE_MS * 1000;
+        active++;
+    }
+    power_inputs_note(active > 0);
+    ESP_LOGI(TAG, "Inputs configured: %d active", active);
+}
+
+static void input_task(void *arg) {
+    (void)arg;
+    input_setup();
+    for (;;) {
+        uint8_t idx = 0;
+        TickType_t wait = input_run_timers(esp_timer_get_time());
+        if (xQueueReceive(g_input_q, &idx, wait) != pdTRUE) continue;
+        if (idx == INPUT_RECONFIGURE) {
+            input_setup();
+        } else if (idx < MAX_INPUTS) {
+            input_edge(idx, esp_timer_get_time());
+        }
+    }
+}
+
+/* Call after a config save; the input task re-reads inputs, bindings and pin conflicts. */
+static void input_reconfigure(void) {
+    uint8_t cmd = INPUT_RECONFIGURE;
+    if (g_input_q && xQueueSend(g_input_q, &cmd, pdMS_TO_TICKS(100)) != pdTRUE) {
+        ESP_LOGW(TAG, "Input reconfigure queue full; new input config applies after reboot");
+    }
+}
+
+static void start_inputs(void) {
+    esp_err_t err = gpio_install_isr_service(0);
+    if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) {
+        ESP_LOGW(TAG, "GPIO ISR service unavailable (%s); local inputs disabled", esp_err_to_name(err));
+        return;
+    }
+    g_input_q = xQueueCreate(INPUT_QUEUE_LEN, sizeof(uint8_t));
+    /* Above httpd and the automation task so a press is handled ahead of network work. */
+    if (!g_input_q || xTaskCreatePinnedToCore(input_task, "inputs", INPUT_STACK, NULL, 10, NULL, ACT_CORE) != pdPASS) {
+        ESP_LOGW(TAG, "Input task start failed; local inputs disabled");
+        if (g_input_q) vQueueDelete(g_input_q);
+        g_input_q = NULL;
+    }
+}
+
+static bool input_from_json(cJSON *item, input_entry_t *in) {
+    cJSON *gpio = cJSON_GetObjectItem(item, "gpio");
+    cJSON *mode = cJSON_GetObjectItem(item, "mode");
+    cJSON *active_low = cJSON_GetObjectItem(item, "active_low");
+    memset(in, 0, sizeof(*in));
+    if (!cJSON_IsObject(item) || !cJSON_IsNumber(gpio)) return false;
+    /* gpio -1 keeps the slot empty so later input indexes stay stable. */
+    if (gpio->valueint == -1) return true;
+    if (!is_safe_scan_gpio_int(gpio->valueint)) return false;
+    in->mode = INPUT_MODE_BUTTON;
+    if (cJSON_IsString(mode)) {
+        if (strcmp(mode->valuestring, "switch") == 0) {
+            in->mode = INPUT_MODE_SWITCH;
+        } else if (strcmp(mode->valuestring, "button") != 0) {
+            return false;
+        }
+    }
+    in->enabled = 1;
+    in->gpio = (uint8_t)gpio->valueint;
+    in->active_low = !cJSON_IsFalse(active_low);
+    return true;
+}
+
+static bool input_binding_from_json(cJSON *item, input_binding_t *b) {
+    control_op_t op;
+    if (!cJSON_IsObject(item) || !control_op_from_json(item, &op) || op.action == CTRL_ACT_KEEP) return false;
+    cJSON *input = cJSON_GetObjectItem(item, "input");
+    cJSON *event = cJSON_GetObjectItem(item, "event");
+    if (!cJSON_IsNumber(input) || input->valueint < 0 || input->valueint >= MAX_INPUTS) return false;
+    memset(b, 0, sizeof(*b));
+    b->event = INPUT_EV_COUNT;
+    for (int i = 0; i < INPUT_EV_COUNT; i++) {
+        if (cJSON_IsString(event) && strcmp(event->valuestring, INPUT_EVENT_NAMES[i]) == 0) b->event = (uint8_t)i;
+    }
+    if (b->event == INPUT_EV_COUNT) return false;
+    b->input = (uint8_t)input->valueint;
+    b->channel = (uint8_t)op.channel;
+    b->action = (uint8_t)op.action;
+    b->value = (int16_t)clamp_int(op.value, INT16_MIN, INT16_MAX);
+    b->transition_ms = (uint16_t)op.transition_ms;
+    b->duration_ms = (uint32_t)op.duration_ms;
+    return true;
+}
+
+static void write_inputs_json(json_writer_t *jw) {
+    jw_begin_array(jw, "inputs");
+    for (int i = 0; i < MAX_INPUTS; i++) {
+        const input_entry_t *in = &g_cfg.inputs[i];
+        if (!in->enabled) continue;
+        jw_begin_object(jw, NULL);
+        jw_int(jw, "id", i);
+        jw_int(jw, "gpio", in->gpio);
+        jw_str(jw, "mode", INPUT_MODE_NAMES[in->mode]);
+        jw_bool(jw, "active_low", in->active_low);
+        jw_bool(jw, "available", input_pin_available(in->gpio, i));
+        jw_end_object(jw);
+    }
+    jw_end_array(jw);
+    jw_begin_array(jw, "input_bindings");
+    for (int i = 0; i < MAX_INPUT_BINDINGS; i++) {
+        const input_binding_t *b = &g_cfg.input_bindings[i];
+        if (b->channel == CTRL_CH_NONE) continue;
+        jw_begin_object(jw, NULL);
+        jw_int(jw, "input", b->input);
+        jw_str(jw, "event", INPUT_EVENT_NAMES[b->event]);
+        jw_int(jw, "channel", b->channel);
+        jw_str(jw, "state", CONTROL_ACTION_NAMES[b->action]);
+        jw_int(jw, "value", b->value);
+        jw_int(jw, "transition_ms", b->transition_ms);
+        jw_int(jw, "duration_ms", (long)b->duration_ms);
+        jw_end_object(jw);
+    }
+    jw_end_array(jw);
+}
+
+static void configure_output_pins_only(void) {
+    configure_relay_gpio_outputs();
+    build_channel_registry();
+    if (aux_pin_available(LIGHT_SINGLE_PIN)) {
+        gpio_reset_pin(LIGHT_SINGLE_PIN);
+        gpio_set_direction(LIGHT_SINGLE_PIN, GPIO_MODE_OUTPUT);
+    } else {
+        ESP_LOGW(TAG, "LIGHT_SINGLE pin %d conflicts with relay mapping; feature disabled", LIGHT_SINGLE_PIN);
+    }
+    if (aux_pin_available(FAN_POWER_PIN)) {
+        gpio_reset_pin(FAN_POWER_PIN);
+        gpio_set_direction(FAN_POWER_PIN, GPIO_MODE_OUTPUT);
+    } else {
+        ESP_LOGW(TAG, "FAN_POWER pin %d conflicts with relay mapping; feature disabled", FAN_POWER_PIN);
+    }
+
+    ledc_timer_config_t timer = {
+        .speed_mode = LEDC_LOW_SPEED_MODE,
+        .duty_resolution = (ledc_timer_bit_t)PWM_DUTY_BITS,
+        .timer_num = LEDC_TIMER_0,
+        .freq_hz = 5000,
+        .clk_cfg = LEDC_AUTO_CLK,
+    };
+    ledc_timer_config(&timer);
+    init_gamma_table();
+
+    typedef struct {
+        int gpio;
         ledc_channel_t channel;
         const char *name;
     } pwm_chan_t;
@@ -642,6 +2109,7 @@ static void configure_output_pins_only(void) {
         {.gpio = RGB_W_PIN, .channel = CH_RGB_W, .name = "RGB_W"},
         {.gpio = FAN_SPEED_PIN, .channel = CH_FAN, .name = "FAN_SPEED"},
     };
+    g_ledc_ready_mask = 0;
     for (size_t i = 0; i < sizeof(chans) / sizeof(chans[0]); i++) {
         ledc_stop(LEDC_LOW_SPEED_MODE, chans[i].channel, 0);
         if (!aux_pin_available(chans[i].gpio)) {
@@ -655,28 +2123,36 @@ static void configure_output_pins_only(void) {
             .timer_sel = LEDC_TIMER_0,
             .duty = 0,
         };
-        ledc_channel_config(&cfg);
+        if (ledc_channel_config(&cfg) == ESP_OK) g_ledc_ready_mask |= 1u << chans[i].channel;
+    }
+    if (!g_ledc_fade_ready) {
+        g_ledc_fade_ready = ledc_fade_func_install(0) == ESP_OK;
+        if (!g_ledc_fade_ready) ESP_LOGW(TAG, "LEDC fade service unavailable; transitions will switch instantly");
     }
 }
 
 static void init_outputs(void) {
     configure_output_pins_only();
 
-    for (int i = 0; i < MAX_RELAYS; i++) apply_relay(i, false);
+    output_state_t boot = {0};
+    if (g_cfg.restore_outputs && !load_persisted_outputs(&boot)) {
+        ESP_LOGI(TAG, "No saved output state, starting with outputs off");
+    }
+    for (int i = 0; i < MAX_RELAYS; i++) apply_relay(i, boot.relay[i]);
     for (int i = g_cfg.relay_count; i < MAX_RELAYS; i++) {
         if (valid_output_gpio_int(g_cfg.relay_gpio[i])) {
             gpio_set_level((gpio_num_t)g_cfg.relay_gpio[i], 0);
         }
         g_state.relay[i] = false;
     }
-    apply_light_single(false);
-    apply_dimmer(0);
-    apply_rgb(0, 0, 0, 0);
-    apply_fan(false, 0);
+    apply_light_single(boot.light_single);
+    apply_dimmer(boot.dimmer_pct, 0);
+    apply_rgb(boot.rgb[0], boot.rgb[1], boot.rgb[2], boot.rgb[3], 0);
+    apply_fan(boot.fan_power, boot.fan_speed_pct, 0);
 }
 
-static void add_ip_info_to_json(cJSON *obj, const char *prefix, esp_netif_t *netif) {
-    if (!obj || !prefix || !netif) return;
+static void write_ip_info_json(json_writer_t *jw, const char *prefix, esp_netif_t *netif) {
+    if (!prefix || !netif) return;
     esp_netif_ip_info_t info = {0};
     if (esp_netif_get_ip_info(netif, &info) != ESP_OK) return;
     char ip[20] = {0};
@@ -692,25 +2168,25 @@ static void add_ip_info_to_json(cJSON *obj, const char *prefix, esp_netif_t *net
     snprintf(key_ip, sizeof(key_ip), "%s_ip", prefix);
     snprintf(key_gw, sizeof(key_gw), "%s_gw", prefix);
     snprintf(key_mask, sizeof(key_mask), "%s_mask", prefix);
-    cJSON_AddStringToObject(obj, key_ip, ip);
-    cJSON_AddStringToObject(obj, key_gw, gw);
-    cJSON_AddStringToObject(obj, key_mask, mask);
+    jw_str(jw, key_ip, ip);
+    jw_str(jw, key_gw, gw);
+    jw_str(jw, key_mask, mask);
 }
 
-static void add_network_status(cJSON *root) {
-    cJSON *net = cJSON_CreateObject();
+static void write_network_status(json_writer_t *jw) {
+    jw_begin_object(jw, "network");
     wifi_mode_t mode = WIFI_MODE_NULL;
     esp_err_t mode_err = esp_wifi_get_mode(&mode);
     if (mode_err != ESP_OK) {
-        cJSON_AddStringToObject(net, "mode", "unknown");
+        jw_str(jw, "mode", "unknown");
     } else if (mode == WIFI_MODE_STA) {
-        cJSON_AddStringToObject(net, "mode", "sta");
+        jw_str(jw, "mode", "sta");
     } else if (mode == WIFI_MODE_AP) {
-        cJSON_AddStringToObject(net, "mode", "ap");
+        jw_str(jw, "mode", "ap");
     } else if (mode == WIFI_MODE_APSTA) {
-        cJSON_AddStringToObject(net, "mode", "apsta");
+        jw_str(jw, "mode", "apsta");
     } else {
-        cJSON_AddStringToObject(net, "mode", "unknown");
+        jw_str(jw, "mode", "unknown");
     }
 
     bool sta_connected = false;
@@ -718,419 +2194,667 @@ static void add_network_status(cJSON *root) {
         EventBits_t bits = xEventGroupGetBits(g_wifi_events);
         sta_connected = (bits & WIFI_CONNECTED_BIT) != 0;
     }
-    cJSON_AddBoolToObject(net, "sta_connected", sta_connected);
-    cJSON_AddNumberToObject(net, "last_disconnect_reason", g_last_wifi_disc_reason);
-    cJSON_AddStringToObject(net, "configured_ssid", g_cfg.wifi_ssid);
-    cJSON_AddStringToObject(net, "fallback_ap_ssid", g_cfg.ap_ssid);
-    cJSON_AddBoolToObject(net, "static_ip_enabled", g_cfg.use_static_ip);
+    jw_bool(jw, "sta_connected", sta_connected);
+    jw_str(jw, "wifi_state", WIFI_STATE_NAMES[g_wifi_state]);
+    jw_bool(jw, "ap_fallback_active", g_wifi_ap_active);
+    jw_begin_object(jw, "reconnect");
+    jw_int(jw, "connects", (long)g_wifi_timing.connects);
+    jw_int(jw, "last_connect_ms", (long)g_wifi_timing.last_connect_ms);
+    jw_bool(jw, "last_fast", g_wifi_timing.last_fast);
+    jw_int(jw, "attempts", g_sta_fail_count);
+    jw_end_object(jw);
+    jw_int(jw, "last_disconnect_reason", g_last_wifi_disc_reason);
+    jw_str(jw, "configured_ssid", g_cfg.wifi_ssid);
+    jw_str(jw, "fallback_ap_ssid", g_cfg.ap_ssid);
+    jw_bool(jw, "static_ip_enabled", g_cfg.use_static_ip);
+    jw_bool(jw, "time_synced", g_time_synced);
+#if CONFIG_EIGHTBB_MQTT
+    jw_bool(jw, "mqtt_connected", g_mqtt_connected);
+#endif
 
     wifi_ap_record_t ap_info = {0};
-    if (esp_wifi_sta_get_ap_info(&ap_info) == ESP_OK) {
-        cJSON_AddStringToObject(net, "connected_ssid", (const char *)ap_info.ssid);
-        cJSON_AddNumberToObject(net, "rssi", ap_info.rssi);
-    } else {
-        cJSON_AddStringToObject(net, "connected_ssid", "");
-    }
-
-    add_ip_info_to_json(net, "sta", g_sta_netif);
-    add_ip_info_to_json(net, "ap", g_ap_netif);
-    cJSON_AddItemToObject(root, "network", net);
-}
-
-static esp_err_t status_handler(httpd_req_t *req) {
-    sanitize_relay_gpio_map();
-    cJSON *root = cJSON_CreateObject();
-    cJSON_AddStringToObject(root, "name", g_cfg.name);
-    cJSON_AddStringToObject(root, "device_id", g_cfg.device_id);
-    cJSON_AddStringToObject(root, "type", g_cfg.type);
-    cJSON_AddNumberToObject(root, "relay_count", g_cfg.relay_count);
-    cJSON_AddBoolToObject(root, "static_ip_enabled", g_cfg.use_static_ip);
-    cJSON_AddStringToObject(root, "static_ip", g_cfg.static_ip);
-    cJSON_AddStringToObject(root, "gateway", g_cfg.gateway);
-    cJSON_AddStringToObject(root, "subnet_mask", g_cfg.subnet_mask);
-    cJSON_AddStringToObject(root, "fw_version", "0.3.0");
-    cJSON_AddStringToObject(root, "ota_mode", "signed-hmac");
-    add_outputs_json(root);
-    cJSON *relay_gpio = cJSON_CreateArray();
-    for (int i = 0; i < MAX_RELAYS; i++) {
-        cJSON_AddItemToArray(relay_gpio, cJSON_CreateNumber(g_cfg.relay_gpio[i]));
-    }
-    cJSON_AddItemToObject(root, "relay_gpio", relay_gpio);
-    cJSON *relay_names = cJSON_CreateArray();
-    for (int i = 0; i < MAX_RELAYS; i++) {
-        cJSON_AddItemToArray(relay_names, cJSON_CreateString(g_cfg.relay_names[i]));
-    }
-    cJSON_AddItemToObject(root, "relay_names", relay_names);
-    cJSON *gpio_candidates = cJSON_CreateArray();
-    for (size_t i = 0; i < sizeof(SAFE_SCAN_GPIOS) / sizeof(SAFE_SCAN_GPIOS[0]); i++) {
+    jw_str(jw, "connected_ssid", esp_wifi_sta_get_ap_info(&ap_info) == ESP_OK ? (const char *)ap_info.ssid : "");
+
+    write_ip_info_json(jw, "sta", g_sta_netif);
+    write_ip_info_json(jw, "ap", g_ap_netif);
+    jw_end_object(jw);
+}
+
+/* Values sampled per request; kept out of the network tier so its ETag stays exact. */
+static void write_live_status(json_writer_t *jw) {
+    bool sta_connected = g_wifi_events && (xEventGroupGetBits(g_wifi_events) & WIFI_CONNECTED_BIT) != 0;
+    int64_t now_us = esp_timer_get_time();
+    jw_begin_object(jw, "live");
+    wifi_ap_record_t ap_info = {0};
+    if (esp_wifi_sta_get_ap_info(&ap_info) == ESP_OK) jw_int(jw, "rssi", ap_info.rssi);
+    jw_int(jw, "outage_ms", sta_connected ? 0 : (long)((now_us - g_wifi_timing.outage_start_us) / 1000));
+    jw_int(jw, "next_retry_ms",
+           g_wifi_state == WIFI_STATE_BACKOFF && g_wifi_timing.next_retry_us > now_us ? (long)((g_wifi_timing.next_retry_us - now_us) / 1000) : 0);
+    jw_end_object(jw);
+}
+
+#define STATUS_TIER_CONFIG BIT0
+#define STATUS_TIER_OUTPUTS BIT1
+#define STATUS_TIER_NETWORK BIT2
+/* Only on request (fields=live); a response carrying it has no ETag and is never a 304. */
+#define STATUS_TIER_LIVE BIT3
+#define STATUS_TIER_ALL (STATUS_TIER_CONFIG | STATUS_TIER_OUTPUTS | STATUS_TIER_NETWORK)
+
+/* sha256 of this boot's image as installed over the air (ota_running_image_init); "" when unknown. */
+static char g_running_sha256[65] = "";
+
+/* Static + config tier; only changes when save_config_to_nvs bumps g_cfg_generation. */
+static void write_status_config_members(json_writer_t *jw) {
+    jw_str(jw, "name", g_cfg.name);
+    jw_str(jw, "device_id", g_cfg.device_id);
+    jw_str(jw, "type", g_cfg.type);
+    jw_int(jw, "relay_count", g_cfg.relay_count);
+    jw_bool(jw, "static_ip_enabled", g_cfg.use_static_ip);
+    jw_str(jw, "static_ip", g_cfg.static_ip);
+    jw_str(jw, "gateway", g_cfg.gateway);
+    jw_str(jw, "subnet_mask", g_cfg.subnet_mask);
+    jw_bool(jw, "restore_outputs", g_cfg.restore_outputs);
+    jw_int(jw, "state_save_delay_ms", g_cfg.state_save_delay_ms);
+    jw_str(jw, "fw_version", FW_BUILD_VERSION);
+    jw_str(jw, "fw_sha256", g_running_sha256);
+    jw_str(jw, "ota_mode", "signed-hmac");
+    jw_begin_array(jw, "relay_gpio");
+    for (int i = 0; i < MAX_RELAYS; i++) jw_int(jw, NULL, g_cfg.relay_gpio[i]);
+    jw_end_array(jw);
+    jw_begin_array(jw, "relay_names");
+    for (int i = 0; i < MAX_RELAYS; i++) jw_str(jw, NULL, g_cfg.relay_names[i]);
+    jw_end_array(jw);
+    jw_begin_array(jw, "gpio_candidates");
+    for (size_t i = 0; i < SAFE_SCAN_GPIO_COUNT; i++) {
         int pin = SAFE_SCAN_GPIOS[i];
         if (g_web_led_enabled && pin == WEB_STATUS_LED_PIN) continue;
-        if (GPIO_IS_VALID_OUTPUT_GPIO(pin) && is_safe_scan_gpio_int(pin)) {
-            cJSON_AddItemToArray(gpio_candidates, cJSON_CreateNumber(pin));
+        if (GPIO_IS_VALID_OUTPUT_GPIO(pin) && is_safe_scan_gpio_int(pin)) jw_int(jw, NULL, pin);
+    }
+    jw_end_array(jw);
+    write_schedules_json(jw);
+    write_inputs_json(jw);
+    jw_str(jw, "mqtt_uri", g_cfg.mqtt_uri);
+    jw_str(jw, "mqtt_user", g_cfg.mqtt_user);
+    jw_bool(jw, "mqtt_pass_set", g_cfg.mqtt_pass[0] != '\0');
+    jw_str(jw, "mqtt_prefix", g_cfg.mqtt_prefix);
+    jw_str(jw, "power_profile", power_profile_name(g_cfg.power_profile));
+    jw_int(jw, "power_wake_hold_ms", g_cfg.power_wake_hold_ms);
+    jw_int(jw, "power_listen_interval", g_cfg.power_listen_interval);
+    jw_begin_array(jw, "channels");
+    for (int id = CTRL_CH_RELAY1; id < CTRL_CH_COUNT; id++) {
+        if (!g_channels[id].enabled) continue;
+        jw_begin_object(jw, NULL);
+        jw_int(jw, "id", id);
+        jw_str(jw, "name", g_channels[id].name);
+        jw_end_object(jw);
+    }
+    jw_end_array(jw);
+    jw_bool(jw, "web_ui_running", g_server != NULL);
+    jw_bool(jw, "web_led_enabled", g_web_led_enabled);
+    jw_int(jw, "web_led_pin", WEB_STATUS_LED_PIN);
+}
+
+typedef struct {
+    char *members;
+    uint32_t generation;
+} status_config_render_t;
+
+/* Runs on the actuation task so g_cfg and g_channels cannot change mid-render. The generation is
+ * read here too: it is bumped only after the commit, so the tag is never newer than the content. */
+static void status_config_render_job(void *ctx) {
+    status_config_render_t *r = (status_config_render_t *)ctx;
+    r->generation = g_cfg_generation;
+    json_writer_t jw;
+    jw_init(&jw, NULL, NULL, 0);
+    write_status_config_members(&jw);
+    size_t size = jw.total + 1;
+    r->members = malloc(size);
+    if (!r->members) return;
+    jw_init(&jw, NULL, r->members, size);
+    write_status_config_members(&jw);
+    if (!jw_cstr(&jw)) {
+        free(r->members);
+        r->members = NULL;
+    }
+}
+
+/* Returns the config tier as bare object members (no braces), rendered once per generation. */
+static const char *status_config_members(void) {
+    if (g_status_cfg_cache && g_status_cfg_cache_gen == g_cfg_generation) return g_status_cfg_cache;
+    status_config_render_t r = {0};
+    act_call(status_config_render_job, &r);
+    if (!r.members) return NULL;
+    free(g_status_cfg_cache);
+    g_status_cfg_cache = r.members;
+    g_status_cfg_cache_gen = r.generation;
+    return g_status_cfg_cache;
+}
+
+static int parse_status_tiers(httpd_req_t *req) {
+    char query[64] = {0};
+    char fields[48] = {0};
+    if (httpd_req_get_url_query_str(req, query, sizeof(query)) != ESP_OK) return STATUS_TIER_ALL;
+    if (httpd_query_key_value(query, "fields", fields, sizeof(fields)) != ESP_OK) return STATUS_TIER_ALL;
+    int tiers = 0;
+    char *save = NULL;
+    for (char *tok = strtok_r(fields, ",", &save); tok; tok = strtok_r(NULL, ",", &save)) {
+        if (strcmp(tok, "config") == 0 || strcmp(tok, "static") == 0) tiers |= STATUS_TIER_CONFIG;
+        else if (strcmp(tok, "outputs") == 0) tiers |= STATUS_TIER_OUTPUTS;
+        else if (strcmp(tok, "network") == 0) tiers |= STATUS_TIER_NETWORK;
+        else if (strcmp(tok, "live") == 0) tiers |= STATUS_TIER_LIVE;
+    }
+    return tiers ? tiers : STATUS_TIER_ALL;
+}
+
+/* Every cached tier only changes with its generation counter, so the ETag is strong. The boot id
+ * keeps a tag held from before a reboot (config save, OTA, restored outputs) from matching after it. */
+static void build_status_etag(int tiers, char *out, size_t out_size) {
+    while (g_status_boot_id == 0) g_status_boot_id = esp_random();
+    snprintf(out, out_size, "\"b%08x-t%d-c%u-o%u-n%u\"", (unsigned)g_status_boot_id, tiers,
+             (unsigned)((tiers & STATUS_TIER_CONFIG) ? g_cfg_generation : 0),
+             (unsigned)((tiers & STATUS_TIER_OUTPUTS) ? g_state_generation : 0),
+             (unsigned)((tiers & STATUS_TIER_NETWORK) ? g_net_generation : 0));
+}
+
+static bool etag_matches(httpd_req_t *req, const char *etag) {
+    char inm[128] = {0};
+    if (httpd_req_get_hdr_value_str(req, "If-None-Match", inm, sizeof(inm)) != ESP_OK) return false;
+    if (strcmp(inm, "*") == 0) return true;
+    /* Weak comparison: ignore W/ prefixes on either side. */
+    const char *opaque = strncmp(etag, "W/", 2) == 0 ? etag + 2 : etag;
+    return strstr(inm, opaque) != NULL;
+}
+
+static esp_err_t send_not_modified(httpd_req_t *req, const char *etag) {
+    httpd_resp_set_status(req, "304 Not Modified");
+    httpd_resp_set_hdr(req, "ETag", etag);
+    return httpd_resp_send(req, NULL, 0);
+}
+
+static esp_err_t status_handler(httpd_req_t *req, http_auth_t auth) {
+    int tiers = parse_status_tiers(req);
+    char etag[64] = {0};
+    if (!(tiers & STATUS_TIER_LIVE)) {
+        build_status_etag(tiers, etag, sizeof(etag));
+        if (etag_matches(req, etag)) return send_not_modified(req, etag);
+    }
+
+    const char *cfg_members = NULL;
+    if (tiers & STATUS_TIER_CONFIG) {
+        cfg_members = status_config_members();
+        if (!cfg_members) return http_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "status render failed");
+    }
+
+    char buf[JSON_WRITER_BUF];
+    json_writer_t jw;
+    jw_init(&jw, req, buf, sizeof(buf));
+    if (etag[0]) httpd_resp_set_hdr(req, "ETag", etag);
+    httpd_resp_set_hdr(req, "Cache-Control", etag[0] ? "no-cache" : "no-store");
+    jw_begin_object(&jw, NULL);
+    jw_raw_members(&jw, cfg_members);
+    if (tiers & STATUS_TIER_OUTPUTS) write_current_outputs_json(&jw);
+    if (tiers & STATUS_TIER_NETWORK) write_network_status(&jw);
+    if (tiers & STATUS_TIER_LIVE) write_live_status(&jw);
+    jw_end_object(&jw);
+    return jw_send(&jw);
+}
+
+static esp_err_t send_events_snapshot(httpd_req_t *req) {
+    char buf[JSON_WRITER_BUF];
+    json_writer_t jw;
+    jw_init(&jw, NULL, buf, sizeof(buf));
+    jw_begin_object(&jw, NULL);
+    jw_str(&jw, "type", "snapshot");
+    jw_int(&jw, "seq", (long)g_event_seq);
+    write_current_outputs_json(&jw);
+    jw_end_object(&jw);
+    const char *body = jw_cstr(&jw);
+    if (!body) return ESP_FAIL;
+    httpd_ws_frame_t ws = {
+        .final = true,
+        .type = HTTPD_WS_TYPE_TEXT,
+        .payload = (uint8_t *)body,
+        .len = jw.len,
+    };
+    return httpd_ws_send_frame(req, &ws);
+}
+
+static esp_err_t events_handler(httpd_req_t *req) {
+    if (req->method == HTTP_GET) {
+        int fd = httpd_req_to_sockfd(req);
+        if (!events_add_client(fd)) {
+            ESP_LOGW(TAG, "Event client fd=%d rejected, %d clients connected", fd, g_event_client_count);
+            return ESP_FAIL;
+        }
+        ESP_LOGI(TAG, "Event client fd=%d connected (clients=%d)", fd, g_event_client_count);
+        power_wake_note();
+        return send_events_snapshot(req);
+    }
+
+    /* Clients only send short text commands; "snapshot" re-sends the full output state. */
+    uint8_t buf[32] = {0};
+    httpd_ws_frame_t frame = {.type = HTTPD_WS_TYPE_TEXT};
+    esp_err_t err = httpd_ws_recv_frame(req, &frame, 0);
+    if (err != ESP_OK) return err;
+    if (frame.len == 0) return ESP_OK;
+    if (frame.len >= sizeof(buf)) return ESP_FAIL;
+    frame.payload = buf;
+    err = httpd_ws_recv_frame(req, &frame, frame.len);
+    if (err != ESP_OK) return err;
+    if (frame.type == HTTPD_WS_TYPE_TEXT && strcmp((const char *)buf, "snapshot") == 0) {
+        return send_events_snapshot(req);
+    }
+    return ESP_OK;
+}
+
+static void http_close_handler(httpd_handle_t hd, int sockfd) {
+    (void)hd;
+    events_remove_client(sockfd);
+    close(sockfd);
+}
+
+static esp_err_t web_root_handler(httpd_req_t *req, http_auth_t auth) {
+    // The UI is stored pre-gzipped (see main/web/index.html); every browser we target accepts gzip.
+    if (etag_matches(req, WEB_UI_GZ_ETAG)) {
+        return send_not_modified(req, WEB_UI_GZ_ETAG);
+    }
+    httpd_resp_set_type(req, "text/html; charset=utf-8");
+    httpd_resp_set_hdr(req, "Content-Encoding", "gzip");
+    httpd_resp_set_hdr(req, "Vary", "Accept-Encoding");
+    httpd_resp_set_hdr(req, "ETag", WEB_UI_GZ_ETAG);
+    httpd_resp_set_hdr(req, "Cache-Control", "no-cache");
+    return httpd_resp_send(req, (const char *)WEB_UI_GZ, WEB_UI_GZ_LEN);
+}
+
+static esp_err_t favicon_handler(httpd_req_t *req, http_auth_t auth) {
+    httpd_resp_set_status(req, "204 No Content");
+    return httpd_resp_send(req, NULL, 0);
+}
+
+/* Request bodies are read into a small pool allocated once at server start instead of per-handler
+ * stack arrays, and are read until content_len so TCP-segmented bodies are not truncated. */
+#define HTTP_BODY_MAX 4096
+#define HTTP_BODY_POOL 2
+#define HTTP_BODY_WAIT_MS 2000
+#define HTTP_BODY_RECV_RETRIES 3
+
+typedef struct {
+    char *data;
+    int len;
+    int slot;
+} http_body_t;
+
+static char *g_body_pool = NULL;
+static QueueHandle_t g_body_free_q = NULL;
+
+static bool http_body_pool_init(void) {
+    if (g_body_pool) return true;
+    g_body_pool = malloc((size_t)HTTP_BODY_POOL * (HTTP_BODY_MAX + 1));
+    g_body_free_q = xQueueCreate(HTTP_BODY_POOL, sizeof(int));
+    if (!g_body_pool || !g_body_free_q) {
+        ESP_LOGE(TAG, "HTTP body pool allocation failed");
+        return false;
+    }
+    for (int i = 0; i < HTTP_BODY_POOL; i++) xQueueSend(g_body_free_q, &i, 0);
+    return true;
+}
+
+static void http_body_release(http_body_t *body) {
+    if (body->slot >= 0) xQueueSend(g_body_free_q, &body->slot, 0);
+    body->slot = -1;
+    body->data = NULL;
+}
+
+/* On failure the error response has already been sent and *err holds its result. */
+static bool http_body_read(httpd_req_t *req, http_body_t *body, esp_err_t *err) {
+    body->data = NULL;
+    body->len = 0;
+    body->slot = -1;
+    if (req->content_len == 0) {
+        *err = http_send_err(req, HTTPD_400_BAD_REQUEST, "bad payload");
+        return false;
+    }
+    if (req->content_len > HTTP_BODY_MAX) {
+        *err = http_send_err(req, HTTPD_413_CONTENT_TOO_LARGE, "payload too large");
+        return false;
+    }
+    if (!g_body_free_q || xQueueReceive(g_body_free_q, &body->slot, pdMS_TO_TICKS(HTTP_BODY_WAIT_MS)) != pdTRUE) {
+        body->slot = -1;
+        *err = http_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "server busy");
+        return false;
+    }
+    body->data = g_body_pool + (size_t)body->slot * (HTTP_BODY_MAX + 1);
+    int timeouts = 0;
+    while (body->len < (int)req->content_len) {
+        int r = httpd_req_recv(req, body->data + body->len, req->content_len - body->len);
+        if (r == HTTPD_SOCK_ERR_TIMEOUT && ++timeouts <= HTTP_BODY_RECV_RETRIES) continue;
+        if (r <= 0) {
+            http_body_release(body);
+            *err = http_send_err(req, HTTPD_408_REQ_TIMEOUT, "body read failed");
+            return false;
         }
+        body->len += r;
+    }
+    body->data[body->len] = '\0';
+    return true;
+}
+
+/* Reads the body and parses it with cJSON; the pooled buffer is returned before this exits. */
+static cJSON *http_body_parse_json(httpd_req_t *req, esp_err_t *err) {
+    http_body_t body;
+    if (!http_body_read(req, &body, err)) return NULL;
+    cJSON *root = cJSON_Parse(body.data);
+    http_body_release(&body);
+    if (!root) *err = http_send_err(req, HTTPD_400_BAD_REQUEST, "json parse failed");
+    return root;
+}
+
+/* Admission control, run from http_route_entry before auth or any body read:
+ * - every client IP gets a token bucket per class, so a tight status poller runs dry without
+ *   touching anyone's control budget;
+ * - requests in flight (the one on the httpd task plus queued/running async jobs) are capped by free
+ *   heap, and each class needs a heap floor. Control is exempt from the cap and has the lowest floor,
+ *   so it keeps working while status and OTA are being refused.
+ * Refusals are a fixed 429 with Retry-After. The client table is only touched on the httpd task. */
+#define HTTP_RL_CLIENTS 8
+#define HTTP_RL_MILLI 1000
+#define HTTP_INFLIGHT_HEAP_PER_REQ (8 * 1024)
+
+typedef struct {
+    uint16_t per_s;
+    uint16_t burst;
+    uint32_t min_heap;
+} http_class_limit_t;
+
+static const http_class_limit_t HTTP_CLASS_LIMITS[HTTP_CLASS_COUNT] = {
+    [HTTP_CLASS_STATUS] = {HTTPD_CFG_RL_STATUS_PER_S, HTTPD_CFG_RL_STATUS_PER_S * 2, 24 * 1024},
+    [HTTP_CLASS_CONTROL] = {HTTPD_CFG_RL_CONTROL_PER_S, HTTPD_CFG_RL_CONTROL_PER_S * 2, 6 * 1024},
+    [HTTP_CLASS_BULK] = {HTTPD_CFG_RL_BULK_PER_S, HTTPD_CFG_RL_BULK_PER_S * 3, 40 * 1024},
+};
+
+typedef struct {
+    uint32_t ip; /* network order, 0 = free slot */
+    int64_t last_us;
+    uint32_t tokens_milli[HTTP_CLASS_COUNT];
+    int64_t refill_us[HTTP_CLASS_COUNT];
+} http_rl_client_t;
+
+static http_rl_client_t g_http_rl[HTTP_RL_CLIENTS];
+static int g_http_inflight = 0;
+static portMUX_TYPE g_http_inflight_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static uint32_t http_client_ip(httpd_req_t *req) {
+    int fd = httpd_req_to_sockfd(req);
+    struct sockaddr_storage addr;
+    socklen_t len = sizeof(addr);
+    if (fd < 0 || getpeername(fd, (struct sockaddr *)&addr, &len) != 0) return 0;
+    if (addr.ss_family == AF_INET) return ((struct sockaddr_in *)&addr)->sin_addr.s_addr;
+    uint32_t v4 = 0;
+    /* IPv4 clients of a dual-stack listener show up as ::ffff:a.b.c.d. */
+    if (addr.ss_family == AF_INET6) memcpy(&v4, &((struct sockaddr_in6 *)&addr)->sin6_addr.s6_addr[12], sizeof(v4));
+    return v4;
+}
+
+static http_rl_client_t *http_rl_client(uint32_t ip, int64_t now_us) {
+    http_rl_client_t *victim = &g_http_rl[0];
+    for (int i = 0; i < HTTP_RL_CLIENTS; i++) {
+        if (g_http_rl[i].ip == ip) return &g_http_rl[i];
+        if (g_http_rl[i].last_us < victim->last_us) victim = &g_http_rl[i];
+    }
+    /* Evict the client seen longest ago; a newcomer starts with full buckets. */
+    memset(victim, 0, sizeof(*victim));
+    victim->ip = ip;
+    for (int c = 0; c < HTTP_CLASS_COUNT; c++) {
+        victim->tokens_milli[c] = (uint32_t)HTTP_CLASS_LIMITS[c].burst * HTTP_RL_MILLI;
+        victim->refill_us[c] = now_us;
+    }
+    return victim;
+}
+
+static bool http_rl_take(http_rl_client_t *client, http_class_t cls, int64_t now_us) {
+    const http_class_limit_t *lim = &HTTP_CLASS_LIMITS[cls];
+    uint32_t cap = (uint32_t)lim->burst * HTTP_RL_MILLI;
+    int64_t refill = (now_us - client->refill_us[cls]) * lim->per_s / (1000000 / HTTP_RL_MILLI);
+    if (refill > 0) {
+        uint64_t tokens = (uint64_t)client->tokens_milli[cls] + (uint64_t)refill;
+        client->tokens_milli[cls] = tokens > cap ? cap : (uint32_t)tokens;
+        client->refill_us[cls] = now_us;
+    }
+    if (client->tokens_milli[cls] < HTTP_RL_MILLI) return false;
+    client->tokens_milli[cls] -= HTTP_RL_MILLI;
+    return true;
+}
+
+static void http_inflight_release(void) {
+    portENTER_CRITICAL(&g_http_inflight_lock);
+    if (g_http_inflight > 0) g_http_inflight--;
+    portEXIT_CRITICAL(&g_http_inflight_lock);
+}
+
+/* True when the request may run; the caller then owes one http_inflight_release(). */
+static bool http_admit(httpd_req_t *req, http_class_t cls) {
+    int64_t now_us = esp_timer_get_time();
+    uint32_t ip = http_client_ip(req);
+    if (ip != 0) {
+        http_rl_client_t *client = http_rl_client(ip, now_us);
+        client->last_us = now_us;
+        if (!http_rl_take(client, cls, now_us)) return false;
     }
-    cJSON_AddItemToObject(root, "gpio_candidates", gpio_candidates);
-    cJSON_AddBoolToObject(root, "web_ui_running", g_server != NULL);
-    cJSON_AddBoolToObject(root, "web_led_enabled", g_web_led_enabled);
-    cJSON_AddNumberToObject(root, "web_led_pin", WEB_STATUS_LED_PIN);
-    add_network_status(root);
 
-    esp_err_t err = send_json(req, root);
-    cJSON_Delete(root);
-    return err;
+    uint32_t free_heap = esp_get_free_heap_size();
+    if (free_heap < HTTP_CLASS_LIMITS[cls].min_heap) return false;
+    int cap = (int)(free_heap / HTTP_INFLIGHT_HEAP_PER_REQ);
+    if (cap > HTTPD_CFG_INFLIGHT_MAX) cap = HTTPD_CFG_INFLIGHT_MAX;
+    if (cap < 1) cap = 1;
+    bool ok;
+    portENTER_CRITICAL(&g_http_inflight_lock);
+    ok = cls == HTTP_CLASS_CONTROL || g_http_inflight < cap;
+    if (ok) g_http_inflight++;
+    portEXIT_CRITICAL(&g_http_inflight_lock);
+    return ok;
+}
+
+static esp_err_t http_send_limited(httpd_req_t *req, http_route_t *route) {
+    portENTER_CRITICAL(&g_metrics_lock);
+    route->stats.limited++;
+    route->stats.errors++;
+    portEXIT_CRITICAL(&g_metrics_lock);
+    httpd_resp_set_status(req, "429 Too Many Requests");
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_set_hdr(req, "Retry-After", "1");
+    return httpd_resp_sendstr(req, "{\"detail\":\"rate limited\"}");
+}
+
+/* Long operations (OTA download/upload, config save) run on a worker task with an async request
+ * copy, so the httpd task keeps serving control and status while they are in progress. */
+#define HTTP_ASYNC_QUEUE_LEN 4
+#define HTTP_ASYNC_STACK 8192
+
+typedef struct {
+    httpd_req_t *req;
+    http_route_t *route;
+    http_auth_t auth;
+    int64_t start_us;
+} http_async_job_t;
+
+static QueueHandle_t g_http_async_q = NULL;
+
+static void http_async_worker(void *arg) {
+    http_async_job_t job;
+    for (;;) {
+        if (xQueueReceive(g_http_async_q, &job, portMAX_DELAY) != pdTRUE) continue;
+        esp_err_t err = job.route->fn(job.req, job.auth);
+        http_route_record(job.route, esp_timer_get_time() - job.start_us, err != ESP_OK);
+        httpd_req_async_handler_complete(job.req);
+        http_inflight_release();
+    }
+}
+
+static bool http_async_init(void) {
+    if (g_http_async_q) return true;
+    g_http_async_q = xQueueCreate(HTTP_ASYNC_QUEUE_LEN, sizeof(http_async_job_t));
+    if (!g_http_async_q ||
+        xTaskCreatePinnedToCore(http_async_worker, "http_async", HTTP_ASYNC_STACK, NULL, 5, NULL, NET_CORE) != pdPASS) {
+        ESP_LOGE(TAG, "HTTP async worker start failed");
+        return false;
+    }
+    return true;
 }
 
-static esp_err_t web_root_handler(httpd_req_t *req) {
-    const char *html =
-        "<!doctype html>"
-        "<html><head><meta charset='utf-8'/>"
-        "<meta name='viewport' content='width=device-width,initial-scale=1'/>"
-        "<title>8bb ESP32</title>"
-        "<style>"
-        ":root{color-scheme:dark;--bg:#0b1318;--bg-soft:#112028;--panel:#14242d;--panel-soft:#19313c;--line:#294754;--line-strong:#376173;--ink:#eaf6f8;--ink-soft:#9db7c0;--primary:#14967f;--primary-strong:#0f7665;--primary-soft:#133d38;--secondary:#1c3340;--shadow:0 18px 40px rgba(0,0,0,.28)}"
-        "*{box-sizing:border-box}"
-        "body{margin:0;font-family:'Segoe UI','Noto Sans',sans-serif;background:radial-gradient(circle at 14% 12%,rgba(20,150,127,.18),transparent 28%),radial-gradient(circle at 84% 10%,rgba(70,121,166,.16),transparent 24%),linear-gradient(180deg,#0d171d 0%,#0a1116 100%);color:var(--ink)}"
-        ".shell{max-width:1320px;margin:0 auto;padding:24px 16px 36px}"
-        ".hero{display:grid;grid-template-columns:minmax(0,1.5fr) minmax(220px,.8fr);gap:16px;align-items:end;margin-bottom:16px}"
-        ".hero-copy{padding:22px 24px;border:1px solid rgba(55,97,115,.55);border-radius:22px;background:linear-gradient(180deg,rgba(25,49,60,.92),rgba(15,31,40,.94));box-shadow:var(--shadow)}"
-        ".eyebrow{text-transform:uppercase;letter-spacing:.14em;font-size:11px;font-weight:700;color:#8ecfbe}"
-        "h1{margin:8px 0 6px;font-size:30px;letter-spacing:-.03em}"
-        ".hero-copy p{margin:0;color:var(--ink-soft);line-height:1.6}"
-        ".hero-aside{display:grid;gap:10px}"
-        ".hero-chip{padding:14px 16px;border-radius:18px;border:1px solid rgba(55,97,115,.55);background:rgba(18,35,44,.86);color:var(--ink-soft);box-shadow:var(--shadow)}"
-        ".hero-chip strong{display:block;margin-top:4px;color:var(--ink)}"
-        "h2{font-size:17px;margin:0 0 12px;letter-spacing:-.02em}"
-        ".card{border:1px solid rgba(55,97,115,.52);border-radius:20px;padding:18px;background:linear-gradient(180deg,rgba(20,36,45,.94),rgba(13,26,33,.96));margin-bottom:14px;box-shadow:var(--shadow)}"
-        ".row{display:grid;grid-template-columns:repeat(2,minmax(0,1fr));gap:12px}"
-        ".row3{display:grid;grid-template-columns:repeat(3,minmax(0,1fr));gap:12px}"
-        ".row4{display:grid;grid-template-columns:repeat(4,minmax(0,1fr));gap:12px}"
-        "label{display:block;font-size:12px;font-weight:600;color:var(--ink-soft);margin-bottom:6px;letter-spacing:.02em}"
-        "input,select,button,textarea{width:100%;padding:12px 14px;border-radius:14px;border:1px solid var(--line);background:#0d171d;color:var(--ink);box-sizing:border-box;font:inherit}"
-        "input:focus,select:focus,textarea:focus{outline:none;border-color:#3fa594;box-shadow:0 0 0 4px rgba(20,150,127,.14)}"
-        "button{cursor:pointer;border-color:transparent;background:linear-gradient(180deg,var(--primary) 0%,var(--primary-strong) 100%);font-weight:700;letter-spacing:.01em;box-shadow:0 12px 24px rgba(20,150,127,.18);transition:transform .16s ease,filter .16s ease,box-shadow .16s ease}"
-        "button:hover{transform:translateY(-1px);filter:saturate(1.04);box-shadow:0 16px 28px rgba(20,150,127,.2)}"
-        "button.secondary{background:linear-gradient(180deg,#243f4f 0%,#182d38 100%);border-color:rgba(61,95,109,.7);box-shadow:0 10px 22px rgba(0,0,0,.18)}"
-        ".small{font-size:12px;color:var(--ink-soft);line-height:1.55}"
-        ".status-banner{margin-top:12px;padding:12px 14px;border-radius:14px;background:rgba(11,24,30,.75);border:1px solid rgba(55,97,115,.45);min-height:44px;display:flex;align-items:center}"
-        ".tabs{display:flex;gap:10px;flex-wrap:wrap;margin:12px 0 16px}"
-        ".tab{width:auto;padding:10px 16px;border-radius:999px;background:linear-gradient(180deg,#19313c 0%,#12242d 100%);border:1px solid rgba(55,97,115,.58)}"
-        ".tab.active{background:linear-gradient(180deg,#245a70 0%,#1b485a 100%);border-color:#4f8ba0}"
-        ".panel{display:none}"
-        ".panel.active{display:block}"
-        ".relay-grid{display:grid;grid-template-columns:repeat(4,minmax(140px,1fr));gap:12px}"
-        ".relayBtn{min-height:60px}"
-        ".relayBtn.on{background:linear-gradient(180deg,#2f8d4a 0%,#226638 100%);border-color:#63c781}"
-        ".relayBtn.off{background:linear-gradient(180deg,#9c3a40 0%,#6a2428 100%);border-color:#f0a0a5}"
-        ".relay-config-grid{display:grid;grid-template-columns:repeat(3,minmax(120px,1fr));gap:12px}"
-        ".kpi{display:grid;grid-template-columns:repeat(4,minmax(130px,1fr));gap:12px}"
-        ".cfg-nav{display:flex;gap:10px;flex-wrap:wrap;margin:12px 0 14px}"
-        ".cfg-nav button{width:auto;padding:10px 14px;border-radius:999px}"
-        ".cfg-nav button.active{background:linear-gradient(180deg,#245a70 0%,#1b485a 100%);border-color:#4f8ba0}"
-        ".cfg-section{display:none}"
-        ".cfg-section.active{display:block}"
-        "pre{background:linear-gradient(180deg,#091116 0%,#0b171d 100%);border:1px solid rgba(55,97,115,.55);padding:14px 16px;border-radius:16px;overflow:auto;max-height:320px;color:#d8f8ee;line-height:1.55}"
-        "@media (max-width:1024px){.hero{grid-template-columns:1fr}.row4{grid-template-columns:repeat(2,minmax(0,1fr))}.kpi,.relay-grid{grid-template-columns:repeat(2,minmax(0,1fr))}}"
-        "@media (max-width:760px){.shell{padding:16px 12px 28px}.row,.row3,.row4,.relay-config-grid,.kpi,.relay-grid{grid-template-columns:1fr}.tabs,.cfg-nav{gap:8px}.tab,.cfg-nav button{width:100%}}"
-        "</style></head><body>"
-        "<div class='shell'>"
-        "<div class='hero'>"
-        "<div class='hero-copy'>"
-        "<div class='eyebrow'>Local device console</div>"
-        "<h1>8bb ESP32 Device</h1>"
-        "<p>Control outputs, tune network settings, test GPIO mapping, and run OTA updates directly from the device on your LAN.</p>"
-        "</div>"
-        "<div class='hero-aside'>"
-        "<div class='hero-chip'><span class='eyebrow'>Interface</span><strong>Local web control</strong></div>"
-        "<div class='hero-chip'><span class='eyebrow'>API</span><strong>/api/status</strong></div>"
-        "</div>"
-        "</div>"
-        "<div class='card session-card'>"
-        "<h2>Session</h2>"
-        "<div class='row'>"
-        "<div><label>Passcode</label><input id='pass' type='password' placeholder='required for write actions'/></div>"
-        "<div><label>Pair Test</label><button id='pairBtn'>Pair</button></div>"
-        "</div>"
-        "<div class='row'>"
-        "<div><label><input id='rememberPass' type='checkbox' style='width:auto;margin-right:8px'/>Remember passcode on this browser</label></div>"
-        "<div><label>Saved Passcode</label><button id='clearSavedPassBtn' class='secondary'>Clear Saved Passcode</button></div>"
-        "</div>"
-        "<div class='row4'>"
-        "<button id='refreshBtn'>Refresh Status</button>"
-        "<button id='applyCfgBtn'>Save Config</button>"
-        "<button id='applyCfgRebootBtn'>Save + Reboot</button>"
-        "<button id='rebootBtn' class='secondary'>Reboot Device</button>"
-        "</div>"
-        "<div id='actionOut' class='small status-banner'>Ready.</div>"
-        "<div class='small'>Session controls stay local to this device. Save applies config without reboot unless you choose reboot.</div>"
-        "</div>"
-
-        "<div class='tabs'>"
-        "<button class='tab active' data-tab='overviewPanel'>Overview</button>"
-        "<button class='tab' data-tab='controlsPanel'>Controls</button>"
-        "<button class='tab' data-tab='gpioPanel'>GPIO Scanner</button>"
-        "<button class='tab' data-tab='configPanel'>Config</button>"
-        "<button class='tab' data-tab='rawPanel'>Raw Status</button>"
-        "</div>"
-
-        "<div id='overviewPanel' class='panel active'>"
-        "<div class='card'>"
-        "<h2>Network Connection</h2>"
-        "<div class='kpi'>"
-        "<div><label>Mode</label><input id='netMode' readonly/></div>"
-        "<div><label>Connected SSID</label><input id='netSsid' readonly/></div>"
-        "<div><label>STA IP</label><input id='netStaIp' readonly/></div>"
-        "<div><label>AP IP</label><input id='netApIp' readonly/></div>"
-        "</div>"
-        "<div class='kpi'>"
-        "<div><label>Configured SSID</label><input id='netCfgSsid' readonly/></div>"
-        "<div><label>Fallback AP SSID</label><input id='netApSsid' readonly/></div>"
-        "<div><label>Last Wi-Fi Reason</label><input id='netReason' readonly/></div>"
-        "<div><label>Relay Ports</label><input id='relayCountView' readonly/></div>"
-        "</div>"
-        "</div>"
-        "</div>"
-
-        "<div id='controlsPanel' class='panel'>"
-        "<div class='card'>"
-        "<h2>Outputs</h2>"
-        "<div id='relayButtons' class='relay-grid'></div>"
-        "<div class='row3' style='margin-top:8px'>"
-        "<button id='lightBtn'>Toggle Light</button>"
-        "<button id='fanPowerBtn'>Toggle Fan Power</button>"
-        "<button id='refreshControlBtn' class='secondary'>Reload Controls</button>"
-        "</div>"
-        "<div class='row'>"
-        "<div><label>Dimmer %</label><input id='dimmerVal' type='number' min='0' max='100' value='50'/></div>"
-        "<div><label>Fan Speed %</label><input id='fanVal' type='number' min='0' max='100' value='50'/></div>"
-        "</div>"
-        "<div class='row'>"
-        "<button id='setDimmerBtn'>Set Dimmer</button>"
-        "<button id='setFanBtn'>Set Fan Speed</button>"
-        "</div>"
-        "</div>"
-        "</div>"
-
-        "<div id='gpioPanel' class='panel'>"
-        "<div class='card'>"
-        "<h2>GPIO Test</h2>"
-        "<div class='row3'>"
-        "<div><label>GPIO</label><input id='gpioPin' type='number' min='0' max='39' value='16'/></div>"
-        "<div><label>Level</label><select id='gpioLevel'><option value='1'>ON (1)</option><option value='0'>OFF (0)</option></select></div>"
-        "<div><label>Apply</label><button id='gpioSetBtn'>Set GPIO</button></div>"
-        "</div>"
-        "<div class='small'>Temporary test only. Does not change saved relay mapping.</div>"
-        "</div>"
-
-        "<div class='card'>"
-        "<h2>GPIO Scanner</h2>"
-        "<div class='row4'>"
-        "<button id='scanStartBtn'>Start Scan (1.5s)</button>"
-        "<button id='scanPauseBtn' class='secondary'>Pause</button>"
-        "<button id='scanContinueBtn' class='secondary'>Continue</button>"
-        "<button id='scanStopBtn' class='secondary'>Stop</button>"
-        "</div>"
-        "<div class='row3' style='margin-top:8px'>"
-        "<button id='scanTestOnBtn'>Test ON Current GPIO</button>"
-        "<button id='scanTestOffBtn'>Test OFF Current GPIO</button>"
-        "<button id='scanNextBtn' class='secondary'>Next GPIO</button>"
-        "</div>"
-        "<div class='row3' style='margin-top:8px'>"
-        "<div><label>Start From GPIO</label><input id='scanStartPin' type='number' min='2' max='33' value='16'/></div>"
-        "<div><label>Current Scan GPIO</label><input id='scanCurrentPin' readonly/></div>"
-        "<div><label>Scan State</label><input id='scanState' readonly value='stopped'/></div>"
-        "</div>"
-        "<div class='small'>Scans only safe ESP32 output GPIOs. Use Pause instantly when relay clicks, test ON/OFF, then Continue.</div>"
-        "</div>"
-        "</div>"
-
-        "<div id='configPanel' class='panel'>"
-        "<div class='card'>"
-        "<h2>Config</h2>"
-        "<div class='cfg-nav'>"
-        "<button id='cfgMenuGeneral' class='active'>General</button>"
-        "<button id='cfgMenuNetwork'>Network</button>"
-        "<button id='cfgMenuRelays'>Relays</button>"
-        "<button id='cfgMenuOta'>OTA</button>"
-        "</div>"
-        "<div id='cfgSectionGeneral' class='cfg-section active'>"
-        "<div class='row3'>"
-        "<div><label>Device Name</label><input id='cfgName' placeholder='8bb-esp32'/></div>"
-        "<div><label>Device ID</label><input id='cfgDeviceId' placeholder='8bb-esp32'/></div>"
-        "<div><label>Device Type</label><input id='cfgType' placeholder='relay_switch'/></div>"
-        "</div>"
-        "<div class='row'>"
-        "<div><label>New Device Passcode</label><input id='cfgNewPass' type='password'/></div>"
-        "<div><label>Apply General</label><button id='cfgApplyGeneralBtn'>Apply General</button></div>"
-        "</div>"
-        "</div>"
-
-        "<div id='cfgSectionNetwork' class='cfg-section'>"
-        "<div class='row'>"
-        "<div><label>Wi-Fi SSID</label><input id='cfgWifiSsid'/></div>"
-        "<div><label>Wi-Fi Password</label><input id='cfgWifiPass' type='password'/></div>"
-        "</div>"
-        "<div class='row'>"
-        "<div><label>Fallback AP SSID</label><input id='cfgApSsid'/></div>"
-        "<div><label>Fallback AP Password</label><input id='cfgApPass' type='password'/></div>"
-        "</div>"
-        "<div class='row'>"
-        "<div><label>Use Static IP</label><select id='cfgStaticUse'><option value='0'>No (DHCP)</option><option value='1'>Yes</option></select></div>"
-        "<div><label>Static IP</label><input id='cfgStaticIp' placeholder='192.168.1.50'/></div>"
-        "<div><label>Gateway</label><input id='cfgGateway' placeholder='192.168.1.1'/></div>"
-        "</div>"
-        "<div class='row'>"
-        "<div><label>Subnet Mask</label><input id='cfgMask' placeholder='255.255.255.0'/></div>"
-        "<div><label>Apply Network</label><button id='cfgApplyNetworkBtn'>Apply Network</button></div>"
-        "</div>"
-        "<div class='small'>Switching to manual will prefill the current STA IP, gateway and subnet when available.</div>"
-        "</div>"
-
-        "<div id='cfgSectionRelays' class='cfg-section'>"
-        "<div class='row'>"
-        "<div><label>Relay Port Count (1-8)</label><input id='cfgRelayCount' type='number' min='1' max='8' value='4'/></div>"
-        "<div><label>Apply Port Count</label><button id='cfgRelayCountApply' class='secondary'>Update Relay Rows</button></div>"
-        "</div>"
-        "<div id='relayConfigRows' class='relay-config-grid' style='margin-top:8px'></div>"
-        "<div class='row' style='margin-top:8px'>"
-        "<div><label>Apply Relay Setup</label><button id='cfgApplyRelaysBtn'>Apply Relays</button></div>"
-        "<div></div>"
-        "</div>"
-        "</div>"
-
-        "<div id='cfgSectionOta' class='cfg-section'>"
-        "<div class='row'>"
-        "<div><label>OTA Key</label><input id='cfgOtaKey' type='password'/></div>"
-        "<div><label>Apply OTA Key</label><button id='cfgApplyOtaBtn'>Apply OTA</button></div>"
-        "</div>"
-        "<div class='card' style='margin-top:10px'>"
-        "<h2>OTA (Local File Upload)</h2>"
-        "<div class='row'>"
-        "<div><label>Firmware .bin</label><input id='otaFile' type='file' accept='.bin,application/octet-stream'/></div>"
-        "<div><label>Upload + Reboot</label><button id='otaUploadBtn'>Upload OTA File</button></div>"
-        "</div>"
-        "<div class='small'>Uploads firmware directly to this device and reboots only after successful OTA write.</div>"
-        "</div>"
-        "</div>"
-        "</div>"
-
-        "<div id='rawPanel' class='panel'>"
-        "<div class='card'><h2>Status</h2><pre id='statusOut'>Loading...</pre></div>"
-        "<div class='card'><h2>Log</h2><pre id='logOut'></pre></div>"
-        "</div>"
-        "<script>"
-        "const $=id=>document.getElementById(id);"
-        "const MAX_RELAYS=8;"
-        "const SAFE_GPIO=[2,4,5,12,13,14,15,16,17,18,19,21,22,23,25,26,27,32,33];"
-        "const PASS_LOCAL_KEY='8bb_device_passcode_v1';"
-        "const PASS_SESSION_KEY='8bb_device_passcode_session_v1';"
-        "const STATUS_POLL_MS=5000;"
-        "const API_TIMEOUT_MS=5000;"
-        "let S={};"
-        "let controlBusy=false;let configBusy=false;let configDirty=false;let configHydrated=false;let lastRelayCfgSig='';"
-        "let scanner={running:false,paused:false,pins:[],idx:0,currentPin:null,timer:null};"
-        "const log=m=>{const line=(new Date().toISOString()+' '+m);$('logOut').textContent=(line+'\\n'+$('logOut').textContent).slice(0,6000);$('actionOut').textContent=line;};"
-        "function loadPassFromStorage(){let p='';try{p=sessionStorage.getItem(PASS_SESSION_KEY)||'';}catch(_){}if(!p){try{p=localStorage.getItem(PASS_LOCAL_KEY)||'';}catch(_){}}if(p){$('pass').value=p;}try{$('rememberPass').checked=!!localStorage.getItem(PASS_LOCAL_KEY);}catch(_){$('rememberPass').checked=false;}}"
-        "function savePassToStorage(){const p=$('pass').value||'';try{if(p){sessionStorage.setItem(PASS_SESSION_KEY,p);}else{sessionStorage.removeItem(PASS_SESSION_KEY);}}catch(_){}try{if($('rememberPass').checked&&p){localStorage.setItem(PASS_LOCAL_KEY,p);}else{localStorage.removeItem(PASS_LOCAL_KEY);}}catch(_){}}"
-        "const pass=()=>{const p=$('pass').value||'';savePassToStorage();return p;};"
-        "function requirePass(){const p=pass();if(!p){log('enter passcode first');throw new Error('passcode required');}return p;}"
-        "function setTab(name){document.querySelectorAll('.panel').forEach(p=>p.classList.remove('active'));document.querySelectorAll('.tab').forEach(t=>t.classList.remove('active'));const p=$(name);if(p)p.classList.add('active');document.querySelectorAll('.tab').forEach(t=>{if(t.getAttribute('data-tab')===name)t.classList.add('active');});}"
-        "function setConfigSection(name){['General','Network','Relays','Ota'].forEach(k=>{const btn=$('cfgMenu'+k);const sec=$('cfgSection'+k);if(btn)btn.classList.toggle('active',k.toLowerCase()===name);if(sec)sec.classList.toggle('active',k.toLowerCase()===name);});}"
-        "document.querySelectorAll('.tab').forEach(t=>t.onclick=()=>setTab(t.getAttribute('data-tab')));"
-        "async function api(path,payload,timeoutMs){"
-        "const tm=(Number.isFinite(timeoutMs)&&timeoutMs>0)?timeoutMs:API_TIMEOUT_MS;"
-        "const ctl=new AbortController();const timer=setTimeout(()=>ctl.abort(),tm);"
-        "const o=payload?{method:'POST',headers:{'Content-Type':'application/json'},body:JSON.stringify(payload),signal:ctl.signal}:{signal:ctl.signal};"
-        "let r;let t='';let j={};"
-        "try{r=await fetch(path,o);t=await r.text();try{j=t?JSON.parse(t):{}}catch(_){j={raw:t}}}catch(e){if(e&&e.name==='AbortError'){throw new Error('Request timeout for '+path);}throw e;}finally{clearTimeout(timer);}"
-        "if(!r.ok){throw new Error((j&&j.detail)||t||('HTTP '+r.status));}return j;}"
-        "function markConfigDirty(){configDirty=true;}"
-        "function bindConfigInputs(){document.querySelectorAll('#configPanel input,#configPanel select,#configPanel textarea').forEach(el=>{if(el.dataset&&el.dataset.cfgBound==='1')return;el.addEventListener('input',markConfigDirty);el.addEventListener('change',markConfigDirty);if(el.dataset)el.dataset.cfgBound='1';});}"
-        "function relayCfgSig(s){return JSON.stringify({count:s&&s.relay_count||0,gpio:(s&&s.relay_gpio)||[],names:(s&&s.relay_names)||[]});}"
-        "function buildRelayConfigRows(){const c=Math.min(MAX_RELAYS,Math.max(1,parseInt($('cfgRelayCount').value||'4',10)));const rg=Array.isArray(S.relay_gpio)?S.relay_gpio:[];const rn=Array.isArray(S.relay_names)?S.relay_names:[];const out=(S&&S.outputs)?S.outputs:{};let h='';for(let i=0;i<c;i++){const idx=i+1;const relayKey='relay'+idx;const v=(Number.isInteger(rg[i])?rg[i]:(i<4?[16,17,18,19][i]:-1));const st=out[relayKey]?'on':'off';const nm=((rn[i]||'').trim()||('Relay '+idx));h+='<div><label>Relay '+idx+' Name</label><input id=\\'cfgRelayName'+idx+'\\' value=\\''+nm.replace(/'/g,'&#39;')+'\\'/></div>';h+='<div><label>Relay '+idx+' GPIO (safe only)</label><input id=\\'cfgRelay'+idx+'\\' type=\\'number\\' min=\\'-1\\' max=\\'33\\' value=\\''+v+'\\'/></div>';h+='<div><label>Current State</label><input id=\\'cfgRelayState'+idx+'\\' readonly value=\\''+st+'\\'/></div>';}$('relayConfigRows').innerHTML=h;bindConfigInputs();lastRelayCfgSig=relayCfgSig(S);}"
-        "function buildRelayButtons(){const c=Math.min(MAX_RELAYS,Math.max(1,parseInt(S.relay_count||'4',10)));const rn=Array.isArray(S.relay_names)?S.relay_names:[];const out=(S&&S.outputs)?S.outputs:{};let h='';for(let i=1;i<=c;i++){const key='relay'+i;const nm=((rn[i-1]||'').trim()||('Relay '+i));const cls=out[key]?'on':'off';h+='<button type=\\'button\\' class=\\'relayBtn '+cls+'\\' data-relay=\\''+key+'\\'>'+nm+' ('+(out[key]?'ON':'OFF')+')</button>';}$('relayButtons').innerHTML=h;document.querySelectorAll('.relayBtn').forEach(b=>b.onclick=()=>doControl(b.getAttribute('data-relay'),'toggle'));}"
-        "function applyOutputsUI(){const out=(S&&S.outputs)?S.outputs:{};const c=Math.min(MAX_RELAYS,Math.max(1,parseInt(S.relay_count||'4',10)));for(let i=1;i<=c;i++){const key='relay'+i;const el=$('cfgRelayState'+i);if(el){el.value=out[key]?'on':'off';}}buildRelayButtons();}"
-        "function setOverview(s){const n=s.network||{};$('netMode').value=n.mode||'';$('netSsid').value=n.connected_ssid||'';$('netStaIp').value=n.sta_ip||'';$('netApIp').value=n.ap_ip||'';$('netCfgSsid').value=n.configured_ssid||'';$('netApSsid').value=n.fallback_ap_ssid||'';$('netReason').value=((n.last_disconnect_reason==null)?'':n.last_disconnect_reason).toString();$('relayCountView').value=((s.relay_count==null)?'':s.relay_count).toString();}"
-        "function setCfgFromStatus(s,force){const n=s.network||{};const shouldSync=!!force||(!configDirty&&!configBusy);if(shouldSync){$('cfgName').value=s.name||$('cfgName').value;$('cfgDeviceId').value=s.device_id||$('cfgDeviceId').value;$('cfgType').value=s.type||$('cfgType').value;$('cfgStaticUse').value=s.static_ip_enabled?'1':'0';$('cfgStaticIp').value=s.static_ip||'';$('cfgGateway').value=s.gateway||'';$('cfgMask').value=s.subnet_mask||'';$('cfgWifiSsid').value=n.configured_ssid||$('cfgWifiSsid').value;$('cfgApSsid').value=n.fallback_ap_ssid||$('cfgApSsid').value;$('cfgRelayCount').value=(s.relay_count||4);}const sig=relayCfgSig(s);if(shouldSync&&(force||!configHydrated||sig!==lastRelayCfgSig)){buildRelayConfigRows();}setOverview(s);applyOutputsUI();configHydrated=true;bindConfigInputs();}"
-        "let refreshBusy=false;"
-        "function fillStaticFromCurrent(){const n=S.network||{};if((!$('cfgStaticIp').value||$('cfgStaticIp').value===(S.static_ip||''))&&n.sta_ip)$('cfgStaticIp').value=n.sta_ip;if((!$('cfgGateway').value||$('cfgGateway').value===(S.gateway||''))&&n.sta_gw)$('cfgGateway').value=n.sta_gw;if((!$('cfgMask').value||$('cfgMask').value===(S.subnet_mask||''))&&n.sta_mask)$('cfgMask').value=n.sta_mask;}"
-        "async function refresh(silent,forceConfigSync){if(refreshBusy)return;refreshBusy=true;try{S=await api('/api/status',null,2800);$('statusOut').textContent=JSON.stringify(S,null,2);setCfgFromStatus(S,!!forceConfigSync);if(!silent)log('status refreshed');}catch(e){log('status error: '+e.message);}finally{refreshBusy=false;}}"
-        "async function doControl(channel,state,value){if(controlBusy){log('control busy, please wait');return null;}controlBusy=true;try{const p={passcode:requirePass(),channel:channel,state:state};if(value!==undefined)p.value=value;log('sending control '+channel+' '+state+'...');const r=await api('/api/control',p,4500);if(r&&r.outputs){S.outputs=r.outputs;applyOutputsUI();}$('statusOut').textContent=JSON.stringify(S,null,2);log('control '+channel+' '+state+' ok');return r;}catch(e){log('control error: '+e.message);return null;}finally{controlBusy=false;}}"
-        "$('lightBtn').onclick=()=>doControl('light','toggle');"
-        "$('fanPowerBtn').onclick=()=>doControl('fan_power','toggle');"
-        "$('refreshControlBtn').onclick=()=>refresh();"
-        "$('setDimmerBtn').onclick=()=>doControl('dimmer','set',parseInt($('dimmerVal').value||'0',10));"
-        "$('setFanBtn').onclick=()=>doControl('fan_speed','set',parseInt($('fanVal').value||'0',10));"
-        "$('gpioSetBtn').onclick=async()=>{try{const p={passcode:pass(),gpio:parseInt($('gpioPin').value||'0',10),value:parseInt($('gpioLevel').value||'0',10)};const r=await api('/api/test/gpio',p);log('gpio test ok '+JSON.stringify(r));}catch(e){log('gpio test error: '+e.message);}};"
-        "$('pairBtn').onclick=async()=>{try{const r=await api('/api/pair',{passcode:requirePass()});log('pair ok '+JSON.stringify(r));}catch(e){log('pair error: '+e.message);}};"
-        "$('cfgRelayCountApply').onclick=()=>buildRelayConfigRows();"
-        "$('refreshBtn').onclick=()=>refresh();"
-        "async function scannerSet(pin,level){await api('/api/test/gpio',{passcode:requirePass(),gpio:pin,value:level});}"
-        "function scannerUpdateState(t){$('scanState').value=t;}"
-        "function scannerClearTimer(){if(scanner.timer){clearTimeout(scanner.timer);scanner.timer=null;}}"
-        "async function scannerStep(){if(!scanner.running||scanner.paused)return;if(!scanner.pins.length){scannerUpdateState('error');log('scanner error: no safe GPIO candidates');scanner.running=false;return;}if(scanner.currentPin!==null){try{await scannerSet(scanner.currentPin,0);}catch(e){log('scanner clear gpio '+scanner.currentPin+' failed: '+e.message);}}let attempts=0;scanner.currentPin=null;while(attempts<scanner.pins.length&&scanner.currentPin===null){if(scanner.idx>=scanner.pins.length)scanner.idx=0;const pin=scanner.pins[scanner.idx++];attempts+=1;$('scanCurrentPin').value=String(pin);$('gpioPin').value=String(pin);try{await scannerSet(pin,1);scanner.currentPin=pin;scannerUpdateState('running');log('scanner gpio '+pin+' ON');}catch(e){log('scanner skip gpio '+pin+': '+e.message);}}if(scanner.currentPin===null){scannerUpdateState('error');log('scanner error: all GPIO candidates failed');scanner.running=false;return;}if(!scanner.running||scanner.paused){scannerUpdateState(scanner.paused?'paused':'stopped');return;}scanner.timer=setTimeout(()=>{scannerStep().catch(e=>log('scanner error: '+e.message));},1500);}"
-        "function scannerPins(){const fromStatus=Array.isArray(S.gpio_candidates)?S.gpio_candidates:[];const base=fromStatus.length?fromStatus:SAFE_GPIO;const pins=base.map(x=>parseInt(x,10)).filter(v=>Number.isInteger(v)&&SAFE_GPIO.includes(v));return Array.from(new Set(pins));}"
-        "$('scanStartBtn').onclick=async()=>{try{scanner.running=true;scanner.paused=false;scanner.pins=scannerPins();scannerClearTimer();if(scanner.currentPin!==null){try{await scannerSet(scanner.currentPin,0);}catch(_){}}scanner.currentPin=null;const startRaw=parseInt($('scanStartPin').value||'',10);if(Number.isInteger(startRaw)){const exact=scanner.pins.indexOf(startRaw);if(exact>=0){scanner.idx=exact;}else{const next=scanner.pins.findIndex(v=>v>=startRaw);scanner.idx=(next>=0?next:0);}}else{scanner.idx=0;}if(scanner.pins.length){$('scanStartPin').value=String(scanner.pins[scanner.idx]);}scannerUpdateState('starting');await scannerStep();}catch(e){log('scan start error: '+e.message);}};"
-        "$('scanPauseBtn').onclick=()=>{scanner.paused=true;scannerClearTimer();scannerUpdateState('paused');log('scanner paused at gpio '+((scanner.currentPin==null)?'none':scanner.currentPin));};"
-        "$('scanContinueBtn').onclick=()=>{if(!scanner.running)return;scanner.paused=false;scannerUpdateState('running');scannerStep().catch(e=>log('scanner continue error: '+e.message));};"
-        "$('scanStopBtn').onclick=async()=>{scanner.running=false;scanner.paused=false;scannerClearTimer();if(scanner.currentPin!==null){try{await scannerSet(scanner.currentPin,0);}catch(_){}}scanner.currentPin=null;$('scanCurrentPin').value='';scannerUpdateState('stopped');log('scanner stopped');};"
-        "$('scanNextBtn').onclick=()=>{if(!scanner.running)return;if(scanner.paused){scanner.paused=false;scannerStep().catch(e=>log('scanner next error: '+e.message));}};"
-        "$('scanTestOnBtn').onclick=async()=>{try{const p=scanner.currentPin!==null?scanner.currentPin:parseInt($('gpioPin').value||'0',10);await scannerSet(p,1);$('scanCurrentPin').value=String(p);scanner.currentPin=p;log('manual test ON gpio '+p);}catch(e){log('manual test ON error: '+e.message);}};"
-        "$('scanTestOffBtn').onclick=async()=>{try{const p=scanner.currentPin!==null?scanner.currentPin:parseInt($('gpioPin').value||'0',10);await scannerSet(p,0);$('scanCurrentPin').value=String(p);scanner.currentPin=p;log('manual test OFF gpio '+p);}catch(e){log('manual test OFF error: '+e.message);}};"
-        "$('pass').addEventListener('input',()=>savePassToStorage());"
-        "$('rememberPass').addEventListener('change',()=>savePassToStorage());"
-        "$('clearSavedPassBtn').onclick=()=>{try{localStorage.removeItem(PASS_LOCAL_KEY);}catch(_){}try{sessionStorage.removeItem(PASS_SESSION_KEY);}catch(_){}$('pass').value='';$('rememberPass').checked=false;log('saved passcode cleared');};"
-        "function buildConfigPayload(section){const part=section||'all';const p={passcode:pass()};const setIf=(k,v)=>{if(v!==undefined&&v!==null&&String(v).length>0)p[k]=v;};if(part==='all'||part==='general'){setIf('name',$('cfgName').value.trim());setIf('device_id',$('cfgDeviceId').value.trim());setIf('type',$('cfgType').value.trim());setIf('new_passcode',$('cfgNewPass').value);}if(part==='all'||part==='network'){p.use_static_ip=$('cfgStaticUse').value==='1';setIf('wifi_ssid',$('cfgWifiSsid').value);setIf('wifi_pass',$('cfgWifiPass').value);setIf('ap_ssid',$('cfgApSsid').value);setIf('ap_pass',$('cfgApPass').value);setIf('static_ip',$('cfgStaticIp').value.trim());setIf('gateway',$('cfgGateway').value.trim());setIf('subnet_mask',$('cfgMask').value.trim());}if(part==='all'||part==='relays'){const c=Math.min(MAX_RELAYS,Math.max(1,parseInt($('cfgRelayCount').value||'4',10)));p.relay_count=c;const rg=[];for(let i=1;i<=MAX_RELAYS;i++){const el=$('cfgRelay'+i);if(!el){rg.push(-1);continue;}const raw=parseInt(el.value||'-1',10);if(raw===-1){rg.push(-1);}else if(Number.isInteger(raw)&&SAFE_GPIO.includes(raw)){rg.push(raw);}else{rg.push(-1);log('relay '+i+' gpio '+el.value+' not safe, set to -1');}}p.relay_gpio=rg;const rn=[];for(let i=1;i<=MAX_RELAYS;i++){const el=$('cfgRelayName'+i);rn.push(el?String(el.value||'').trim():('Relay '+i));}p.relay_names=rn;}if(part==='all'||part==='ota'){setIf('ota_key',$('cfgOtaKey').value);}return p;}"
-        "async function saveConfig(rebootAfterSave,section){if(configBusy){log('config save already running');return;}configBusy=true;try{const scope=section||'all';const p=buildConfigPayload(scope);if(rebootAfterSave){p.reboot=true;}log('saving '+scope+' config...');const cfgRes=await api('/api/config',p,7000);if(cfgRes&&cfgRes.relay_count){S.relay_count=cfgRes.relay_count;}if(cfgRes&&cfgRes.relay_gpio){S.relay_gpio=cfgRes.relay_gpio;}if(cfgRes&&cfgRes.relay_names){S.relay_names=cfgRes.relay_names;}configDirty=false;buildRelayConfigRows();applyOutputsUI();log('config saved '+scope+(rebootAfterSave?' (reboot requested)':' (applied)'));if(!rebootAfterSave){setTimeout(()=>refresh(true,true),350);}}catch(e){log('config error: '+e.message);}finally{configBusy=false;}}"
-        "$('applyCfgBtn').onclick=()=>saveConfig(false,'all');"
-        "$('applyCfgRebootBtn').onclick=()=>saveConfig(true,'all');"
-        "$('cfgApplyGeneralBtn').onclick=()=>saveConfig(false,'general');"
-        "$('cfgApplyNetworkBtn').onclick=()=>saveConfig(false,'network');"
-        "$('cfgApplyRelaysBtn').onclick=()=>saveConfig(false,'relays');"
-        "$('cfgApplyOtaBtn').onclick=()=>saveConfig(false,'ota');"
-        "$('cfgMenuGeneral').onclick=()=>setConfigSection('general');"
-        "$('cfgMenuNetwork').onclick=()=>setConfigSection('network');"
-        "$('cfgMenuRelays').onclick=()=>setConfigSection('relays');"
-        "$('cfgMenuOta').onclick=()=>setConfigSection('ota');"
-        "$('cfgStaticUse').onchange=()=>{if($('cfgStaticUse').value==='1'){fillStaticFromCurrent();}};"
-        "$('rebootBtn').onclick=async()=>{try{const r=await api('/api/reboot',{passcode:requirePass()});log('reboot requested '+JSON.stringify(r));}catch(e){log('reboot error: '+e.message);}};"
-        "$('otaUploadBtn').onclick=async()=>{try{const f=$('otaFile').files&&$('otaFile').files[0];if(!f){throw new Error('select firmware .bin first');}const p=requirePass();const r=await fetch('/api/ota/upload',{method:'POST',headers:{'Content-Type':'application/octet-stream','X-Passcode':p},body:f});const t=await r.text();let j={};try{j=t?JSON.parse(t):{}}catch(_){j={raw:t}}if(!r.ok){throw new Error((j&&j.detail)||t||('HTTP '+r.status));}log('ota upload ok '+JSON.stringify(j));}catch(e){log('ota upload error: '+e.message);}};"
-        "loadPassFromStorage();"
-        "bindConfigInputs();"
-        "scannerUpdateState('stopped');"
-        "refresh(false,true);setInterval(()=>refresh(true,false),STATUS_POLL_MS);"
-        "</script>"
-        "</div>"
-        "</body></html>";
-    httpd_resp_set_type(req, "text/html; charset=utf-8");
-    return httpd_resp_sendstr(req, html);
+static esp_err_t http_async_submit(httpd_req_t *req, http_route_t *route, http_auth_t auth, int64_t start_us) {
+    http_async_job_t job = {.route = route, .auth = auth, .start_us = start_us};
+    if (httpd_req_async_handler_begin(req, &job.req) != ESP_OK) {
+        http_inflight_release();
+        return http_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "async begin failed");
+    }
+    if (xQueueSend(g_http_async_q, &job, 0) != pdTRUE) {
+        httpd_resp_set_status(job.req, "503 Service Unavailable");
+        httpd_resp_set_hdr(job.req, "Retry-After", "5");
+        httpd_resp_sendstr(job.req, "busy");
+        http_route_record(route, esp_timer_get_time() - start_us, true);
+        httpd_req_async_handler_complete(job.req);
+        http_inflight_release();
+    }
+    return ESP_OK;
 }
 
-static esp_err_t favicon_handler(httpd_req_t *req) {
-    httpd_resp_set_status(req, "204 No Content");
-    return httpd_resp_send(req, NULL, 0);
+/* Every route except the WebSocket goes through here (user_ctx is its http_route_t). */
+static esp_err_t http_route_entry(httpd_req_t *req) {
+    http_route_t *route = (http_route_t *)req->user_ctx;
+    int64_t start_us = esp_timer_get_time();
+    if (!http_admit(req, route->cls)) {
+        esp_err_t err = http_send_limited(req, route);
+        http_route_record(route, esp_timer_get_time() - start_us, err != ESP_OK);
+        return err;
+    }
+    /* The token is verified once here; a stale or forged one is refused from the headers alone,
+     * before any body is received. */
+    http_auth_t auth = route->auth ? http_session_auth(req) : HTTP_AUTH_NONE;
+    if (auth == HTTP_AUTH_BAD) {
+        esp_err_t err = http_send_err(req, HTTPD_401_UNAUTHORIZED, "invalid session token");
+        http_route_record(route, esp_timer_get_time() - start_us, err != ESP_OK);
+        http_inflight_release();
+        return err;
+    }
+    if (route->async && g_http_async_q) return http_async_submit(req, route, auth, start_us);
+    esp_err_t err = route->fn(req, auth);
+    http_route_record(route, esp_timer_get_time() - start_us, err != ESP_OK);
+    http_inflight_release();
+    return err;
 }
 
-static esp_err_t pair_handler(httpd_req_t *req) {
-    char buf[256] = {0};
-    int len = httpd_req_recv(req, buf, sizeof(buf) - 1);
-    if (len <= 0) return httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "bad payload");
-    cJSON *root = cJSON_Parse(buf);
-    if (!root) return httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "json parse failed");
+static esp_err_t pair_handler(httpd_req_t *req, http_auth_t auth) {
+    esp_err_t err = ESP_OK;
+    cJSON *root = http_body_parse_json(req, &err);
+    if (!root) return err;
     bool ok = check_passcode(root);
+    cJSON *ttl = cJSON_GetObjectItem(root, "ttl_s");
+    int ttl_s = cJSON_IsNumber(ttl) ? clamp_int(ttl->valueint, SESSION_TOKEN_MIN_TTL_S, SESSION_TOKEN_MAX_TTL_S) : SESSION_TOKEN_TTL_S;
     cJSON_Delete(root);
-    if (!ok) return httpd_resp_send_err(req, HTTPD_401_UNAUTHORIZED, "invalid passcode");
-    return httpd_resp_sendstr(req, "{\"paired\":true}");
+    if (!ok) return http_send_err(req, HTTPD_401_UNAUTHORIZED, "invalid passcode");
+
+    char token[SESSION_TOKEN_LEN + 1];
+    session_token_issue((uint32_t)ttl_s, token);
+    char out_buf[160];
+    json_writer_t jw;
+    jw_init(&jw, req, out_buf, sizeof(out_buf));
+    jw_begin_object(&jw, NULL);
+    jw_bool(&jw, "paired", true);
+    jw_str(&jw, "token", token);
+    jw_str(&jw, "token_type", "Bearer");
+    jw_int(&jw, "expires_in", ttl_s);
+    jw_end_object(&jw);
+    return jw_send(&jw);
+}
+
+/* Installs a parsed config and re-derives pins and outputs from it; runs on the actuation task. */
+static void config_commit_job(void *ctx) {
+    memcpy(&g_cfg, ctx, sizeof(g_cfg));
+    sanitize_state_save_delay(&g_cfg);
+    sanitize_power_config(&g_cfg);
+    sanitize_automation_config();
+    sanitize_wifi_field(g_cfg.wifi_ssid);
+    sanitize_wifi_field(g_cfg.wifi_pass);
+    sanitize_wifi_field(g_cfg.ap_ssid);
+    sanitize_wifi_field(g_cfg.ap_pass);
+    sanitize_wifi_field(g_cfg.device_id);
+    for (int i = 0; i < MAX_RELAYS; i++) {
+        sanitize_wifi_field(g_cfg.relay_names[i]);
+    }
+    sanitize_relay_count(&g_cfg);
+    sanitize_relay_gpio_map(&g_cfg);
+    sanitize_input_config();
+    ensure_device_id();
+    set_default_relay_names();
+    auth_invalidate();
+    configure_output_pins_only();
+    setup_web_status_led();
+    set_web_status_led(g_server != NULL);
+    for (int i = 0; i < MAX_RELAYS; i++) {
+        if (i < g_cfg.relay_count) {
+            apply_relay(i, g_state.relay[i]);
+        } else {
+            if (valid_relay_gpio_int(g_cfg.relay_gpio[i])) {
+                gpio_set_level((gpio_num_t)g_cfg.relay_gpio[i], 0);
+            }
+            g_state.relay[i] = false;
+        }
+    }
+    publish_output_delta();
 }
 
-static esp_err_t config_handler(httpd_req_t *req) {
-    char buf[4096] = {0};
-    int len = httpd_req_recv(req, buf, sizeof(buf) - 1);
-    if (len <= 0) return httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "bad payload");
-    cJSON *root = cJSON_Parse(buf);
-    if (!root) return httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "json parse failed");
-    if (!check_passcode(root)) {
+static esp_err_t config_handler(httpd_req_t *req, http_auth_t auth) {
+    esp_err_t err = ESP_OK;
+    cJSON *root = http_body_parse_json(req, &err);
+    if (!root) return err;
+    if (!check_request_auth(auth, root)) {
+        cJSON_Delete(root);
+        return http_send_err(req, HTTPD_401_UNAUTHORIZED, "invalid passcode");
+    }
+
+    /* Schedules replace the whole table and are checked before any field is applied. */
+    cJSON *schedules = cJSON_GetObjectItem(root, "schedules");
+    schedule_entry_t sched[MAX_SCHEDULES] = {0};
+    if (cJSON_IsArray(schedules)) {
+        int count = cJSON_GetArraySize(schedules);
+        int bad = count > MAX_SCHEDULES ? MAX_SCHEDULES : -1;
+        for (int i = 0; i < count && bad < 0; i++) {
+            if (!schedule_from_json(cJSON_GetArrayItem(schedules, i), &sched[i])) bad = i;
+        }
+        if (bad >= 0) {
+            cJSON_Delete(root);
+            char msg[64] = {0};
+            snprintf(msg, sizeof(msg), "invalid schedules[%d] (max 16); nothing saved", bad);
+            return http_send_err(req, HTTPD_400_BAD_REQUEST, msg);
+        }
+    }
+    cJSON *inputs = cJSON_GetObjectItem(root, "inputs");
+    cJSON *bindings = cJSON_GetObjectItem(root, "input_bindings");
+    input_entry_t input_cfg[MAX_INPUTS] = {0};
+    input_binding_t binding_cfg[MAX_INPUT_BINDINGS] = {0};
+    const char *bad_list = NULL;
+    int bad_index = -1;
+    if (cJSON_IsArray(inputs)) {
+        int count = cJSON_GetArraySize(inputs);
+        bad_index = count > MAX_INPUTS ? MAX_INPUTS : -1;
+        for (int i = 0; i < count && bad_index < 0; i++) {
+            if (!input_from_json(cJSON_GetArrayItem(inputs, i), &input_cfg[i])) bad_index = i;
+        }
+        if (bad_index >= 0) bad_list = "inputs";
+    }
+    if (cJSON_IsArray(bindings) && !bad_list) {
+        int count = cJSON_GetArraySize(bindings);
+        bad_index = count > MAX_INPUT_BINDINGS ? MAX_INPUT_BINDINGS : -1;
+        for (int i = 0; i < count && bad_index < 0; i++) {
+            if (!input_binding_from_json(cJSON_GetArrayItem(bindings, i), &binding_cfg[i])) bad_index = i;
+        }
+        if (bad_index >= 0) bad_list = "input_bindings";
+    }
+    if (bad_list) {
         cJSON_Delete(root);
-        return httpd_resp_send_err(req, HTTPD_401_UNAUTHORIZED, "invalid passcode");
+        char msg[64] = {0};
+        snprintf(msg, sizeof(msg), "invalid %s[%d]; nothing saved", bad_list, bad_index);
+        return http_send_err(req, HTTPD_400_BAD_REQUEST, msg);
     }
 
     cJSON *name = cJSON_GetObjectItem(root, "name");
@@ -1149,25 +2873,45 @@ static esp_err_t config_handler(httpd_req_t *req) {
     cJSON *static_ip = cJSON_GetObjectItem(root, "static_ip");
     cJSON *gateway = cJSON_GetObjectItem(root, "gateway");
     cJSON *subnet_mask = cJSON_GetObjectItem(root, "subnet_mask");
+    cJSON *restore_outputs = cJSON_GetObjectItem(root, "restore_outputs");
+    cJSON *state_save_delay = cJSON_GetObjectItem(root, "state_save_delay_ms");
+    cJSON *timezone = cJSON_GetObjectItem(root, "timezone");
+    cJSON *ntp_server = cJSON_GetObjectItem(root, "ntp_server");
+    cJSON *mqtt_uri = cJSON_GetObjectItem(root, "mqtt_uri");
+    cJSON *mqtt_user = cJSON_GetObjectItem(root, "mqtt_user");
+    cJSON *mqtt_pass = cJSON_GetObjectItem(root, "mqtt_pass");
+    cJSON *mqtt_prefix = cJSON_GetObjectItem(root, "mqtt_prefix");
+    cJSON *power_profile = cJSON_GetObjectItem(root, "power_profile");
+    cJSON *power_wake_hold = cJSON_GetObjectItem(root, "power_wake_hold_ms");
+    cJSON *power_listen_interval = cJSON_GetObjectItem(root, "power_listen_interval");
     cJSON *reboot_after_save_json = cJSON_GetObjectItem(root, "reboot");
     bool reboot_after_save = cJSON_IsTrue(reboot_after_save_json);
 
-    if (cJSON_IsString(name)) safe_strcpy(g_cfg.name, name->valuestring, sizeof(g_cfg.name));
-    if (cJSON_IsString(device_id)) safe_strcpy(g_cfg.device_id, device_id->valuestring, sizeof(g_cfg.device_id));
-    if (cJSON_IsString(type)) safe_strcpy(g_cfg.type, type->valuestring, sizeof(g_cfg.type));
-    if (cJSON_IsString(passcode)) safe_strcpy(g_cfg.passcode, passcode->valuestring, sizeof(g_cfg.passcode));
-    if (cJSON_IsString(wifi_ssid)) safe_strcpy(g_cfg.wifi_ssid, wifi_ssid->valuestring, sizeof(g_cfg.wifi_ssid));
-    if (cJSON_IsString(wifi_pass)) safe_strcpy(g_cfg.wifi_pass, wifi_pass->valuestring, sizeof(g_cfg.wifi_pass));
-    if (cJSON_IsString(ap_ssid)) safe_strcpy(g_cfg.ap_ssid, ap_ssid->valuestring, sizeof(g_cfg.ap_ssid));
-    if (cJSON_IsString(ap_pass)) safe_strcpy(g_cfg.ap_pass, ap_pass->valuestring, sizeof(g_cfg.ap_pass));
-    if (cJSON_IsNumber(relay_count)) g_cfg.relay_count = relay_count->valueint;
+    /* Fields are parsed into a copy; the actuation task swaps it in, so control never sees half a save. */
+    device_config_t *next = malloc(sizeof(*next));
+    if (!next) {
+        cJSON_Delete(root);
+        return http_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "out of memory");
+    }
+    memcpy(next, &g_cfg, sizeof(*next));
+    if (cJSON_IsString(name)) safe_strcpy(next->name, name->valuestring, sizeof(next->name));
+    if (cJSON_IsString(device_id)) safe_strcpy(next->device_id, device_id->valuestring, sizeof(next->device_id));
+    if (cJSON_IsString(type)) safe_strcpy(next->type, type->valuestring, sizeof(next->type));
+    if (cJSON_IsString(passcode)) {
+        safe_strcpy(next->passcode, passcode->valuestring, sizeof(next->passcode));
+    }
+    if (cJSON_IsString(wifi_ssid)) safe_strcpy(next->wifi_ssid, wifi_ssid->valuestring, sizeof(next->wifi_ssid));
+    if (cJSON_IsString(wifi_pass)) safe_strcpy(next->wifi_pass, wifi_pass->valuestring, sizeof(next->wifi_pass));
+    if (cJSON_IsString(ap_ssid)) safe_strcpy(next->ap_ssid, ap_ssid->valuestring, sizeof(next->ap_ssid));
+    if (cJSON_IsString(ap_pass)) safe_strcpy(next->ap_pass, ap_pass->valuestring, sizeof(next->ap_pass));
+    if (cJSON_IsNumber(relay_count)) next->relay_count = relay_count->valueint;
     if (cJSON_IsArray(relay_gpio)) {
         for (int i = 0; i < MAX_RELAYS; i++) {
             cJSON *it = cJSON_GetArrayItem(relay_gpio, i);
             if (cJSON_IsNumber(it)) {
                 int pin = it->valueint;
                 if (pin == -1 || valid_relay_gpio_int(pin)) {
-                    g_cfg.relay_gpio[i] = pin;
+                    next->relay_gpio[i] = pin;
                 }
             }
         }
@@ -1176,118 +2920,226 @@ static esp_err_t config_handler(httpd_req_t *req) {
         for (int i = 0; i < MAX_RELAYS; i++) {
             cJSON *it = cJSON_GetArrayItem(relay_names, i);
             if (cJSON_IsString(it)) {
-                safe_strcpy(g_cfg.relay_names[i], it->valuestring, sizeof(g_cfg.relay_names[i]));
+                safe_strcpy(next->relay_names[i], it->valuestring, sizeof(next->relay_names[i]));
             }
         }
     }
-    if (cJSON_IsString(ota_key)) safe_strcpy(g_cfg.ota_key, ota_key->valuestring, sizeof(g_cfg.ota_key));
-    if (cJSON_IsBool(static_ip_enabled)) g_cfg.use_static_ip = cJSON_IsTrue(static_ip_enabled);
-    if (cJSON_IsString(static_ip)) safe_strcpy(g_cfg.static_ip, static_ip->valuestring, sizeof(g_cfg.static_ip));
-    if (cJSON_IsString(gateway)) safe_strcpy(g_cfg.gateway, gateway->valuestring, sizeof(g_cfg.gateway));
-    if (cJSON_IsString(subnet_mask)) safe_strcpy(g_cfg.subnet_mask, subnet_mask->valuestring, sizeof(g_cfg.subnet_mask));
-    sanitize_wifi_field(g_cfg.wifi_ssid);
-    sanitize_wifi_field(g_cfg.wifi_pass);
-    sanitize_wifi_field(g_cfg.ap_ssid);
-    sanitize_wifi_field(g_cfg.ap_pass);
-    sanitize_wifi_field(g_cfg.device_id);
-    for (int i = 0; i < MAX_RELAYS; i++) {
-        sanitize_wifi_field(g_cfg.relay_names[i]);
-    }
-    sanitize_relay_count();
-    sanitize_relay_gpio_map();
-    ensure_device_id();
-    set_default_relay_names();
-    configure_output_pins_only();
-    setup_web_status_led();
-    set_web_status_led(g_server != NULL);
-    for (int i = 0; i < MAX_RELAYS; i++) {
-        if (i < g_cfg.relay_count) {
-            apply_relay(i, g_state.relay[i]);
-        } else {
-            if (valid_relay_gpio_int(g_cfg.relay_gpio[i])) {
-                gpio_set_level((gpio_num_t)g_cfg.relay_gpio[i], 0);
-            }
-            g_state.relay[i] = false;
-        }
+    if (cJSON_IsString(ota_key)) safe_strcpy(next->ota_key, ota_key->valuestring, sizeof(next->ota_key));
+    if (cJSON_IsBool(static_ip_enabled)) next->use_static_ip = cJSON_IsTrue(static_ip_enabled);
+    if (cJSON_IsString(static_ip)) safe_strcpy(next->static_ip, static_ip->valuestring, sizeof(next->static_ip));
+    if (cJSON_IsString(gateway)) safe_strcpy(next->gateway, gateway->valuestring, sizeof(next->gateway));
+    if (cJSON_IsString(subnet_mask)) safe_strcpy(next->subnet_mask, subnet_mask->valuestring, sizeof(next->subnet_mask));
+    if (cJSON_IsBool(restore_outputs)) next->restore_outputs = cJSON_IsTrue(restore_outputs);
+    if (cJSON_IsNumber(state_save_delay)) next->state_save_delay_ms = state_save_delay->valueint;
+    if (cJSON_IsString(timezone)) safe_strcpy(next->timezone, timezone->valuestring, sizeof(next->timezone));
+    if (cJSON_IsString(ntp_server)) safe_strcpy(next->ntp_server, ntp_server->valuestring, sizeof(next->ntp_server));
+    if (cJSON_IsString(mqtt_uri)) safe_strcpy(next->mqtt_uri, mqtt_uri->valuestring, sizeof(next->mqtt_uri));
+    if (cJSON_IsString(mqtt_user)) safe_strcpy(next->mqtt_user, mqtt_user->valuestring, sizeof(next->mqtt_user));
+    if (cJSON_IsString(mqtt_pass)) safe_strcpy(next->mqtt_pass, mqtt_pass->valuestring, sizeof(next->mqtt_pass));
+    if (cJSON_IsString(mqtt_prefix)) safe_strcpy(next->mqtt_prefix, mqtt_prefix->valuestring, sizeof(next->mqtt_prefix));
+    if (cJSON_IsString(power_profile)) {
+        int profile = power_profile_from_name(power_profile->valuestring);
+        if (profile >= 0) next->power_profile = profile;
     }
+    if (cJSON_IsNumber(power_wake_hold)) next->power_wake_hold_ms = power_wake_hold->valueint;
+    if (cJSON_IsNumber(power_listen_interval)) next->power_listen_interval = power_listen_interval->valueint;
+    if (cJSON_IsArray(schedules)) memcpy(next->schedules, sched, sizeof(sched));
+    if (cJSON_IsArray(inputs)) memcpy(next->inputs, input_cfg, sizeof(input_cfg));
+    if (cJSON_IsArray(bindings)) memcpy(next->input_bindings, binding_cfg, sizeof(binding_cfg));
+    act_call(config_commit_job, next);
+    free(next);
+    input_reconfigure();
 
     save_config_to_nvs();
+    output_persist_kick();
+    automation_reconfigure();
+    power_apply();
+#if CONFIG_EIGHTBB_MQTT
+    mqtt_reconfigure();
+#endif
+#if CONFIG_EIGHTBB_MDNS
+    mdns_reconfigure();
+#endif
     cJSON_Delete(root);
 
-    cJSON *resp = cJSON_CreateObject();
-    cJSON_AddBoolToObject(resp, "saved", true);
-    cJSON_AddBoolToObject(resp, "rebooted", false);
-    cJSON_AddBoolToObject(resp, "rebooting", reboot_after_save);
-    cJSON_AddNumberToObject(resp, "relay_count", g_cfg.relay_count);
-    cJSON *relay_gpio_out = cJSON_CreateArray();
-    for (int i = 0; i < MAX_RELAYS; i++) {
-        cJSON_AddItemToArray(relay_gpio_out, cJSON_CreateNumber(g_cfg.relay_gpio[i]));
-    }
-    cJSON_AddItemToObject(resp, "relay_gpio", relay_gpio_out);
-    cJSON_AddStringToObject(resp, "device_id", g_cfg.device_id);
-    cJSON *relay_names_out = cJSON_CreateArray();
-    for (int i = 0; i < MAX_RELAYS; i++) {
-        cJSON_AddItemToArray(relay_names_out, cJSON_CreateString(g_cfg.relay_names[i]));
-    }
-    cJSON_AddItemToObject(resp, "relay_names", relay_names_out);
-    esp_err_t resp_err = send_json(req, resp);
-    cJSON_Delete(resp);
+    char out_buf[JSON_WRITER_BUF];
+    json_writer_t jw;
+    jw_init(&jw, req, out_buf, sizeof(out_buf));
+    jw_begin_object(&jw, NULL);
+    jw_bool(&jw, "saved", true);
+    jw_bool(&jw, "rebooted", false);
+    jw_bool(&jw, "rebooting", reboot_after_save);
+    jw_int(&jw, "relay_count", g_cfg.relay_count);
+    jw_begin_array(&jw, "relay_gpio");
+    for (int i = 0; i < MAX_RELAYS; i++) jw_int(&jw, NULL, g_cfg.relay_gpio[i]);
+    jw_end_array(&jw);
+    jw_str(&jw, "device_id", g_cfg.device_id);
+    jw_begin_array(&jw, "relay_names");
+    for (int i = 0; i < MAX_RELAYS; i++) jw_str(&jw, NULL, g_cfg.relay_names[i]);
+    jw_end_array(&jw);
+    jw_end_object(&jw);
+    esp_err_t resp_err = jw_send(&jw);
     if (resp_err == ESP_OK && reboot_after_save) {
         schedule_restart_ms(700);
     }
     return resp_err;
 }
 
-static esp_err_t control_handler(httpd_req_t *req) {
-    char buf[1024] = {0};
-    int len = httpd_req_recv(req, buf, sizeof(buf) - 1);
-    if (len <= 0) return httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "bad payload");
-    cJSON *root = cJSON_Parse(buf);
-    if (!root) return httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "json parse failed");
-    if (!check_passcode(root)) {
+static esp_err_t control_apply_at_respond(httpd_req_t *req, const control_op_t *ops, int count, double apply_at) {
+    int64_t in_ms = 0;
+    int bad = -1;
+    char msg[80] = {0};
+    switch (apply_at_schedule(ops, count, apply_at, &in_ms, &bad)) {
+    case APPLY_AT_OK:
+        break;
+    case APPLY_AT_BAD_TIME:
+        return http_send_err(req, HTTPD_400_BAD_REQUEST, "apply_at must be a Unix time in ms");
+    case APPLY_AT_NO_TIME:
+        return http_send_err(req, HTTPD_400_BAD_REQUEST, "apply_at needs SNTP time (time_synced is false)");
+    case APPLY_AT_RANGE:
+        snprintf(msg, sizeof(msg), "apply_at is %lld ms from device time (allowed -%d..%d)", (long long)in_ms, APPLY_AT_LATE_MS,
+                 APPLY_AT_MAX_AHEAD_MS);
+        return http_send_err(req, HTTPD_400_BAD_REQUEST, msg);
+    case APPLY_AT_FULL:
+        snprintf(msg, sizeof(msg), "too many pending apply_at requests (max %d)", APPLY_AT_SLOTS);
+        return http_send_err(req, HTTPD_400_BAD_REQUEST, msg);
+    case APPLY_AT_BAD_OP:
+        snprintf(msg, sizeof(msg), "unsupported channel/state in ops[%d]; nothing scheduled", bad);
+        return http_send_err(req, HTTPD_400_BAD_REQUEST, msg);
+    }
+
+    char out_buf[JSON_WRITER_BUF];
+    json_writer_t jw;
+    jw_init(&jw, req, out_buf, sizeof(out_buf));
+    jw_begin_object(&jw, NULL);
+    jw_bool(&jw, "ok", true);
+    jw_bool(&jw, "scheduled", in_ms > 0);
+    jw_int(&jw, "apply_at", (int64_t)apply_at);
+    jw_int(&jw, "in_ms", in_ms);
+    jw_int(&jw, "ops", count);
+    /* Already-passed timestamps were applied on the spot, so the outputs are current. */
+    if (in_ms <= 0) write_current_outputs_json(&jw);
+    jw_end_object(&jw);
+    return jw_send(&jw);
+}
+
+static esp_err_t control_batch_respond(httpd_req_t *req, cJSON *ops_json, cJSON *apply_at) {
+    int count = cJSON_GetArraySize(ops_json);
+    if (count <= 0 || count > MAX_BATCH_OPS) {
+        return http_send_err(req, HTTPD_400_BAD_REQUEST, "ops must hold 1-16 entries");
+    }
+    control_op_t ops[MAX_BATCH_OPS];
+    int bad = -1;
+    for (int i = 0; i < count && bad < 0; i++) {
+        if (!control_op_from_json(cJSON_GetArrayItem(ops_json, i), &ops[i])) bad = i;
+    }
+    if (bad < 0 && cJSON_IsNumber(apply_at)) return control_apply_at_respond(req, ops, count, apply_at->valuedouble);
+    if (bad < 0) bad = apply_control_batch(ops, count);
+    if (bad >= 0) {
+        char msg[64] = {0};
+        snprintf(msg, sizeof(msg), "unsupported channel/state in ops[%d]; nothing applied", bad);
+        return http_send_err(req, HTTPD_400_BAD_REQUEST, msg);
+    }
+
+    char out_buf[JSON_WRITER_BUF];
+    json_writer_t jw;
+    jw_init(&jw, req, out_buf, sizeof(out_buf));
+    jw_begin_object(&jw, NULL);
+    jw_bool(&jw, "ok", true);
+    jw_int(&jw, "applied", count);
+    write_current_outputs_json(&jw);
+    jw_end_object(&jw);
+    return jw_send(&jw);
+}
+
+static esp_err_t control_respond(httpd_req_t *req, const char *channel_name) {
+    char out_buf[JSON_WRITER_BUF];
+    json_writer_t jw;
+    jw_init(&jw, req, out_buf, sizeof(out_buf));
+    jw_begin_object(&jw, NULL);
+    jw_bool(&jw, "ok", true);
+    jw_str(&jw, "channel", channel_name);
+    write_current_outputs_json(&jw);
+    jw_end_object(&jw);
+    return jw_send(&jw);
+}
+
+static esp_err_t control_handler(httpd_req_t *req, http_auth_t auth) {
+    /* With a session token the body's passcode field is never looked at. */
+    bool token_ok = auth == HTTP_AUTH_OK;
+    http_body_t body;
+    esp_err_t err = ESP_OK;
+    if (!http_body_read(req, &body, &err)) return err;
+
+    /* Single ops are the hot path: parse them in place without building a cJSON tree. */
+    flat_json_t fj;
+    if (flat_json_parse(body.data, &fj)) {
+        char pass[MAX_STR] = {0};
+        char channel_name[32] = {0};
+        control_op_t op;
+        bool authed = token_ok || (flat_json_get_str(&fj, "passcode", pass, sizeof(pass)) && passcode_matches(pass));
+        bool parsed = authed && control_op_from_flat(&fj, &op, channel_name, sizeof(channel_name));
+        double apply_at = 0;
+        bool timed = parsed && flat_json_get_num(&fj, "apply_at", &apply_at);
+        http_body_release(&body);
+        if (!authed) return http_send_err(req, HTTPD_401_UNAUTHORIZED, "invalid passcode");
+        /* Only authenticated commands hold the radio awake; junk traffic must not defeat power saving. */
+        power_wake_note();
+        if (timed) return control_apply_at_respond(req, &op, 1, apply_at);
+        if (!parsed || !apply_control_op(&op)) return http_send_err(req, HTTPD_400_BAD_REQUEST, "unsupported channel/state");
+        return control_respond(req, channel_name);
+    }
+
+    cJSON *root = cJSON_Parse(body.data);
+    http_body_release(&body);
+    if (!root) return http_send_err(req, HTTPD_400_BAD_REQUEST, "json parse failed");
+    if (!token_ok && !check_passcode(root)) {
         cJSON_Delete(root);
-        return httpd_resp_send_err(req, HTTPD_401_UNAUTHORIZED, "invalid passcode");
+        return http_send_err(req, HTTPD_401_UNAUTHORIZED, "invalid passcode");
     }
+    power_wake_note();
 
-    bool ok = handle_control(root);
-    cJSON *channel = cJSON_GetObjectItem(root, "channel");
-    char channel_name[32] = {0};
-    if (cJSON_IsString(channel)) {
-        safe_strcpy(channel_name, channel->valuestring, sizeof(channel_name));
+    cJSON *ops_json = cJSON_GetObjectItem(root, "ops");
+    cJSON *apply_at = cJSON_GetObjectItem(root, "apply_at");
+    if (cJSON_IsArray(ops_json)) {
+        err = control_batch_respond(req, ops_json, apply_at);
+        cJSON_Delete(root);
+        return err;
+    }
+
+    control_op_t op;
+    bool parsed = control_op_from_json(root, &op);
+    if (parsed && cJSON_IsNumber(apply_at)) {
+        double at_ms = apply_at->valuedouble;
+        cJSON_Delete(root);
+        return control_apply_at_respond(req, &op, 1, at_ms);
     }
+    bool ok = parsed && apply_control_op(&op);
     cJSON_Delete(root);
-    if (!ok) return httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "unsupported channel/state");
-    cJSON *out = cJSON_CreateObject();
-    cJSON_AddBoolToObject(out, "ok", true);
-    cJSON_AddStringToObject(out, "channel", channel_name);
-    add_outputs_json(out);
-    esp_err_t err = send_json(req, out);
-    cJSON_Delete(out);
-    return err;
+    if (!ok) return http_send_err(req, HTTPD_400_BAD_REQUEST, "unsupported channel/state");
+    return control_respond(req, g_channels[op.channel].name);
 }
 
-static esp_err_t gpio_test_handler(httpd_req_t *req) {
-    char buf[256] = {0};
-    int len = httpd_req_recv(req, buf, sizeof(buf) - 1);
-    if (len <= 0) return httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "bad payload");
-    cJSON *root = cJSON_Parse(buf);
-    if (!root) return httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "json parse failed");
-    if (!check_passcode(root)) {
+static esp_err_t gpio_test_handler(httpd_req_t *req, http_auth_t auth) {
+    esp_err_t err = ESP_OK;
+    cJSON *root = http_body_parse_json(req, &err);
+    if (!root) return err;
+    if (!check_request_auth(auth, root)) {
         cJSON_Delete(root);
-        return httpd_resp_send_err(req, HTTPD_401_UNAUTHORIZED, "invalid passcode");
+        return http_send_err(req, HTTPD_401_UNAUTHORIZED, "invalid passcode");
     }
 
     cJSON *gpio = cJSON_GetObjectItem(root, "gpio");
     cJSON *value = cJSON_GetObjectItem(root, "value");
     if (!cJSON_IsNumber(gpio) || !cJSON_IsNumber(value)) {
         cJSON_Delete(root);
-        return httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "gpio and value are required numbers");
+        return http_send_err(req, HTTPD_400_BAD_REQUEST, "gpio and value are required numbers");
     }
     int pin = gpio->valueint;
     int level = value->valueint ? 1 : 0;
     if (pin < 0 || pin > 39 || !GPIO_IS_VALID_OUTPUT_GPIO(pin)) {
         cJSON_Delete(root);
-        return httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "invalid output gpio");
+        return http_send_err(req, HTTPD_400_BAD_REQUEST, "invalid output gpio");
     }
 
     gpio_reset_pin((gpio_num_t)pin);
@@ -1295,328 +3147,1597 @@ static esp_err_t gpio_test_handler(httpd_req_t *req) {
     gpio_set_level((gpio_num_t)pin, level);
     cJSON_Delete(root);
 
-    cJSON *out = cJSON_CreateObject();
-    cJSON_AddBoolToObject(out, "ok", true);
-    cJSON_AddNumberToObject(out, "gpio", pin);
-    cJSON_AddNumberToObject(out, "level", level);
-    esp_err_t err = send_json(req, out);
-    cJSON_Delete(out);
-    return err;
+    char out_buf[96];
+    json_writer_t jw;
+    jw_init(&jw, req, out_buf, sizeof(out_buf));
+    jw_begin_object(&jw, NULL);
+    jw_bool(&jw, "ok", true);
+    jw_int(&jw, "gpio", pin);
+    jw_int(&jw, "level", level);
+    jw_end_object(&jw);
+    return jw_send(&jw);
+}
+
+/* The allocation-free flat parse in fw_manifest.c handles every manifest the flasher writes; cJSON is
+ * only the fallback for escapes it does not decode. */
+static bool verify_manifest(const char *manifest_json, char *sha_out, size_t sha_out_size) {
+    manifest_result_t res = manifest_verify(manifest_json, g_cfg.ota_key, g_cfg.type, sha_out, sha_out_size);
+    if (res != MANIFEST_UNPARSED) return res == MANIFEST_OK;
+
+    cJSON *root = cJSON_Parse(manifest_json);
+    if (!root) return false;
+    static const char *const keys[] = {"algorithm", "sha256", "version", "device_type", "signature"};
+    const char *vals[5] = {0};
+    for (int i = 0; i < 5; i++) {
+        cJSON *item = cJSON_GetObjectItem(root, keys[i]);
+        vals[i] = cJSON_IsString(item) ? item->valuestring : NULL;
+    }
+    manifest_fields_t m = {.algorithm = vals[0], .sha256 = vals[1], .version = vals[2], .device_type = vals[3], .signature = vals[4]};
+    bool ok = manifest_check(&m, g_cfg.ota_key, g_cfg.type) == MANIFEST_OK;
+    if (ok) safe_strcpy(sha_out, m.sha256, sha_out_size);
+    cJSON_Delete(root);
+    return ok;
+}
+
+/* OTA pipeline: the network reader fills a ring of buffers and a writer task hashes and
+ * flashes them, so flash erase/write stalls no longer stop the TCP receive window draining. */
+#define OTA_PIPE_BUFS 4
+#define OTA_PIPE_BUF_SIZE 4096
+#define OTA_PIPE_TIMEOUT_MS 30000
+#define OTA_RESUME_MAX 5
+
+typedef struct {
+    int index;
+    int len; /* -1 marks end of stream */
+} ota_chunk_t;
+
+typedef struct {
+    char base_sha256[65];
+    uint32_t base_size;
+    uint32_t target_size;
+} ota_patch_info_t;
+
+typedef struct {
+    const esp_partition_t *partition;
+    esp_ota_handle_t handle;
+    delta_state_t *delta; /* set for a patch download; COPY ops read delta_base */
+    const esp_partition_t *delta_base;
+    uint8_t *pool;
+    QueueHandle_t free_q;
+    QueueHandle_t full_q;
+    SemaphoreHandle_t done;
+    mbedtls_sha256_context sha;
+    volatile bool failed;
+    bool drained;
+    uint32_t written;
+} ota_pipeline_t;
+
+typedef struct {
+    bool active;
+    bool ok;
+    const char *source;
+    const char *error;
+    uint32_t bytes;
+    uint32_t total;
+    uint32_t resumes;
+    int last_decile;
+    int64_t started_us;
+    int64_t finished_us;
+} ota_progress_t;
+
+static ota_progress_t g_ota_progress = {0};
+
+static void ota_progress_start(const char *source, uint32_t total) {
+    memset(&g_ota_progress, 0, sizeof(g_ota_progress));
+    g_ota_progress.active = true;
+    g_ota_progress.source = source;
+    g_ota_progress.total = total;
+    g_ota_progress.started_us = esp_timer_get_time();
+}
+
+static uint32_t ota_progress_elapsed_ms(void) {
+    int64_t end = g_ota_progress.active ? esp_timer_get_time() : g_ota_progress.finished_us;
+    return (uint32_t)((end - g_ota_progress.started_us) / 1000);
+}
+
+static uint32_t ota_progress_kbps(void) {
+    uint32_t ms = ota_progress_elapsed_ms();
+    return ms ? (uint32_t)(((uint64_t)g_ota_progress.bytes * 8) / ms) : 0;
+}
+
+static void ota_progress_update(uint32_t bytes) {
+    g_ota_progress.bytes = bytes;
+    if (g_ota_progress.total == 0) return;
+    int decile = (int)(((uint64_t)bytes * 10) / g_ota_progress.total);
+    if (decile == g_ota_progress.last_decile) return;
+    g_ota_progress.last_decile = decile;
+    ESP_LOGI(TAG, "OTA %s %u/%u bytes (%d%%) %u kbit/s", g_ota_progress.source, (unsigned)bytes,
+             (unsigned)g_ota_progress.total, decile * 10, (unsigned)ota_progress_kbps());
+}
+
+static void ota_progress_finish(bool ok, const char *error) {
+    g_ota_progress.active = false;
+    g_ota_progress.ok = ok;
+    g_ota_progress.error = error;
+    g_ota_progress.finished_us = esp_timer_get_time();
+    ESP_LOGI(TAG, "OTA %s %s bytes=%u ms=%u kbps=%u resumes=%u", g_ota_progress.source ? g_ota_progress.source : "-",
+             ok ? "done" : (error ? error : "failed"), (unsigned)g_ota_progress.bytes, (unsigned)ota_progress_elapsed_ms(),
+             (unsigned)ota_progress_kbps(), (unsigned)g_ota_progress.resumes);
+}
+
+static void write_ota_progress_members(json_writer_t *jw) {
+    jw_str(jw, "state", g_ota_progress.active ? "running" : (!g_ota_progress.source ? "idle" : (g_ota_progress.ok ? "done" : "failed")));
+    if (g_ota_progress.source) jw_str(jw, "source", g_ota_progress.source);
+    if (g_ota_progress.error) jw_str(jw, "error", g_ota_progress.error);
+    jw_int(jw, "bytes", (long)g_ota_progress.bytes);
+    jw_int(jw, "total", (long)g_ota_progress.total);
+    jw_int(jw, "ms", g_ota_progress.source ? (long)ota_progress_elapsed_ms() : 0);
+    jw_int(jw, "kbps", (long)ota_progress_kbps());
+    jw_int(jw, "resumes", (long)g_ota_progress.resumes);
 }
 
-static bool compute_manifest_signature(const char *sha256, const char *version, const char *device_type, char *out, size_t out_size) {
-    if (!sha256 || !version || !device_type || !out) return false;
-    char msg[256] = {0};
-    snprintf(msg, sizeof(msg), "%s:%s:%s", sha256, version, device_type);
-    unsigned char hmac[32] = {0};
-    const mbedtls_md_info_t *info = mbedtls_md_info_from_type(MBEDTLS_MD_SHA256);
-    if (!info) return false;
-    if (mbedtls_md_hmac(info, (const unsigned char *)g_cfg.ota_key, strlen(g_cfg.ota_key), (const unsigned char *)msg, strlen(msg), hmac) != 0) {
+/* Output side of the pipeline: every byte of the new image is hashed and flashed here. */
+static bool ota_pipeline_emit(ota_pipeline_t *p, const uint8_t *data, size_t len) {
+    mbedtls_sha256_update(&p->sha, data, len);
+    if (esp_ota_write(p->handle, data, len) != ESP_OK) {
+        ESP_LOGE(TAG, "esp_ota_write failed at %u", (unsigned)p->written);
         return false;
     }
-    hex_encode(hmac, sizeof(hmac), out, out_size);
+    p->written += len;
     return true;
 }
 
-static bool http_get_to_buffer(const char *url, char *buf, size_t buf_size) {
-    if (!url || !buf || buf_size < 2) return false;
-    esp_http_client_config_t cfg = {.url = url, .timeout_ms = 15000};
-    esp_http_client_handle_t client = esp_http_client_init(&cfg);
-    if (!client) return false;
-    if (esp_http_client_open(client, 0) != ESP_OK) {
-        esp_http_client_cleanup(client);
+static bool ota_delta_read_base(void *ctx, uint32_t offset, uint8_t *buf, size_t len) {
+    ota_pipeline_t *p = (ota_pipeline_t *)ctx;
+    if (esp_partition_read(p->delta_base, offset, buf, len) != ESP_OK) {
+        ESP_LOGE(TAG, "Delta base read failed at %u", (unsigned)offset);
         return false;
     }
+    return true;
+}
 
-    int read_total = 0;
-    while (read_total < (int)(buf_size - 1)) {
-        int r = esp_http_client_read(client, buf + read_total, buf_size - 1 - read_total);
-        if (r <= 0) break;
-        read_total += r;
+static bool ota_delta_emit(void *ctx, const uint8_t *data, size_t len) {
+    return ota_pipeline_emit((ota_pipeline_t *)ctx, data, len);
+}
+
+static bool ota_delta_feed(ota_pipeline_t *p, const uint8_t *data, size_t len) {
+    delta_result_t res = delta_feed(p->delta, data, len);
+    if (res == DELTA_OK) return true;
+    ESP_LOGE(TAG, "Delta patch rejected (%s) after %u bytes", delta_result_name(res), (unsigned)p->written);
+    return false;
+}
+
+static void ota_writer_task(void *arg) {
+    ota_pipeline_t *p = (ota_pipeline_t *)arg;
+    ota_chunk_t chunk;
+    while (xQueueReceive(p->full_q, &chunk, portMAX_DELAY) == pdTRUE && chunk.len >= 0) {
+        uint8_t *data = p->pool + (size_t)chunk.index * OTA_PIPE_BUF_SIZE;
+        if (!p->failed) {
+            bool ok = p->delta ? ota_delta_feed(p, data, (size_t)chunk.len) : ota_pipeline_emit(p, data, (size_t)chunk.len);
+            if (!ok) p->failed = true;
+        }
+        xQueueSend(p->free_q, &chunk.index, portMAX_DELAY);
     }
-    buf[read_total] = '\0';
-    esp_http_client_close(client);
-    esp_http_client_cleanup(client);
-    return read_total > 0;
+    xSemaphoreGive(p->done);
+    vTaskDelete(NULL);
 }
 
-static bool verify_manifest(const char *manifest_json, char *sha_out, size_t sha_out_size) {
-    cJSON *root = cJSON_Parse(manifest_json);
-    if (!root) return false;
+static void ota_pipeline_release(ota_pipeline_t *p) {
+    if (p->delta) {
+        free(p->delta->scratch);
+        free(p->delta);
+        p->delta = NULL;
+    }
+    if (p->pool) free(p->pool);
+    if (p->free_q) vQueueDelete(p->free_q);
+    if (p->full_q) vQueueDelete(p->full_q);
+    if (p->done) vSemaphoreDelete(p->done);
+    p->pool = NULL;
+    p->free_q = NULL;
+    p->full_q = NULL;
+    p->done = NULL;
+}
 
-    cJSON *algo = cJSON_GetObjectItem(root, "algorithm");
-    cJSON *sha = cJSON_GetObjectItem(root, "sha256");
-    cJSON *version = cJSON_GetObjectItem(root, "version");
-    cJSON *device_type = cJSON_GetObjectItem(root, "device_type");
-    cJSON *signature = cJSON_GetObjectItem(root, "signature");
-    if (!cJSON_IsString(algo) || !cJSON_IsString(sha) || !cJSON_IsString(version) || !cJSON_IsString(device_type) || !cJSON_IsString(signature)) {
-        cJSON_Delete(root);
+/* A known image_size pre-erases exactly that span up front; otherwise sectors are erased as
+ * they are written, which the ring hides from the reader. */
+static bool ota_pipeline_begin(ota_pipeline_t *p, uint32_t image_size, const ota_patch_info_t *patch) {
+    memset(p, 0, sizeof(*p));
+    p->partition = esp_ota_get_next_update_partition(NULL);
+    if (!p->partition) {
+        ESP_LOGE(TAG, "No OTA partition available");
         return false;
     }
-    if (strcmp(algo->valuestring, "hmac-sha256") != 0) {
-        cJSON_Delete(root);
+    if (patch) {
+        p->delta = calloc(1, sizeof(delta_state_t));
+        if (p->delta) p->delta->scratch = malloc(OTA_PIPE_BUF_SIZE);
+        if (!p->delta || !p->delta->scratch) {
+            ESP_LOGE(TAG, "Delta state allocation failed");
+            ota_pipeline_release(p);
+            return false;
+        }
+        p->delta_base = esp_ota_get_running_partition();
+        delta_init(p->delta, patch->base_size, patch->target_size, p->delta->scratch, OTA_PIPE_BUF_SIZE, ota_delta_read_base,
+                   ota_delta_emit, p);
+        image_size = patch->target_size;
+    }
+    if (image_size > p->partition->size) {
+        ESP_LOGE(TAG, "OTA image %u bytes exceeds partition %u", (unsigned)image_size, (unsigned)p->partition->size);
+        ota_pipeline_release(p);
         return false;
     }
-    if (strcmp(device_type->valuestring, g_cfg.type) != 0 && strcmp(device_type->valuestring, "any") != 0) {
-        cJSON_Delete(root);
+    p->pool = malloc((size_t)OTA_PIPE_BUFS * OTA_PIPE_BUF_SIZE);
+    p->free_q = xQueueCreate(OTA_PIPE_BUFS, sizeof(int));
+    p->full_q = xQueueCreate(OTA_PIPE_BUFS + 1, sizeof(ota_chunk_t));
+    p->done = xSemaphoreCreateBinary();
+    if (!p->pool || !p->free_q || !p->full_q || !p->done) {
+        ESP_LOGE(TAG, "OTA pipeline allocation failed");
+        ota_pipeline_release(p);
+        return false;
+    }
+    for (int i = 0; i < OTA_PIPE_BUFS; i++) xQueueSend(p->free_q, &i, 0);
+
+    int64_t erase_start = esp_timer_get_time();
+    if (esp_ota_begin(p->partition, image_size ? image_size : OTA_WITH_SEQUENTIAL_WRITES, &p->handle) != ESP_OK) {
+        ESP_LOGE(TAG, "esp_ota_begin failed");
+        ota_pipeline_release(p);
+        return false;
+    }
+    if (image_size) ESP_LOGI(TAG, "OTA pre-erased %u bytes in %lld ms", (unsigned)image_size, (long long)((esp_timer_get_time() - erase_start) / 1000));
+
+    mbedtls_sha256_init(&p->sha);
+    mbedtls_sha256_starts(&p->sha, 0);
+    if (xTaskCreatePinnedToCore(ota_writer_task, "ota_writer", 4096, p, 6, NULL, NET_CORE) != pdPASS) {
+        ESP_LOGE(TAG, "OTA writer task start failed");
+        mbedtls_sha256_free(&p->sha);
+        esp_ota_abort(p->handle);
+        ota_pipeline_release(p);
         return false;
     }
+    return true;
+}
+
+/* Next free ring buffer, or NULL if the writer failed or stalled. */
+static uint8_t *ota_pipeline_acquire(ota_pipeline_t *p, int *index) {
+    if (p->failed) return NULL;
+    if (xQueueReceive(p->free_q, index, pdMS_TO_TICKS(OTA_PIPE_TIMEOUT_MS)) != pdTRUE) {
+        ESP_LOGE(TAG, "OTA writer stalled");
+        p->failed = true;
+        return NULL;
+    }
+    return p->pool + (size_t)(*index) * OTA_PIPE_BUF_SIZE;
+}
+
+static void ota_pipeline_submit(ota_pipeline_t *p, int index, int len) {
+    if (len <= 0) {
+        xQueueSend(p->free_q, &index, 0);
+        return;
+    }
+    ota_chunk_t chunk = {.index = index, .len = len};
+    xQueueSend(p->full_q, &chunk, portMAX_DELAY);
+}
+
+/* Flushes the ring and stops the writer; returns false if any write failed. */
+static bool ota_pipeline_drain(ota_pipeline_t *p, char *sha_hex, size_t sha_hex_size) {
+    if (p->drained) return !p->failed;
+    ota_chunk_t end = {.index = -1, .len = -1};
+    xQueueSend(p->full_q, &end, portMAX_DELAY);
+    xSemaphoreTake(p->done, portMAX_DELAY);
+    unsigned char sha_bin[32] = {0};
+    mbedtls_sha256_finish(&p->sha, sha_bin);
+    mbedtls_sha256_free(&p->sha);
+    if (sha_hex) hex_encode(sha_bin, sizeof(sha_bin), sha_hex, sha_hex_size);
+    if (p->delta) {
+        if (!p->failed && delta_finish(p->delta) != DELTA_OK) {
+            ESP_LOGE(TAG, "Delta incomplete: wrote %u of %u bytes", (unsigned)p->written, (unsigned)p->delta->target_size);
+            p->failed = true;
+        }
+    }
+    ota_pipeline_release(p);
+    p->drained = true;
+    return !p->failed;
+}
+
+static void ota_pipeline_abort(ota_pipeline_t *p) {
+    ota_pipeline_drain(p, NULL, 0);
+    esp_ota_abort(p->handle);
+}
 
-    char expected_sig[65] = {0};
-    bool sig_ok = compute_manifest_signature(sha->valuestring, version->valuestring, device_type->valuestring, expected_sig, sizeof(expected_sig));
-    bool ok = sig_ok && strcmp(expected_sig, signature->valuestring) == 0;
-    if (ok) safe_strcpy(sha_out, sha->valuestring, sha_out_size);
+static bool ota_pipeline_commit(ota_pipeline_t *p) {
+    if (esp_ota_end(p->handle) != ESP_OK) {
+        ESP_LOGE(TAG, "esp_ota_end failed");
+        return false;
+    }
+    if (esp_ota_set_boot_partition(p->partition) != ESP_OK) {
+        ESP_LOGE(TAG, "esp_ota_set_boot_partition failed");
+        return false;
+    }
+    return true;
+}
+
+/* Reads the optional unsigned "patch" block; the patched image is still checked against the signed sha256. */
+static bool parse_manifest_patch(const char *manifest_json, ota_patch_info_t *out) {
+    cJSON *root = cJSON_Parse(manifest_json);
+    if (!root) return false;
+    cJSON *patch = cJSON_GetObjectItem(root, "patch");
+    cJSON *format = patch ? cJSON_GetObjectItem(patch, "format") : NULL;
+    cJSON *base_sha = patch ? cJSON_GetObjectItem(patch, "base_sha256") : NULL;
+    cJSON *base_size = patch ? cJSON_GetObjectItem(patch, "base_size") : NULL;
+    cJSON *target_size = patch ? cJSON_GetObjectItem(patch, "target_size") : NULL;
+    bool ok = cJSON_IsString(format) && strcmp(format->valuestring, "8bdp1") == 0 && cJSON_IsString(base_sha) &&
+              strlen(base_sha->valuestring) == 64 && cJSON_IsNumber(base_size) && base_size->valuedouble > 0 &&
+              base_size->valuedouble <= UINT32_MAX && cJSON_IsNumber(target_size) && target_size->valuedouble > 0 &&
+              target_size->valuedouble <= UINT32_MAX;
+    if (ok) {
+        safe_strcpy(out->base_sha256, base_sha->valuestring, sizeof(out->base_sha256));
+        out->base_size = (uint32_t)base_size->valuedouble;
+        out->target_size = (uint32_t)target_size->valuedouble;
+    }
     cJSON_Delete(root);
     return ok;
 }
 
-static bool ota_download_and_apply(const char *firmware_url, const char *expected_sha) {
-    const esp_partition_t *update_partition = esp_ota_get_next_update_partition(NULL);
-    if (!update_partition) {
-        ESP_LOGE(TAG, "No OTA partition available");
-        return false;
+/* A delta only applies to the exact image it was built from, so hash that prefix of the running slot. */
+static bool running_image_matches(const ota_patch_info_t *patch) {
+    const esp_partition_t *running = esp_ota_get_running_partition();
+    if (!running || patch->base_size > running->size) return false;
+    uint8_t *buf = malloc(OTA_PIPE_BUF_SIZE);
+    if (!buf) return false;
+    mbedtls_sha256_context sha;
+    mbedtls_sha256_init(&sha);
+    mbedtls_sha256_starts(&sha, 0);
+    bool ok = true;
+    for (uint32_t off = 0; ok && off < patch->base_size; off += OTA_PIPE_BUF_SIZE) {
+        uint32_t n = patch->base_size - off < OTA_PIPE_BUF_SIZE ? patch->base_size - off : OTA_PIPE_BUF_SIZE;
+        ok = esp_partition_read(running, off, buf, n) == ESP_OK;
+        if (ok) mbedtls_sha256_update(&sha, buf, n);
     }
+    unsigned char digest[32] = {0};
+    mbedtls_sha256_finish(&sha, digest);
+    mbedtls_sha256_free(&sha);
+    free(buf);
+    char hex[65] = {0};
+    hex_encode(digest, sizeof(digest), hex, sizeof(hex));
+    return ok && strcmp(hex, patch->base_sha256) == 0;
+}
 
-    esp_ota_handle_t ota_handle = 0;
-    if (esp_ota_begin(update_partition, OTA_SIZE_UNKNOWN, &ota_handle) != ESP_OK) {
-        ESP_LOGE(TAG, "esp_ota_begin failed");
-        return false;
+/* One client for the OTA server, kept across checks: manifest, patch and image reuse a keep-alive
+ * connection when they share a host, and the saved TLS session makes later handshakes abbreviated.
+ * Only ota_apply_handler uses it, on the single async worker. */
+#define OTA_HTTP_TIMEOUT_MS 30000
+#define OTA_ETAG_MAX 64
+
+static esp_http_client_handle_t g_ota_http = NULL;
+static char g_ota_etag_rx[OTA_ETAG_MAX]; /* ETag of the last response; empty when absent or too long to cache */
+
+static esp_err_t ota_http_event(esp_http_client_event_t *evt) {
+    if (evt->event_id == HTTP_EVENT_ON_HEADER && strcasecmp(evt->header_key, "ETag") == 0 &&
+        strlen(evt->header_value) < sizeof(g_ota_etag_rx)) {
+        safe_strcpy(g_ota_etag_rx, evt->header_value, sizeof(g_ota_etag_rx));
+    }
+    return ESP_OK;
+}
+
+/* Points the shared client at url without leftover Range/If-None-Match headers; a new host drops the old connection. */
+static esp_http_client_handle_t ota_http_client(const char *url) {
+    if (g_ota_http && esp_http_client_set_url(g_ota_http, url) != ESP_OK) {
+        esp_http_client_cleanup(g_ota_http);
+        g_ota_http = NULL;
+    }
+    if (g_ota_http) {
+        esp_http_client_delete_header(g_ota_http, "Range");
+        esp_http_client_delete_header(g_ota_http, "If-None-Match");
+        return g_ota_http;
+    }
+    esp_http_client_config_t cfg = {
+        .url = url,
+        .timeout_ms = OTA_HTTP_TIMEOUT_MS,
+        .buffer_size = OTA_PIPE_BUF_SIZE,
+        .keep_alive_enable = true,
+        .event_handler = ota_http_event,
+#if CONFIG_ESP_TLS_CLIENT_SESSION_TICKETS
+        .save_client_session = true,
+#endif
+    };
+    g_ota_http = esp_http_client_init(&cfg);
+    return g_ota_http;
+}
+
+/* Sends the request and reads the headers. A kept-alive socket the server closed while idle only
+ * fails on use, so one retry goes out on a fresh connection. */
+static int64_t ota_http_start(esp_http_client_handle_t client) {
+    for (int attempt = 0; attempt < 2; attempt++) {
+        g_ota_etag_rx[0] = '\0';
+        if (esp_http_client_open(client, 0) == ESP_OK) {
+            int64_t len = esp_http_client_fetch_headers(client);
+            if (len >= 0 || esp_http_client_is_chunked_response(client)) return len > 0 ? len : 0;
+        }
+        esp_http_client_close(client);
+    }
+    return -1;
+}
+
+/* Opens (or re-opens) the image request and checks its status; returns the body length, 0 when
+ * unknown, -1 on error. */
+static int64_t ota_http_open(esp_http_client_handle_t client, int expected_status) {
+    int64_t len = ota_http_start(client);
+    if (len < 0) return -1;
+    int status = esp_http_client_get_status_code(client);
+    if (status != expected_status) {
+        ESP_LOGE(TAG, "OTA HTTP status %d (expected %d)", status, expected_status);
+        esp_http_client_close(client);
+        return -1;
+    }
+    return len;
+}
+
+/* Keeps the connection for the next request only when this response was read to its end. */
+static void ota_http_finish(esp_http_client_handle_t client, bool ok) {
+    if (!ok || !esp_http_client_is_complete_data_received(client)) esp_http_client_close(client);
+}
+
+typedef enum {
+    OTA_FETCH_FAILED,
+    OTA_FETCH_NOT_MODIFIED,
+    OTA_FETCH_OK,
+} ota_fetch_result_t;
+
+/* GETs the manifest into buf; with an etag the server may answer 304 without a body. */
+static ota_fetch_result_t ota_fetch_manifest(const char *url, const char *etag, char *buf, size_t buf_size) {
+    esp_http_client_handle_t client = ota_http_client(url);
+    if (!client) return OTA_FETCH_FAILED;
+    if (etag[0]) esp_http_client_set_header(client, "If-None-Match", etag);
+    if (ota_http_start(client) < 0) return OTA_FETCH_FAILED;
+    int status = esp_http_client_get_status_code(client);
+    if (status == 304 && etag[0]) {
+        ota_http_finish(client, true);
+        return OTA_FETCH_NOT_MODIFIED;
+    }
+    if (status != 200) {
+        ESP_LOGE(TAG, "Manifest HTTP status %d", status);
+        esp_http_client_close(client);
+        return OTA_FETCH_FAILED;
+    }
+    int read_total = 0;
+    int r = 0;
+    while (read_total < (int)(buf_size - 1)) {
+        r = esp_http_client_read(client, buf + read_total, buf_size - 1 - read_total);
+        if (r <= 0) break;
+        read_total += r;
+    }
+    buf[read_total] = '\0';
+    ota_http_finish(client, r >= 0);
+    return read_total > 0 ? OTA_FETCH_OK : OTA_FETCH_FAILED;
+}
+
+/* Last manifest that passed verification, kept in NVS so an unchanged one costs a 304 (or, without
+ * ETags, one digest compare) instead of a fresh signature check. installed_* record the image this
+ * device last flashed, so a check against the same manifest answers up_to_date without a download. */
+#define OTA_MANIFEST_CACHE_VERSION 2
+
+typedef struct {
+    uint8_t version;
+    uint32_t key_hash; /* manifest URL, ota_key and device type the entry was verified under */
+    char etag[OTA_ETAG_MAX];
+    uint8_t digest[32]; /* SHA-256 of the manifest body */
+    char sha256[65];    /* signed image digest */
+    bool has_patch;
+    ota_patch_info_t patch;
+    char installed_sha256[65];
+    uint32_t installed_addr; /* partition it went to; after a rollback the running one differs */
+    uint8_t installed_elf_sha[32]; /* app_elf_sha256 of that image; a serial flash over the slot changes it */
+} ota_manifest_cache_t;
+
+static ota_manifest_cache_t g_ota_cache;
+static bool g_ota_cache_loaded = false;
+static uint32_t g_ota_manifest_checks = 0;
+static uint32_t g_ota_manifest_not_modified = 0;
+
+static uint32_t ota_manifest_key_hash(const char *manifest_url) {
+    uint32_t hash = fnv1a_update(FNV1A_INIT, manifest_url, strlen(manifest_url));
+    hash = fnv1a_update(hash, g_cfg.ota_key, strlen(g_cfg.ota_key));
+    return fnv1a_update(hash, g_cfg.type, strlen(g_cfg.type));
+}
+
+static void ota_cache_load(void) {
+    if (g_ota_cache_loaded) return;
+    g_ota_cache_loaded = true;
+    nvs_handle_t nvs;
+    if (nvs_open("ota", NVS_READONLY, &nvs) != ESP_OK) return;
+    ota_manifest_cache_t cache;
+    size_t len = sizeof(cache);
+    if (nvs_get_blob(nvs, "manifest", &cache, &len) == ESP_OK && len == sizeof(cache) &&
+        cache.version == OTA_MANIFEST_CACHE_VERSION) {
+        g_ota_cache = cache;
+    }
+    nvs_close(nvs);
+}
+
+/* NVS is only rewritten when the manifest, its ETag or the installed image changed. */
+static void ota_cache_store(const ota_manifest_cache_t *cache) {
+    if (memcmp(cache, &g_ota_cache, sizeof(*cache)) == 0) return;
+    g_ota_cache = *cache;
+    nvs_handle_t nvs;
+    if (nvs_open("ota", NVS_READWRITE, &nvs) != ESP_OK) return;
+    if (nvs_set_blob(nvs, "manifest", cache, sizeof(*cache)) == ESP_OK && nvs_commit(nvs) == ESP_OK) g_nvs_stats.ota_cache_writes++;
+    nvs_close(nvs);
+}
+
+/* Remembers the image an OTA just committed so the boot that runs it can report its sha256. */
+static void ota_record_installed(const char *sha256) {
+    const esp_partition_t *boot = esp_ota_get_boot_partition();
+    esp_app_desc_t desc;
+    if (!boot || esp_ota_get_partition_description(boot, &desc) != ESP_OK) return;
+    ota_cache_load();
+    ota_manifest_cache_t entry = g_ota_cache;
+    if (entry.version != OTA_MANIFEST_CACHE_VERSION) {
+        /* Zero digest and ETag: the manifest half never counts as cached. */
+        memset(&entry, 0, sizeof(entry));
+        entry.version = OTA_MANIFEST_CACHE_VERSION;
+    }
+    safe_strcpy(entry.installed_sha256, sha256, sizeof(entry.installed_sha256));
+    entry.installed_addr = boot->address;
+    memcpy(entry.installed_elf_sha, desc.app_elf_sha256, sizeof(entry.installed_elf_sha));
+    ota_cache_store(&entry);
+}
+
+/* Once per boot: the running image is the one last installed over the air only if the slot and the
+ * app's ELF hash both match the record. Otherwise (rollback, serial flash, older record) it stays unknown. */
+static void ota_running_image_init(void) {
+    ota_cache_load();
+    const esp_partition_t *running = esp_ota_get_running_partition();
+    const esp_app_desc_t *app = esp_app_get_description();
+    if (running && g_ota_cache.installed_sha256[0] && running->address == g_ota_cache.installed_addr &&
+        memcmp(app->app_elf_sha256, g_ota_cache.installed_elf_sha, sizeof(g_ota_cache.installed_elf_sha)) == 0) {
+        safe_strcpy(g_running_sha256, g_ota_cache.installed_sha256, sizeof(g_running_sha256));
     }
+}
 
-    esp_http_client_config_t cfg = {.url = firmware_url, .timeout_ms = 30000};
-    esp_http_client_handle_t client = esp_http_client_init(&cfg);
-    if (!client || esp_http_client_open(client, 0) != ESP_OK) {
-        esp_ota_end(ota_handle);
-        if (client) esp_http_client_cleanup(client);
+/* Streams firmware_url into the inactive slot; with `patch` set the body is a delta replayed against the running image. */
+static bool ota_download_and_apply(const char *firmware_url, const char *expected_sha, const ota_patch_info_t *patch) {
+    esp_http_client_handle_t client = ota_http_client(firmware_url);
+    int64_t total = client ? ota_http_open(client, 200) : -1;
+    if (total < 0) {
         ESP_LOGE(TAG, "HTTP open failed");
         return false;
     }
 
-    unsigned char sha_bin[32] = {0};
-    char sha_hex[65] = {0};
-    unsigned char buf[1024];
-    mbedtls_sha256_context sha_ctx;
-    mbedtls_sha256_init(&sha_ctx);
-    mbedtls_sha256_starts(&sha_ctx, 0);
-
-    while (1) {
-        int r = esp_http_client_read(client, (char *)buf, sizeof(buf));
-        if (r < 0) {
-            ESP_LOGE(TAG, "HTTP read failed");
-            esp_http_client_close(client);
-            esp_http_client_cleanup(client);
-            mbedtls_sha256_free(&sha_ctx);
-            esp_ota_end(ota_handle);
-            return false;
+    ota_pipeline_t pipe;
+    if (!ota_pipeline_begin(&pipe, (uint32_t)total, patch)) {
+        esp_http_client_close(client);
+        return false;
+    }
+    ota_progress_start(patch ? "delta" : "url", (uint32_t)total);
+
+    uint32_t received = 0;
+    const char *error = NULL;
+    while (!error) {
+        int index = 0;
+        uint8_t *buf = ota_pipeline_acquire(&pipe, &index);
+        if (!buf) {
+            error = "flash write failed";
+            break;
         }
-        if (r == 0) break;
-
-        mbedtls_sha256_update(&sha_ctx, buf, r);
-        if (esp_ota_write(ota_handle, buf, r) != ESP_OK) {
-            ESP_LOGE(TAG, "esp_ota_write failed");
-            esp_http_client_close(client);
-            esp_http_client_cleanup(client);
-            mbedtls_sha256_free(&sha_ctx);
-            esp_ota_end(ota_handle);
-            return false;
+        int r = esp_http_client_read(client, (char *)buf, OTA_PIPE_BUF_SIZE);
+        ota_pipeline_submit(&pipe, index, r);
+        if (r > 0) {
+            received += r;
+            ota_progress_update(received);
+            continue;
         }
-    }
-
-    mbedtls_sha256_finish(&sha_ctx, sha_bin);
-    mbedtls_sha256_free(&sha_ctx);
-    hex_encode(sha_bin, sizeof(sha_bin), sha_hex, sizeof(sha_hex));
+        if (total > 0 ? received >= (uint32_t)total : (r == 0 && esp_http_client_is_complete_data_received(client))) break;
 
-    esp_http_client_close(client);
-    esp_http_client_cleanup(client);
+        /* Dropped mid-image: pick up where we stopped with a Range request instead of starting over. */
+        if (total == 0 || g_ota_progress.resumes >= OTA_RESUME_MAX) {
+            error = "download interrupted";
+            break;
+        }
+        g_ota_progress.resumes++;
+        ESP_LOGW(TAG, "OTA download dropped at %u/%u, resuming (%u/%d)", (unsigned)received, (unsigned)total,
+                 (unsigned)g_ota_progress.resumes, OTA_RESUME_MAX);
+        esp_http_client_close(client);
+        vTaskDelay(pdMS_TO_TICKS(500 * g_ota_progress.resumes));
+        char range[32];
+        snprintf(range, sizeof(range), "bytes=%u-", (unsigned)received);
+        esp_http_client_set_header(client, "Range", range);
+        if (ota_http_open(client, 206) != (int64_t)(total - received)) error = "range resume rejected";
+    }
+    ota_http_finish(client, !error);
 
-    if (strcmp(sha_hex, expected_sha) != 0) {
+    char sha_hex[65] = {0};
+    if (!ota_pipeline_drain(&pipe, sha_hex, sizeof(sha_hex)) && !error) error = "flash write failed";
+    if (!error && strcmp(sha_hex, expected_sha) != 0) {
         ESP_LOGE(TAG, "SHA mismatch expected=%s got=%s", expected_sha, sha_hex);
-        esp_ota_end(ota_handle);
-        return false;
+        error = "sha mismatch";
     }
-
-    if (esp_ota_end(ota_handle) != ESP_OK) {
-        ESP_LOGE(TAG, "esp_ota_end failed");
+    if (error) {
+        ota_pipeline_abort(&pipe);
+        ota_progress_finish(false, error);
         return false;
     }
-    if (esp_ota_set_boot_partition(update_partition) != ESP_OK) {
-        ESP_LOGE(TAG, "esp_ota_set_boot_partition failed");
+    if (!ota_pipeline_commit(&pipe)) {
+        ota_progress_finish(false, "partition finalize failed");
         return false;
     }
+    ota_progress_finish(true, NULL);
     ESP_LOGI(TAG, "OTA ready; reboot pending");
     return true;
 }
 
-static esp_err_t ota_apply_handler(httpd_req_t *req) {
-    char body[512] = {0};
-    int len = httpd_req_recv(req, body, sizeof(body) - 1);
-    if (len <= 0) return httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "bad payload");
-    cJSON *root = cJSON_Parse(body);
-    if (!root) return httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "json parse failed");
-    if (!check_passcode(root)) {
+static esp_err_t ota_apply_handler(httpd_req_t *req, http_auth_t auth) {
+    esp_err_t err = ESP_OK;
+    cJSON *root = http_body_parse_json(req, &err);
+    if (!root) return err;
+    if (!check_request_auth(auth, root)) {
         cJSON_Delete(root);
-        return httpd_resp_send_err(req, HTTPD_401_UNAUTHORIZED, "invalid passcode");
+        return http_send_err(req, HTTPD_401_UNAUTHORIZED, "invalid passcode");
     }
 
     cJSON *firmware_url = cJSON_GetObjectItem(root, "firmware_url");
     cJSON *manifest_url = cJSON_GetObjectItem(root, "manifest_url");
+    cJSON *patch_url = cJSON_GetObjectItem(root, "patch_url");
+    bool force = cJSON_IsTrue(cJSON_GetObjectItem(root, "force"));
     if (!cJSON_IsString(firmware_url) || !cJSON_IsString(manifest_url)) {
         cJSON_Delete(root);
-        return httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "firmware_url and manifest_url required");
+        return http_send_err(req, HTTPD_400_BAD_REQUEST, "firmware_url and manifest_url required");
     }
     char firmware_url_copy[256] = {0};
     char manifest_url_copy[256] = {0};
+    char patch_url_copy[256] = {0};
     safe_strcpy(firmware_url_copy, firmware_url->valuestring, sizeof(firmware_url_copy));
     safe_strcpy(manifest_url_copy, manifest_url->valuestring, sizeof(manifest_url_copy));
+    if (cJSON_IsString(patch_url)) safe_strcpy(patch_url_copy, patch_url->valuestring, sizeof(patch_url_copy));
     cJSON_Delete(root);
 
-    char manifest_buf[OTA_BUFFER_MAX] = {0};
-    if (!http_get_to_buffer(manifest_url_copy, manifest_buf, sizeof(manifest_buf))) {
-        return httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "manifest download failed");
+    /* The cached entry only counts for this URL and the current key, so a 304 never skips a check the
+     * manifest would now fail. force refetches the manifest and re-flashes even an installed image. */
+    ota_cache_load();
+    uint32_t key_hash = ota_manifest_key_hash(manifest_url_copy);
+    bool cache_valid = !force && g_ota_cache.version == OTA_MANIFEST_CACHE_VERSION && g_ota_cache.key_hash == key_hash;
+    ota_manifest_cache_t entry = g_ota_cache;
+
+    /* Heap, not stack: an 8 KB manifest frame was bigger than the whole httpd task stack. */
+    char *manifest_buf = calloc(1, OTA_BUFFER_MAX);
+    if (!manifest_buf) return http_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "out of memory");
+    g_ota_manifest_checks++;
+    ota_fetch_result_t fetched =
+        ota_fetch_manifest(manifest_url_copy, cache_valid ? g_ota_cache.etag : "", manifest_buf, OTA_BUFFER_MAX);
+    if (fetched == OTA_FETCH_FAILED) {
+        free(manifest_buf);
+        return http_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "manifest download failed");
     }
-
+    if (fetched == OTA_FETCH_NOT_MODIFIED) {
+        g_ota_manifest_not_modified++;
+    } else {
+        uint8_t digest[32] = {0};
+        mbedtls_sha256((const unsigned char *)manifest_buf, strlen(manifest_buf), digest, 0);
+        if (!cache_valid || memcmp(digest, g_ota_cache.digest, sizeof(digest)) != 0) {
+            char sha[65] = {0};
+            if (!verify_manifest(manifest_buf, sha, sizeof(sha))) {
+                free(manifest_buf);
+                return http_send_err(req, HTTPD_401_UNAUTHORIZED, "manifest signature verification failed");
+            }
+            entry.version = OTA_MANIFEST_CACHE_VERSION;
+            entry.key_hash = key_hash;
+            safe_strcpy(entry.sha256, sha, sizeof(entry.sha256));
+            memset(&entry.patch, 0, sizeof(entry.patch));
+            entry.has_patch = parse_manifest_patch(manifest_buf, &entry.patch);
+        }
+        memcpy(entry.digest, digest, sizeof(entry.digest));
+        safe_strcpy(entry.etag, g_ota_etag_rx, sizeof(entry.etag));
+    }
+    free(manifest_buf);
+    ota_cache_store(&entry);
     char expected_sha[65] = {0};
-    if (!verify_manifest(manifest_buf, expected_sha, sizeof(expected_sha))) {
-        return httpd_resp_send_err(req, HTTPD_401_UNAUTHORIZED, "manifest signature verification failed");
+    safe_strcpy(expected_sha, entry.sha256, sizeof(expected_sha));
+
+    if (!force && g_running_sha256[0] && strcmp(g_running_sha256, entry.sha256) == 0) {
+        char out_buf[128];
+        json_writer_t jw;
+        jw_init(&jw, req, out_buf, sizeof(out_buf));
+        jw_begin_object(&jw, NULL);
+        jw_bool(&jw, "ok", true);
+        jw_bool(&jw, "rebooting", false);
+        jw_str(&jw, "mode", "url_manifest");
+        jw_bool(&jw, "up_to_date", true);
+        jw_bool(&jw, "manifest_cached", fetched == OTA_FETCH_NOT_MODIFIED);
+        jw_end_object(&jw);
+        return jw_send(&jw);
     }
 
-    bool ok = ota_download_and_apply(firmware_url_copy, expected_sha);
+    /* Try the delta first; any mismatch or failure falls back to the full image. */
+    bool delta = false;
+    ota_patch_info_t patch = entry.patch;
+    bool has_patch = patch_url_copy[0] && entry.has_patch;
+    if (has_patch) {
+        if (running_image_matches(&patch)) {
+            delta = ota_download_and_apply(patch_url_copy, expected_sha, &patch);
+            if (!delta) ESP_LOGW(TAG, "Delta OTA failed; falling back to full image");
+        } else {
+            ESP_LOGW(TAG, "Running image does not match patch base; using full image");
+        }
+    }
+    bool ok = delta || ota_download_and_apply(firmware_url_copy, expected_sha, NULL);
     if (!ok) {
-        return httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "ota apply failed");
-    }
-    cJSON *resp = cJSON_CreateObject();
-    cJSON_AddBoolToObject(resp, "ok", true);
-    cJSON_AddBoolToObject(resp, "rebooting", true);
-    cJSON_AddStringToObject(resp, "mode", "url_manifest");
-    esp_err_t err = send_json(req, resp);
-    cJSON_Delete(resp);
+        return http_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "ota apply failed");
+    }
+    ota_record_installed(expected_sha);
+    char out_buf[192];
+    json_writer_t jw;
+    jw_init(&jw, req, out_buf, sizeof(out_buf));
+    jw_begin_object(&jw, NULL);
+    jw_bool(&jw, "ok", true);
+    jw_bool(&jw, "rebooting", true);
+    jw_str(&jw, "mode", "url_manifest");
+    jw_bool(&jw, "delta", delta);
+    jw_bool(&jw, "manifest_cached", fetched == OTA_FETCH_NOT_MODIFIED);
+    jw_int(&jw, "bytes", (long)g_ota_progress.bytes);
+    jw_int(&jw, "ms", (long)ota_progress_elapsed_ms());
+    jw_int(&jw, "kbps", (long)ota_progress_kbps());
+    jw_int(&jw, "resumes", (long)g_ota_progress.resumes);
+    jw_end_object(&jw);
+    err = jw_send(&jw);
     if (err == ESP_OK) {
         schedule_restart_ms(700);
     }
     return err;
 }
 
-static esp_err_t ota_upload_handler(httpd_req_t *req) {
-    if (!check_passcode_header(req)) {
-        return httpd_resp_send_err(req, HTTPD_401_UNAUTHORIZED, "invalid passcode header");
+static esp_err_t ota_upload_handler(httpd_req_t *req, http_auth_t auth) {
+    if (auth != HTTP_AUTH_OK && !check_passcode_header(req)) {
+        return http_send_err(req, HTTPD_401_UNAUTHORIZED, "invalid passcode header");
     }
     if (req->content_len <= 0) {
-        return httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "empty firmware payload");
+        return http_send_err(req, HTTPD_400_BAD_REQUEST, "empty firmware payload");
     }
 
-    const esp_partition_t *update_partition = esp_ota_get_next_update_partition(NULL);
-    if (!update_partition) {
-        return httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "no ota partition");
+    ota_pipeline_t pipe;
+    if (!ota_pipeline_begin(&pipe, (uint32_t)req->content_len, NULL)) {
+        return http_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "esp_ota_begin failed");
     }
-
-    esp_ota_handle_t ota_handle = 0;
-    if (esp_ota_begin(update_partition, req->content_len, &ota_handle) != ESP_OK) {
-        return httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "esp_ota_begin failed");
-    }
-
-    mbedtls_sha256_context sha_ctx;
-    mbedtls_sha256_init(&sha_ctx);
-    mbedtls_sha256_starts(&sha_ctx, 0);
-    unsigned char sha_bin[32] = {0};
-    char sha_hex[65] = {0};
+    ota_progress_start("upload", (uint32_t)req->content_len);
 
     int remaining = req->content_len;
     int total_written = 0;
-    unsigned char chunk[1024];
+    const char *error = NULL;
     while (remaining > 0) {
-        int to_read = remaining > (int)sizeof(chunk) ? (int)sizeof(chunk) : remaining;
-        int r = httpd_req_recv(req, (char *)chunk, to_read);
-        if (r <= 0) {
-            mbedtls_sha256_free(&sha_ctx);
-            esp_ota_end(ota_handle);
-            return httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "firmware upload read failed");
+        int index = 0;
+        uint8_t *buf = ota_pipeline_acquire(&pipe, &index);
+        if (!buf) {
+            error = "esp_ota_write failed";
+            break;
         }
-        if (esp_ota_write(ota_handle, chunk, r) != ESP_OK) {
-            mbedtls_sha256_free(&sha_ctx);
-            esp_ota_end(ota_handle);
-            return httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "esp_ota_write failed");
+        int to_read = remaining > OTA_PIPE_BUF_SIZE ? OTA_PIPE_BUF_SIZE : remaining;
+        int r = httpd_req_recv(req, (char *)buf, to_read);
+        ota_pipeline_submit(&pipe, index, r);
+        if (r == HTTPD_SOCK_ERR_TIMEOUT) continue;
+        if (r <= 0) {
+            error = "firmware upload read failed";
+            break;
         }
-        mbedtls_sha256_update(&sha_ctx, chunk, r);
         total_written += r;
         remaining -= r;
+        ota_progress_update((uint32_t)total_written);
     }
 
-    mbedtls_sha256_finish(&sha_ctx, sha_bin);
-    mbedtls_sha256_free(&sha_ctx);
-    hex_encode(sha_bin, sizeof(sha_bin), sha_hex, sizeof(sha_hex));
-
-    if (esp_ota_end(ota_handle) != ESP_OK) {
-        return httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "esp_ota_end failed");
+    char sha_hex[65] = {0};
+    if (!ota_pipeline_drain(&pipe, sha_hex, sizeof(sha_hex)) && !error) error = "esp_ota_write failed";
+    if (error) {
+        ota_pipeline_abort(&pipe);
+        ota_progress_finish(false, error);
+        return http_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, error);
     }
-    if (esp_ota_set_boot_partition(update_partition) != ESP_OK) {
-        return httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "esp_ota_set_boot_partition failed");
+    if (!ota_pipeline_commit(&pipe)) {
+        ota_progress_finish(false, "partition finalize failed");
+        return http_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "ota finalize failed");
     }
-
-    cJSON *resp = cJSON_CreateObject();
-    cJSON_AddBoolToObject(resp, "ok", true);
-    cJSON_AddBoolToObject(resp, "rebooting", true);
-    cJSON_AddStringToObject(resp, "mode", "local_upload");
-    cJSON_AddNumberToObject(resp, "bytes", total_written);
-    cJSON_AddStringToObject(resp, "sha256", sha_hex);
-    esp_err_t err = send_json(req, resp);
-    cJSON_Delete(resp);
+    ota_progress_finish(true, NULL);
+    ota_record_installed(sha_hex);
+
+    char out_buf[192];
+    json_writer_t jw;
+    jw_init(&jw, req, out_buf, sizeof(out_buf));
+    jw_begin_object(&jw, NULL);
+    jw_bool(&jw, "ok", true);
+    jw_bool(&jw, "rebooting", true);
+    jw_str(&jw, "mode", "local_upload");
+    jw_int(&jw, "bytes", total_written);
+    jw_str(&jw, "sha256", sha_hex);
+    jw_int(&jw, "ms", (long)ota_progress_elapsed_ms());
+    jw_int(&jw, "kbps", (long)ota_progress_kbps());
+    jw_end_object(&jw);
+    esp_err_t err = jw_send(&jw);
     if (err == ESP_OK) {
         schedule_restart_ms(900);
     }
     return err;
 }
 
-static esp_err_t reboot_handler(httpd_req_t *req) {
-    char body[256] = {0};
-    int len = httpd_req_recv(req, body, sizeof(body) - 1);
-    if (len <= 0) return httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "bad payload");
-    cJSON *root = cJSON_Parse(body);
-    if (!root) return httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "json parse failed");
-    if (!check_passcode(root)) {
+static esp_err_t ota_status_handler(httpd_req_t *req, http_auth_t auth) {
+    char out_buf[256];
+    json_writer_t jw;
+    jw_init(&jw, req, out_buf, sizeof(out_buf));
+    jw_begin_object(&jw, NULL);
+    write_ota_progress_members(&jw);
+    jw_end_object(&jw);
+    return jw_send(&jw);
+}
+
+static esp_err_t reboot_handler(httpd_req_t *req, http_auth_t auth) {
+    esp_err_t err = ESP_OK;
+    cJSON *root = http_body_parse_json(req, &err);
+    if (!root) return err;
+    if (!check_request_auth(auth, root)) {
         cJSON_Delete(root);
-        return httpd_resp_send_err(req, HTTPD_401_UNAUTHORIZED, "invalid passcode");
+        return http_send_err(req, HTTPD_401_UNAUTHORIZED, "invalid passcode");
     }
     cJSON_Delete(root);
-    cJSON *resp = cJSON_CreateObject();
-    cJSON_AddBoolToObject(resp, "ok", true);
-    cJSON_AddBoolToObject(resp, "rebooting", true);
-    esp_err_t err = send_json(req, resp);
-    cJSON_Delete(resp);
+    char out_buf[64];
+    json_writer_t jw;
+    jw_init(&jw, req, out_buf, sizeof(out_buf));
+    jw_begin_object(&jw, NULL);
+    jw_bool(&jw, "ok", true);
+    jw_bool(&jw, "rebooting", true);
+    jw_end_object(&jw);
+    err = jw_send(&jw);
     if (err == ESP_OK) {
         schedule_restart_ms(600);
     }
     return err;
 }
 
+#if CONFIG_EIGHTBB_UDP_CONTROL
+/* Compact UDP control protocol. All multi-byte fields are little-endian; the MAC is the
+ * first 16 bytes of HMAC-SHA256(passcode, every preceding byte of the datagram). Commands carry the
+ * device's per-boot nonce, so datagrams captured before a reboot never verify after it. */
+#define UDP_CTL_MAGIC0 '8'
+#define UDP_CTL_MAGIC1 'B'
+#define UDP_CTL_VERSION 2
+#define UDP_CTL_TYPE_COMMAND 1
+#define UDP_CTL_TYPE_ACK 2
+#define UDP_CTL_DEVICE_ID_LEN 24
+#define UDP_CTL_MAC_LEN 16
+
+enum {
+    UDP_ACK_OK = 0,
+    /* 1 was "bad MAC"; unauthenticated datagrams now get no answer at all. */
+    UDP_ACK_REPLAY = 2,
+    UDP_ACK_BAD_CHANNEL = 3,
+    UDP_ACK_STALE_NONCE = 4, /* authentic but for another boot; resend with the ack's nonce */
+};
+
+typedef struct __attribute__((packed)) {
+    uint8_t magic[2];
+    uint8_t version;
+    uint8_t type;
+    uint8_t channel;
+    uint8_t action;
+    uint16_t transition_ms; /* little-endian; 0 switches instantly */
+    uint8_t value[RGB_CHANNELS]; /* value[0] for dimmer/fan, r/g/b/w for rgb (0xff keeps current) */
+    uint32_t seq;
+    uint32_t nonce;
+    char device_id[UDP_CTL_DEVICE_ID_LEN];
+    uint8_t mac[UDP_CTL_MAC_LEN];
+} udp_ctl_command_t;
+
+typedef struct __attribute__((packed)) {
+    uint8_t magic[2];
+    uint8_t version;
+    uint8_t type;
+    uint8_t status;
+    uint8_t channel;
+    uint8_t reserved[2];
+    uint32_t seq;
+    uint32_t nonce;
+    uint8_t relay_mask;
+    uint8_t light;
+    uint8_t dimmer;
+    uint8_t fan_power;
+    uint8_t rgb[RGB_CHANNELS];
+    uint8_t fan_speed;
+    uint8_t reserved2[3];
+    uint8_t mac[UDP_CTL_MAC_LEN];
+} udp_ctl_ack_t;
+
+static uint32_t g_udp_nonce = 0; /* drawn at task start, never 0 so hosts can use 0 for unknown */
+static uint32_t g_udp_last_seq = 0;
+static bool g_udp_seq_seen = false;
+
+static void udp_ctl_mac(const auth_cache_t *auth, const void *data, size_t len, uint8_t out[UDP_CTL_MAC_LEN]) {
+    uint8_t full[32];
+    hal_hmac_sha256((const uint8_t *)auth->passcode, strlen(auth->passcode), (const uint8_t *)data, len, full);
+    memcpy(out, full, UDP_CTL_MAC_LEN);
+}
+
+/* Within one boot sequence numbers must increase (mod 2^32) so captured datagrams cannot be
+ * replayed. The first one after boot is taken as is: older captures fail on the nonce instead. */
+static bool udp_ctl_seq_fresh(uint32_t seq) {
+    return !g_udp_seq_seen || (int32_t)(seq - g_udp_last_seq) > 0;
+}
+
+static uint8_t udp_ctl_execute(const udp_ctl_command_t *cmd) {
+    control_op_t op = {
+        .channel = (control_channel_t)cmd->channel,
+        .action = (control_action_t)cmd->action,
+        .value = cmd->value[0],
+        .transition_ms = clamp_int(cmd->transition_ms, 0, MAX_TRANSITION_MS),
+    };
+    if (op.action > CTRL_ACT_KEEP) return UDP_ACK_BAD_CHANNEL;
+    for (int i = 0; i < RGB_CHANNELS; i++) op.rgb[i] = cmd->value[i] == 0xff ? -1 : cmd->value[i];
+    return apply_control_op(&op) ? UDP_ACK_OK : UDP_ACK_BAD_CHANNEL;
+}
+
+/* Output state rides only on acks for authenticated, fresh commands; a replayed datagram learns
+ * nothing beyond the current nonce, which is not secret. */
+static void udp_ctl_fill_ack(const auth_cache_t *auth, udp_ctl_ack_t *ack, const udp_ctl_command_t *cmd, uint8_t status) {
+    memset(ack, 0, sizeof(*ack));
+    ack->magic[0] = UDP_CTL_MAGIC0;
+    ack->magic[1] = UDP_CTL_MAGIC1;
+    ack->version = UDP_CTL_VERSION;
+    ack->type = UDP_CTL_TYPE_ACK;
+    ack->status = status;
+    ack->channel = cmd->channel;
+    ack->seq = cmd->seq;
+    ack->nonce = g_udp_nonce;
+    if (status == UDP_ACK_REPLAY || status == UDP_ACK_STALE_NONCE) {
+        udp_ctl_mac(auth, ack, offsetof(udp_ctl_ack_t, mac), ack->mac);
+        return;
+    }
+    output_state_t st;
+    outputs_snapshot(&st);
+    for (int i = 0; i < MAX_RELAYS; i++) {
+        if (st.relay[i]) ack->relay_mask |= (uint8_t)(1u << i);
+    }
+    ack->light = st.light_single ? 1 : 0;
+    ack->dimmer = (uint8_t)st.dimmer_pct;
+    ack->fan_power = st.fan_power ? 1 : 0;
+    for (int i = 0; i < RGB_CHANNELS; i++) ack->rgb[i] = (uint8_t)st.rgb[i];
+    ack->fan_speed = (uint8_t)st.fan_speed_pct;
+    udp_ctl_mac(auth, ack, offsetof(udp_ctl_ack_t, mac), ack->mac);
+}
+
+static void udp_control_task(void *arg) {
+    (void)arg;
+    int sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_IP);
+    if (sock < 0) {
+        ESP_LOGE(TAG, "UDP control socket failed errno=%d", errno);
+        vTaskDelete(NULL);
+        return;
+    }
+    struct sockaddr_in bind_addr = {
+        .sin_family = AF_INET,
+        .sin_port = htons(CONFIG_EIGHTBB_UDP_CONTROL_PORT),
+        .sin_addr.s_addr = htonl(INADDR_ANY),
+    };
+    if (bind(sock, (struct sockaddr *)&bind_addr, sizeof(bind_addr)) != 0) {
+        ESP_LOGE(TAG, "UDP control bind port=%d failed errno=%d", CONFIG_EIGHTBB_UDP_CONTROL_PORT, errno);
+        close(sock);
+        vTaskDelete(NULL);
+        return;
+    }
+    do {
+        g_udp_nonce = esp_random();
+    } while (g_udp_nonce == 0);
+    ESP_LOGI(TAG, "UDP control listening port=%d", CONFIG_EIGHTBB_UDP_CONTROL_PORT);
+
+    udp_ctl_command_t cmd;
+    udp_ctl_ack_t ack;
+    auth_cache_t auth;
+    while (1) {
+        struct sockaddr_in from = {0};
+        socklen_t from_len = sizeof(from);
+        int len = recvfrom(sock, &cmd, sizeof(cmd), 0, (struct sockaddr *)&from, &from_len);
+        if (len != (int)sizeof(cmd)) continue;
+        if (cmd.magic[0] != UDP_CTL_MAGIC0 || cmd.magic[1] != UDP_CTL_MAGIC1 ||
+            cmd.version != UDP_CTL_VERSION || cmd.type != UDP_CTL_TYPE_COMMAND) {
+            continue;
+        }
+        auth_snapshot(&auth);
+        /* Datagrams for other devices are dropped silently so broadcasts do not fan out acks. */
+        if (strncmp(cmd.device_id, auth.device_id, UDP_CTL_DEVICE_ID_LEN) != 0) continue;
+
+        uint8_t expected[UDP_CTL_MAC_LEN];
+        udp_ctl_mac(&auth, &cmd, offsetof(udp_ctl_command_t, mac), expected);
+        /* No ack without the passcode: the device id is public (discovery, mDNS), so answering would
+         * leak state and make the port a reflector. */
+        if (!constant_time_equal(expected, cmd.mac, sizeof(expected))) continue;
+        uint8_t status;
+        if (cmd.nonce != g_udp_nonce) {
+            status = UDP_ACK_STALE_NONCE;
+        } else if (!udp_ctl_seq_fresh(cmd.seq)) {
+            status = UDP_ACK_REPLAY;
+        } else {
+            g_udp_last_seq = cmd.seq;
+            g_udp_seq_seen = true;
+            power_wake_note();
+            status = udp_ctl_execute(&cmd);
+        }
+        udp_ctl_fill_ack(&auth, &ack, &cmd, status);
+        sendto(sock, &ack, sizeof(ack), 0, (struct sockaddr *)&from, from_len);
+    }
+}
+
+static void start_udp_control(void) {
+    xTaskCreatePinnedToCore(udp_control_task, "udp_ctl", 4096, NULL, 6, NULL, NET_CORE);
+}
+#endif
+
+#if CONFIG_EIGHTBB_MQTT
+/* Optional MQTT client (on when mqtt_uri is set). Topics live under <mqtt_prefix>/<device_id>:
+ * status (birth/LWT, retained), info (retained), state/<channel> (retained, QoS 1), set and set/<channel>.
+ * Output changes only mark channels dirty; the mqtt_pub task publishes them, so control paths never
+ * wait on the broker and bursts collapse into the latest value. */
+#define MQTT_TOPIC_MAX 160
+#define MQTT_PAYLOAD_MAX 96
+#define MQTT_CMD_MAX 1024
+#define MQTT_PUB_STACK 4096
+#define MQTT_RECONNECT_MS 5000
+#define MQTT_KEEPALIVE_S 30
+
+static esp_mqtt_client_handle_t g_mqtt = NULL;
+static SemaphoreHandle_t g_mqtt_client_lock = NULL; /* held while publishing and while tearing the client down */
+static TaskHandle_t g_mqtt_pub_task = NULL;
+static uint32_t g_mqtt_dirty = 0; /* bit per control_channel_t */
+static portMUX_TYPE g_mqtt_lock = portMUX_INITIALIZER_UNLOCKED;
+static char g_mqtt_base[MQTT_TOPIC_MAX];
+static char g_mqtt_lwt_topic[MQTT_TOPIC_MAX];
+/* Copies of the config the running client was built from, so an unrelated save does not reconnect. */
+static char g_mqtt_uri[MAX_STR];
+static char g_mqtt_user[MAX_STR];
+static char g_mqtt_pass[MAX_STR];
+static char g_mqtt_client_id[MAX_STR];
+
+static void mqtt_mark_dirty(uint32_t mask) {
+    if (!g_mqtt || mask == 0) return;
+    portENTER_CRITICAL(&g_mqtt_lock);
+    g_mqtt_dirty |= mask;
+    portEXIT_CRITICAL(&g_mqtt_lock);
+    if (g_mqtt_pub_task) xTaskNotifyGive(g_mqtt_pub_task);
+}
+
+/* Called from publish_output_delta for every g_state change. */
+static void mqtt_note_output_delta(const output_state_t *prev, const output_state_t *cur) {
+    uint32_t mask = 0;
+    for (int i = 0; i < MAX_RELAYS; i++) {
+        if (prev->relay[i] != cur->relay[i]) mask |= 1u << (CTRL_CH_RELAY1 + i);
+    }
+    if (prev->light_single != cur->light_single) mask |= 1u << CTRL_CH_LIGHT;
+    if (prev->dimmer_pct != cur->dimmer_pct) mask |= 1u << CTRL_CH_DIMMER;
+    if (memcmp(prev->rgb, cur->rgb, sizeof(cur->rgb)) != 0) mask |= 1u << CTRL_CH_RGB;
+    if (prev->fan_power != cur->fan_power || prev->fan_speed_pct != cur->fan_speed_pct) mask |= 1u << CTRL_CH_FAN;
+    mqtt_mark_dirty(mask);
+}
+
+/* rgbw and the fan sub-channels report through the rgb and fan topics. */
+static int mqtt_state_payload(control_channel_t id, const output_state_t *st, char *out, size_t len) {
+    if (id >= CTRL_CH_RELAY1 && id <= CTRL_CH_RELAY8) return snprintf(out, len, "%s", st->relay[id - CTRL_CH_RELAY1] ? "on" : "off");
+    switch (id) {
+    case CTRL_CH_LIGHT:
+        return snprintf(out, len, "%s", st->light_single ? "on" : "off");
+    case CTRL_CH_DIMMER:
+        return snprintf(out, len, "%d", st->dimmer_pct);
+    case CTRL_CH_RGB:
+        return snprintf(out, len, "{\"r\":%d,\"g\":%d,\"b\":%d,\"w\":%d}", st->rgb[0], st->rgb[1], st->rgb[2], st->rgb[3]);
+    case CTRL_CH_FAN:
+        return snprintf(out, len, "{\"power\":%s,\"speed\":%d}", st->fan_power ? "true" : "false", st->fan_speed_pct);
+    default:
+        return -1;
+    }
+}
+
+static void mqtt_publish_info(void) {
+    char topic[MQTT_TOPIC_MAX];
+    char payload[MAX_STR * 3];
+    snprintf(topic, sizeof(topic), "%s/info", g_mqtt_base);
+    json_writer_t jw;
+    jw_init(&jw, NULL, payload, sizeof(payload));
+    jw_begin_object(&jw, NULL);
+    jw_str(&jw, "name", g_cfg.name);
+    jw_str(&jw, "type", g_cfg.type);
+    jw_str(&jw, "fw_version", FW_BUILD_VERSION);
+    jw_end_object(&jw);
+    const char *body = jw_cstr(&jw);
+    if (body) esp_mqtt_client_publish(g_mqtt, topic, body, (int)jw.len, 1, 1);
+}
+
+static void mqtt_pub_task(void *arg) {
+    (void)arg;
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        xSemaphoreTake(g_mqtt_client_lock, portMAX_DELAY);
+        if (!g_mqtt || !g_mqtt_connected) {
+            xSemaphoreGive(g_mqtt_client_lock);
+            continue;
+        }
+        portENTER_CRITICAL(&g_mqtt_lock);
+        uint32_t dirty = g_mqtt_dirty;
+        g_mqtt_dirty = 0;
+        portEXIT_CRITICAL(&g_mqtt_lock);
+
+        output_state_t st;
+        outputs_snapshot(&st);
+        for (int id = CTRL_CH_RELAY1; id < CTRL_CH_COUNT; id++) {
+            if (!(dirty & (1u << id)) || !channel_desc((control_channel_t)id)) continue;
+            char topic[MQTT_TOPIC_MAX];
+            char payload[MQTT_PAYLOAD_MAX];
+            int n = mqtt_state_payload((control_channel_t)id, &st, payload, sizeof(payload));
+            if (n < 0) continue;
+            snprintf(topic, sizeof(topic), "%s/state/%s", g_mqtt_base, g_channels[id].name);
+            /* A failed publish is not retried here; the full refresh on the next connect covers it. */
+            if (esp_mqtt_client_publish(g_mqtt, topic, payload, n, 1, 1) < 0) ESP_LOGW(TAG, "MQTT publish %s failed", topic);
+        }
+        xSemaphoreGive(g_mqtt_client_lock);
+    }
+}
+
+/* Plain per-channel commands: on, off, toggle or a number (set). */
+static bool mqtt_channel_command(const char *channel, const char *payload) {
+    control_op_t op = {.rgb = {-1, -1, -1, -1}};
+    op.channel = parse_control_channel(channel);
+    char *end = NULL;
+    long value = strtol(payload, &end, 10);
+    if (end != payload && *end == '\0') {
+        op.action = CTRL_ACT_SET;
+        op.value = (int)value;
+    } else {
+        op.action = parse_control_action(payload);
+        if (op.action == CTRL_ACT_KEEP) return false;
+    }
+    return op.channel != CTRL_CH_NONE && apply_control_op(&op);
+}
+
+/* JSON commands on <base>/set take the /api/control body (single op or "ops" batch) minus the
+ * passcode: broker credentials and ACLs are the trust boundary for MQTT. */
+static bool mqtt_json_command(const char *payload) {
+    cJSON *root = cJSON_Parse(payload);
+    if (!root) return false;
+    bool ok = false;
+    cJSON *ops_json = cJSON_GetObjectItem(root, "ops");
+    cJSON *apply_at = cJSON_GetObjectItem(root, "apply_at");
+    control_op_t ops[MAX_BATCH_OPS];
+    int count = 1;
+    if (cJSON_IsArray(ops_json)) {
+        count = cJSON_GetArraySize(ops_json);
+        ok = count > 0 && count <= MAX_BATCH_OPS;
+        for (int i = 0; ok && i < count; i++) ok = control_op_from_json(cJSON_GetArrayItem(ops_json, i), &ops[i]);
+    } else {
+        ok = control_op_from_json(root, &ops[0]);
+    }
+    if (ok && cJSON_IsNumber(apply_at)) {
+        int64_t in_ms = 0;
+        int bad = -1;
+        ok = apply_at_schedule(ops, count, apply_at->valuedouble, &in_ms, &bad) == APPLY_AT_OK;
+    } else if (ok) {
+        ok = apply_control_batch(ops, count) < 0;
+    }
+    cJSON_Delete(root);
+    return ok;
+}
+
+static void mqtt_handle_data(const esp_mqtt_event_t *ev) {
+    /* Commands are small; anything split across several events is not a command. */
+    if (ev->current_data_offset != 0 || ev->data_len != ev->total_data_len || ev->data_len >= MQTT_CMD_MAX) return;
+    size_t base_len = strlen(g_mqtt_base);
+    if (ev->topic_len < (int)base_len + 4 || strncmp(ev->topic, g_mqtt_base, base_len) != 0) return;
+    char topic[MQTT_TOPIC_MAX];
+    int topic_len = ev->topic_len < (int)sizeof(topic) - 1 ? ev->topic_len : (int)sizeof(topic) - 1;
+    memcpy(topic, ev->topic, topic_len);
+    topic[topic_len] = '\0';
+    char *payload = malloc(ev->data_len + 1);
+    if (!payload) return;
+    memcpy(payload, ev->data, ev->data_len);
+    payload[ev->data_len] = '\0';
+
+    const char *suffix = topic + base_len;
+    bool ok = false;
+    power_wake_note();
+    if (strcmp(suffix, "/set") == 0) {
+        ok = mqtt_json_command(payload);
+    } else if (strncmp(suffix, "/set/", 5) == 0) {
+        ok = mqtt_channel_command(suffix + 5, payload);
+    } else {
+        free(payload);
+        return;
+    }
+    if (!ok) ESP_LOGW(TAG, "MQTT command on %s rejected", topic);
+    free(payload);
+}
+
+static void mqtt_event_handler(void *arg, esp_event_base_t base, int32_t event_id, void *event_data) {
+    (void)arg;
+    (void)base;
+    esp_mqtt_event_handle_t ev = (esp_mqtt_event_handle_t)event_data;
+    switch ((esp_mqtt_event_id_t)event_id) {
+    case MQTT_EVENT_CONNECTED: {
+        char topic[MQTT_TOPIC_MAX];
+        ESP_LOGI(TAG, "MQTT connected to %s", g_mqtt_uri);
+        g_mqtt_connected = true;
+        g_net_generation++;
+        esp_mqtt_client_publish(g_mqtt, g_mqtt_lwt_topic, "online", 6, 1, 1);
+        mqtt_publish_info();
+        snprintf(topic, sizeof(topic), "%s/set", g_mqtt_base);
+        esp_mqtt_client_subscribe(g_mqtt, topic, 1);
+        snprintf(topic, sizeof(topic), "%s/set/+", g_mqtt_base);
+        esp_mqtt_client_subscribe(g_mqtt, topic, 1);
+        /* Refresh every retained state topic; the broker may have lost them or missed changes. */
+        mqtt_mark_dirty(UINT32_MAX);
+        break;
+    }
+    case MQTT_EVENT_DISCONNECTED:
+        if (g_mqtt_connected) ESP_LOGW(TAG, "MQTT disconnected");
+        g_mqtt_connected = false;
+        g_net_generation++;
+        break;
+    case MQTT_EVENT_DATA:
+        mqtt_handle_data(ev);
+        break;
+    default:
+        break;
+    }
+}
+
+static void mqtt_stop(void) {
+    if (!g_mqtt) return;
+    xSemaphoreTake(g_mqtt_client_lock, portMAX_DELAY);
+    esp_mqtt_client_handle_t client = g_mqtt;
+    if (g_mqtt_connected) esp_mqtt_client_publish(client, g_mqtt_lwt_topic, "offline", 7, 1, 1);
+    g_mqtt = NULL;
+    g_mqtt_connected = false;
+    xSemaphoreGive(g_mqtt_client_lock);
+    esp_mqtt_client_stop(client);
+    esp_mqtt_client_destroy(client);
+}
+
+/* Builds the client from config; safe to call again after every config save. */
+static void mqtt_reconfigure(void) {
+    char base[MQTT_TOPIC_MAX];
+    snprintf(base, sizeof(base), "%s/%s", g_cfg.mqtt_prefix[0] ? g_cfg.mqtt_prefix : "8bb", g_cfg.device_id);
+    bool same = g_mqtt && strcmp(g_mqtt_uri, g_cfg.mqtt_uri) == 0 && strcmp(g_mqtt_user, g_cfg.mqtt_user) == 0 &&
+                strcmp(g_mqtt_pass, g_cfg.mqtt_pass) == 0 && strcmp(g_mqtt_base, base) == 0;
+    if (same) {
+        if (g_mqtt_connected) mqtt_publish_info();
+        return;
+    }
+    mqtt_stop();
+    if (g_cfg.mqtt_uri[0] == '\0') return;
+
+    safe_strcpy(g_mqtt_uri, g_cfg.mqtt_uri, sizeof(g_mqtt_uri));
+    safe_strcpy(g_mqtt_user, g_cfg.mqtt_user, sizeof(g_mqtt_user));
+    safe_strcpy(g_mqtt_pass, g_cfg.mqtt_pass, sizeof(g_mqtt_pass));
+    safe_strcpy(g_mqtt_base, base, sizeof(g_mqtt_base));
+    snprintf(g_mqtt_lwt_topic, sizeof(g_mqtt_lwt_topic), "%s/status", g_mqtt_base);
+    snprintf(g_mqtt_client_id, sizeof(g_mqtt_client_id), "8bb-%s", g_cfg.device_id);
+
+    esp_mqtt_client_config_t cfg = {
+        .broker.address.uri = g_mqtt_uri,
+        .credentials.client_id = g_mqtt_client_id,
+        .credentials.username = g_mqtt_user[0] ? g_mqtt_user : NULL,
+        .credentials.authentication.password = g_mqtt_pass[0] ? g_mqtt_pass : NULL,
+        .session.last_will = {.topic = g_mqtt_lwt_topic, .msg = "offline", .msg_len = 7, .qos = 1, .retain = 1},
+        .session.keepalive = MQTT_KEEPALIVE_S,
+        .network.reconnect_timeout_ms = MQTT_RECONNECT_MS,
+    };
+    esp_mqtt_client_handle_t client = esp_mqtt_client_init(&cfg);
+    if (!client) {
+        ESP_LOGE(TAG, "MQTT client init failed");
+        return;
+    }
+    esp_mqtt_client_register_event(client, MQTT_EVENT_ANY, mqtt_event_handler, NULL);
+    g_mqtt = client;
+    if (esp_mqtt_client_start(client) != ESP_OK) {
+        ESP_LOGE(TAG, "MQTT client start failed");
+        g_mqtt = NULL;
+        esp_mqtt_client_destroy(client);
+    }
+}
+
+/* Wi-Fi got an IP back: reconnect now instead of waiting out the client's retry timer. */
+static void mqtt_on_network_up(void) {
+    if (g_mqtt && !g_mqtt_connected) esp_mqtt_client_reconnect(g_mqtt);
+}
+
+static void start_mqtt(void) {
+    g_mqtt_client_lock = xSemaphoreCreateMutex();
+    if (!g_mqtt_client_lock ||
+        xTaskCreatePinnedToCore(mqtt_pub_task, "mqtt_pub", MQTT_PUB_STACK, NULL, 4, &g_mqtt_pub_task, NET_CORE) != pdPASS) {
+        ESP_LOGE(TAG, "MQTT publisher start failed; MQTT disabled");
+        return;
+    }
+    mqtt_reconfigure();
+}
+#endif
+
+#if CONFIG_EIGHTBB_MDNS
+/* mDNS advertisement: <hostname>.local plus an _8bb._tcp service on port 80 whose TXT record
+ * carries device_id, type and fw_version, so hosts can list devices without probing the subnet. */
+#define MDNS_SERVICE_TYPE "_8bb"
+#define MDNS_SERVICE_PROTO "_tcp"
+
+static bool g_mdns_running = false;
+
+/* mDNS labels only allow [a-z0-9-]; everything else in the device name becomes '-'. */
+static void mdns_hostname_from_name(char *out, size_t out_len, const char *name) {
+    size_t n = 0;
+    for (const char *p = name; *p && n + 1 < out_len && n < 63; p++) {
+        char c = *p;
+        if (c >= 'A' && c <= 'Z') c = (char)(c - 'A' + 'a');
+        bool ok = (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9');
+        if (!ok) {
+            if (n == 0 || out[n - 1] == '-') continue;
+            c = '-';
+        }
+        out[n++] = c;
+    }
+    while (n > 0 && out[n - 1] == '-') n--;
+    out[n] = '\0';
+    if (n == 0) safe_strcpy(out, "8bb-device", out_len);
+}
+
+static void mdns_apply_identity(void) {
+    char host[64];
+    mdns_hostname_from_name(host, sizeof(host), g_cfg.name);
+    mdns_hostname_set(host);
+    mdns_instance_name_set(g_cfg.name);
+}
+
+/* Config save: hostname, instance name and TXT follow the new name/type/device_id. */
+static void mdns_reconfigure(void) {
+    if (!g_mdns_running) return;
+    mdns_apply_identity();
+    mdns_service_txt_item_set(MDNS_SERVICE_TYPE, MDNS_SERVICE_PROTO, "device_id", g_cfg.device_id);
+    mdns_service_txt_item_set(MDNS_SERVICE_TYPE, MDNS_SERVICE_PROTO, "type", g_cfg.type);
+}
+
+static void start_mdns(void) {
+    if (mdns_init() != ESP_OK) {
+        ESP_LOGE(TAG, "mDNS init failed; advertisement disabled");
+        return;
+    }
+    mdns_apply_identity();
+    mdns_txt_item_t txt[] = {
+        {"device_id", g_cfg.device_id},
+        {"type", g_cfg.type},
+        {"fw_version", FW_BUILD_VERSION},
+    };
+    if (mdns_service_add(NULL, MDNS_SERVICE_TYPE, MDNS_SERVICE_PROTO, 80, txt, sizeof(txt) / sizeof(txt[0])) != ESP_OK) {
+        ESP_LOGE(TAG, "mDNS service add failed");
+        mdns_free();
+        return;
+    }
+    g_mdns_running = true;
+}
+#endif
+
+#if CONFIG_EIGHTBB_DISCOVERY
+/* UDP discovery responder. A datagram starting with "8BB?" (usually a broadcast) is answered
+ * unicast with a one-line JSON identity, so a scan costs one broadcast instead of a subnet sweep. */
+#define DISCOVERY_MAGIC "8BB?"
+#define DISCOVERY_MAGIC_LEN 4
+#define DISCOVERY_REPLY_MAX 384
+/* Replies are spread over this window so a fleet answering one broadcast does not overrun the
+ * host's receive buffer or collide on the air. */
+#define DISCOVERY_JITTER_MS 100
+
+static const char *discovery_build_reply(json_writer_t *jw, char *buf, size_t buf_len) {
+    uint8_t mac[6] = {0};
+    esp_wifi_get_mac(WIFI_IF_STA, mac);
+    char mac_str[18];
+    snprintf(mac_str, sizeof(mac_str), MACSTR, MAC2STR(mac));
+    char ip[16] = "";
+    esp_netif_ip_info_t info = {0};
+    if (g_sta_netif && esp_netif_get_ip_info(g_sta_netif, &info) == ESP_OK) {
+        snprintf(ip, sizeof(ip), IPSTR, IP2STR(&info.ip));
+    }
+
+    jw_init(jw, NULL, buf, buf_len);
+    jw_begin_object(jw, NULL);
+    jw_str(jw, "device_id", g_cfg.device_id);
+    jw_str(jw, "name", g_cfg.name);
+    jw_str(jw, "type", g_cfg.type);
+    jw_str(jw, "fw_version", FW_BUILD_VERSION);
+    jw_str(jw, "mac", mac_str);
+    jw_str(jw, "ip", ip);
+    jw_int(jw, "port", 80);
+#if CONFIG_EIGHTBB_UDP_CONTROL
+    jw_int(jw, "udp_port", CONFIG_EIGHTBB_UDP_CONTROL_PORT);
+#endif
+    jw_end_object(jw);
+    return jw_cstr(jw);
+}
+
+static void discovery_task(void *arg) {
+    (void)arg;
+    int sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_IP);
+    if (sock < 0) {
+        ESP_LOGE(TAG, "Discovery socket failed errno=%d", errno);
+        vTaskDelete(NULL);
+        return;
+    }
+    struct sockaddr_in bind_addr = {
+        .sin_family = AF_INET,
+        .sin_port = htons(CONFIG_EIGHTBB_DISCOVERY_PORT),
+        .sin_addr.s_addr = htonl(INADDR_ANY),
+    };
+    if (bind(sock, (struct sockaddr *)&bind_addr, sizeof(bind_addr)) != 0) {
+        ESP_LOGE(TAG, "Discovery bind port=%d failed errno=%d", CONFIG_EIGHTBB_DISCOVERY_PORT, errno);
+        close(sock);
+        vTaskDelete(NULL);
+        return;
+    }
+    ESP_LOGI(TAG, "Discovery responder listening port=%d", CONFIG_EIGHTBB_DISCOVERY_PORT);
+
+    char req[32];
+    char reply[DISCOVERY_REPLY_MAX];
+    while (1) {
+        struct sockaddr_in from = {0};
+        socklen_t from_len = sizeof(from);
+        int len = recvfrom(sock, req, sizeof(req), 0, (struct sockaddr *)&from, &from_len);
+        if (len < DISCOVERY_MAGIC_LEN || memcmp(req, DISCOVERY_MAGIC, DISCOVERY_MAGIC_LEN) != 0) continue;
+        vTaskDelay(pdMS_TO_TICKS(esp_random() % DISCOVERY_JITTER_MS));
+        json_writer_t jw;
+        if (discovery_build_reply(&jw, reply, sizeof(reply))) sendto(sock, reply, jw.len, 0, (struct sockaddr *)&from, from_len);
+    }
+}
+
+static void start_discovery(void) {
+    xTaskCreatePinnedToCore(discovery_task, "discovery", 3072, NULL, 3, NULL, NET_CORE);
+}
+#endif
+
+/* Wi-Fi runs as an event-driven state machine in its own task, so app_main never blocks on
+ * association and the HTTP server is reachable (over the fallback AP or once DHCP lands) early. */
+typedef enum {
+    WIFI_MGR_EVT_STA_START,
+    WIFI_MGR_EVT_STA_DISCONNECTED,
+    WIFI_MGR_EVT_STA_GOT_IP,
+} wifi_mgr_event_t;
+
+/* Last AP that gave us an IP, so the next association can skip the scan. */
+#define WIFI_FAST_CACHE_VERSION 1
+
+typedef struct __attribute__((packed)) {
+    uint8_t version;
+    uint8_t channel;
+    uint8_t bssid[6];
+    uint32_t cred_hash;
+} wifi_fast_cache_t;
+
+RTC_NOINIT_ATTR static wifi_fast_cache_t g_rtc_wifi_cache;
+RTC_NOINIT_ATTR static uint32_t g_rtc_wifi_cache_check;
+
+static QueueHandle_t g_wifi_mgr_queue = NULL;
+static wifi_fast_cache_t g_wifi_cache;
+static bool g_wifi_cache_valid = false;
+static bool g_wifi_fast_attempt = false;
+
+static uint32_t wifi_cred_hash(void) {
+    uint32_t hash = fnv1a_update(FNV1A_INIT, g_cfg.wifi_ssid, strlen(g_cfg.wifi_ssid));
+    return fnv1a_update(hash, g_cfg.wifi_pass, strlen(g_cfg.wifi_pass));
+}
+
+static uint32_t wifi_cache_checksum(const wifi_fast_cache_t *c) {
+    return fnv1a_update(FNV1A_INIT, c, sizeof(*c));
+}
+
+/* RTC memory first (warm resets), then NVS; either copy only counts for the current credentials. */
+static void load_wifi_fast_cache(void) {
+    uint32_t creds = wifi_cred_hash();
+    if (g_rtc_wifi_cache.version == WIFI_FAST_CACHE_VERSION && g_rtc_wifi_cache_check == wifi_cache_checksum(&g_rtc_wifi_cache) &&
+        g_rtc_wifi_cache.cred_hash == creds) {
+        g_wifi_cache = g_rtc_wifi_cache;
+        g_wifi_cache_valid = true;
+        return;
+    }
+    nvs_handle_t nvs;
+    if (nvs_open("wifi", NVS_READONLY, &nvs) != ESP_OK) return;
+    wifi_fast_cache_t cache;
+    size_t len = sizeof(cache);
+    if (nvs_get_blob(nvs, "fast", &cache, &len) == ESP_OK && len == sizeof(cache) &&
+        cache.version == WIFI_FAST_CACHE_VERSION && cache.cred_hash == creds) {
+        g_wifi_cache = cache;
+        g_wifi_cache_valid = true;
+    }
+    nvs_close(nvs);
+}
+
+/* NVS is only rewritten when the AP or channel actually changed (roams, router swaps). */
+static void store_wifi_fast_cache(void) {
+    wifi_ap_record_t ap = {0};
+    if (esp_wifi_sta_get_ap_info(&ap) != ESP_OK) return;
+    wifi_fast_cache_t cache = {.version = WIFI_FAST_CACHE_VERSION, .channel = ap.primary, .cred_hash = wifi_cred_hash()};
+    memcpy(cache.bssid, ap.bssid, sizeof(cache.bssid));
+    g_rtc_wifi_cache = cache;
+    g_rtc_wifi_cache_check = wifi_cache_checksum(&cache);
+    if (g_wifi_cache_valid && memcmp(&cache, &g_wifi_cache, sizeof(cache)) == 0) return;
+    g_wifi_cache = cache;
+    g_wifi_cache_valid = true;
+
+    nvs_handle_t nvs;
+    if (nvs_open("wifi", NVS_READWRITE, &nvs) != ESP_OK) return;
+    if (nvs_set_blob(nvs, "fast", &cache, sizeof(cache)) == ESP_OK && nvs_commit(nvs) == ESP_OK) g_nvs_stats.wifi_cache_writes++;
+    nvs_close(nvs);
+    ESP_LOGI(TAG, "Wi-Fi fast cache bssid=%02x:%02x:%02x:%02x:%02x:%02x channel=%u", cache.bssid[0], cache.bssid[1],
+             cache.bssid[2], cache.bssid[3], cache.bssid[4], cache.bssid[5], (unsigned)cache.channel);
+}
+
+/* The Wi-Fi fields of g_cfg, copied on the actuation task so a concurrent config commit cannot hand
+ * the driver a half-written SSID or password. They were sanitized when the config was committed. */
+typedef struct {
+    char sta_ssid[MAX_STR];
+    char sta_pass[MAX_STR];
+    char ap_ssid[MAX_STR];
+    char ap_pass[MAX_STR];
+    int power_profile;
+    int power_listen_interval;
+} wifi_cfg_snapshot_t;
+
+static void wifi_cfg_snapshot_job(void *ctx) {
+    wifi_cfg_snapshot_t *out = (wifi_cfg_snapshot_t *)ctx;
+    memcpy(out->sta_ssid, g_cfg.wifi_ssid, sizeof(out->sta_ssid));
+    memcpy(out->sta_pass, g_cfg.wifi_pass, sizeof(out->sta_pass));
+    memcpy(out->ap_ssid, g_cfg.ap_ssid, sizeof(out->ap_ssid));
+    memcpy(out->ap_pass, g_cfg.ap_pass, sizeof(out->ap_pass));
+    out->power_profile = g_cfg.power_profile;
+    out->power_listen_interval = g_cfg.power_listen_interval;
+}
+
+static void wifi_cfg_snapshot(wifi_cfg_snapshot_t *out) {
+    act_call(wifi_cfg_snapshot_job, out);
+}
+
+static void configure_sta(bool fast) {
+    wifi_cfg_snapshot_t wc;
+    wifi_cfg_snapshot(&wc);
+    wifi_config_t sta_cfg = {0};
+    size_t sta_ssid_len = copy_wifi_field(sta_cfg.sta.ssid, sizeof(sta_cfg.sta.ssid), wc.sta_ssid);
+    size_t sta_pass_len = copy_wifi_field(sta_cfg.sta.password, sizeof(sta_cfg.sta.password), wc.sta_pass);
+    g_wifi_fast_attempt = fast && g_wifi_cache_valid;
+    if (g_wifi_fast_attempt) {
+        sta_cfg.sta.bssid_set = true;
+        memcpy(sta_cfg.sta.bssid, g_wifi_cache.bssid, sizeof(sta_cfg.sta.bssid));
+        sta_cfg.sta.channel = g_wifi_cache.channel;
+    }
+    /* Only max modem sleep honours the listen interval; 0 keeps the driver default. */
+    if (wc.power_profile == POWER_PROFILE_LOW_POWER) sta_cfg.sta.listen_interval = (uint16_t)wc.power_listen_interval;
+    ESP_LOGI(TAG, "STA cfg ssid=%s ssid_len=%d pass_len=%d fast=%d channel=%u", (char *)sta_cfg.sta.ssid, (int)sta_ssid_len,
+             (int)sta_pass_len, g_wifi_fast_attempt ? 1 : 0, (unsigned)sta_cfg.sta.channel);
+    esp_wifi_set_config(WIFI_IF_STA, &sta_cfg);
+}
+
 static void wifi_event_handler(void *arg, esp_event_base_t event_base, int32_t event_id, void *event_data) {
     (void)arg;
+    g_net_generation++;
+    wifi_mgr_event_t evt;
     if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_START) {
         ESP_LOGI(TAG, "Wi-Fi STA start ssid=%s", g_cfg.wifi_ssid);
-        esp_wifi_connect();
+        evt = WIFI_MGR_EVT_STA_START;
     } else if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_DISCONNECTED) {
         wifi_event_sta_disconnected_t *disc = (wifi_event_sta_disconnected_t *)event_data;
         g_last_wifi_disc_reason = disc ? disc->reason : -1;
-        ESP_LOGW(TAG, "Wi-Fi disconnected reason=%d retry=%d", disc ? disc->reason : -1, g_sta_fail_count + 1);
-        g_sta_fail_count++;
-        if (g_sta_fail_count < 5) {
-            esp_wifi_connect();
-        } else {
-            xEventGroupSetBits(g_wifi_events, WIFI_FAIL_BIT);
-        }
+        g_wifi_timing.disconnects++;
+        xEventGroupClearBits(g_wifi_events, WIFI_CONNECTED_BIT);
+        evt = WIFI_MGR_EVT_STA_DISCONNECTED;
     } else if (event_base == IP_EVENT && event_id == IP_EVENT_STA_GOT_IP) {
-        ip_event_got_ip_t *evt = (ip_event_got_ip_t *)event_data;
-        if (evt) {
+        ip_event_got_ip_t *got = (ip_event_got_ip_t *)event_data;
+        if (got) {
             ESP_LOGI(TAG, "NET_OK name=%s host=%s.local ip=" IPSTR " gw=" IPSTR " mask=" IPSTR,
-                     g_cfg.name, g_cfg.name, IP2STR(&evt->ip_info.ip), IP2STR(&evt->ip_info.gw), IP2STR(&evt->ip_info.netmask));
+                     g_cfg.name, g_cfg.name, IP2STR(&got->ip_info.ip), IP2STR(&got->ip_info.gw), IP2STR(&got->ip_info.netmask));
         }
-        g_sta_fail_count = 0;
         g_last_wifi_disc_reason = 0;
         xEventGroupSetBits(g_wifi_events, WIFI_CONNECTED_BIT);
+#if CONFIG_EIGHTBB_MQTT
+        mqtt_on_network_up();
+#endif
+        evt = WIFI_MGR_EVT_STA_GOT_IP;
+    } else {
+        return;
     }
+    if (g_wifi_mgr_queue) xQueueSend(g_wifi_mgr_queue, &evt, 0);
 }
 
-static void start_wifi_ap_fallback(void) {
-    ESP_LOGW(TAG, "Starting fallback AP ssid=%s", g_cfg.ap_ssid);
+static void start_wifi_ap_fallback(wifi_mode_t mode) {
+    wifi_cfg_snapshot_t wc;
+    wifi_cfg_snapshot(&wc);
+    ESP_LOGW(TAG, "Starting fallback AP ssid=%s", wc.ap_ssid);
     wifi_config_t ap_cfg = {
         .ap = {
             .ssid_len = 0,
@@ -1625,20 +4746,19 @@ static void start_wifi_ap_fallback(void) {
             .authmode = WIFI_AUTH_WPA2_PSK,
         }
     };
-    sanitize_wifi_field(g_cfg.ap_ssid);
-    sanitize_wifi_field(g_cfg.ap_pass);
-    size_t ssid_len = copy_wifi_field(ap_cfg.ap.ssid, sizeof(ap_cfg.ap.ssid), g_cfg.ap_ssid);
-    size_t pass_len = copy_wifi_field(ap_cfg.ap.password, sizeof(ap_cfg.ap.password), g_cfg.ap_pass);
+    size_t ssid_len = copy_wifi_field(ap_cfg.ap.ssid, sizeof(ap_cfg.ap.ssid), wc.ap_ssid);
+    size_t pass_len = copy_wifi_field(ap_cfg.ap.password, sizeof(ap_cfg.ap.password), wc.ap_pass);
     ap_cfg.ap.ssid_len = ssid_len;
     if (pass_len < 8) ap_cfg.ap.authmode = WIFI_AUTH_OPEN;
     ESP_LOGI(TAG, "AP cfg ssid=%s auth=%s pass_len=%d",
              (char *)ap_cfg.ap.ssid,
              ap_cfg.ap.authmode == WIFI_AUTH_OPEN ? "open" : "wpa2",
              (int)pass_len);
-    esp_wifi_set_mode(WIFI_MODE_AP);
+    esp_wifi_set_mode(mode);
     esp_wifi_set_config(WIFI_IF_AP, &ap_cfg);
     esp_wifi_start();
-    esp_wifi_set_ps(WIFI_PS_NONE);
+    g_net_generation++;
+    power_apply_wifi();
     if (g_ap_netif) {
         esp_netif_ip_info_t ap_ip = {0};
         if (esp_netif_get_ip_info(g_ap_netif, &ap_ip) == ESP_OK) {
@@ -1665,8 +4785,134 @@ static void apply_static_ip_if_needed(void) {
     ESP_LOGI(TAG, "Static IP configured");
 }
 
-static void start_wifi_station_or_ap(void) {
+/* The fallback AP comes up next to the STA (APSTA) so the device stays reachable on the LAN
+ * while reconnect attempts continue in the background. */
+static void wifi_ap_fallback_up(void) {
+    if (g_wifi_ap_active) return;
+    ESP_LOGW(TAG, "Wi-Fi STA unavailable, enabling fallback AP while retrying");
+    start_wifi_ap_fallback(WIFI_MODE_APSTA);
+    g_wifi_ap_active = true;
+    xEventGroupSetBits(g_wifi_events, WIFI_FAIL_BIT);
+}
+
+static void wifi_ap_fallback_down(void) {
+    if (!g_wifi_ap_active) return;
+    ESP_LOGI(TAG, "Wi-Fi STA back, disabling fallback AP");
+    esp_wifi_set_mode(WIFI_MODE_STA);
+    g_wifi_ap_active = false;
+    g_net_generation++;
+    power_apply_wifi();
+    xEventGroupClearBits(g_wifi_events, WIFI_FAIL_BIT);
+}
+
+static int wifi_backoff_ms(int attempt) {
+    int shift = attempt < 1 ? 0 : (attempt > 16 ? 16 : attempt - 1);
+    int64_t delay = (int64_t)WIFI_BACKOFF_BASE_MS << shift;
+    if (delay > WIFI_BACKOFF_MAX_MS) delay = WIFI_BACKOFF_MAX_MS;
+    /* Up to 25% jitter keeps a room full of devices from hammering a rebooting router in lockstep. */
+    return (int)(delay - (int64_t)(esp_random() % (uint32_t)(delay / 4 + 1)));
+}
+
+static void wifi_manager_task(void *arg) {
+    (void)arg;
+    if (strlen(g_cfg.wifi_ssid) == 0) {
+        start_wifi_ap_fallback(WIFI_MODE_AP);
+        g_wifi_ap_active = true;
+        g_wifi_state = WIFI_STATE_AP_ONLY;
+        g_net_generation++;
+        xEventGroupSetBits(g_wifi_events, WIFI_FAIL_BIT);
+        vTaskDelete(NULL);
+        return;
+    }
+
+    load_wifi_fast_cache();
+    esp_wifi_set_mode(WIFI_MODE_STA);
+    configure_sta(true);
+    apply_static_ip_if_needed();
+    g_wifi_state = WIFI_STATE_CONNECTING;
+    g_net_generation++;
+    g_wifi_timing.outage_start_us = esp_timer_get_time();
+    int64_t ap_deadline_us = g_wifi_timing.outage_start_us + (int64_t)WIFI_STA_CONNECT_TIMEOUT_MS * 1000;
+    esp_wifi_start();
+    power_apply_wifi();
+
+    for (;;) {
+        int64_t now_us = esp_timer_get_time();
+        TickType_t wait = portMAX_DELAY;
+        if (g_wifi_state == WIFI_STATE_BACKOFF) {
+            int64_t left_us = g_wifi_timing.next_retry_us - now_us;
+            wait = left_us > 0 ? pdMS_TO_TICKS(left_us / 1000) + 1 : 0;
+        } else if (g_wifi_state == WIFI_STATE_CONNECTING && !g_wifi_ap_active) {
+            int64_t left_us = ap_deadline_us - now_us;
+            wait = left_us > 0 ? pdMS_TO_TICKS(left_us / 1000) + 1 : 0;
+        }
+        wifi_mgr_event_t evt;
+        if (xQueueReceive(g_wifi_mgr_queue, &evt, wait) != pdTRUE) {
+            if (g_wifi_state == WIFI_STATE_BACKOFF) {
+                g_wifi_state = WIFI_STATE_CONNECTING;
+                g_net_generation++;
+                esp_wifi_connect();
+            } else {
+                ESP_LOGW(TAG, "Wi-Fi STA not connected after %d ms", WIFI_STA_CONNECT_TIMEOUT_MS);
+                wifi_ap_fallback_up();
+            }
+            continue;
+        }
+        switch (evt) {
+        case WIFI_MGR_EVT_STA_START:
+            esp_wifi_connect();
+            break;
+        case WIFI_MGR_EVT_STA_GOT_IP:
+            if (g_wifi_state != WIFI_STATE_CONNECTED) {
+                g_wifi_timing.connects++;
+                g_wifi_timing.last_connect_ms = (int32_t)((esp_timer_get_time() - g_wifi_timing.outage_start_us) / 1000);
+                g_wifi_timing.last_fast = g_wifi_fast_attempt;
+                ESP_LOGI(TAG, "Wi-Fi connected in %d ms attempts=%d fast=%d", (int)g_wifi_timing.last_connect_ms,
+                         g_sta_fail_count + 1, g_wifi_fast_attempt ? 1 : 0);
+            }
+            g_wifi_state = WIFI_STATE_CONNECTED;
+            g_sta_fail_count = 0;
+            store_wifi_fast_cache();
+            wifi_ap_fallback_down();
+            break;
+        case WIFI_MGR_EVT_STA_DISCONNECTED: {
+            if (g_wifi_state == WIFI_STATE_CONNECTED) {
+                /* Lost an established link: retry the AP we just had straight away. */
+                ESP_LOGW(TAG, "Wi-Fi link lost reason=%d, reconnecting", g_last_wifi_disc_reason);
+                g_wifi_state = WIFI_STATE_CONNECTING;
+                g_wifi_timing.outage_start_us = esp_timer_get_time();
+                ap_deadline_us = g_wifi_timing.outage_start_us + (int64_t)WIFI_STA_CONNECT_TIMEOUT_MS * 1000;
+                configure_sta(true);
+                esp_wifi_connect();
+                break;
+            }
+            if (g_wifi_state != WIFI_STATE_CONNECTING) break;
+            if (g_wifi_fast_attempt) {
+                /* The cached AP/channel did not answer; drop the hint and scan normally. */
+                ESP_LOGW(TAG, "Wi-Fi fast connect failed reason=%d, falling back to scan", g_last_wifi_disc_reason);
+                configure_sta(false);
+                esp_wifi_connect();
+                break;
+            }
+            g_sta_fail_count++;
+            if (g_sta_fail_count >= WIFI_STA_MAX_RETRIES) wifi_ap_fallback_up();
+            int delay_ms = wifi_backoff_ms(g_sta_fail_count);
+            ESP_LOGW(TAG, "Wi-Fi disconnected reason=%d retry=%d in %d ms", g_last_wifi_disc_reason, g_sta_fail_count, delay_ms);
+            g_wifi_state = WIFI_STATE_BACKOFF;
+            g_wifi_timing.next_retry_us = esp_timer_get_time() + (int64_t)delay_ms * 1000;
+            break;
+        }
+        }
+        /* wifi_event_handler bumped the generation before this task updated state and counters. */
+        g_net_generation++;
+    }
+}
+
+/* Brings up netifs and the Wi-Fi driver without waiting for association; the manager task
+ * owns the STA/AP decision from here on. */
+static void init_network_stack(void) {
     g_wifi_events = xEventGroupCreate();
+    g_wifi_mgr_queue = xQueueCreate(8, sizeof(wifi_mgr_event_t));
     esp_netif_init();
     esp_event_loop_create_default();
     g_sta_netif = esp_netif_create_default_wifi_sta();
@@ -1676,75 +4922,241 @@ static void start_wifi_station_or_ap(void) {
     esp_wifi_init(&cfg);
     esp_event_handler_instance_register(WIFI_EVENT, ESP_EVENT_ANY_ID, &wifi_event_handler, NULL, NULL);
     esp_event_handler_instance_register(IP_EVENT, IP_EVENT_STA_GOT_IP, &wifi_event_handler, NULL, NULL);
+}
 
-    if (strlen(g_cfg.wifi_ssid) == 0) {
-        start_wifi_ap_fallback();
-        return;
+static void start_wifi_manager(void) {
+    if (xTaskCreatePinnedToCore(wifi_manager_task, "wifi_mgr", 4096, NULL, 5, NULL, NET_CORE) != pdPASS) {
+        ESP_LOGE(TAG, "Wi-Fi manager start failed, switching to AP fallback");
+        start_wifi_ap_fallback(WIFI_MODE_AP);
+        g_wifi_ap_active = true;
+        g_wifi_state = WIFI_STATE_AP_ONLY;
     }
+}
 
-    wifi_config_t sta_cfg = {0};
-    sanitize_wifi_field(g_cfg.wifi_ssid);
-    sanitize_wifi_field(g_cfg.wifi_pass);
-    size_t sta_ssid_len = copy_wifi_field(sta_cfg.sta.ssid, sizeof(sta_cfg.sta.ssid), g_cfg.wifi_ssid);
-    size_t sta_pass_len = copy_wifi_field(sta_cfg.sta.password, sizeof(sta_cfg.sta.password), g_cfg.wifi_pass);
-    ESP_LOGI(TAG, "STA cfg ssid=%s ssid_len=%d pass_len=%d", (char *)sta_cfg.sta.ssid, (int)sta_ssid_len, (int)sta_pass_len);
+static esp_err_t metrics_handler(httpd_req_t *req, http_auth_t auth);
+
+/* Registered in order; async routes run on the worker so long transfers never block the httpd task. */
+static http_route_t g_routes[] = {
+    {.uri = "/", .method = HTTP_GET, .fn = web_root_handler},
+    {.uri = "/favicon.ico", .method = HTTP_GET, .fn = favicon_handler},
+    {.uri = "/api/status", .method = HTTP_GET, .fn = status_handler},
+    {.uri = "/api/metrics", .method = HTTP_GET, .fn = metrics_handler},
+    {.uri = "/api/pair", .method = HTTP_POST, .fn = pair_handler, .cls = HTTP_CLASS_BULK},
+    {.uri = "/api/config", .method = HTTP_POST, .fn = config_handler, .async = true, .auth = true, .cls = HTTP_CLASS_BULK},
+    {.uri = "/api/control", .method = HTTP_POST, .fn = control_handler, .auth = true, .cls = HTTP_CLASS_CONTROL},
+    {.uri = "/api/test/gpio", .method = HTTP_POST, .fn = gpio_test_handler, .auth = true, .cls = HTTP_CLASS_CONTROL},
+    {.uri = "/api/ota/apply", .method = HTTP_POST, .fn = ota_apply_handler, .async = true, .auth = true, .cls = HTTP_CLASS_BULK},
+    {.uri = "/api/ota/upload", .method = HTTP_POST, .fn = ota_upload_handler, .async = true, .auth = true, .cls = HTTP_CLASS_BULK},
+    {.uri = "/api/ota/status", .method = HTTP_GET, .fn = ota_status_handler},
+    {.uri = "/api/reboot", .method = HTTP_POST, .fn = reboot_handler, .auth = true, .cls = HTTP_CLASS_BULK},
+};
 
-    esp_wifi_set_mode(WIFI_MODE_STA);
-    esp_wifi_set_config(WIFI_IF_STA, &sta_cfg);
-    apply_static_ip_if_needed();
-    esp_wifi_start();
-    esp_wifi_set_ps(WIFI_PS_NONE);
+#define HTTP_ROUTE_COUNT (sizeof(g_routes) / sizeof(g_routes[0]))
+
+/* Prometheus text exposition for /api/metrics, streamed through the JSON writer's chunk buffer. */
+static void metrics_printf(json_writer_t *jw, const char *fmt, ...) {
+    char line[160];
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(line, sizeof(line), fmt, ap);
+    va_end(ap);
+    if (n < 0) return;
+    jw_write(jw, line, (size_t)n < sizeof(line) ? (size_t)n : sizeof(line) - 1);
+}
 
-    EventBits_t bits = xEventGroupWaitBits(g_wifi_events, WIFI_CONNECTED_BIT | WIFI_FAIL_BIT, pdFALSE, pdFALSE, pdMS_TO_TICKS(15000));
-    if (bits & WIFI_CONNECTED_BIT) {
-        ESP_LOGI(TAG, "Wi-Fi connected");
-    } else {
-        ESP_LOGW(TAG, "Wi-Fi STA failed, switching to AP fallback");
-        esp_wifi_stop();
-        start_wifi_ap_fallback();
+/* Label values may only carry \" \\ and \n escapes. */
+static void metrics_label_value(char *out, size_t out_len, const char *in) {
+    size_t o = 0;
+    for (; in && *in && o + 2 < out_len; in++) {
+        if (*in == '"' || *in == '\\') {
+            out[o++] = '\\';
+            out[o++] = *in;
+        } else if (*in == '\n') {
+            out[o++] = '\\';
+            out[o++] = 'n';
+        } else {
+            out[o++] = *in;
+        }
+    }
+    out[o] = '\0';
+}
+
+/* Upper bound of the bucket holding quantile q; the +Inf bucket reports the largest finite bound. */
+static double http_route_quantile_s(const http_route_stats_t *st, double q) {
+    if (st->count == 0) return 0;
+    uint32_t rank = (uint32_t)ceil(q * st->count);
+    if (rank == 0) rank = 1;
+    uint32_t seen = 0;
+    for (int b = 0; b <= HTTP_LAT_BUCKETS; b++) {
+        seen += st->hist[b];
+        if (seen >= rank) {
+            return HTTP_LAT_BOUNDS_US[b < HTTP_LAT_BUCKETS ? b : HTTP_LAT_BUCKETS - 1] / 1e6;
+        }
+    }
+    return HTTP_LAT_BOUNDS_US[HTTP_LAT_BUCKETS - 1] / 1e6;
+}
+
+static const char *http_method_name(httpd_method_t method) {
+    switch (method) {
+        case HTTP_GET:
+            return "GET";
+        case HTTP_POST:
+            return "POST";
+        default:
+            return "OTHER";
+    }
+}
+
+static esp_err_t metrics_handler(httpd_req_t *req, http_auth_t auth) {
+    char out_buf[JSON_WRITER_BUF];
+    json_writer_t jw;
+    jw_init(&jw, req, out_buf, sizeof(out_buf));
+    httpd_resp_set_type(req, "text/plain; version=0.0.4");
+
+    char id[MAX_STR * 2], type[MAX_STR * 2];
+    metrics_label_value(id, sizeof(id), g_cfg.device_id);
+    metrics_label_value(type, sizeof(type), g_cfg.type);
+    metrics_printf(&jw, "# TYPE eightbb_device_info gauge\neightbb_device_info{device_id=\"%s\",type=\"%s\",fw_version=\"%s\"} 1\n",
+                   id, type, FW_BUILD_VERSION);
+    metrics_printf(&jw, "# TYPE eightbb_uptime_seconds gauge\neightbb_uptime_seconds %lld\n",
+                   (long long)(esp_timer_get_time() / 1000000));
+
+    metrics_printf(&jw, "# TYPE eightbb_heap_free_bytes gauge\neightbb_heap_free_bytes %u\n", (unsigned)esp_get_free_heap_size());
+    metrics_printf(&jw, "# TYPE eightbb_heap_min_free_bytes gauge\neightbb_heap_min_free_bytes %u\n",
+                   (unsigned)esp_get_minimum_free_heap_size());
+    metrics_printf(&jw, "# TYPE eightbb_heap_largest_free_block_bytes gauge\neightbb_heap_largest_free_block_bytes %u\n",
+                   (unsigned)heap_caps_get_largest_free_block(MALLOC_CAP_8BIT));
+
+    metrics_printf(&jw, "# TYPE eightbb_wifi_connects_total counter\neightbb_wifi_connects_total %u\n", (unsigned)g_wifi_timing.connects);
+    metrics_printf(&jw, "# TYPE eightbb_wifi_disconnects_total counter\neightbb_wifi_disconnects_total %u\n",
+                   (unsigned)g_wifi_timing.disconnects);
+    metrics_printf(&jw, "# TYPE eightbb_wifi_last_connect_ms gauge\neightbb_wifi_last_connect_ms %ld\n", (long)g_wifi_timing.last_connect_ms);
+    wifi_ap_record_t ap = {0};
+    if (esp_wifi_sta_get_ap_info(&ap) == ESP_OK) {
+        metrics_printf(&jw, "# TYPE eightbb_wifi_rssi_dbm gauge\neightbb_wifi_rssi_dbm %d\n", (int)ap.rssi);
+    }
+
+    metrics_printf(&jw, "# TYPE eightbb_power_awake gauge\neightbb_power_awake %d\n", g_power_awake ? 1 : 0);
+    metrics_printf(&jw, "# TYPE eightbb_power_wakes_total counter\neightbb_power_wakes_total %u\n", (unsigned)g_power_wakes);
+    metrics_printf(&jw, "# TYPE eightbb_actuator_jobs_total counter\neightbb_actuator_jobs_total %u\n", (unsigned)g_act_jobs);
+    metrics_printf(&jw, "# TYPE eightbb_actuator_dropped_total counter\neightbb_actuator_dropped_total %u\n", (unsigned)g_act_dropped);
+    metrics_printf(&jw, "# TYPE eightbb_actuator_queue_wait_us gauge\neightbb_actuator_queue_wait_us %d\n", (int)g_act_last_wait_us);
+    metrics_printf(&jw, "# TYPE eightbb_actuator_queue_wait_max_us gauge\neightbb_actuator_queue_wait_max_us %d\n",
+                   (int)g_act_max_wait_us);
+    metrics_printf(&jw, "# TYPE eightbb_apply_at_last_late_us gauge\neightbb_apply_at_last_late_us %d\n", (int)g_apply_at_last_late_us);
+
+#if CONFIG_EIGHTBB_MQTT
+    metrics_printf(&jw, "# TYPE eightbb_mqtt_connected gauge\neightbb_mqtt_connected %d\n", g_mqtt_connected ? 1 : 0);
+#endif
+
+    metrics_printf(&jw, "# TYPE eightbb_ota_bytes gauge\neightbb_ota_bytes %u\n", (unsigned)g_ota_progress.bytes);
+    metrics_printf(&jw, "# TYPE eightbb_ota_elapsed_ms gauge\neightbb_ota_elapsed_ms %u\n",
+                   g_ota_progress.started_us ? (unsigned)ota_progress_elapsed_ms() : 0u);
+    metrics_printf(&jw, "# TYPE eightbb_ota_kbps gauge\neightbb_ota_kbps %u\n", g_ota_progress.started_us ? (unsigned)ota_progress_kbps() : 0u);
+    metrics_printf(&jw, "# TYPE eightbb_ota_resumes gauge\neightbb_ota_resumes %u\n", (unsigned)g_ota_progress.resumes);
+    metrics_printf(&jw, "# TYPE eightbb_ota_manifest_checks_total counter\neightbb_ota_manifest_checks_total %u\n",
+                   (unsigned)g_ota_manifest_checks);
+    metrics_printf(&jw, "# TYPE eightbb_ota_manifest_not_modified_total counter\neightbb_ota_manifest_not_modified_total %u\n",
+                   (unsigned)g_ota_manifest_not_modified);
+
+    metrics_printf(&jw, "# TYPE eightbb_nvs_config_saves_total counter\neightbb_nvs_config_saves_total %u\n",
+                   (unsigned)g_nvs_stats.config_saves);
+    metrics_printf(&jw, "# TYPE eightbb_nvs_config_section_writes_total counter\neightbb_nvs_config_section_writes_total %u\n",
+                   (unsigned)g_nvs_stats.config_section_writes);
+    metrics_printf(&jw, "# TYPE eightbb_nvs_state_writes_total counter\neightbb_nvs_state_writes_total %u\n",
+                   (unsigned)g_nvs_stats.state_writes);
+    metrics_printf(&jw, "# TYPE eightbb_nvs_wifi_cache_writes_total counter\neightbb_nvs_wifi_cache_writes_total %u\n",
+                   (unsigned)g_nvs_stats.wifi_cache_writes);
+    metrics_printf(&jw, "# TYPE eightbb_nvs_ota_cache_writes_total counter\neightbb_nvs_ota_cache_writes_total %u\n",
+                   (unsigned)g_nvs_stats.ota_cache_writes);
+
+    metrics_printf(&jw, "# TYPE eightbb_http_requests_total counter\n# TYPE eightbb_http_errors_total counter\n"
+                        "# TYPE eightbb_http_limited_total counter\n"
+                        "# TYPE eightbb_http_request_duration_seconds summary\n");
+    for (size_t i = 0; i < HTTP_ROUTE_COUNT; i++) {
+        http_route_stats_t st;
+        portENTER_CRITICAL(&g_metrics_lock);
+        st = g_routes[i].stats;
+        portEXIT_CRITICAL(&g_metrics_lock);
+        const char *uri = g_routes[i].uri;
+        const char *method = http_method_name(g_routes[i].method);
+        metrics_printf(&jw, "eightbb_http_requests_total{handler=\"%s\",method=\"%s\"} %u\n", uri, method, (unsigned)st.count);
+        metrics_printf(&jw, "eightbb_http_errors_total{handler=\"%s\",method=\"%s\"} %u\n", uri, method, (unsigned)st.errors);
+        metrics_printf(&jw, "eightbb_http_limited_total{handler=\"%s\",method=\"%s\"} %u\n", uri, method, (unsigned)st.limited);
+        metrics_printf(&jw, "eightbb_http_request_duration_seconds{handler=\"%s\",quantile=\"0.5\"} %.3f\n", uri,
+                       http_route_quantile_s(&st, 0.5));
+        metrics_printf(&jw, "eightbb_http_request_duration_seconds{handler=\"%s\",quantile=\"0.99\"} %.3f\n", uri,
+                       http_route_quantile_s(&st, 0.99));
+        metrics_printf(&jw, "eightbb_http_request_duration_seconds_sum{handler=\"%s\"} %.6f\n", uri, st.sum_us / 1e6);
+        metrics_printf(&jw, "eightbb_http_request_duration_seconds_count{handler=\"%s\"} %u\n", uri, (unsigned)st.count);
     }
+    return jw_send(&jw);
 }
 
 static void start_http_server(void) {
     httpd_config_t config = HTTPD_DEFAULT_CONFIG();
     config.server_port = 80;
-    config.max_uri_handlers = 16;
+    config.max_uri_handlers = HTTPD_CFG_MAX_URI_HANDLERS;
+    config.max_open_sockets = HTTPD_CFG_MAX_SOCKETS;
+    config.stack_size = HTTPD_CFG_STACK_SIZE;
+    /* Parsing and sockets stay on the network core; control ops cross over to the actuation task. */
+    config.core_id = NET_CORE;
+    /* Evict the least recently used socket instead of refusing a new client when all are taken. */
+    config.lru_purge_enable = HTTPD_CFG_LRU_PURGE;
+    /* TCP keep-alive probes reclaim sockets held by phones that left Wi-Fi without closing. */
+    config.keep_alive_enable = HTTPD_CFG_KEEP_ALIVE;
+    config.keep_alive_idle = 5;
+    config.keep_alive_interval = 5;
+    config.keep_alive_count = 3;
+    config.close_fn = http_close_handler;
+    events_reset_clients();
+    if (!http_body_pool_init()) {
+        set_web_status_led(false);
+        return;
+    }
     if (httpd_start(&g_server, &config) != ESP_OK) {
         ESP_LOGE(TAG, "HTTP server start failed");
         set_web_status_led(false);
         return;
     }
+    http_async_init();
 
-    httpd_uri_t root_uri = {.uri = "/", .method = HTTP_GET, .handler = web_root_handler};
-    httpd_uri_t favicon_uri = {.uri = "/favicon.ico", .method = HTTP_GET, .handler = favicon_handler};
-    httpd_uri_t status_uri = {.uri = "/api/status", .method = HTTP_GET, .handler = status_handler};
-    httpd_uri_t pair_uri = {.uri = "/api/pair", .method = HTTP_POST, .handler = pair_handler};
-    httpd_uri_t config_uri = {.uri = "/api/config", .method = HTTP_POST, .handler = config_handler};
-    httpd_uri_t control_uri = {.uri = "/api/control", .method = HTTP_POST, .handler = control_handler};
-    httpd_uri_t gpio_test_uri = {.uri = "/api/test/gpio", .method = HTTP_POST, .handler = gpio_test_handler};
-    httpd_uri_t ota_uri = {.uri = "/api/ota/apply", .method = HTTP_POST, .handler = ota_apply_handler};
-    httpd_uri_t ota_upload_uri = {.uri = "/api/ota/upload", .method = HTTP_POST, .handler = ota_upload_handler};
-    httpd_uri_t reboot_uri = {.uri = "/api/reboot", .method = HTTP_POST, .handler = reboot_handler};
-
-    httpd_register_uri_handler(g_server, &root_uri);
-    httpd_register_uri_handler(g_server, &favicon_uri);
-    httpd_register_uri_handler(g_server, &status_uri);
-    httpd_register_uri_handler(g_server, &pair_uri);
-    httpd_register_uri_handler(g_server, &config_uri);
-    httpd_register_uri_handler(g_server, &control_uri);
-    httpd_register_uri_handler(g_server, &gpio_test_uri);
-    httpd_register_uri_handler(g_server, &ota_uri);
-    httpd_register_uri_handler(g_server, &ota_upload_uri);
-    httpd_register_uri_handler(g_server, &reboot_uri);
+    for (size_t i = 0; i < HTTP_ROUTE_COUNT; i++) {
+        httpd_uri_t uri = {.uri = g_routes[i].uri, .method = g_routes[i].method, .handler = http_route_entry, .user_ctx = &g_routes[i]};
+        httpd_register_uri_handler(g_server, &uri);
+    }
+    httpd_uri_t events_uri = {.uri = "/api/events", .method = HTTP_GET, .handler = events_handler, .is_websocket = true};
+    httpd_register_uri_handler(g_server, &events_uri);
     setup_web_status_led();
     set_web_status_led(true);
     ESP_LOGI(TAG, "HTTP API ready");
 }
 
 void app_main(void) {
+    start_actuator();
     nvs_flash_init();
     load_config_from_nvs();
+    ota_running_image_init();
+    power_init();
     init_outputs();
-    start_wifi_station_or_ap();
+    start_inputs();
+    start_output_persist_task();
+    init_network_stack();
+#if CONFIG_EIGHTBB_MDNS
+    start_mdns();
+#endif
+    start_automation();
+    start_apply_at();
     start_http_server();
+#if CONFIG_EIGHTBB_UDP_CONTROL
+    start_udp_control();
+#endif
+#if CONFIG_EIGHTBB_DISCOVERY
+    start_discovery();
+#endif
+    start_wifi_manager();
+#if CONFIG_EIGHTBB_MQTT
+    start_mqtt();
+#endif
+    ESP_LOGI(TAG, "Boot services up after %lld ms", (long long)(esp_timer_get_time() / 1000));
 }
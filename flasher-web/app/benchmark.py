@@ -0,0 +1,450 @@
+"""Repeatable load test for the device HTTP API.
+
+Run from ``flasher-web``::
+
+    python -m app.benchmark run --host 192.168.1.50 --passcode 1234
+    python -m app.benchmark compare data/benchmarks/old.json data/benchmarks/new.json
+
+Results are written as JSON under ``data/benchmarks`` keyed by the device ``fw_version`` so runs
+can be compared release over release.
+"""
+
+from __future__ import annotations
+
+import argparse
+import json
+import re
+import threading
+import time
+from pathlib import Path
+from typing import Any
+from collections.abc import Callable
+
+import httpx
+
+from .device_comm import _session_token, fetch_device_status, normalize_device_host
+from .storage import DATA_DIR, utc_now
+
+BENCHMARK_DIR = DATA_DIR / "benchmarks"
+RESULT_SCHEMA = 1
+PERCENTILES = (50, 90, 99)
+_ERROR_SAMPLES = 5
+_METRIC_LINE = re.compile(r"^([a-zA-Z_:][a-zA-Z0-9_:]*)(\{[^}]*\})?\s+(\S+)$")
+_LABEL = re.compile(r'(\w+)="((?:[^"\\]|\\.)*)"')
+_DEVICE_GAUGES = (
+    "eightbb_heap_free_bytes",
+    "eightbb_heap_min_free_bytes",
+    "eightbb_heap_largest_free_block_bytes",
+    "eightbb_uptime_seconds",
+    "eightbb_wifi_rssi_dbm",
+)
+_OTA_REBOOT_TIMEOUT_S = 120.0
+
+
+def percentile(values: list[float], pct: float) -> float:
+    """Linear-interpolated percentile; 0.0 for an empty list."""
+    if not values:
+        return 0.0
+    ordered = sorted(values)
+    rank = (len(ordered) - 1) * pct / 100.0
+    low = int(rank)
+    high = min(low + 1, len(ordered) - 1)
+    return ordered[low] + (ordered[high] - ordered[low]) * (rank - low)
+
+
+def parse_metrics(text: str) -> dict[tuple[str, tuple[tuple[str, str], ...]], float]:
+    """Prometheus text exposition to {(name, sorted labels): value}; comments are skipped."""
+    out: dict[tuple[str, tuple[tuple[str, str], ...]], float] = {}
+    for line in text.splitlines():
+        match = _METRIC_LINE.match(line.strip())
+        if not match:
+            continue
+        try:
+            value = float(match.group(3))
+        except ValueError:
+            continue
+        labels = tuple(sorted(_LABEL.findall(match.group(2) or "")))
+        out[(match.group(1), labels)] = value
+    return out
+
+
+def scrape_metrics(base: str, timeout: float = 4.0) -> dict[tuple[str, tuple[tuple[str, str], ...]], float] | None:
+    """None when the firmware has no /api/metrics (older builds) or it cannot be reached."""
+    try:
+        with httpx.Client(timeout=timeout) as client:
+            res = client.get(f"{base}/api/metrics")
+        if res.status_code != 200:
+            return None
+        return parse_metrics(res.text)
+    except httpx.HTTPError:
+        return None
+
+
+def _route_metric(metrics: dict, name: str, handler: str) -> float:
+    for (metric, labels), value in metrics.items():
+        if metric == name and dict(labels).get("handler") == handler and "quantile" not in dict(labels):
+            return value
+    return 0.0
+
+
+def _device_side(before: dict | None, after: dict | None, path: str) -> dict[str, Any]:
+    """Handler counters as deltas over the run; quantiles are the device's since-boot histogram."""
+    if before is None or after is None:
+        return {"available": False}
+    out: dict[str, Any] = {"available": True}
+    for key in ("requests_total", "errors_total", "limited_total"):
+        name = f"eightbb_http_{key}"
+        out[key] = int(_route_metric(after, name, path) - _route_metric(before, name, path))
+    count = _route_metric(after, "eightbb_http_request_duration_seconds_count", path) - _route_metric(
+        before, "eightbb_http_request_duration_seconds_count", path
+    )
+    total = _route_metric(after, "eightbb_http_request_duration_seconds_sum", path) - _route_metric(
+        before, "eightbb_http_request_duration_seconds_sum", path
+    )
+    out["handler_mean_ms"] = round(total / count * 1000, 3) if count > 0 else 0.0
+    for (metric, labels), value in after.items():
+        label_map = dict(labels)
+        if metric == "eightbb_http_request_duration_seconds" and label_map.get("handler") == path:
+            out[f"handler_since_boot_q{label_map.get('quantile')}_ms"] = round(value * 1000, 3)
+    for gauge in _DEVICE_GAUGES:
+        if (gauge, ()) in before:
+            out[f"{gauge}_before"] = before[(gauge, ())]
+        if (gauge, ()) in after:
+            out[f"{gauge}_after"] = after[(gauge, ())]
+    return out
+
+
+def _summarize(latencies: list[float], codes: dict[str, int], errors: list[str], wall_s: float) -> dict[str, Any]:
+    total = sum(codes.values())
+    ok = sum(n for code, n in codes.items() if code.startswith("2") or code == "304")
+    limited = codes.get("429", 0)
+    summary: dict[str, Any] = {
+        "requests": total,
+        "ok": ok,
+        "limited": limited,
+        "errors": total - ok - limited,
+        "error_rate": round((total - ok - limited) / total, 4) if total else 0.0,
+        "limited_rate": round(limited / total, 4) if total else 0.0,
+        "wall_s": round(wall_s, 3),
+        "throughput_rps": round(ok / wall_s, 2) if wall_s > 0 else 0.0,
+        "status_codes": dict(sorted(codes.items())),
+        "latency_ms": {
+            **{f"p{p}": round(percentile(latencies, p), 2) for p in PERCENTILES},
+            "mean": round(sum(latencies) / len(latencies), 2) if latencies else 0.0,
+            "max": round(max(latencies), 2) if latencies else 0.0,
+        },
+    }
+    if errors:
+        summary["error_samples"] = errors[:_ERROR_SAMPLES]
+    return summary
+
+
+def run_http_scenario(
+    base: str,
+    method: str,
+    path: str,
+    *,
+    requests: int,
+    concurrency: int,
+    keep_alive: bool,
+    rate: float = 0.0,
+    timeout: float = 8.0,
+    headers: dict[str, str] | None = None,
+    body_for: Callable[[int], Any] | None = None,
+) -> dict[str, Any]:
+    """Fire ``requests`` calls from ``concurrency`` workers; ``rate`` > 0 paces the total to that many per second.
+
+    With keep-alive each worker reuses one connection; without it every request opens a new TCP
+    connection and sends ``Connection: close``, which is what a one-shot client (curl, a phone app
+    waking up) costs the device.
+    """
+    lock = threading.Lock()
+    latencies: list[float] = []
+    codes: dict[str, int] = {}
+    errors: list[str] = []
+    next_index = [0]
+    send_headers = dict(headers or {})
+    if not keep_alive:
+        send_headers["Connection"] = "close"
+    limits = httpx.Limits(max_connections=1, max_keepalive_connections=1 if keep_alive else 0)
+    started = time.perf_counter()
+
+    def worker() -> None:
+        with httpx.Client(timeout=timeout, limits=limits) as client:
+            while True:
+                with lock:
+                    index = next_index[0]
+                    if index >= requests:
+                        return
+                    next_index[0] += 1
+                if rate > 0:
+                    delay = started + index / rate - time.perf_counter()
+                    if delay > 0:
+                        time.sleep(delay)
+                body = body_for(index) if body_for else None
+                t0 = time.perf_counter()
+                try:
+                    if isinstance(body, (bytes, bytearray)):
+                        res = client.request(method, f"{base}{path}", content=bytes(body), headers=send_headers)
+                    else:
+                        res = client.request(method, f"{base}{path}", json=body, headers=send_headers)
+                    elapsed = (time.perf_counter() - t0) * 1000
+                    code = str(res.status_code)
+                    detail = "" if res.is_success or code in ("304", "429") else f"HTTP {code}: {res.text[:120]}"
+                except httpx.HTTPError as exc:
+                    elapsed = None
+                    code = exc.__class__.__name__
+                    detail = f"{code}: {exc}"
+                with lock:
+                    codes[code] = codes.get(code, 0) + 1
+                    if elapsed is not None:
+                        latencies.append(elapsed)
+                    if detail and len(errors) < _ERROR_SAMPLES:
+                        errors.append(detail)
+
+    threads = [threading.Thread(target=worker, daemon=True) for _ in range(max(1, concurrency))]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    return _summarize(latencies, codes, errors, time.perf_counter() - started)
+
+
+def _wait_for_status(host: str, timeout_s: float) -> dict[str, Any] | None:
+    deadline = time.monotonic() + timeout_s
+    while time.monotonic() < deadline:
+        try:
+            return fetch_device_status(host, timeout=3.0)
+        except Exception:
+            time.sleep(1.0)
+    return None
+
+
+def run_ota_upload(host: str, base: str, headers: dict[str, str], image: Path, runs: int, timeout: float) -> dict[str, Any]:
+    """Upload ``image`` ``runs`` times, waiting for the reboot in between.
+
+    A valid image is committed and the device reboots into it, so point this at the build you are
+    already running. Uploads are sequential: the device serializes them on its OTA worker anyway.
+    """
+    payload = image.read_bytes()
+    samples: list[dict[str, Any]] = []
+    for _ in range(max(1, runs)):
+        t0 = time.perf_counter()
+        sample: dict[str, Any] = {"bytes": len(payload)}
+        try:
+            with httpx.Client(timeout=httpx.Timeout(connect=10.0, read=timeout, write=timeout, pool=10.0)) as client:
+                res = client.post(
+                    f"{base}/api/ota/upload",
+                    content=payload,
+                    headers={**headers, "Content-Type": "application/octet-stream"},
+                )
+            elapsed = time.perf_counter() - t0
+            sample.update({"status": res.status_code, "elapsed_ms": round(elapsed * 1000, 1)})
+            sample["host_kbps"] = round(len(payload) / 1024 / elapsed, 1) if elapsed > 0 else 0.0
+            if res.is_success:
+                body = res.json()
+                sample.update({"device_ms": body.get("ms"), "device_kbps": body.get("kbps")})
+            else:
+                sample["error"] = res.text[:200]
+        except httpx.HTTPError as exc:
+            sample.update({"status": exc.__class__.__name__, "error": str(exc)})
+        if sample.get("status") == 200:
+            # The device restarts ~1 s after answering; time until /api/status answers again.
+            time.sleep(2.0)
+            back = _wait_for_status(host, _OTA_REBOOT_TIMEOUT_S)
+            sample["reboot_s"] = round(time.perf_counter() - t0 - sample["elapsed_ms"] / 1000, 1) if back else None
+            sample["fw_version_after"] = str(back.get("fw_version", "")) if back else ""
+        samples.append(sample)
+    good = [s for s in samples if s.get("status") == 200]
+    return {
+        "runs": len(samples),
+        "ok": len(good),
+        "errors": len(samples) - len(good),
+        "host_kbps_mean": round(sum(s["host_kbps"] for s in good) / len(good), 1) if good else 0.0,
+        "elapsed_ms_p50": round(percentile([s["elapsed_ms"] for s in good], 50), 1),
+        "samples": samples,
+    }
+
+
+def _control_body_factory(template: dict[str, Any], passcode: str | None) -> Callable[[int], dict[str, Any]]:
+    def body(_: int) -> dict[str, Any]:
+        return {**template, "passcode": passcode} if passcode is not None else dict(template)
+
+    return body
+
+
+def run_benchmark(args: argparse.Namespace) -> dict[str, Any]:
+    base = normalize_device_host(args.host)
+    status = fetch_device_status(args.host)
+    auth_headers: dict[str, str] = {}
+    body_passcode: str | None = args.passcode
+    token_used = False
+    if args.passcode and not args.no_token:
+        with httpx.Client(timeout=8) as client:
+            token = _session_token(client, base, args.passcode)
+        if token:
+            auth_headers["Authorization"] = f"Bearer {token}"
+            body_passcode = None
+            token_used = True
+    modes = {"on": [True], "off": [False], "both": [True, False]}[args.keep_alive]
+    control_template = json.loads(args.control_json)
+    control_requests = args.requests
+    if control_template.get("state") == "toggle" and control_requests % 2:
+        # An even number of toggles leaves the output where it started.
+        control_requests += 1
+
+    scenarios: list[dict[str, Any]] = []
+    for route in args.routes:
+        if route == "ota_upload":
+            continue
+        for keep_alive in modes:
+            if route == "status":
+                spec = {"method": "GET", "path": "/api/status", "requests": args.requests, "headers": {}, "body_for": None}
+            elif args.passcode:
+                spec = {
+                    "method": "POST",
+                    "path": "/api/control",
+                    "requests": control_requests,
+                    "headers": auth_headers,
+                    "body_for": _control_body_factory(control_template, body_passcode),
+                }
+            else:
+                continue
+            before = scrape_metrics(base)
+            result = run_http_scenario(
+                base,
+                spec["method"],
+                spec["path"],
+                requests=spec["requests"],
+                concurrency=args.concurrency,
+                keep_alive=keep_alive,
+                rate=args.rate,
+                timeout=args.timeout,
+                headers=spec["headers"],
+                body_for=spec["body_for"],
+            )
+            after = scrape_metrics(base)
+            scenarios.append(
+                {
+                    "name": f"{route}_{'keepalive' if keep_alive else 'close'}",
+                    "route": spec["path"],
+                    "keep_alive": keep_alive,
+                    "concurrency": args.concurrency,
+                    "rate": args.rate,
+                    **result,
+                    "device": _device_side(before, after, spec["path"]),
+                }
+            )
+            if args.pause > 0:
+                time.sleep(args.pause)
+
+    ota: dict[str, Any] | None = None
+    if "ota_upload" in args.routes and args.ota_image and args.passcode:
+        ota_headers = auth_headers or {"X-Passcode": args.passcode}
+        ota = run_ota_upload(args.host, base, ota_headers, Path(args.ota_image), args.ota_runs, args.ota_timeout)
+
+    return {
+        "schema": RESULT_SCHEMA,
+        "created_at": utc_now(),
+        "host": base,
+        "device_id": str(status.get("device_id", "")),
+        "device_type": str(status.get("type", "")),
+        "fw_version": str(status.get("fw_version", "")),
+        "session_token": token_used,
+        "scenarios": scenarios,
+        "ota_upload": ota,
+    }
+
+
+def _file_part(value: str) -> str:
+    return re.sub(r"[^A-Za-z0-9._-]+", "_", value) or "unknown"
+
+
+def default_result_path(result: dict[str, Any]) -> Path:
+    stamp = time.strftime("%Y%m%dT%H%M%S")
+    return BENCHMARK_DIR / f"{_file_part(result['fw_version'])}_{_file_part(result['device_id'])}_{stamp}.json"
+
+
+def compare_results(old: dict[str, Any], new: dict[str, Any]) -> list[dict[str, Any]]:
+    """Per-scenario p50/p99/throughput/error-rate deltas, new minus old."""
+    old_by_name = {s["name"]: s for s in old.get("scenarios", [])}
+    rows: list[dict[str, Any]] = []
+    for scenario in new.get("scenarios", []):
+        prev = old_by_name.get(scenario["name"])
+        if not prev:
+            continue
+        row: dict[str, Any] = {"name": scenario["name"]}
+        for key in ("p50", "p99"):
+            row[f"{key}_ms"] = (prev["latency_ms"][key], scenario["latency_ms"][key])
+        row["throughput_rps"] = (prev["throughput_rps"], scenario["throughput_rps"])
+        row["error_rate"] = (prev["error_rate"], scenario["error_rate"])
+        row["handler_mean_ms"] = (prev["device"].get("handler_mean_ms"), scenario["device"].get("handler_mean_ms"))
+        rows.append(row)
+    return rows
+
+
+def _print_run(result: dict[str, Any]) -> None:
+    print(f"{result['device_id']} fw={result['fw_version']} token={result['session_token']}")
+    for s in result["scenarios"]:
+        lat = s["latency_ms"]
+        print(
+            f"  {s['name']:<22} n={s['requests']:<5} rps={s['throughput_rps']:<8} "
+            f"p50={lat['p50']}ms p90={lat['p90']}ms p99={lat['p99']}ms "
+            f"err={s['error_rate']:.1%} 429={s['limited_rate']:.1%} dev={s['device'].get('handler_mean_ms', '-')}ms"
+        )
+    if result.get("ota_upload"):
+        ota = result["ota_upload"]
+        print(f"  ota_upload             runs={ota['runs']} ok={ota['ok']} kbps={ota['host_kbps_mean']} p50={ota['elapsed_ms_p50']}ms")
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description="Benchmark the device HTTP API.")
+    sub = parser.add_subparsers(dest="command", required=True)
+
+    run = sub.add_parser("run", help="Run the load test against one device.")
+    run.add_argument("--host", required=True)
+    run.add_argument("--passcode", default="", help="Needed for control and ota_upload.")
+    run.add_argument("--routes", nargs="+", choices=("status", "control", "ota_upload"), default=["status", "control"])
+    run.add_argument("--requests", type=int, default=200, help="Requests per scenario.")
+    run.add_argument("--concurrency", type=int, default=4)
+    run.add_argument("--keep-alive", choices=("on", "off", "both"), default="both")
+    run.add_argument(
+        "--rate",
+        type=float,
+        default=0.0,
+        help="Total requests/s per scenario (0 = unpaced). Unpaced runs will mostly measure the 429 path.",
+    )
+    run.add_argument("--timeout", type=float, default=8.0)
+    run.add_argument("--pause", type=float, default=2.0, help="Seconds between scenarios so the rate buckets refill.")
+    run.add_argument("--control-json", default='{"channel":"relay1","state":"toggle"}')
+    run.add_argument("--no-token", action="store_true", help="Send the passcode in each body instead of a session token.")
+    run.add_argument("--ota-image", default="", help="Firmware .bin to upload; the device reboots into it.")
+    run.add_argument("--ota-runs", type=int, default=1)
+    run.add_argument("--ota-timeout", type=float, default=180.0)
+    run.add_argument("--out", default="", help="Result path (default data/benchmarks/<fw>_<device>_<time>.json).")
+
+    cmp_parser = sub.add_parser("compare", help="Compare two result files.")
+    cmp_parser.add_argument("old")
+    cmp_parser.add_argument("new")
+
+    args = parser.parse_args()
+    if args.command == "compare":
+        old = json.loads(Path(args.old).read_text(encoding="utf-8"))
+        new = json.loads(Path(args.new).read_text(encoding="utf-8"))
+        print(f"{old.get('fw_version')} -> {new.get('fw_version')}")
+        for row in compare_results(old, new):
+            name = row.pop("name")
+            print(f"  {name:<22} " + " ".join(f"{key}={a}->{b}" for key, (a, b) in row.items()))
+        return 0
+
+    result = run_benchmark(args)
+    out = Path(args.out) if args.out else default_result_path(result)
+    out.parent.mkdir(parents=True, exist_ok=True)
+    out.write_text(json.dumps(result, indent=2) + "\n", encoding="utf-8")
+    _print_run(result)
+    print(f"Wrote {out}")
+    return 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
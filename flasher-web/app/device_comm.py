@@ -1,12 +1,48 @@
 from __future__ import annotations
 
+import hashlib
+import hmac
 import os
+import socket
+import struct
+import threading
 import time
 from typing import Any
 from collections.abc import Callable
 
 import httpx
 
+UDP_CONTROL_PORT = int(os.environ.get("DEVICE_UDP_CONTROL_PORT", "4210"))
+_UDP_MAGIC = b"8B"
+_UDP_VERSION = 2
+_UDP_COMMAND_FMT = "<2sBBBBH4BII24s"
+_UDP_ACK_FMT = "<2sBBBB2xIIBBBB4BB3x"
+_UDP_MAC_LEN = 16
+_UDP_CHANNELS = {
+    **{f"relay{i}": i for i in range(1, 9)},
+    "light": 9,
+    "dimmer": 10,
+    "rgb": 11,
+    "rgbw": 12,
+    "fan": 13,
+    "fan_power": 14,
+    "fan_speed": 15,
+}
+_UDP_ACTIONS = {"off": 0, "on": 1, "toggle": 2, "set": 3}
+_UDP_ACK_STATUS = {0: "ok", 2: "replay", 3: "bad_channel", 4: "stale_nonce"}
+_UDP_ACK_STALE_NONCE = 4
+# Re-pair this long before a session token expires rather than racing the device clock.
+_SESSION_REFRESH_MARGIN_S = 60.0
+# Firmware without session tokens answers /api/pair without one; ask again only after this long.
+_SESSION_UNSUPPORTED_RETRY_S = 300.0
+
+# Per-boot nonce each device last handed out in an ack, keyed by (address, device_id).
+_udp_nonce_lock = threading.Lock()
+_udp_nonces: dict[tuple[str, str], int] = {}
+
+_session_lock = threading.Lock()
+_sessions: dict[tuple[str, str], tuple[str, float]] = {}
+
 
 def normalize_device_host(host: str) -> str:
     value = host.strip()
@@ -23,12 +59,51 @@ def fetch_device_status(host: str, timeout: float = 8.0) -> dict[str, Any]:
     return res.json()
 
 
+def _session_key(base: str, passcode: str) -> tuple[str, str]:
+    return base, hashlib.sha256(passcode.encode("utf-8")).hexdigest()
+
+
+def _session_token(client: httpx.Client, base: str, passcode: str) -> str:
+    """Cached /api/pair token for this device, or "" when it cannot issue one."""
+    key = _session_key(base, passcode)
+    now = time.monotonic()
+    with _session_lock:
+        cached = _sessions.get(key)
+    if cached and cached[1] > now:
+        return cached[0]
+    try:
+        res = client.post(f"{base}/api/pair", json={"passcode": passcode})
+        res.raise_for_status()
+        body = res.json()
+    except Exception:
+        return ""
+    token = str(body.get("token", "") or "") if isinstance(body, dict) else ""
+    if token:
+        expires = now + max(0.0, float(body.get("expires_in", 0) or 0) - _SESSION_REFRESH_MARGIN_S)
+    else:
+        expires = now + _SESSION_UNSUPPORTED_RETRY_S
+    with _session_lock:
+        _sessions[key] = (token, expires)
+    return token
+
+
+def _post_authed(client: httpx.Client, base: str, path: str, passcode: str, payload: dict[str, Any]) -> httpx.Response:
+    # With a token the device checks only the header and never reads a passcode from the body.
+    token = _session_token(client, base, passcode)
+    if token:
+        res = client.post(f"{base}{path}", json=payload, headers={"Authorization": f"Bearer {token}"})
+        if res.status_code != 401:
+            return res
+        # Rebooted or passcode changed: the token is gone, fall back to the passcode.
+        with _session_lock:
+            _sessions.pop(_session_key(base, passcode), None)
+    return client.post(f"{base}{path}", json={**payload, "passcode": passcode})
+
+
 def send_device_command(host: str, passcode: str, command: dict[str, Any]) -> dict[str, Any]:
     base = normalize_device_host(host)
-    payload = dict(command)
-    payload["passcode"] = passcode
     with httpx.Client(timeout=8) as client:
-        res = client.post(f"{base}/api/control", json=payload)
+        res = _post_authed(client, base, "/api/control", passcode, dict(command))
     res.raise_for_status()
     body = res.text.strip()
     if not body:
@@ -39,12 +114,129 @@ def send_device_command(host: str, passcode: str, command: dict[str, Any]) -> di
         return {"ok": True, "raw": body}
 
 
+def send_device_batch(host: str, passcode: str, ops: list[dict[str, Any]]) -> dict[str, Any]:
+    """Apply several control ops in one request; the device validates all before applying any."""
+    base = normalize_device_host(host)
+    with httpx.Client(timeout=8) as client:
+        res = _post_authed(client, base, "/api/control", passcode, {"ops": [dict(op) for op in ops]})
+    res.raise_for_status()
+    return res.json()
+
+
+def _udp_mac(passcode: str, data: bytes) -> bytes:
+    return hmac.new(passcode.encode("utf-8"), data, hashlib.sha256).digest()[:_UDP_MAC_LEN]
+
+
+def _udp_exchange(address: str, passcode: str, packet: bytes, seq_value: int, timeout: float) -> tuple[Any, ...]:
+    with socket.socket(socket.AF_INET, socket.SOCK_DGRAM) as sock:
+        sock.settimeout(timeout)
+        sock.sendto(packet, (address, UDP_CONTROL_PORT))
+        ack_len = struct.calcsize(_UDP_ACK_FMT)
+        while True:
+            data, _ = sock.recvfrom(256)
+            if len(data) != ack_len + _UDP_MAC_LEN:
+                continue
+            fields = struct.unpack(_UDP_ACK_FMT, data[:ack_len])
+            if fields[0] != _UDP_MAGIC or fields[1] != _UDP_VERSION or fields[2] != 2 or fields[5] != seq_value:
+                continue
+            if not hmac.compare_digest(_udp_mac(passcode, data[:ack_len]), data[ack_len:]):
+                raise ValueError("UDP ack failed MAC verification")
+            return fields
+
+
+def send_udp_command(
+    host: str,
+    passcode: str,
+    device_id: str,
+    command: dict[str, Any],
+    seq: int | None = None,
+    timeout: float = 0.5,
+) -> dict[str, Any]:
+    """Send one control command over the firmware UDP protocol and wait for its ack.
+
+    A wrong passcode gets no ack at all, so it surfaces as a socket timeout.
+    """
+    channel = _UDP_CHANNELS.get(str(command.get("channel", "")).strip())
+    if channel is None:
+        raise ValueError(f"Unsupported UDP channel: {command.get('channel')}")
+    action = _UDP_ACTIONS.get(str(command.get("state", "toggle")).strip(), 4)
+
+    def pct(key: str, default: int = 0xFF) -> int:
+        raw = command.get(key)
+        return default if raw is None else max(0, min(100, int(raw)))
+
+    if channel in (11, 12):
+        values = (pct("r"), pct("g"), pct("b"), pct("w"))
+    else:
+        values = (pct("value", 0), 0, 0, 0)
+    transition_ms = max(0, min(60000, int(command.get("transition_ms") or 0)))
+    # The device accepts any first seq after a reboot, then only increasing ones (mod 2^32);
+    # milliseconds since epoch keep increasing across host restarts.
+    seq_value = (int(time.time() * 1000) if seq is None else int(seq)) & 0xFFFFFFFF
+    address = normalize_device_host(host).split("://", 1)[1].split("/", 1)[0].split(":", 1)[0]
+    nonce_key = (address, device_id)
+    with _udp_nonce_lock:
+        nonce = _udp_nonces.get(nonce_key, 0)
+
+    started = time.perf_counter()
+    # Datagrams are MAC'd over the device's per-boot nonce. An unknown or stale nonce costs one
+    # extra round trip: the device answers with the current one and the command is resent.
+    for _ in range(2):
+        body = struct.pack(
+            _UDP_COMMAND_FMT,
+            _UDP_MAGIC,
+            _UDP_VERSION,
+            1,
+            channel,
+            action,
+            transition_ms,
+            *values,
+            seq_value,
+            nonce,
+            device_id.encode("utf-8")[:24],
+        )
+        fields = _udp_exchange(address, passcode, body + _udp_mac(passcode, body), seq_value, timeout)
+        with _udp_nonce_lock:
+            _udp_nonces[nonce_key] = fields[6]
+        if fields[3] != _UDP_ACK_STALE_NONCE or fields[6] == nonce:
+            break
+        nonce = fields[6]
+    elapsed_ms = round((time.perf_counter() - started) * 1000, 2)
+
+    status, relay_mask = fields[3], fields[7]
+    # Replay and stale-nonce acks carry no output state.
+    outputs: dict[str, Any] = {}
+    if status in (0, 3):
+        outputs = {f"relay{i + 1}": bool(relay_mask & (1 << i)) for i in range(8)}
+        outputs.update(
+            {
+                "light": bool(fields[8]),
+                "dimmer": fields[9],
+                "fan_power": bool(fields[10]),
+                "rgb_r": fields[11],
+                "rgb_g": fields[12],
+                "rgb_b": fields[13],
+                "rgb_w": fields[14],
+                "fan_speed": fields[15],
+            }
+        )
+    return {
+        "ok": status == 0,
+        "status": _UDP_ACK_STATUS.get(status, str(status)),
+        "seq": seq_value,
+        "outputs": outputs,
+        "_udp_elapsed_ms": elapsed_ms,
+    }
+
+
 def push_ota_to_device(
     host: str,
     passcode: str,
     firmware_url: str,
     manifest_url: str,
     progress_cb: Callable[[str], None] | None = None,
+    patch_url: str | None = None,
+    force: bool = False,
 ) -> dict[str, Any]:
     def progress(message: str) -> None:
         if progress_cb:
@@ -62,9 +254,16 @@ def push_ota_to_device(
         "firmware_url": firmware_url,
         "manifest_url": manifest_url,
     }
+    if patch_url:
+        payload["patch_url"] = patch_url
+    if force:
+        # Otherwise the device skips the download when it already runs the signed image.
+        payload["force"] = True
     progress(f"HTTP POST {endpoint}")
     progress(f"firmware_url={firmware_url}")
     progress(f"manifest_url={manifest_url}")
+    if patch_url:
+        progress(f"patch_url={patch_url}")
     timeout = httpx.Timeout(connect=10.0, read=timeout_s, write=20.0, pool=20.0)
     started = time.perf_counter()
     with httpx.Client(timeout=timeout) as client:
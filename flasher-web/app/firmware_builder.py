@@ -1,6 +1,8 @@
 from __future__ import annotations
 
 import glob
+import gzip
+import hashlib
 import json
 import os
 import re
@@ -18,6 +20,8 @@ PROJECT_ROOT = Path(__file__).resolve().parents[2]
 ESP_FW_DIR = PROJECT_ROOT / "esp32-firmware"
 ESP_FW_BUILD_DIR = ESP_FW_DIR / "build"
 ESP_FW_GENERATED_DEFAULTS = ESP_FW_DIR / "main" / "generated_defaults.h"
+ESP_FW_WEB_UI_SOURCE = ESP_FW_DIR / "main" / "web" / "index.html"
+ESP_FW_GENERATED_WEB_UI = ESP_FW_DIR / "main" / "generated_web_ui.h"
 FIRMWARE_DIR = DATA_DIR / "firmware"
 BUILD_LOG_DIR = DATA_DIR / "logs" / "firmware_builds"
 APP_BIN_NAME = "esp32_smart_device.bin"
@@ -151,7 +155,7 @@ def _extract_relay_defaults(defaults: dict[str, object]) -> tuple[int, list[int]
     return relay_count, relay_gpio
 
 
-def _write_generated_defaults(defaults: dict[str, object], log_file: Path) -> None:
+def _write_generated_defaults(defaults: dict[str, object], log_file: Path, version: str = "") -> None:
     relay_count, relay_gpio = _extract_relay_defaults(defaults)
     merged = {
         "name": str(defaults.get("name", "8bb-esp32") or "8bb-esp32"),
@@ -175,6 +179,7 @@ def _write_generated_defaults(defaults: dict[str, object], log_file: Path) -> No
             "#pragma once",
             "",
             "// Auto-generated by flasher build endpoint. Do not edit manually.",
+            *([f'#define FW_BUILD_VERSION "{_c_escape(version)}"'] if version else []),
             f'#define FW_DEFAULT_NAME "{_c_escape(merged["name"])}"',
             f'#define FW_DEFAULT_TYPE "{_c_escape(merged["type"])}"',
             f'#define FW_DEFAULT_PASSCODE "{_c_escape(merged["passcode"])}"',
@@ -219,6 +224,34 @@ def _write_generated_defaults(defaults: dict[str, object], log_file: Path) -> No
     )
 
 
+def _write_generated_web_ui(log_file: Path) -> None:
+    raw = ESP_FW_WEB_UI_SOURCE.read_bytes()
+    # mtime=0 keeps the blob (and therefore the ETag) identical across rebuilds of the same UI.
+    packed = gzip.compress(raw, compresslevel=9, mtime=0)
+    etag = hashlib.sha256(packed).hexdigest()[:16]
+    rows = [", ".join(f"0x{b:02x}" for b in packed[i : i + 16]) for i in range(0, len(packed), 16)]
+    content = "\n".join(
+        [
+            "#pragma once",
+            "",
+            "// Auto-generated by flasher build endpoint from main/web/index.html. Do not edit manually.",
+            "#include <stdint.h>",
+            "",
+            f'#define WEB_UI_GZ_ETAG "\\"{etag}\\""',
+            f"#define WEB_UI_GZ_LEN {len(packed)}",
+            "static const uint8_t WEB_UI_GZ[WEB_UI_GZ_LEN] = {",
+            *[f"    {row}," for row in rows],
+            "};",
+            "",
+        ]
+    )
+    ESP_FW_GENERATED_WEB_UI.write_text(content, encoding="utf-8")
+    _append_log(
+        log_file,
+        "generated_web_ui=" + json.dumps({"raw_bytes": len(raw), "gzip_bytes": len(packed), "etag": etag}),
+    )
+
+
 def _dedupe_keep_order(values: list[str]) -> list[str]:
     out: list[str] = []
     seen: set[str] = set()
@@ -706,7 +739,8 @@ def build_firmware(
         if not ESP_FW_DIR.exists():
             raise FileNotFoundError(f"Firmware source folder not found: {ESP_FW_DIR}")
 
-        _write_generated_defaults(defaults or {}, log_file)
+        _write_generated_defaults(defaults or {}, log_file, version)
+        _write_generated_web_ui(log_file)
 
         idf_cmd, idf_env = _resolve_idf_cmd_and_env(log_file, context="initial")
 
@@ -59,6 +59,7 @@ from .profiles import (
     get_profile_file_paths,
     list_firmware_profiles,
 )
+from .rollout import cancel_rollout, get_rollout, list_rollouts, start_rollout
 from .scanner import scan_network
 from .session_logs import SESSION_COOKIE_NAME, append_activity, append_error, get_or_create_client_session_id
 from .serial_monitor import (
@@ -76,6 +77,7 @@ from .schemas import (
     FlashJobCreate,
     FirmwareProfileCreate,
     IntegrationsConfig,
+    OTARolloutRequest,
     OTASignRequest,
     TileCreate,
 )
@@ -2843,8 +2845,14 @@ def push_device_ota(device_id: str, payload: DeviceOTAPushRequest, request: Requ
     except ValueError as exc:
         raise HTTPException(status_code=400, detail=str(exc)) from exc
     firmware_path = FIRMWARE_DIR / firmware_filename
+    base_firmware_path = None
+    if payload.base_firmware_filename:
+        try:
+            base_firmware_path = FIRMWARE_DIR / _safe_filename(payload.base_firmware_filename, "base_firmware_filename")
+        except ValueError as exc:
+            raise HTTPException(status_code=400, detail=str(exc)) from exc
     try:
-        signed = sign_firmware(firmware_path, payload.version, device_type, shared_key)
+        signed = sign_firmware(firmware_path, payload.version, device_type, shared_key, base_firmware_path)
     except (FileNotFoundError, ValueError) as exc:
         raise HTTPException(status_code=400, detail=str(exc)) from exc
 
@@ -2852,9 +2860,11 @@ def push_device_ota(device_id: str, payload: DeviceOTAPushRequest, request: Requ
     firmware_url = f"{base}/downloads/firmware/{firmware_filename}"
     manifest_name = Path(signed["manifest_path"]).name
     manifest_url = f"{base}/downloads/ota/{manifest_name}"
+    patch = signed["manifest"].get("patch")
+    patch_url = f"{base}/downloads/ota/{patch['file']}" if patch else None
 
     try:
-        result = push_ota_to_device(host, passcode, firmware_url, manifest_url)
+        result = push_ota_to_device(host, passcode, firmware_url, manifest_url, patch_url=patch_url)
     except httpx.HTTPError as exc:
         raise HTTPException(status_code=502, detail=f"OTA push failed: {exc}") from exc
     append_event("device_ota_push", {"device_id": device_id, "firmware": firmware_filename, "version": payload.version})
@@ -3835,6 +3845,82 @@ def ota_sign(payload: OTASignRequest) -> dict[str, Any]:
         raise HTTPException(status_code=status, detail=str(exc)) from exc
 
 
+@app.post("/api/ota/rollouts", dependencies=[Depends(require_auth_if_configured)])
+def post_ota_rollout(payload: OTARolloutRequest, request: Request) -> dict[str, Any]:
+    shared_key = _load_ota_shared_key()
+    if not shared_key:
+        raise HTTPException(status_code=400, detail="OTA shared key is not configured")
+    device_ids = list(dict.fromkeys(d.strip() for d in payload.device_ids if d.strip()))
+    if not device_ids:
+        raise HTTPException(status_code=400, detail="device_ids is required")
+
+    targets: list[dict[str, Any]] = []
+    device_types: set[str] = set()
+    for device_id in device_ids:
+        conn, row = _require_device(device_id)
+        host = (row["host"] or "").strip()
+        passcode = decrypt_secret(row["passcode_enc"] or "")
+        device_types.add(row["type"])
+        conn.close()
+        if not host or not passcode:
+            raise HTTPException(status_code=400, detail=f"Device {device_id} is missing host or passcode")
+        targets.append({"device_id": device_id, "host": host, "passcode": passcode})
+    if len(device_types) != 1:
+        # Manifests are signed per device type; one manifest file per firmware/version.
+        raise HTTPException(status_code=400, detail="All rollout devices must share one device type")
+
+    try:
+        firmware_filename = _safe_filename(payload.firmware_filename, "firmware_filename")
+        base_firmware_path = (
+            FIRMWARE_DIR / _safe_filename(payload.base_firmware_filename, "base_firmware_filename")
+            if payload.base_firmware_filename
+            else None
+        )
+        signed = sign_firmware(FIRMWARE_DIR / firmware_filename, payload.version, device_types.pop(), shared_key, base_firmware_path)
+    except (FileNotFoundError, ValueError) as exc:
+        raise HTTPException(status_code=400, detail=str(exc)) from exc
+
+    base = _resolve_download_base_url(request)
+    patch = signed["manifest"].get("patch")
+    try:
+        return start_rollout(
+            targets=targets,
+            version=payload.version,
+            sha256=signed["manifest"]["sha256"],
+            firmware_url=f"{base}/downloads/firmware/{firmware_filename}",
+            manifest_url=f"{base}/downloads/ota/{Path(signed['manifest_path']).name}",
+            patch_url=f"{base}/downloads/ota/{patch['file']}" if patch else None,
+            parallelism=payload.parallelism,
+            canary_count=payload.canary_count,
+            wave_size=payload.wave_size,
+            max_failures=payload.max_failures,
+            health_timeout_s=payload.health_timeout_s,
+            force=payload.force,
+        )
+    except ValueError as exc:
+        raise HTTPException(status_code=400, detail=str(exc)) from exc
+
+
+@app.get("/api/ota/rollouts", dependencies=[Depends(require_auth_if_configured)])
+def get_ota_rollouts() -> list[dict[str, Any]]:
+    return list_rollouts()
+
+
+@app.get("/api/ota/rollouts/{rollout_id}", dependencies=[Depends(require_auth_if_configured)])
+def get_ota_rollout(rollout_id: str) -> dict[str, Any]:
+    rollout = get_rollout(rollout_id)
+    if not rollout:
+        raise HTTPException(status_code=404, detail="Rollout not found")
+    return rollout
+
+
+@app.post("/api/ota/rollouts/{rollout_id}/cancel", dependencies=[Depends(require_auth_if_configured)])
+def post_ota_rollout_cancel(rollout_id: str) -> dict[str, Any]:
+    if not cancel_rollout(rollout_id):
+        raise HTTPException(status_code=404, detail="Rollout not running")
+    return {"ok": True, "rollout_id": rollout_id}
+
+
 @app.post("/api/firmware/profiles", dependencies=[Depends(require_auth_if_configured)])
 def create_profile(payload: FirmwareProfileCreate) -> dict[str, Any]:
     shared_key = _load_ota_shared_key()
@@ -3,6 +3,7 @@ from __future__ import annotations
 import hashlib
 import hmac
 import json
+import struct
 from pathlib import Path
 from typing import Any
 
@@ -10,13 +11,105 @@ from .storage import DATA_DIR, append_event, utc_now
 
 OTA_DIR = DATA_DIR / "ota"
 
+# Delta patch ("8bdp1"): 16-byte header (magic, version, base_size, target_size) followed by
+# COPY(base_offset, length) / DATA(length, bytes) ops and END. The device replays it against
+# its running partition and checks the result against the manifest sha256.
+PATCH_FORMAT = "8bdp1"
+_PATCH_MAGIC = b"8BDP"
+_PATCH_HEADER = struct.Struct("<4sB3xII")
+_PATCH_OP_END = 0
+_PATCH_OP_COPY = 1
+_PATCH_OP_DATA = 2
+_PATCH_BLOCK = 32
+_PATCH_INDEX_STEP = 4
+
 
 def _make_signature(shared_key: str, digest: str, version: str, device_type: str) -> str:
     message = f"{digest}:{version}:{device_type}".encode("utf-8")
     return hmac.new(shared_key.encode("utf-8"), message, hashlib.sha256).hexdigest()
 
 
-def sign_firmware(firmware_path: Path, version: str, device_type: str, shared_key: str) -> dict[str, Any]:
+def _match_length(base: bytes, src: int, target: bytes, dst: int) -> int:
+    length = 0
+    step = 4096
+    limit = min(len(base) - src, len(target) - dst)
+    while step:
+        while length + step <= limit and base[src + length : src + length + step] == target[dst + length : dst + length + step]:
+            length += step
+        step //= 2
+    return length
+
+
+def make_delta_patch(base: bytes, target: bytes) -> bytes:
+    """Greedy copy/insert delta of target against base (blocks indexed every 4 bytes of base)."""
+    index: dict[bytes, int] = {}
+    for offset in range(0, len(base) - _PATCH_BLOCK + 1, _PATCH_INDEX_STEP):
+        index.setdefault(base[offset : offset + _PATCH_BLOCK], offset)
+
+    out = bytearray(_PATCH_HEADER.pack(_PATCH_MAGIC, 1, len(base), len(target)))
+
+    def emit_data(start: int, end: int) -> None:
+        if end > start:
+            out.extend(struct.pack("<BI", _PATCH_OP_DATA, end - start))
+            out.extend(target[start:end])
+
+    literal_start = 0
+    next_src = 0
+    pos = 0
+    while pos + _PATCH_BLOCK <= len(target):
+        block = target[pos : pos + _PATCH_BLOCK]
+        # Prefer continuing the previous copy; that keeps unchanged runs after small edits in one op.
+        if base[next_src : next_src + _PATCH_BLOCK] == block:
+            src = next_src
+        else:
+            src = index.get(block, -1)
+        if src < 0:
+            pos += 1
+            continue
+        length = _match_length(base, src, target, pos)
+        while pos > literal_start and src > 0 and target[pos - 1] == base[src - 1]:
+            pos -= 1
+            src -= 1
+            length += 1
+        emit_data(literal_start, pos)
+        out.extend(struct.pack("<BII", _PATCH_OP_COPY, src, length))
+        pos += length
+        literal_start = pos
+        next_src = src + length
+    emit_data(literal_start, len(target))
+    out.append(_PATCH_OP_END)
+    return bytes(out)
+
+
+def _write_delta_patch(base_path: Path, firmware_bytes: bytes, patch_stem: str) -> dict[str, Any] | None:
+    try:
+        base_bytes = base_path.read_bytes()
+    except OSError as exc:
+        raise ValueError(f"Unable to read base firmware file: {base_path}") from exc
+    base_digest = hashlib.sha256(base_bytes).hexdigest()
+    patch = make_delta_patch(base_bytes, firmware_bytes)
+    if len(patch) >= len(firmware_bytes):
+        # Nothing gained over the full image; devices just download firmware_url.
+        return None
+    patch_path = OTA_DIR / f"{patch_stem}.from-{base_digest[:12]}.patch"
+    patch_path.write_bytes(patch)
+    return {
+        "format": PATCH_FORMAT,
+        "file": patch_path.name,
+        "size": len(patch),
+        "base_sha256": base_digest,
+        "base_size": len(base_bytes),
+        "target_size": len(firmware_bytes),
+    }
+
+
+def sign_firmware(
+    firmware_path: Path,
+    version: str,
+    device_type: str,
+    shared_key: str,
+    base_firmware_path: Path | None = None,
+) -> dict[str, Any]:
     if not firmware_path.exists():
         raise FileNotFoundError(f"Firmware not found: {firmware_path}")
     if firmware_path.is_dir():
@@ -46,6 +139,13 @@ def sign_firmware(firmware_path: Path, version: str, device_type: str, shared_ke
         "signature": signature,
     }
 
+    if base_firmware_path is not None:
+        patch = _write_delta_patch(base_firmware_path, firmware_bytes, f"{firmware_path.stem}-{version}")
+        if patch:
+            # Unsigned on purpose: the device verifies the patched image against the signed sha256,
+            # and firmware that predates delta support ignores the field and pulls the full image.
+            manifest["patch"] = patch
+
     manifest_path = OTA_DIR / f"{firmware_path.stem}-{version}.manifest.json"
     manifest_path.write_text(json.dumps(manifest, indent=2), encoding="utf-8")
     append_event("ota_signed", {"manifest": str(manifest_path), "firmware": firmware_path.name, "version": version})
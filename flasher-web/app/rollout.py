@@ -0,0 +1,282 @@
+from __future__ import annotations
+
+import threading
+import time
+import uuid
+from concurrent.futures import ThreadPoolExecutor
+from pathlib import Path
+from typing import Any
+
+from .device_comm import fetch_device_status, push_ota_to_device
+from .storage import DATA_DIR, append_event, utc_now
+
+ROLLOUT_LOG_DIR = DATA_DIR / "logs" / "ota_rollouts"
+MAX_ROLLOUT_PARALLELISM = 16
+_HEALTH_POLL_SECONDS = 3.0
+
+_lock = threading.Lock()
+_rollouts: dict[str, dict[str, Any]] = {}
+_cancel_events: dict[str, threading.Event] = {}
+
+
+def _read(rollout_id: str) -> dict[str, Any] | None:
+    with _lock:
+        item = _rollouts.get(rollout_id)
+        if not item:
+            return None
+        out = dict(item)
+        out["devices"] = [dict(d) for d in item["devices"]]
+        return out
+
+
+def _update_device(rollout_id: str, device_id: str, **fields: Any) -> None:
+    with _lock:
+        item = _rollouts.get(rollout_id)
+        if not item:
+            return
+        for dev in item["devices"]:
+            if dev["device_id"] == device_id:
+                dev.update(fields)
+                return
+
+
+def _update(rollout_id: str, **fields: Any) -> None:
+    with _lock:
+        item = _rollouts.get(rollout_id)
+        if item:
+            item.update(fields)
+
+
+def _log(rollout_id: str, line: str) -> None:
+    chunk = f"[{utc_now()}] {line}"
+    with _lock:
+        item = _rollouts.get(rollout_id)
+        if not item:
+            return
+        output = str(item.get("output", ""))
+        item["output"] = f"{output}\n{chunk}" if output else chunk
+        log_file = str(item.get("log_file", ""))
+    if log_file:
+        try:
+            log_path = Path(log_file)
+            log_path.parent.mkdir(parents=True, exist_ok=True)
+            with log_path.open("a", encoding="utf-8") as fp:
+                fp.write(chunk + "\n")
+        except Exception:
+            pass
+
+
+def plan_waves(count: int, canary_count: int, wave_size: int) -> list[int]:
+    """Wave sizes: canaries first, then fixed-size waves (0 = everything left in one wave)."""
+    waves: list[int] = []
+    remaining = count
+    canaries = max(0, min(canary_count, remaining))
+    if canaries:
+        waves.append(canaries)
+        remaining -= canaries
+    step = wave_size if wave_size > 0 else remaining
+    while remaining > 0:
+        size = min(step, remaining)
+        waves.append(size)
+        remaining -= size
+    return waves
+
+
+def _runs_image(status: dict[str, Any], spec: dict[str, Any], *, allow_version: bool) -> bool:
+    """fw_sha256 is the signed digest of the image the device booted; fw_version is only the
+    compile-time default unless the build went through the flasher. Firmware that predates
+    fw_sha256 can only be matched by version, and only where allow_version says so."""
+    if "fw_sha256" in status:
+        return str(status["fw_sha256"]) == spec["sha256"]
+    return allow_version and str(status.get("fw_version", "")) == spec["version"]
+
+
+def _is_healthy(status: dict[str, Any], spec: dict[str, Any]) -> bool:
+    return _runs_image(status, spec, allow_version=True) and bool(status.get("web_ui_running"))
+
+
+def _wait_for_health(host: str, spec: dict[str, Any], timeout_s: float, cancel: threading.Event) -> dict[str, Any]:
+    deadline = time.monotonic() + timeout_s
+    last_error = ""
+    last_version = ""
+    # The device answers /api/ota/apply just before it reboots; give it a moment to go down.
+    cancel.wait(_HEALTH_POLL_SECONDS)
+    while time.monotonic() < deadline and not cancel.is_set():
+        try:
+            status = fetch_device_status(host, timeout=4.0)
+            last_version = str(status.get("fw_version", ""))
+            if _is_healthy(status, spec):
+                return {"ok": True, "status": status}
+            last_error = (
+                f"fw_version={last_version or '?'} fw_sha256={str(status.get('fw_sha256', '?'))[:12] or '?'} "
+                f"web_ui_running={bool(status.get('web_ui_running'))}"
+            )
+        except Exception as exc:
+            last_error = str(exc) or exc.__class__.__name__
+        cancel.wait(_HEALTH_POLL_SECONDS)
+    if cancel.is_set():
+        return {"ok": False, "error": "cancelled"}
+    return {"ok": False, "error": f"health check timed out after {int(timeout_s)}s ({last_error})", "fw_version": last_version}
+
+
+def _run_device(rollout_id: str, spec: dict[str, Any], target: dict[str, Any], cancel: threading.Event) -> bool:
+    device_id = target["device_id"]
+    host = target["host"]
+    version = spec["version"]
+    if cancel.is_set():
+        _update_device(rollout_id, device_id, state="skipped", error="cancelled")
+        return True
+    started = time.perf_counter()
+    _update_device(rollout_id, device_id, state="pushing", started_at=utc_now())
+    try:
+        before = fetch_device_status(host, timeout=4.0)
+        # Skipping needs proof the device runs this exact image; a matching fw_version is not enough.
+        if _runs_image(before, spec, allow_version=False) and bool(before.get("web_ui_running")) and not spec["force"]:
+            _log(rollout_id, f"{device_id}: already on {version}, skipping")
+            _update_device(rollout_id, device_id, state="current", ended_at=utc_now())
+            return True
+        _log(rollout_id, f"{device_id}: POST /api/ota/apply (from {before.get('fw_version', '?')})")
+        result = push_ota_to_device(
+            host,
+            target["passcode"],
+            spec["firmware_url"],
+            spec["manifest_url"],
+            lambda msg: None,
+            patch_url=spec.get("patch_url"),
+            force=bool(spec["force"]),
+        )
+        _update_device(rollout_id, device_id, state="verifying", device_response=result)
+        _log(
+            rollout_id,
+            f"{device_id}: image applied ({result.get('bytes', '?')} bytes, delta={bool(result.get('delta'))}); waiting for reboot",
+        )
+    except Exception as exc:
+        _log(rollout_id, f"{device_id}: push failed: {exc}")
+        _update_device(rollout_id, device_id, state="failed", error=str(exc), ended_at=utc_now())
+        return False
+
+    health = _wait_for_health(host, spec, spec["health_timeout_s"], cancel)
+    elapsed_ms = int((time.perf_counter() - started) * 1000)
+    if not health.get("ok"):
+        _log(rollout_id, f"{device_id}: unhealthy: {health.get('error')}")
+        _update_device(rollout_id, device_id, state="failed", error=health.get("error", ""), elapsed_ms=elapsed_ms, ended_at=utc_now())
+        return False
+    _log(rollout_id, f"{device_id}: healthy on {version} after {elapsed_ms}ms")
+    _update_device(rollout_id, device_id, state="healthy", elapsed_ms=elapsed_ms, ended_at=utc_now())
+    return True
+
+
+def _run_rollout(rollout_id: str, spec: dict[str, Any], targets: list[dict[str, Any]]) -> None:
+    cancel = _cancel_events[rollout_id]
+    waves = plan_waves(len(targets), spec["canary_count"], spec["wave_size"])
+    _update(rollout_id, status="running", started_at=utc_now())
+    _log(rollout_id, f"Rollout of {spec['version']} to {len(targets)} device(s): waves={waves} parallelism={spec['parallelism']}")
+    failures = 0
+    offset = 0
+    halted = ""
+    with ThreadPoolExecutor(max_workers=spec["parallelism"]) as pool:
+        for index, size in enumerate(waves):
+            if cancel.is_set():
+                halted = "cancelled"
+                break
+            wave = targets[offset : offset + size]
+            offset += size
+            label = "canary" if index == 0 and spec["canary_count"] > 0 else f"wave {index + 1}"
+            _update(rollout_id, current_wave=index + 1)
+            _log(rollout_id, f"Starting {label}: {', '.join(t['device_id'] for t in wave)}")
+            results = list(pool.map(lambda t: _run_device(rollout_id, spec, t, cancel), wave))
+            failures += results.count(False)
+            _update(rollout_id, failures=failures)
+            # Gate the next wave: a bad image should stop at the canaries, not walk the whole fleet.
+            if failures > spec["max_failures"]:
+                halted = f"{failures} device(s) failed health gate after {label}"
+                break
+    for target in targets[offset:]:
+        _update_device(rollout_id, target["device_id"], state="skipped", error=halted or "not started")
+    status = "success" if not halted else ("cancelled" if halted == "cancelled" else "halted")
+    if halted:
+        _log(rollout_id, f"Rollout stopped: {halted}")
+    else:
+        _log(rollout_id, "Rollout finished")
+    _update(rollout_id, status=status, halted_reason=halted, ended_at=utc_now())
+    append_event("ota_rollout_finished", {"rollout_id": rollout_id, "status": status, "failures": failures, "version": spec["version"]})
+    with _lock:
+        _cancel_events.pop(rollout_id, None)
+
+
+def start_rollout(
+    *,
+    targets: list[dict[str, Any]],
+    version: str,
+    sha256: str,
+    firmware_url: str,
+    manifest_url: str,
+    patch_url: str | None = None,
+    parallelism: int = 4,
+    canary_count: int = 1,
+    wave_size: int = 0,
+    max_failures: int = 0,
+    health_timeout_s: float = 180.0,
+    force: bool = False,
+) -> dict[str, Any]:
+    """Start a background rollout; targets are dicts with device_id, host and passcode."""
+    if not targets:
+        raise ValueError("No devices selected for rollout")
+    rollout_id = str(uuid.uuid4())
+    ROLLOUT_LOG_DIR.mkdir(parents=True, exist_ok=True)
+    spec = {
+        "version": version,
+        "sha256": sha256,
+        "firmware_url": firmware_url,
+        "manifest_url": manifest_url,
+        "patch_url": patch_url,
+        "parallelism": max(1, min(MAX_ROLLOUT_PARALLELISM, int(parallelism))),
+        "canary_count": max(0, int(canary_count)),
+        "wave_size": max(0, int(wave_size)),
+        "max_failures": max(0, int(max_failures)),
+        "health_timeout_s": max(30.0, float(health_timeout_s)),
+        "force": bool(force),
+    }
+    rollout = {
+        "rollout_id": rollout_id,
+        "status": "queued",
+        **{k: v for k, v in spec.items() if k != "force"},
+        "waves": plan_waves(len(targets), spec["canary_count"], spec["wave_size"]),
+        "current_wave": 0,
+        "failures": 0,
+        "halted_reason": "",
+        "created_at": utc_now(),
+        "started_at": "",
+        "ended_at": "",
+        "log_file": str(ROLLOUT_LOG_DIR / f"{time.strftime('%Y%m%d')}_{rollout_id[:8]}.log"),
+        "output": "",
+        "devices": [{"device_id": t["device_id"], "host": t["host"], "state": "pending", "error": ""} for t in targets],
+    }
+    with _lock:
+        _rollouts[rollout_id] = rollout
+        _cancel_events[rollout_id] = threading.Event()
+    append_event("ota_rollout_started", {"rollout_id": rollout_id, "version": version, "devices": len(targets)})
+    thread = threading.Thread(target=_run_rollout, args=(rollout_id, spec, targets), daemon=True)
+    thread.start()
+    return _read(rollout_id) or rollout
+
+
+def get_rollout(rollout_id: str) -> dict[str, Any] | None:
+    return _read(rollout_id)
+
+
+def list_rollouts() -> list[dict[str, Any]]:
+    with _lock:
+        ids = list(_rollouts.keys())
+    out = [_read(rid) for rid in ids]
+    return sorted((r for r in out if r), key=lambda r: r["created_at"], reverse=True)
+
+
+def cancel_rollout(rollout_id: str) -> bool:
+    """Stops new pushes; devices already flashing finish their current transfer."""
+    with _lock:
+        event = _cancel_events.get(rollout_id)
+    if not event:
+        return False
+    event.set()
+    return True
@@ -1,14 +1,36 @@
 from __future__ import annotations
 
+import asyncio
 import ipaddress
-import platform
+import json
 import re
+import socket
+import struct
 import subprocess
+import time
+from collections.abc import Iterable, Iterator
 from concurrent.futures import ThreadPoolExecutor
-from typing import Any
+from typing import Any, Coroutine
 
 import httpx
 
+# Whole-scan wall clock budget. Broadcast discovery does not depend on subnet size; the HTTP
+# fallback simply stops at the deadline instead of covering a fixed number of hosts.
+SCAN_BUDGET_S = 1.8
+# Firmware jitters discovery replies by up to 100 ms; the window leaves room for Wi-Fi latency.
+DISCOVERY_WINDOW_S = 0.6
+DISCOVERY_RESEND_S = 0.25
+DISCOVERY_PORT = 4211
+DISCOVERY_MAGIC = b"8BB?"
+MDNS_ADDR = ("224.0.0.251", 5353)
+MDNS_SERVICE = "_8bb._tcp.local"
+PROBE_CONCURRENCY = 128
+PROBE_CONNECT_TIMEOUT_S = 0.4
+NEIGHBOR_PROBE_LIMIT = 20
+# ARP priming sends one datagram per host; stay below the kernel's neighbour table soft limit.
+PRIME_MAX_HOSTS = 512
+DISCOVERED_SCORE = 10
+
 ARP_RE = re.compile(r"(?:\(|\s)(\d+\.\d+\.\d+\.\d+)(?:\)|\s).{0,40}(([0-9a-f]{2}[:-]){5}[0-9a-f]{2})", re.IGNORECASE)
 IP_NEIGH_RE = re.compile(
     r"^\s*(\d+\.\d+\.\d+\.\d+)\s+dev\s+\S+(?:\s+lladdr\s+(([0-9a-f]{2}:){5}[0-9a-f]{2}))?.*$",
@@ -47,11 +69,10 @@ def _sanitize_name(value: Any) -> str:
     return text[:96]
 
 
-def _quick_http_probe(ip: str) -> tuple[str, int, str]:
+async def _quick_http_probe(client: httpx.AsyncClient, ip: str) -> tuple[str, int, str]:
     # Keep probing short, but long enough for slower ESP web handlers.
     try:
-        with httpx.Client(timeout=1.2) as client:
-            status_res = client.get(f"http://{ip}/api/status")
+        status_res = await client.get(f"http://{ip}/api/status", timeout=httpx.Timeout(1.2, connect=PROBE_CONNECT_TIMEOUT_S))
         if status_res.status_code < 400:
             try:
                 body = status_res.json()
@@ -68,12 +89,14 @@ def _quick_http_probe(ip: str) -> tuple[str, int, str]:
                 return hint, 8, name
             except Exception:
                 return "esp_firmware", 6, ""
+    except (httpx.ConnectError, httpx.ConnectTimeout):
+        # Nothing listens on port 80; the other paths would fail the same way.
+        return "unknown", 0, ""
     except Exception:
         pass
 
     try:
-        with httpx.Client(timeout=1.0) as client:
-            status_res = client.get(f"http://{ip}/status")
+        status_res = await client.get(f"http://{ip}/status", timeout=1.0)
         if status_res.status_code < 400:
             text = status_res.text.lower()
             if "relay" in text or "esp" in text or "switch" in text or "light" in text:
@@ -82,8 +105,7 @@ def _quick_http_probe(ip: str) -> tuple[str, int, str]:
         pass
 
     try:
-        with httpx.Client(timeout=0.8) as client:
-            root_res = client.get(f"http://{ip}/")
+        root_res = await client.get(f"http://{ip}/", timeout=0.8)
         if root_res.status_code < 400:
             body = root_res.text.lower()
             if any(marker in body for marker in ("tuya", "smartlife", "moes", "gateway", "bhub")):
@@ -126,22 +148,254 @@ def _network_from_hint(subnet_hint: str | None) -> ipaddress.IPv4Network | None:
     return None
 
 
-def _ping_once(ip: str, timeout_ms: int = 240) -> None:
-    os_name = platform.system().lower()
-    if "windows" in os_name:
-        cmd = ["ping", "-n", "1", "-w", str(timeout_ms), ip]
-    else:
-        cmd = ["ping", "-c", "1", "-W", "1", ip]
+def _in_network(ip: str, network: ipaddress.IPv4Network | None) -> bool:
+    if not ip:
+        return False
+    if network is None:
+        return True
     try:
-        subprocess.run(cmd, stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL, check=False)
-    except Exception:
+        return ipaddress.ip_address(ip) in network
+    except ValueError:
+        return False
+
+
+def _hosts(network: ipaddress.IPv4Network) -> Iterator[str]:
+    # A /32 hint has no hosts() on older Pythons; probe the address itself.
+    if network.num_addresses == 1:
+        yield str(network.network_address)
+        return
+    for ip in network.hosts():
+        yield str(ip)
+
+
+def _prime_arp(hosts: Iterable[str]) -> int:
+    # One datagram to the discard port makes the OS resolve the neighbour, which is all the ARP
+    # table needs; unlike ping it never waits for an answer.
+    sent = 0
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    try:
+        sock.setblocking(False)
+        for ip in hosts:
+            if sent >= PRIME_MAX_HOSTS:
+                break
+            try:
+                sock.sendto(b"\0", (ip, 9))
+            except OSError:
+                pass
+            sent += 1
+    finally:
+        sock.close()
+    return sent
+
+
+def _discovery_targets(network: ipaddress.IPv4Network | None) -> list[str]:
+    targets = ["255.255.255.255"]
+    if network is not None:
+        if network.num_addresses == 1:
+            targets = [str(network.network_address)]
+        elif network.prefixlen < 31:
+            targets.append(str(network.broadcast_address))
+    return targets
+
+
+def _mdns_query() -> bytes:
+    qname = b"".join(bytes([len(label)]) + label.encode("ascii") for label in MDNS_SERVICE.split(".")) + b"\0"
+    # PTR question with the unicast-response bit set; sent from an ephemeral port the responder
+    # answers us directly instead of multicasting to the whole LAN.
+    return struct.pack("!6H", 0, 0, 1, 0, 0, 0) + qname + struct.pack("!HH", 12, 0x8001)
+
+
+def _dns_name(data: bytes, offset: int) -> tuple[str, int]:
+    labels: list[str] = []
+    end = -1
+    for _ in range(64):
+        length = data[offset]
+        if length & 0xC0 == 0xC0:
+            if end < 0:
+                end = offset + 2
+            offset = ((length & 0x3F) << 8) | data[offset + 1]
+            continue
+        if length == 0:
+            return ".".join(labels), end if end >= 0 else offset + 1
+        labels.append(data[offset + 1 : offset + 1 + length].decode("utf-8", "replace"))
+        offset += 1 + length
+    raise ValueError("dns name too long")
+
+
+def _parse_mdns_response(data: bytes) -> list[dict[str, Any]]:
+    """Instances of MDNS_SERVICE in one response: hostname, port, ip (A record) and TXT items."""
+    try:
+        _id, flags, qdcount, ancount, nscount, arcount = struct.unpack("!6H", data[:12])
+        if not flags & 0x8000:
+            return []
+        offset = 12
+        for _ in range(qdcount):
+            _, offset = _dns_name(data, offset)
+            offset += 4
+        # Lowercased instance name -> name as advertised.
+        instances: dict[str, str] = {}
+        srv: dict[str, tuple[str, int]] = {}
+        txt: dict[str, dict[str, str]] = {}
+        addrs: dict[str, str] = {}
+        for _ in range(ancount + nscount + arcount):
+            name, offset = _dns_name(data, offset)
+            rtype, _rclass, _ttl, rdlen = struct.unpack("!HHIH", data[offset : offset + 10])
+            rdata = offset + 10
+            offset = rdata + rdlen
+            if offset > len(data):
+                break
+            key = name.lower()
+            if rtype == 12 and key == MDNS_SERVICE:
+                instance = _dns_name(data, rdata)[0]
+                instances[instance.lower()] = instance
+            elif rtype == 33:
+                port = struct.unpack("!H", data[rdata + 4 : rdata + 6])[0]
+                srv[key] = (_dns_name(data, rdata + 6)[0], port)
+            elif rtype == 16:
+                items: dict[str, str] = {}
+                pos = rdata
+                while pos < offset:
+                    size = data[pos]
+                    entry = data[pos + 1 : pos + 1 + size].decode("utf-8", "replace")
+                    pos += 1 + size
+                    k, _, v = entry.partition("=")
+                    if k:
+                        items[k.lower()] = v
+                txt[key] = items
+            elif rtype == 1 and rdlen == 4:
+                addrs[key] = socket.inet_ntoa(data[rdata:offset])
+    except (IndexError, ValueError, struct.error):
+        return []
+
+    for key in (*srv, *txt):
+        if key.endswith("." + MDNS_SERVICE):
+            instances.setdefault(key, key)
+    out: list[dict[str, Any]] = []
+    for instance, label in instances.items():
+        host, port = srv.get(instance, ("", 80))
+        out.append(
+            {
+                "instance": label[: -len(MDNS_SERVICE) - 1],
+                "hostname": host,
+                "port": port,
+                "ip": addrs.get(host.lower(), ""),
+                "txt": txt.get(instance, {}),
+            }
+        )
+    return out
+
+
+class _DatagramCollector(asyncio.DatagramProtocol):
+    def __init__(self) -> None:
+        self.packets: list[tuple[bytes, str]] = []
+
+    def datagram_received(self, data: bytes, addr: tuple[Any, ...]) -> None:
+        self.packets.append((data, str(addr[0])))
+
+    def error_received(self, exc: Exception) -> None:
         pass
 
 
-def _probe_ip_candidate(ip: str) -> dict[str, Any] | None:
-    hint, boost, name = _quick_http_probe(ip)
-    if boost <= 0:
-        return None
+def _discovered_row(source: str, ip: str, fields: dict[str, Any]) -> dict[str, Any]:
+    device_type = str(fields.get("type", "") or "").strip().lower()
+    hint = device_type or "esp_firmware"
+    hostname = str(fields.get("hostname", "") or "").strip()
+    return {
+        "ip": ip,
+        "mac": str(fields.get("mac", "") or "").strip().lower(),
+        "hostname": hostname,
+        "name": _sanitize_name(fields.get("name")) or hostname,
+        "source": source,
+        "device_hint": hint,
+        "provider_hint": hint,
+        "score": DISCOVERED_SCORE,
+        "automation_candidate": True,
+        "device_id": str(fields.get("device_id", "") or "").strip(),
+        "fw_version": str(fields.get("fw_version", "") or "").strip(),
+    }
+
+
+async def _discover(network: ipaddress.IPv4Network | None, window_s: float) -> list[dict[str, Any]]:
+    """Broadcast the firmware's UDP discovery probe and an mDNS query, collecting replies for window_s."""
+    loop = asyncio.get_running_loop()
+
+    async def open_endpoint(allow_broadcast: bool) -> tuple[asyncio.DatagramTransport, _DatagramCollector] | None:
+        try:
+            return await loop.create_datagram_endpoint(_DatagramCollector, local_addr=("0.0.0.0", 0), allow_broadcast=allow_broadcast)
+        except OSError:
+            return None
+
+    udp = await open_endpoint(True)
+    mdns = await open_endpoint(False)
+    try:
+        started = time.monotonic()
+        for attempt in range(2):
+            if udp is not None:
+                for target in _discovery_targets(network):
+                    try:
+                        udp[0].sendto(DISCOVERY_MAGIC, (target, DISCOVERY_PORT))
+                    except OSError:
+                        pass
+            if mdns is not None:
+                try:
+                    mdns[0].sendto(_mdns_query(), MDNS_ADDR)
+                except OSError:
+                    pass
+            if attempt == 0:
+                await asyncio.sleep(DISCOVERY_RESEND_S)
+        await asyncio.sleep(max(0.0, window_s - (time.monotonic() - started)))
+    finally:
+        for endpoint in (udp, mdns):
+            if endpoint is not None:
+                endpoint[0].close()
+
+    rows: dict[str, dict[str, Any]] = {}
+    if udp is not None:
+        for data, src in udp[1].packets:
+            try:
+                reply = json.loads(data.decode("utf-8"))
+            except (UnicodeDecodeError, ValueError):
+                continue
+            if not isinstance(reply, dict) or not reply.get("device_id"):
+                continue
+            ip = str(reply.get("ip", "") or "").strip() or src
+            if _in_network(ip, network):
+                rows[ip] = _discovered_row("udp_discovery", ip, reply)
+    if mdns is not None:
+        for data, src in mdns[1].packets:
+            for item in _parse_mdns_response(data):
+                ip = item["ip"] or src
+                if not _in_network(ip, network):
+                    continue
+                hostname = str(item["hostname"]).rstrip(".")
+                row = rows.get(ip)
+                if row is None:
+                    txt = item["txt"]
+                    rows[ip] = _discovered_row("mdns", ip, {**txt, "hostname": hostname, "name": item["instance"]})
+                elif not row["hostname"]:
+                    row["hostname"] = hostname
+    return list(rows.values())
+
+
+async def _run_bounded(items: Iterable[str], worker: Any, deadline: float, concurrency: int = PROBE_CONCURRENCY) -> None:
+    """Run worker(item) over items with at most `concurrency` in flight, abandoning what is left at deadline."""
+    queue = iter(items)
+
+    async def drain() -> None:
+        for item in queue:
+            if time.monotonic() >= deadline:
+                return
+            await worker(item)
+
+    tasks = [asyncio.create_task(drain()) for _ in range(concurrency)]
+    _, pending = await asyncio.wait(tasks, timeout=max(0.0, deadline - time.monotonic()))
+    for task in pending:
+        task.cancel()
+    if pending:
+        await asyncio.gather(*pending, return_exceptions=True)
+
+
+def _probe_row(ip: str, hint: str, boost: int, name: str) -> dict[str, Any]:
     return {
         "ip": ip,
         "mac": "",
@@ -155,21 +409,14 @@ def _probe_ip_candidate(ip: str) -> dict[str, Any] | None:
     }
 
 
-def _active_http_probe(network: ipaddress.IPv4Network, max_hosts: int = 256) -> list[dict[str, Any]]:
-    hosts = [str(ip) for ip in network.hosts()]
-    if len(hosts) > max_hosts:
-        hosts = hosts[:max_hosts]
-    if not hosts:
-        return []
-    out: list[dict[str, Any]] = []
-    with ThreadPoolExecutor(max_workers=64) as pool:
-        for item in pool.map(_probe_ip_candidate, hosts):
-            if item:
-                out.append(item)
-    return out
+def _reverse_lookup(ip: str) -> str:
+    try:
+        return socket.gethostbyaddr(ip)[0]
+    except OSError:
+        return ""
 
 
-def _collect_neighbors(resolve_hostnames: bool) -> list[dict[str, Any]]:
+def _collect_neighbors() -> list[dict[str, Any]]:
     rows: list[dict[str, Any]] = []
 
     try:
@@ -180,20 +427,12 @@ def _collect_neighbors(resolve_hostnames: bool) -> list[dict[str, Any]]:
                 continue
             ip = match.group(1)
             mac = match.group(2).replace("-", ":").lower()
-            hostname = ""
-            if resolve_hostnames:
-                import socket
-
-                try:
-                    hostname = socket.gethostbyaddr(ip)[0]
-                except OSError:
-                    hostname = ""
             rows.append(
                 {
                     "ip": ip,
                     "mac": mac,
-                    "hostname": hostname,
-                    "name": hostname,
+                    "hostname": "",
+                    "name": "",
                     "source": "arp",
                     "device_hint": "unknown",
                 }
@@ -235,17 +474,108 @@ def prime_neighbors(subnet_hint: str | None = None) -> int:
     network = _network_from_hint(subnet_hint)
     if network is None:
         return 0
+    return _prime_arp(_hosts(network))
 
-    # Keep bounded and quick.
-    hosts = [str(ip) for ip in network.hosts()]
-    if len(hosts) > 256:
-        hosts = hosts[:256]
-    if not hosts:
-        return 0
 
-    with ThreadPoolExecutor(max_workers=64) as pool:
-        list(pool.map(_ping_once, hosts))
-    return len(hosts)
+async def _scan(
+    network: ipaddress.IPv4Network | None,
+    resolve_hostnames: bool,
+    automation_only: bool,
+) -> list[dict[str, Any]]:
+    deadline = time.monotonic() + SCAN_BUDGET_S
+    loop = asyncio.get_running_loop()
+    # Blocking helpers (arp, reverse DNS) run here; the pool is abandoned rather than joined at the
+    # deadline so a slow resolver cannot stretch the scan.
+    pool = ThreadPoolExecutor(max_workers=16)
+    try:
+        if network is not None:
+            # Warm the ARP table for the requested subnet while discovery replies come in.
+            _prime_arp(_hosts(network))
+
+        async def neighbors_after_priming() -> list[dict[str, Any]]:
+            await asyncio.sleep(DISCOVERY_WINDOW_S / 2)
+            return await loop.run_in_executor(pool, _collect_neighbors)
+
+        discovered, neighbors = await asyncio.gather(_discover(network, DISCOVERY_WINDOW_S), neighbors_after_priming())
+        by_ip: dict[str, dict[str, Any]] = {row["ip"]: row for row in discovered}
+        results: list[dict[str, Any]] = list(discovered)
+
+        # Dedupe by IP before enrichment/filter; discovery replies already carry the identity.
+        pending: list[dict[str, Any]] = []
+        for row in neighbors:
+            ip = str(row.get("ip", "")).strip()
+            if not _in_network(ip, network):
+                continue
+            known = by_ip.get(ip)
+            if known is not None:
+                if not known.get("mac") and row.get("mac"):
+                    known["mac"] = row["mac"]
+                continue
+            by_ip[ip] = row
+            pending.append(row)
+
+        if resolve_hostnames and pending:
+            lookups = {row["ip"]: loop.run_in_executor(pool, _reverse_lookup, row["ip"]) for row in pending}
+            done, _ = await asyncio.wait(lookups.values(), timeout=max(0.0, deadline - time.monotonic() - 0.8))
+            for row in pending:
+                future = lookups[row["ip"]]
+                if future in done and future.result():
+                    row["hostname"] = row["name"] = future.result()
+
+        limits = httpx.Limits(max_connections=PROBE_CONCURRENCY, max_keepalive_connections=0)
+        async with httpx.AsyncClient(limits=limits) as client:
+            # In automation-only mode every neighbor is probed so ESP devices that appear late in
+            # ARP order are not missed.
+            probe_rows = pending if automation_only else pending[:NEIGHBOR_PROBE_LIMIT]
+            probe_by_ip = {str(row.get("ip", "")).strip(): row for row in probe_rows}
+            for row in pending:
+                row["score"] = _marker_score(f"{row.get('hostname', '')} {row.get('mac', '')}")
+                row["provider_hint"] = "marker_match" if row["score"] > 0 else "unknown"
+
+            async def probe_neighbor(ip: str) -> None:
+                row = probe_by_ip[ip]
+                hint, boost, friendly_name = await _quick_http_probe(client, ip)
+                if boost <= 0:
+                    return
+                row["provider_hint"] = hint
+                row["score"] += boost
+                if hint not in ("unknown", "marker_match") and row.get("device_hint", "unknown") == "unknown":
+                    row["device_hint"] = hint
+                if friendly_name and not str(row.get("name", "")).strip():
+                    row["name"] = friendly_name
+
+            await _run_bounded(list(probe_by_ip), probe_neighbor, deadline)
+            for row in pending:
+                row["automation_candidate"] = row["score"] >= 1
+                results.append(row)
+
+            # Active sweep, only as a fallback: always in automation-only mode (more reliable on
+            # busy LANs) and when discovery and the neighbor table came back sparse.
+            if network is not None and (automation_only or len(results) < 2):
+                probed = set(by_ip)
+
+                async def sweep(ip: str) -> None:
+                    hint, boost, name = await _quick_http_probe(client, ip)
+                    if boost > 0:
+                        results.append(_probe_row(ip, hint, boost, name))
+
+                await _run_bounded((ip for ip in _hosts(network) if ip not in probed), sweep, deadline)
+    finally:
+        pool.shutdown(wait=False, cancel_futures=True)
+
+    if automation_only:
+        results = [row for row in results if bool(row.get("automation_candidate"))]
+    return results
+
+
+def _run(coro: Coroutine[Any, Any, list[dict[str, Any]]]) -> list[dict[str, Any]]:
+    try:
+        asyncio.get_running_loop()
+    except RuntimeError:
+        return asyncio.run(coro)
+    # Called from inside an event loop: run the scan on its own loop in a worker thread.
+    with ThreadPoolExecutor(max_workers=1) as runner:
+        return runner.submit(asyncio.run, coro).result()
 
 
 def scan_network(
@@ -253,89 +583,6 @@ def scan_network(
     resolve_hostnames: bool = False,
     automation_only: bool = False,
 ) -> list[dict[str, Any]]:
-    network = _network_from_hint(subnet_hint)
-    if network is not None:
-        # Warm ARP table for the requested subnet before reading arp cache.
-        prime_neighbors(str(network))
-
-    results: list[dict[str, Any]] = _collect_neighbors(resolve_hostnames)
-
-    # Dedupe by IP before enrichment/filter.
-    deduped: list[dict[str, Any]] = []
-    seen_ips: set[str] = set()
-    for row in results:
-        ip = str(row.get("ip", "")).strip()
-        if network is not None:
-            try:
-                if ipaddress.ip_address(ip) not in network:
-                    continue
-            except ValueError:
-                continue
-        if not ip or ip in seen_ips:
-            continue
-        seen_ips.add(ip)
-        deduped.append(row)
-    results = deduped
-
-    if results:
-        # In automation-only mode we should probe all neighbor entries to avoid
-        # missing valid ESP devices that appear late in ARP order.
-        probe_budget = len(results) if automation_only else 20
-        filtered: list[dict[str, Any]] = []
-        for item in results:
-            ip = str(item.get("ip", "")).strip()
-            host = str(item.get("hostname", "")).strip()
-            mac = str(item.get("mac", "")).strip()
-            score = _marker_score(f"{host} {mac}")
-            provider_hint = "unknown"
-            if score > 0:
-                provider_hint = "marker_match"
-
-            if ip and probe_budget > 0:
-                hint, boost, friendly_name = _quick_http_probe(ip)
-                probe_budget -= 1
-                if boost > 0:
-                    provider_hint = hint
-                    score += boost
-                    if hint not in ("unknown", "marker_match") and item.get("device_hint", "unknown") == "unknown":
-                        item["device_hint"] = hint
-                    if friendly_name and not str(item.get("name", "")).strip():
-                        item["name"] = friendly_name
-
-            candidate = score >= 1
-            item["automation_candidate"] = candidate
-            item["provider_hint"] = provider_hint
-            item["score"] = score
-            if not automation_only or candidate:
-                filtered.append(item)
-        results = filtered
-
-    # Active probe pass:
-    # - Always in automation-only mode (more reliable on busy LANs).
-    # - Also when neighbor table is sparse.
-    should_active_probe = network is not None and (automation_only or len(results) < 2)
-    if should_active_probe:
-        active_hits = _active_http_probe(network)
-        if active_hits:
-            by_ip = {str(r.get("ip", "")).strip(): r for r in results}
-            for hit in active_hits:
-                ip = str(hit.get("ip", "")).strip()
-                if not ip:
-                    continue
-                if ip in by_ip:
-                    row = by_ip[ip]
-                    row["score"] = max(int(row.get("score", 0)), int(hit.get("score", 0)))
-                    if str(row.get("provider_hint", "unknown")) == "unknown":
-                        row["provider_hint"] = hit.get("provider_hint", "unknown")
-                    if str(row.get("device_hint", "unknown")) == "unknown":
-                        row["device_hint"] = hit.get("device_hint", "unknown")
-                    if not str(row.get("name", "")).strip():
-                        row["name"] = str(hit.get("name", "")).strip()
-                    row["automation_candidate"] = True
-                else:
-                    results.append(hit)
-
-        if automation_only:
-            results = [row for row in results if bool(row.get("automation_candidate"))]
-
-    return results
+    """Find LAN devices in about SCAN_BUDGET_S: 8bb discovery/mDNS replies, then ARP neighbors
+    and a bounded-concurrency HTTP probe for hosts that did not answer discovery."""
+    return _run(_scan(_network_from_hint(subnet_hint), resolve_hostnames, automation_only))
@@ -145,6 +145,20 @@ class DeviceCommandRequest(BaseModel):
 class DeviceOTAPushRequest(BaseModel):
     firmware_filename: str
     version: str
+    base_firmware_filename: str | None = None
+
+
+class OTARolloutRequest(BaseModel):
+    device_ids: list[str]
+    firmware_filename: str
+    version: str
+    base_firmware_filename: str | None = None
+    parallelism: int = Field(default=4, ge=1, le=16)
+    canary_count: int = Field(default=1, ge=0)
+    wave_size: int = Field(default=0, ge=0)
+    max_failures: int = Field(default=0, ge=0)
+    health_timeout_s: float = Field(default=180.0, ge=30.0, le=1800.0)
+    force: bool = False
 
 
 class FirmwareProfileCreate(BaseModel):